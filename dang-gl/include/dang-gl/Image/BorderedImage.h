@@ -2,6 +2,7 @@
 
 #include "dang-gl/Image/Image.h"
 #include "dang-gl/Image/ImageBorder.h"
+#include "dang-gl/Image/ImageMipmaps.h"
 #include "dang-gl/Image/PixelFormat.h"
 #include "dang-gl/Image/PixelType.h"
 #include "dang-gl/global.h"
@@ -53,11 +54,54 @@ public:
         return {border, std::visit(ReplaceBorder{std::move(image)}, border)};
     }
 
+    /// @brief Loads a PNG image from the given stream, which is decoded with room for the border to fill it in place.
+    /// @exception PNGError if the stream does not contain a valid PNG.
+    static BorderedImage loadFromPNG(const Border& border, std::istream& stream)
+    {
+        auto [pad_low, pad_high] = borderPadding(border);
+        return replaceBorder(border, Image::loadFromPNG(stream, pad_low, pad_high));
+    }
+
+    /// @brief Loads a PNG image from data in memory, which is decoded with room for the border to fill it in place.
+    /// @exception PNGError if the data does not represent a valid PNG.
+    static BorderedImage loadFromPNG(const Border& border, std::span<const std::byte> data)
+    {
+        auto [pad_low, pad_high] = borderPadding(border);
+        return replaceBorder(border, Image::loadFromPNG(data, pad_low, pad_high));
+    }
+
+    /// @brief Loads a PNG image from the given file, which is decoded with room for the border to fill it in place.
+    /// @exception PNGError if the file cannot be opened.
+    /// @exception PNGError if the file does not represent a valid PNG.
+    static BorderedImage loadFromPNG(const Border& border, const fs::path& path)
+    {
+        auto [pad_low, pad_high] = borderPadding(border);
+        return replaceBorder(border, Image::loadFromPNG(path, pad_low, pad_high));
+    }
+
     /// @brief The image with the now applied border.
     const auto& image() const& { return image_; }
     /// @brief The image with the now applied border.
     auto image() && { return std::move(image_); }
 
+    /// @brief Generates mipmaps for a total number of levels, unless at least that many levels exist already.
+    /// @remark Wrapping borders keep mipmaps seamless, while all other borders simply clamp at the edge of the image.
+    /// @remark Since only the pixels of this image are used, tiles in a texture atlas can never bleed into each other.
+    /// @remark Unlike the free generateMipmaps, levels past a single pixel stay at a single pixel, as a texture atlas
+    /// asks for as many levels as its cells have, which can be more than a smaller tile has on its own.
+    void generateMipmaps(std::size_t levels, const MipmapOptions& options = {})
+    {
+        if (!image_ || mipmapLevels() >= levels)
+            return;
+        mipmaps_ = detail::generateMipmaps(image_, levels, options, std::visit(MipmapEdges{image_.size()}, border_));
+    }
+
+    /// @brief The number of mipmap levels, including the image itself.
+    std::size_t mipmapLevels() const { return mipmaps_.size() + 1; }
+
+    /// @brief The image of the given mipmap level, with level zero being the image itself.
+    const Image& mipmap(std::size_t level) const { return level == 0 ? image_ : mipmaps_[level - 1]; }
+
     // --- BorderedImageData concept:
 
     /// @brief The border that the image now has.
@@ -73,7 +117,14 @@ public:
     const auto& size() const { return image_.size(); }
 
     /// @brief Frees all image data, but leaves the size intact.
-    void free() { image_.free(); }
+    void free()
+    {
+        image_.free();
+        mipmaps_.clear();
+    }
+
+    /// @brief Creates an image without any data, which only has a border and a size, just like a freed image.
+    static BorderedImage placeholder(const Border& border, Size size) { return {border, Image::placeholder(size)}; }
 
 private:
     /// @brief Assumes the given image already has the specified border style.
@@ -82,38 +133,12 @@ private:
         , image_(std::move(image))
     {}
 
-    struct AddBorder {
-        const Image& image;
-
-        Image operator()(BorderNone) const
-        {
-            // Copy could be avoided in this rare case...
-            return image;
-        }
-
-        Image operator()(BorderSolid border) const
-        {
-            // This could be optimized by not filling it with the color completely.
-            // Maybe add an additional Image ctor taking size, image, offset and fill color.
-            Image new_image(image.size() + 2, border.color);
-            new_image.setSubImage({1}, image);
-            return new_image;
-        }
-
-        Image operator()(BorderWrapBoth border) const
-        {
-            Image new_image(image.size() + 2);
-            new_image.setSubImage({1}, image);
-            return ReplaceBorder{std::move(new_image)}(border);
-        }
-
-        Image operator()(BorderWrapPositive border) const
-        {
-            Image new_image(image.size() + 1);
-            new_image.setSubImage({0}, image);
-            return ReplaceBorder{std::move(new_image)}(border);
-        }
-    };
+    /// @brief Splits the padding of the border into the parts in front of and after the image.
+    static std::pair<Size, Size> borderPadding(const Border& border)
+    {
+        auto padding = std::visit(imageBorderPadding, border);
+        return {padding / 2, padding - padding / 2};
+    }
 
     struct ReplaceBorder {
         Image image;
@@ -122,36 +147,134 @@ private:
 
         Image operator()(BorderSolid border) &&
         {
-            Bounds bounds(image.size());
-            for (std::size_t facing = 0; facing < dim * 2; facing++)
-                for (const auto& pos : bounds.facing(facing, typename Bounds::ClipInfo{false, true}).xFirst())
-                    image[pos] = border.color;
+            if constexpr (dim == 2) {
+                if (image.count() == 0)
+                    return std::move(image);
+                auto [width, height] = image.size();
+                std::fill_n(row(0), width, border.color);
+                for (std::size_t y = 1; y < height - 1; y++) {
+                    auto pixels = row(y);
+                    pixels[0] = border.color;
+                    pixels[width - 1] = border.color;
+                }
+                std::fill_n(row(height - 1), width, border.color);
+            }
+            else {
+                Bounds bounds(image.size());
+                for (std::size_t facing = 0; facing < dim * 2; facing++)
+                    for (const auto& pos : bounds.facing(facing, typename Bounds::ClipInfo{false, true}).xFirst())
+                        image[pos] = border.color;
+            }
             return std::move(image);
         }
 
         Image operator()(BorderWrapBoth) &&
         {
             auto size = image.size();
-            Bounds bounds(size);
-            for (std::size_t facing = 0; facing < dim * 2; facing++)
-                for (const auto& pos : bounds.facing(facing, typename Bounds::ClipInfo{false, true}).xFirst())
-                    image[pos] = image[(pos + size - 3) % (size - 2) + 1];
+            if (size.lessThan(3).any())
+                return std::move(image);
+            if constexpr (dim == 2) {
+                // Columns first, so that copying whole rows afterwards also takes care of the corners.
+                auto [width, height] = size;
+                for (std::size_t y = 1; y < height - 1; y++) {
+                    auto pixels = row(y);
+                    pixels[0] = pixels[width - 2];
+                    pixels[width - 1] = pixels[1];
+                }
+                copyRow(height - 2, 0);
+                copyRow(1, height - 1);
+            }
+            else {
+                Bounds bounds(size);
+                for (std::size_t facing = 0; facing < dim * 2; facing++)
+                    for (const auto& pos : bounds.facing(facing, typename Bounds::ClipInfo{false, true}).xFirst())
+                        image[pos] = image[(pos + size - 3) % (size - 2) + 1];
+            }
             return std::move(image);
         }
 
         Image operator()(BorderWrapPositive) &&
         {
-            Bounds bounds(image.size());
-            auto inner_size = image.size() - 1;
-            for (std::size_t facing = 1; facing < dim * 2; facing += 2)
-                for (const auto& pos : bounds.facing(facing, typename Bounds::ClipInfo{false, false}).xFirst())
-                    image[pos] = image[(pos + inner_size) % inner_size];
+            if (image.size().lessThan(2).any())
+                return std::move(image);
+            if constexpr (dim == 2) {
+                auto [width, height] = image.size();
+                for (std::size_t y = 0; y < height - 1; y++) {
+                    auto pixels = row(y);
+                    pixels[width - 1] = pixels[0];
+                }
+                copyRow(0, height - 1);
+            }
+            else {
+                Bounds bounds(image.size());
+                auto inner_size = image.size() - 1;
+                for (std::size_t facing = 1; facing < dim * 2; facing += 2)
+                    for (const auto& pos : bounds.facing(facing, typename Bounds::ClipInfo{false, false}).xFirst())
+                        image[pos] = image[(pos + inner_size) % inner_size];
+            }
             return std::move(image);
         }
+
+        /// @brief The pixels of a single row of a two-dimensional image.
+        Pixel* row(std::size_t y) { return &image[Size(0, y)]; }
+
+        /// @brief Copies a whole row of a two-dimensional image, including the already filled corners.
+        void copyRow(std::size_t from, std::size_t to) { std::memcpy(row(to), row(from), image.byteWidth()); }
+    };
+
+    struct AddBorder {
+        const Image& image;
+
+        Image operator()(BorderNone) const
+        {
+            // Copy could be avoided in this rare case...
+            return image;
+        }
+
+        Image operator()(BorderSolid border) const { return Image(image.size() + 2, border.color, image, Size(1)); }
+
+        Image operator()(BorderWrapBoth border) const { return wrap(Size(1), 2)(border); }
+
+        Image operator()(BorderWrapPositive border) const { return wrap(Size(0), 1)(border); }
+
+        /// @brief Copies the image into a padded one, leaving the border uninitialized, since wrapping overwrites it.
+        /// @remark Images without any pixels have nothing to wrap around, so their border is filled with zeros instead.
+        ReplaceBorder wrap(const Size& offset, std::size_t padding) const
+        {
+            if (image.count() == 0)
+                return {Image(image.size() + padding, Pixel())};
+            auto new_image = Image::uninitialized(image.size() + padding);
+            new_image.setSubImage(offset, image);
+            return {std::move(new_image)};
+        }
+    };
+
+    /// @brief Wraps mipmaps around the period of the image without the border.
+    struct MipmapEdges {
+        Size size;
+
+        using Edges = std::array<detail::MipmapEdge, dim>;
+
+        Edges operator()(BorderNone) const { return {}; }
+
+        Edges operator()(BorderSolid) const { return {}; }
+
+        Edges operator()(BorderWrapBoth) const { return wrap(1, 2); }
+
+        Edges operator()(BorderWrapPositive) const { return wrap(0, 1); }
+
+        Edges wrap(std::size_t offset, std::size_t padding) const
+        {
+            Edges edges;
+            for (std::size_t axis = 0; axis < dim; axis++)
+                edges[axis] = {static_cast<double>(offset), static_cast<double>(size[axis] - padding)};
+            return edges;
+        }
     };
 
     Border border_;
     Image image_;
+    std::vector<Image> mipmaps_;
 };
 
 } // namespace dang::gl
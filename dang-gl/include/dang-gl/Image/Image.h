@@ -1,9 +1,12 @@
 #pragma once
 
+#include "dang-gl/Image/MappedFile.h"
 #include "dang-gl/Image/PNGLoader.h"
+#include "dang-gl/Image/PNGWriter.h"
 #include "dang-gl/Image/Pixel.h"
 #include "dang-gl/Image/PixelFormat.h"
 #include "dang-gl/Image/PixelType.h"
+#include "dang-gl/Image/QOI.h"
 #include "dang-gl/global.h"
 #include "dang-math/bounds.h"
 #include "dang-math/vector.h"
@@ -46,8 +49,9 @@ public:
     {
         size_ = other.size_;
         auto byte_count = byteCount();
-        data_ = std::make_unique<std::byte[]>(byte_count);
+        data_ = std::make_unique_for_overwrite<std::byte[]>(byte_count);
         std::memcpy(data_.get(), other.data_.get(), byte_count);
+        return *this;
     }
 
     Image& operator=(Image&&) = default;
@@ -56,8 +60,8 @@ public:
     Image(const Size& size, const Pixel& value = {})
         : size_(size)
     {
-        for (const auto& pos : Bounds(size_).xFirst())
-            new (&(*this)[pos]) Pixel(value);
+        for (std::size_t row = 0; row < rowCount(); row++)
+            std::uninitialized_fill_n(rowPixels(row), size_[0], value);
     }
 
     /// @brief Initializes the image using the given size and pixel iterator.
@@ -65,8 +69,35 @@ public:
     Image(const Size& size, TIter first)
         : size_(size)
     {
-        for (const auto& pos : Bounds(size_).xFirst())
-            new (&(*this)[pos]) Pixel(first++);
+        for (std::size_t row = 0; row < rowCount(); row++) {
+            auto pixels = rowPixels(row);
+            for (std::size_t x = 0; x < size_[0]; x++)
+                new (&pixels[x]) Pixel(*first++);
+        }
+    }
+
+    /// @brief Initializes the image using the given size, copies an existing image to the offset and fills the rest.
+    /// @remark Cheaper than filling the whole image and calling setSubImage, as every pixel is only written once.
+    Image(const Size& size, const Pixel& value, const Image& image, const Size& offset)
+        : size_(size)
+    {
+        Bounds image_bounds(offset, offset + image.size());
+        assert(Bounds(size_).contains(image_bounds));
+        auto low_width = offset[0];
+        auto image_width = image.size()[0];
+        auto high_width = size_[0] - low_width - image_width;
+        forEachRow(Bounds(size_), [&](const Size& pos) {
+            auto pixels = &(*this)[pos];
+            auto image_pos = pos;
+            image_pos[0] = offset[0];
+            if (!image_bounds.contains(image_pos)) {
+                std::uninitialized_fill_n(pixels, size_[0], value);
+                return;
+            }
+            std::uninitialized_fill_n(pixels, low_width, value);
+            std::memcpy(pixels + low_width, &image[image_pos - offset], image_width * sizeof(Pixel));
+            std::uninitialized_fill_n(pixels + low_width + image_width, high_width, value);
+        });
     }
 
     /// @brief Initializes the image using the given size and preexisting chunk of data, which should match the size.
@@ -84,32 +115,94 @@ public:
     Image(const Image& image, const Bounds& bounds)
         : size_(bounds.size())
     {
-        for (const auto& pos : bounds.xFirst())
-            new (&(*this)[pos - bounds.low]) Pixel(image[pos]);
+        copyRows({}, image, bounds);
+    }
+
+    /// @brief Creates an image of the given size without initializing any of its pixels.
+    /// @remark Meant for writing all pixels right away, e.g. by converting pixels from another image.
+    static Image uninitialized(const Size& size)
+    {
+        Image result;
+        result.size_ = size;
+        if (result.count() > 0)
+            result.data_ = std::make_unique_for_overwrite<std::byte[]>(result.byteCount());
+        return result;
+    }
+
+    /// @brief Creates an image of the given size without any data, just like a freed image.
+    static Image placeholder(const Size& size)
+    {
+        Image result;
+        result.size_ = size;
+        return result;
     }
 
     /// @brief Loads a PNG image from the given stream and returns it.
     /// @exception PNGError if the stream does not contain a valid PNG.
     static Image loadFromPNG(std::istream& stream, Size pad_low = {}, Size pad_high = {})
     {
-        static_assert(pixel_type == PixelType::UNSIGNED_BYTE, "Loading PNG images only supports unsigned bytes.");
-        PNGLoader png_loader;
-        // TODO: Better logging
-        png_loader.on_warning.append([](const PNGWarningInfo& info) { std::cerr << info.message << '\n'; });
-        png_loader.init(stream);
-        auto data = png_loader.read<pixel_format, row_alignment>(true, pad_low, pad_high);
-        return Image(png_loader.size(pad_low + pad_high), std::move(data));
+        return readPNG(stream, pad_low, pad_high);
+    }
+
+    /// @brief Loads a PNG image from data in memory and returns it.
+    /// @exception PNGError if the data does not represent a valid PNG.
+    static Image loadFromPNG(std::span<const std::byte> data, Size pad_low = {}, Size pad_high = {})
+    {
+        return readPNG(data, pad_low, pad_high);
     }
 
     /// @brief Loads a PNG image from the given file and returns it.
+    /// @remark The file is memory-mapped, so that libpng reads it directly without going through a stream.
     /// @exception PNGError if the file cannot be opened.
     /// @exception PNGError if the file does not represent a valid PNG.
     static Image loadFromPNG(const fs::path& path, Size pad_low = {}, Size pad_high = {})
     {
-        std::ifstream stream(path, std::ios::binary);
-        if (!stream)
+        MappedFile file(path);
+        if (!file)
             throw PNGError("Cannot open PNG file: " + path.string());
-        return loadFromPNG(stream, pad_low, pad_high);
+        return loadFromPNG(file.data(), pad_low, pad_high);
+    }
+
+    /// @brief Loads an image in the QOI format from the given file and returns it.
+    /// @exception QOIError if the file cannot be opened.
+    /// @exception QOIError if the file does not represent a valid QOI image.
+    static Image loadFromQOI(const fs::path& path)
+    {
+        MappedFile file(path);
+        if (!file)
+            throw QOIError("Cannot open QOI file: " + path.string());
+        return decodeQOI<Image>(file.data());
+    }
+
+    /// @brief Saves the image as PNG to the given stream, returning any warnings that libpng reported.
+    /// @exception PNGError if libpng reports an error or the stream cannot be written to.
+    std::vector<std::string> saveToPNG(std::ostream& stream, const PNGWriteOptions& options = {}) const
+    {
+        PNGWriter png_writer;
+        std::vector<std::string> warnings;
+        png_writer.on_warning.append([&](const PNGWriterWarningInfo& info) { warnings.push_back(info.message); });
+        png_writer.write(stream, *this, options);
+        return warnings;
+    }
+
+    /// @brief Saves the image as PNG to the given file, returning any warnings that libpng reported.
+    /// @exception PNGError if the file cannot be opened or written to.
+    std::vector<std::string> saveToPNG(const fs::path& path, const PNGWriteOptions& options = {}) const
+    {
+        std::ofstream stream(path, std::ios::binary);
+        if (!stream)
+            throw PNGError("Cannot open PNG file for writing: " + path.string());
+        return saveToPNG(stream, options);
+    }
+
+    /// @brief Saves the image in the QOI format, which is a lot faster than PNG, but also bigger.
+    /// @exception QOIError if the file cannot be opened or written to.
+    void saveToQOI(const fs::path& path) const
+    {
+        auto qoi = encodeQOI(*this);
+        std::ofstream stream(path, std::ios::binary);
+        if (!stream.write(reinterpret_cast<const char*>(qoi.data()), qoi.size()))
+            throw QOIError("Cannot write QOI file: " + path.string());
     }
 
     /// @brief Returns the size of the image along each axis.
@@ -147,8 +240,7 @@ public:
     /// @brief Copies pixels from a subsection of an existing image with a given offset.
     void setSubImage(const Size& offset, const Image& image, const Bounds& bounds)
     {
-        for (const auto& pos : bounds.xFirst())
-            (*this)[pos + offset] = image[pos];
+        copyRows(offset + bounds.low, image, bounds);
     }
 
     /// @brief Copies pixels from an existing image with a given offset.
@@ -174,6 +266,87 @@ public:
     explicit operator bool() const { return bool{data_}; }
 
 private:
+    /// @brief Reads a PNG from either a stream or data in memory.
+    template <typename TSource>
+    static Image readPNG(TSource& source, Size pad_low, Size pad_high)
+    {
+        static_assert(pixel_type == PixelType::UNSIGNED_BYTE, "Loading PNG images only supports unsigned bytes.");
+        PNGLoader png_loader;
+        // TODO: Better logging
+        png_loader.on_warning.append([](const PNGWarningInfo& info) { std::cerr << info.message << '\n'; });
+        png_loader.init(source);
+        auto data = png_loader.read<pixel_format, row_alignment>(true, pad_low, pad_high);
+        return Image(png_loader.size(pad_low + pad_high), std::move(data));
+    }
+
+    /// @brief The number of rows, which is the product of all but the first component of the size.
+    std::size_t rowCount() const { return size_[0] > 0 ? count() / size_[0] : 0; }
+
+    /// @brief The pixels of the row with the given index, with rows of all dimensions laid out one after another.
+    Pixel* rowPixels(std::size_t row) { return reinterpret_cast<Pixel*>(&data_[row * alignedByteWidth()]); }
+
+    /// @brief Calls the function with the first position of every row in the given bounds.
+    template <typename TFunction>
+    static void forEachRow(const Bounds& bounds, TFunction function)
+    {
+        auto size = bounds.size();
+        if (size.product() == 0)
+            return;
+        auto rows = bounds;
+        rows.high[0] = rows.low[0] + 1;
+        for (const auto& pos : rows.xFirst())
+            function(pos);
+    }
+
+    /// @brief Calls the function with the first position of every row in the given bounds, starting at the last row.
+    template <typename TFunction>
+    static void forEachRowReversed(const Bounds& bounds, TFunction function)
+    {
+        auto size = bounds.size();
+        if (size.product() == 0)
+            return;
+        auto pos = bounds.high - 1;
+        pos[0] = bounds.low[0];
+        while (true) {
+            function(pos);
+            std::size_t axis = 1;
+            for (; axis < dim && pos[axis] == bounds.low[axis]; axis++)
+                pos[axis] = bounds.high[axis] - 1;
+            if (axis == dim)
+                return;
+            pos[axis]--;
+        }
+    }
+
+    /// @brief Copies the given bounds of an image to the target position, using a single copy if the layout allows it.
+    /// @remark Copying within the same image is fine, even if source and target overlap.
+    void copyRows(const Size& target, const Image& image, const Bounds& bounds)
+    {
+        auto size = bounds.size();
+        if (size.product() == 0)
+            return;
+
+        // Everything except for the last axis has to be covered completely by both images for a single copy.
+        bool contiguous = dim > 1 && alignedByteWidth() == image.alignedByteWidth();
+        for (std::size_t i = 0; i < dim - 1; i++)
+            contiguous = contiguous && size[i] == size_[i] && size[i] == image.size_[i];
+        if (contiguous) {
+            auto byte_count = alignedByteWidth() * (size.product() / size[0]);
+            std::memmove(&(*this)[target], &image[bounds.low], byte_count);
+            return;
+        }
+
+        auto byte_width = size[0] * sizeof(Pixel);
+        auto copy_row = [&](const Size& pos) {
+            std::memmove(&(*this)[target + pos - bounds.low], &image[pos], byte_width);
+        };
+        // Rows that come after their source would overwrite rows, which have yet to be copied, so start at the end.
+        if (this == &image && &(*this)[target] > &image[bounds.low])
+            forEachRowReversed(bounds, copy_row);
+        else
+            forEachRow(bounds, copy_row);
+    }
+
     /// @brief A helper function, which calculates the position offset of a single dimension.
     template <std::size_t v_first, std::size_t... v_indices>
     std::size_t posToIndexHelperMul(const Size& pos, std::index_sequence<v_indices...>) const
@@ -195,7 +368,9 @@ private:
     }
 
     Size size_;
-    std::unique_ptr<std::byte[]> data_ = count() > 0 ? std::make_unique<std::byte[]>(byteCount()) : nullptr;
+    // Except for uninitialized, all pixels are written right away, so only the padding at the end of each row is left.
+    std::unique_ptr<std::byte[]> data_ =
+        count() > 0 ? std::make_unique_for_overwrite<std::byte[]>(byteCount()) : nullptr;
 };
 
 using Image1D = Image<1>;
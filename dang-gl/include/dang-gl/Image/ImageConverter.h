@@ -0,0 +1,362 @@
+#pragma once
+
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/Pixel.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-gl/global.h"
+#include "dang-math/vector.h"
+#include "dang-utils/enum.h"
+#include "dang-utils/parallel.h"
+
+namespace dang::gl {
+
+/// @brief Optional steps, which an ImageConverter applies to the color of pixels in between reading and writing them.
+enum class ImageConversionStage {
+    SRGBToLinear,
+    LinearToSRGB,
+    PremultiplyAlpha,
+    UnpremultiplyAlpha,
+
+    COUNT
+};
+
+} // namespace dang::gl
+
+namespace dang::utils {
+
+template <>
+struct enum_count<dang::gl::ImageConversionStage> : default_enum_count<dang::gl::ImageConversionStage> {};
+
+} // namespace dang::utils
+
+namespace dang::gl {
+
+namespace detail {
+
+/// @brief Describes, which components a pixel format has and in which order they are stored.
+/// @remark Just like for PNGLoader, RED is treated as grayscale and RG as grayscale with alpha.
+struct PixelFormatLayout {
+    bool gray;
+    bool alpha;
+    bool bgr;
+    bool integer;
+};
+
+template <PixelFormat v_format>
+inline constexpr PixelFormatLayout pixel_format_layout = [] {
+    constexpr auto integer = v_format >= PixelFormat::RED_INTEGER && v_format <= PixelFormat::BGRA_INTEGER;
+    constexpr auto color = integer ? static_cast<PixelFormat>(static_cast<int>(v_format) -
+                                                              static_cast<int>(PixelFormat::RED_INTEGER))
+                                   : v_format;
+    static_assert(color <= PixelFormat::BGRA, "Only color formats can be converted.");
+    return PixelFormatLayout{color == PixelFormat::RED || color == PixelFormat::RG,
+                             color == PixelFormat::RG || color == PixelFormat::RGBA || color == PixelFormat::BGRA,
+                             color == PixelFormat::BGR || color == PixelFormat::BGRA,
+                             integer};
+}();
+
+/// @brief Rec. 709 luma weights, which libpng also uses by default when converting color to grayscale.
+template <typename T>
+T luma(T red, T green, T blue)
+{
+    return red * T(0.2126) + green * T(0.7152) + blue * T(0.0722);
+}
+
+float halfToFloat(GLhalf value);
+GLhalf floatToHalf(float value);
+
+/// @brief Returns a table, which maps all 8-bit sRGB values to linear values.
+const std::array<float, 256>& srgbToLinearTable();
+
+/// @brief Applies all stages in order to each of the given normalized RGBA pixels.
+void applyStages(std::span<const ImageConversionStage> stages, std::span<dmath::vec4> pixels);
+
+// Kernels for the most common conversions of unsigned byte pixels, which use SIMD if available.
+
+void swapRedBlue(const GLubyte* from, GLubyte* to, std::size_t count);
+void addAlpha(const GLubyte* from, GLubyte* to, std::size_t count, bool swap_red_blue);
+void removeAlpha(const GLubyte* from, GLubyte* to, std::size_t count, bool swap_red_blue);
+void grayToRGBA(const GLubyte* from, GLubyte* to, std::size_t count);
+void narrowToByte(const GLushort* from, GLubyte* to, std::size_t component_count);
+void premultiplyAlpha(const GLubyte* from, GLubyte* to, std::size_t count);
+
+/// @brief Converts a single component to a value in the range [0, 1] for unsigned and [-1, 1] for signed types.
+template <PixelType v_type>
+float normalizeComponent(underlying_pixel_type_t<v_type> value)
+{
+    using Type = underlying_pixel_type_t<v_type>;
+    if constexpr (v_type == PixelType::FLOAT)
+        return value;
+    else if constexpr (v_type == PixelType::HALF_FLOAT)
+        return halfToFloat(value);
+    else if constexpr (std::is_unsigned_v<Type>)
+        return static_cast<float>(value) * (1.0f / static_cast<float>(std::numeric_limits<Type>::max()));
+    else
+        return std::max(static_cast<float>(value) / static_cast<float>(std::numeric_limits<Type>::max()), -1.0f);
+}
+
+/// @brief Converts a normalized value back to a single component, clamping and rounding it as necessary.
+template <PixelType v_type>
+underlying_pixel_type_t<v_type> denormalizeComponent(float value)
+{
+    using Type = underlying_pixel_type_t<v_type>;
+    if constexpr (v_type == PixelType::FLOAT)
+        return value;
+    else if constexpr (v_type == PixelType::HALF_FLOAT)
+        return floatToHalf(value);
+    else {
+        // Floats cannot represent the maximum of 32-bit integers, so those are scaled using doubles instead.
+        using Float = std::conditional_t<sizeof(Type) < sizeof(float), float, double>;
+        constexpr auto max = static_cast<Float>(std::numeric_limits<Type>::max());
+        constexpr auto min = std::is_signed_v<Type> ? Float{-1} : Float{0};
+        auto scaled = std::clamp(static_cast<Float>(value), min, Float{1}) * max;
+        return static_cast<Type>(scaled < 0 ? scaled - Float{0.5} : scaled + Float{0.5});
+    }
+}
+
+/// @brief Converts a single component of an integer format, clamping it to the range of the type.
+template <PixelType v_type>
+underlying_pixel_type_t<v_type> clampComponent(double value)
+{
+    using Type = underlying_pixel_type_t<v_type>;
+    constexpr auto min = static_cast<double>(std::numeric_limits<Type>::lowest());
+    constexpr auto max = static_cast<double>(std::numeric_limits<Type>::max());
+    return static_cast<Type>(std::round(std::clamp(value, min, max)));
+}
+
+/// @brief Reads a pixel as RGBA, which is normalized for color formats and left as is for integer formats.
+/// @remark Gray is copied to all color components and a missing alpha is set to the given value.
+template <PixelFormat v_format, PixelType v_type, typename TWorking>
+TWorking readPixel(const Pixel<v_format, v_type>& pixel, typename TWorking::value_type alpha, bool srgb_table)
+{
+    constexpr auto layout = pixel_format_layout<v_format>;
+    auto component = [&](std::size_t index) -> typename TWorking::value_type {
+        if constexpr (layout.integer)
+            return static_cast<double>(pixel[index]);
+        else if constexpr (v_type == PixelType::UNSIGNED_BYTE) {
+            if (srgb_table && index < (layout.gray ? 1 : 3))
+                return srgbToLinearTable()[pixel[index]];
+            return normalizeComponent<v_type>(pixel[index]);
+        }
+        else
+            return normalizeComponent<v_type>(pixel[index]);
+    };
+
+    TWorking result;
+    if constexpr (layout.gray) {
+        result.x() = result.y() = result.z() = component(0);
+        if constexpr (layout.alpha)
+            alpha = component(1);
+    }
+    else {
+        result.x() = component(layout.bgr ? 2 : 0);
+        result.y() = component(1);
+        result.z() = component(layout.bgr ? 0 : 2);
+        if constexpr (layout.alpha)
+            alpha = component(3);
+    }
+    result.w() = alpha;
+    return result;
+}
+
+/// @brief Writes an RGBA value as a pixel, converting color to gray using luma weights, unless it was gray already.
+template <PixelFormat v_format, PixelType v_type, bool v_from_gray, typename TWorking>
+Pixel<v_format, v_type> writePixel(const TWorking& value)
+{
+    constexpr auto layout = pixel_format_layout<v_format>;
+    auto component = [&](auto component_value) {
+        if constexpr (layout.integer)
+            return clampComponent<v_type>(component_value);
+        else
+            return denormalizeComponent<v_type>(component_value);
+    };
+
+    Pixel<v_format, v_type> result;
+    if constexpr (layout.gray) {
+        if constexpr (v_from_gray)
+            result[0] = component(value.x());
+        else
+            result[0] = component(luma(value.x(), value.y(), value.z()));
+        if constexpr (layout.alpha)
+            result[1] = component(value.w());
+    }
+    else {
+        result[layout.bgr ? 2 : 0] = component(value.x());
+        result[1] = component(value.y());
+        result[layout.bgr ? 0 : 2] = component(value.z());
+        if constexpr (layout.alpha)
+            result[3] = component(value.w());
+    }
+    return result;
+}
+
+/// @brief Uses one of the kernels, if there is one for the given conversion.
+/// @return Whether a kernel was available.
+template <PixelFormat v_format, PixelType v_type, PixelFormat v_from_format, PixelType v_from_type>
+bool convertPixelsFast(const void* from, void* to, std::size_t count)
+{
+    constexpr auto layout = pixel_format_layout<v_format>;
+    constexpr auto from_layout = pixel_format_layout<v_from_format>;
+    auto from_bytes = static_cast<const GLubyte*>(from);
+    auto to_bytes = static_cast<GLubyte*>(to);
+
+    if constexpr (v_format == v_from_format && v_type == v_from_type) {
+        std::memcpy(to, from, count * sizeof(Pixel<v_format, v_type>));
+        return true;
+    }
+    else if constexpr (v_type == PixelType::UNSIGNED_BYTE && v_from_type == PixelType::UNSIGNED_BYTE &&
+                       layout.integer == from_layout.integer && !layout.gray && layout.alpha) {
+        if constexpr (from_layout.gray && !from_layout.alpha)
+            grayToRGBA(from_bytes, to_bytes, count);
+        else if constexpr (from_layout.gray)
+            return false;
+        else if constexpr (from_layout.alpha)
+            swapRedBlue(from_bytes, to_bytes, count);
+        else
+            addAlpha(from_bytes, to_bytes, count, layout.bgr != from_layout.bgr);
+        return true;
+    }
+    else if constexpr (v_type == PixelType::UNSIGNED_BYTE && v_from_type == PixelType::UNSIGNED_BYTE &&
+                       layout.integer == from_layout.integer && !layout.gray && !layout.alpha && !from_layout.gray &&
+                       from_layout.alpha) {
+        removeAlpha(from_bytes, to_bytes, count, layout.bgr != from_layout.bgr);
+        return true;
+    }
+    else if constexpr (v_format == v_from_format && !layout.integer && v_type == PixelType::UNSIGNED_BYTE &&
+                       v_from_type == PixelType::UNSIGNED_SHORT) {
+        narrowToByte(static_cast<const GLushort*>(from), to_bytes, count * pixel_format_component_count_v<v_format>);
+        return true;
+    }
+    else
+        return false;
+}
+
+} // namespace detail
+
+/// @brief Converts pixels between any color pixel format and component type, optionally applying additional stages.
+/// @remark Normalized formats are converted via floats in the range [0, 1] (or [-1, 1] for signed types), while integer
+/// formats keep their values, clamped to the range of the new type. Both formats must be of the same kind.
+/// @remark Stages only work on normalized formats and are applied in order. Alpha is assumed to be linear.
+/// @remark Common conversions of unsigned bytes use SIMD kernels and large images are split into rows for multiple
+/// threads.
+class ImageConverter {
+public:
+    /// @brief The minimum number of pixels, for which another thread is used.
+    static constexpr std::size_t min_pixels_per_thread = std::size_t{1} << 16;
+
+    /// @brief Creates a converter, which only changes the pixel format and type.
+    ImageConverter() = default;
+
+    /// @brief Creates a converter, which additionally applies the given stages in order.
+    ImageConverter(std::initializer_list<ImageConversionStage> stages)
+        : stages_(stages)
+    {}
+
+    /// @brief The stages, which are applied in order.
+    const std::vector<ImageConversionStage>& stages() const { return stages_; }
+
+    /// @brief Appends another stage, which is applied after all existing stages.
+    ImageConverter& then(ImageConversionStage stage)
+    {
+        stages_.push_back(stage);
+        return *this;
+    }
+
+    /// @brief Converts pixels of one format and type into pixels of another format and type.
+    /// @remark Like for convert, the new format and type come first, but all of them have to be specified explicitly.
+    template <PixelFormat v_format, PixelType v_type, PixelFormat v_from_format, PixelType v_from_type>
+    void convertPixels(std::span<const Pixel<v_from_format, v_from_type>> from,
+                       std::span<Pixel<v_format, v_type>> to) const
+    {
+        constexpr auto layout = detail::pixel_format_layout<v_format>;
+        constexpr auto from_layout = detail::pixel_format_layout<v_from_format>;
+        static_assert(v_type <= PixelType::FLOAT && v_from_type <= PixelType::FLOAT,
+                      "Packed pixel types cannot be converted.");
+        static_assert(layout.integer == from_layout.integer, "Cannot convert between integer and normalized formats.");
+        static_assert(!layout.integer || (v_type < PixelType::HALF_FLOAT && v_from_type < PixelType::HALF_FLOAT),
+                      "Integer formats require integer types.");
+        assert(from.size() == to.size());
+        assert(!layout.integer || stages_.empty());
+
+        if (stages_.empty() && detail::convertPixelsFast<v_format, v_type, v_from_format, v_from_type>(
+                                   from.data(), to.data(), from.size()))
+            return;
+
+        if constexpr (!layout.integer && v_format == v_from_format && v_type == PixelType::UNSIGNED_BYTE &&
+                      v_from_type == PixelType::UNSIGNED_BYTE && layout.alpha && !layout.gray) {
+            if (stages_.size() == 1 && stages_.front() == ImageConversionStage::PremultiplyAlpha) {
+                detail::premultiplyAlpha(
+                    reinterpret_cast<const GLubyte*>(from.data()), reinterpret_cast<GLubyte*>(to.data()), from.size());
+                return;
+            }
+        }
+
+        using Working = std::conditional_t<layout.integer, dmath::dvec4, dmath::vec4>;
+        typename Working::value_type alpha;
+        if constexpr (layout.integer)
+            alpha = static_cast<double>(std::numeric_limits<underlying_pixel_type_t<v_type>>::max());
+        else
+            alpha = 1.0f;
+
+        // 8-bit sRGB values are converted using a table, as long as they are converted to linear values first.
+        auto stages = std::span<const ImageConversionStage>(stages_);
+        bool srgb_table = v_from_type == PixelType::UNSIGNED_BYTE && !stages.empty() &&
+                          stages.front() == ImageConversionStage::SRGBToLinear;
+        if (srgb_table)
+            stages = stages.subspan(1);
+
+        constexpr std::size_t chunk_size = 64;
+        std::array<Working, chunk_size> chunk;
+        for (std::size_t offset = 0; offset < from.size(); offset += chunk_size) {
+            auto count = std::min(chunk_size, from.size() - offset);
+            for (std::size_t i = 0; i < count; i++)
+                chunk[i] = detail::readPixel<v_from_format, v_from_type, Working>(from[offset + i], alpha, srgb_table);
+            if constexpr (!layout.integer)
+                detail::applyStages(stages, std::span(chunk.data(), count));
+            for (std::size_t i = 0; i < count; i++)
+                to[offset + i] = detail::writePixel<v_format, v_type, from_layout.gray>(chunk[i]);
+        }
+    }
+
+    /// @brief Converts an image into another pixel format and type, splitting large images into rows for threads.
+    template <PixelFormat v_format,
+              PixelType v_type = PixelType::UNSIGNED_BYTE,
+              std::size_t v_row_alignment = 4,
+              std::size_t v_dim,
+              PixelFormat v_from_format,
+              PixelType v_from_type,
+              std::size_t v_from_row_alignment>
+    Image<v_dim, v_format, v_type, v_row_alignment> convert(
+        const Image<v_dim, v_from_format, v_from_type, v_from_row_alignment>& image) const
+    {
+        using Result = Image<v_dim, v_format, v_type, v_row_alignment>;
+        using FromPixel = Pixel<v_from_format, v_from_type>;
+        using ToPixel = typename Result::Pixel;
+
+        auto result = Result::uninitialized(image.size());
+        auto width = image.size()[0];
+        if (width == 0)
+            return result;
+
+        auto from_data = static_cast<const std::byte*>(image.data());
+        auto to_data = static_cast<std::byte*>(result.data());
+        auto from_stride = image.alignedByteWidth();
+        auto to_stride = result.alignedByteWidth();
+        auto min_rows = std::max(min_pixels_per_thread / width, std::size_t{1});
+        dutils::parallelFor(image.count() / width, min_rows, [&](std::size_t begin, std::size_t end) {
+            for (auto row = begin; row < end; row++) {
+                auto from = reinterpret_cast<const FromPixel*>(from_data + row * from_stride);
+                auto to = reinterpret_cast<ToPixel*>(to_data + row * to_stride);
+                convertPixels<v_format, v_type, v_from_format, v_from_type>(std::span(from, width),
+                                                                            std::span(to, width));
+            }
+        });
+        return result;
+    }
+
+private:
+    std::vector<ImageConversionStage> stages_;
+};
+
+} // namespace dang::gl
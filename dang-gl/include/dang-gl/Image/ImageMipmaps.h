@@ -0,0 +1,193 @@
+#pragma once
+
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/ImageConverter.h"
+#include "dang-gl/Image/Pixel.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-gl/global.h"
+#include "dang-math/vector.h"
+#include "dang-utils/enum.h"
+#include "dang-utils/parallel.h"
+
+namespace dang::gl {
+
+/// @brief The filter, which is used to downsample one mipmap level into the next.
+enum class MipmapFilter {
+    /// @brief Averages each block of two pixels along every axis, which is fast but slightly blurry.
+    Box,
+    /// @brief A Kaiser windowed sinc, which keeps images sharp with hardly any ringing.
+    Kaiser,
+    /// @brief A three lobed Lanczos filter, which is the sharpest, but can lead to slight ringing around edges.
+    Lanczos,
+
+    COUNT
+};
+
+} // namespace dang::gl
+
+namespace dang::utils {
+
+template <>
+struct enum_count<dang::gl::MipmapFilter> : default_enum_count<dang::gl::MipmapFilter> {};
+
+} // namespace dang::utils
+
+namespace dang::gl {
+
+/// @brief Options for generating mipmaps on the CPU.
+struct MipmapOptions {
+    MipmapFilter filter = MipmapFilter::Box;
+    /// @brief Whether colors are filtered in linear space, which keeps sRGB textures from getting darker.
+    bool gamma_correct = false;
+};
+
+namespace detail {
+
+/// @brief How a single axis handles pixels outside of the image, which are wrapped around if wrap_size is not zero.
+/// @remark Both offset and size are in pixels of the level that is being downsampled.
+struct MipmapEdge {
+    double wrap_offset = 0.0;
+    double wrap_size = 0.0;
+};
+
+/// @brief Downsamples linear RGBA pixels to half the size along every axis, splitting the work for multiple threads.
+std::vector<dmath::vec4> downsampleMipmap(std::span<const dmath::vec4> pixels,
+                                          std::span<const std::size_t> size,
+                                          std::span<const MipmapEdge> edges,
+                                          MipmapFilter filter);
+
+/// @brief Box filters four byte components per pixel using SIMD if available, which requires at least 2x2 pixels.
+void boxDownsampleRGBA8(
+    const GLubyte* from, std::size_t from_stride, GLubyte* to, std::size_t to_stride, dmath::svec2 to_size);
+
+/// @brief The size of the given mipmap level, which halves the size (rounding down) but never goes below one.
+template <std::size_t v_dim>
+dmath::svec<v_dim> mipmapSize(const dmath::svec<v_dim>& size, std::size_t level)
+{
+    dmath::svec<v_dim> result;
+    for (std::size_t axis = 0; axis < v_dim; axis++)
+        result[axis] = std::max(size[axis] >> level, std::size_t{1});
+    return result;
+}
+
+/// @brief Generates the mipmap levels after the image itself, for which the given edges apply to the first level.
+template <std::size_t v_dim, PixelFormat v_format, PixelType v_type, std::size_t v_row_alignment>
+std::vector<Image<v_dim, v_format, v_type, v_row_alignment>> generateMipmaps(
+    const Image<v_dim, v_format, v_type, v_row_alignment>& image,
+    std::size_t levels,
+    const MipmapOptions& options,
+    std::array<MipmapEdge, v_dim> edges)
+{
+    using Image = Image<v_dim, v_format, v_type, v_row_alignment>;
+    using Pixel = typename Image::Pixel;
+    constexpr auto layout = pixel_format_layout<v_format>;
+    static_assert(v_type <= PixelType::FLOAT, "Mipmaps of packed pixel types are not supported.");
+
+    std::vector<Image> result;
+    if (levels <= 1 || image.count() == 0)
+        return result;
+    result.reserve(levels - 1);
+
+    // Levels are never reallocated, so that a pointer to the previous level stays valid.
+    const Image* base = &image;
+
+    // Every level can be downsampled from the one before, since the box filter rounds just like converting back.
+    if constexpr (v_dim == 2 && v_type == PixelType::UNSIGNED_BYTE && !layout.gray && layout.alpha) {
+        if (options.filter == MipmapFilter::Box && !options.gamma_correct) {
+            for (std::size_t level = 1; level < levels && !base->size().lessThan(2).any(); level++) {
+                auto& next = result.emplace_back(Image::uninitialized(mipmapSize(image.size(), level)));
+                boxDownsampleRGBA8(static_cast<const GLubyte*>(base->data()),
+                                   base->alignedByteWidth(),
+                                   static_cast<GLubyte*>(next.data()),
+                                   next.alignedByteWidth(),
+                                   next.size());
+                base = &next;
+            }
+            if (result.size() + 1 == levels)
+                return result;
+            // A single remaining row or column continues below.
+            for (auto& edge : edges) {
+                edge.wrap_offset /= static_cast<double>(std::size_t{1} << result.size());
+                edge.wrap_size /= static_cast<double>(std::size_t{1} << result.size());
+            }
+        }
+    }
+
+    // All other cases keep pixels as linear floats in between levels, so that they are only rounded once.
+    auto width = base->size()[0];
+    auto row_count = base->count() / width;
+    auto gamma_correct = options.gamma_correct && !layout.integer;
+    auto srgb_table = gamma_correct && v_type == PixelType::UNSIGNED_BYTE;
+    auto from_srgb = std::array{ImageConversionStage::SRGBToLinear};
+    auto to_srgb = std::array{ImageConversionStage::LinearToSRGB};
+
+    std::vector<dmath::vec4> pixels(base->count());
+    auto data = static_cast<const std::byte*>(base->data());
+    auto min_rows = std::max(ImageConverter::min_pixels_per_thread / width, std::size_t{1});
+    dutils::parallelFor(row_count, min_rows, [&](std::size_t begin, std::size_t end) {
+        for (auto row = begin; row < end; row++) {
+            auto from = reinterpret_cast<const Pixel*>(data + row * base->alignedByteWidth());
+            auto to = std::span(pixels).subspan(row * width, width);
+            for (std::size_t x = 0; x < width; x++)
+                to[x] = readPixel<v_format, v_type, dmath::vec4>(from[x], 1.0f, srgb_table);
+            if (gamma_correct && !srgb_table)
+                applyStages(from_srgb, to);
+        }
+    });
+
+    auto size = base->size();
+    for (auto level = result.size() + 1; level < levels; level++) {
+        pixels = downsampleMipmap(pixels, size, edges, options.filter);
+        for (std::size_t axis = 0; axis < v_dim; axis++) {
+            size[axis] = std::max(size[axis] / 2, std::size_t{1});
+            edges[axis].wrap_offset /= 2.0;
+            edges[axis].wrap_size /= 2.0;
+        }
+
+        auto& next = result.emplace_back(Image::uninitialized(size));
+        auto next_width = size[0];
+        auto next_data = static_cast<std::byte*>(next.data());
+        auto next_min_rows = std::max(ImageConverter::min_pixels_per_thread / next_width, std::size_t{1});
+        dutils::parallelFor(next.count() / next_width, next_min_rows, [&](std::size_t begin, std::size_t end) {
+            std::vector<dmath::vec4> row_pixels(next_width);
+            for (auto row = begin; row < end; row++) {
+                auto from = std::span(pixels).subspan(row * next_width, next_width);
+                std::copy(from.begin(), from.end(), row_pixels.begin());
+                if (gamma_correct)
+                    applyStages(to_srgb, row_pixels);
+                auto to = reinterpret_cast<Pixel*>(next_data + row * next.alignedByteWidth());
+                for (std::size_t x = 0; x < next_width; x++)
+                    to[x] = writePixel<v_format, v_type, layout.gray>(row_pixels[x]);
+            }
+        });
+    }
+    return result;
+}
+
+} // namespace detail
+
+/// @brief The number of mipmap levels down to a single pixel, including the image itself.
+template <std::size_t v_dim>
+std::size_t maxMipmapLevels(const dmath::svec<v_dim>& size)
+{
+    return size.maxValue() == 0 ? 0 : static_cast<std::size_t>(dutils::ilog2(size.maxValue())) + 1;
+}
+
+/// @brief Generates mipmap levels on the CPU, returning all levels after the image itself.
+/// @remark Just like OpenGL, each level is half the size (rounded down) of the previous one, but at least one pixel.
+/// @remark Levels are generated one after another, while the pixels of each level are split for multiple threads.
+/// @remark The box filter for four components of unsigned bytes uses SIMD, while other filters and formats go through
+/// floats, which use SIMD via dmath::vec4. Integer formats are filtered the same, but are never gamma corrected.
+/// @param levels The total number of levels including the image itself, which is capped at maxMipmapLevels.
+template <std::size_t v_dim, PixelFormat v_format, PixelType v_type, std::size_t v_row_alignment>
+std::vector<Image<v_dim, v_format, v_type, v_row_alignment>> generateMipmaps(
+    const Image<v_dim, v_format, v_type, v_row_alignment>& image,
+    std::size_t levels,
+    const MipmapOptions& options = {})
+{
+    levels = std::min(levels, maxMipmapLevels(image.size()));
+    return detail::generateMipmaps(image, levels, options, std::array<detail::MipmapEdge, v_dim>{});
+}
+
+} // namespace dang::gl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "dang-gl/global.h"
+
+namespace dang::gl {
+
+/// @brief Maps a whole file into memory for reading, so that it can be read without copying it into a buffer first.
+/// @remark Similar to std::ifstream, failing to open the file does not throw, but can be checked using operator bool.
+class MappedFile {
+public:
+    /// @brief Creates a mapped file without any associated file.
+    MappedFile() = default;
+    /// @brief Maps the given file, which can be checked for success using operator bool.
+    explicit MappedFile(const fs::path& path);
+    /// @brief Unmaps the file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// @brief Whether the file could be opened, which also holds true for empty files.
+    explicit operator bool() const { return open_; }
+
+    /// @brief The full content of the file, which stays valid until the file is unmapped.
+    std::span<const std::byte> data() const { return {data_, size_}; }
+
+    /// @brief The size of the file in bytes.
+    std::size_t size() const { return size_; }
+
+private:
+    /// @brief Unmaps the file if it was mapped.
+    void unmap();
+
+    bool open_ = false;
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace dang::gl
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "dang-gl/Image/BorderedImage.h"
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/MappedFile.h"
+#include "dang-gl/Image/PNGLoader.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-gl/global.h"
+#include "dang-math/vector.h"
+#include "dang-utils/parallel.h"
+
+namespace dang::gl {
+
+/// @brief The same options that PNGLoader::read takes, but with flipping enabled like in Image::loadFromPNG.
+struct PNGBatchOptions {
+    bool flip = true;
+    dmath::svec2 pad_low;
+    dmath::svec2 pad_high;
+};
+
+/// @brief Aggregate statistics over all PNGs, which a PNGBatchLoader finished loading.
+struct PNGBatchStats {
+    std::size_t file_count = 0;
+    std::size_t failed_count = 0;
+    std::size_t pixel_count = 0;
+    /// @brief The sum of the time it took to decode each file, which exceeds the elapsed time when using more threads.
+    std::chrono::nanoseconds decode_time{};
+    /// @brief The wall clock time from the first file starting to the last file finishing.
+    std::chrono::nanoseconds elapsed_time{};
+
+    /// @brief The number of successfully loaded files per second of elapsed time.
+    double filesPerSecond() const;
+    /// @brief The number of decoded megapixels per second of elapsed time.
+    double megapixelsPerSecond() const;
+};
+
+/// @brief Decodes lots of PNGs on a thread pool, rather than one after another on the calling thread.
+/// @remark Results can either be waited on using the returned futures or handled in a callback on the worker thread.
+template <PixelFormat v_pixel_format = PixelFormat::RGBA, std::size_t v_row_alignment = 4>
+class PNGBatchLoader {
+public:
+    using Image = dang::gl::Image<2, v_pixel_format, PixelType::UNSIGNED_BYTE, v_row_alignment>;
+    using BorderedImage = dang::gl::BorderedImage<2, v_pixel_format, PixelType::UNSIGNED_BYTE, v_row_alignment>;
+    using Border = typename BorderedImage::Border;
+
+    /// @brief A loaded image together with the name of its file and how long it took to decode.
+    template <typename TImage>
+    struct Result {
+        std::string name;
+        TImage image;
+        std::chrono::nanoseconds decode_time;
+        /// @brief Any warnings that libpng reported, as the worker threads do not log anything by themselves.
+        std::vector<std::string> warnings;
+    };
+
+    using ImageResult = Result<Image>;
+    using BorderedImageResult = Result<BorderedImage>;
+
+    /// @brief Called on the worker thread with a future, which is ready already and rethrows any PNGError on get.
+    using Callback = std::function<void(std::future<ImageResult>)>;
+
+    /// @brief Uses the shared thread pool.
+    PNGBatchLoader()
+        : PNGBatchLoader(dutils::ThreadPool::shared())
+    {}
+
+    /// @brief Uses the given thread pool, which must outlive the loader.
+    explicit PNGBatchLoader(dutils::ThreadPool& thread_pool)
+        : thread_pool_(&thread_pool)
+    {}
+
+    /// @brief Waits for all queued files, as they still refer to the loader.
+    ~PNGBatchLoader() { wait(); }
+
+    PNGBatchLoader(const PNGBatchLoader&) = delete;
+    PNGBatchLoader(PNGBatchLoader&&) = delete;
+    PNGBatchLoader& operator=(const PNGBatchLoader&) = delete;
+    PNGBatchLoader& operator=(PNGBatchLoader&&) = delete;
+
+    /// @brief Queues a PNG file to be loaded.
+    /// @exception PNGError in the future if the file cannot be opened or does not represent a valid PNG.
+    std::future<ImageResult> load(fs::path path, PNGBatchOptions options = {})
+    {
+        return submit([this, path = std::move(path), options] { return loadFile(path, options); });
+    }
+
+    /// @brief Queues a PNG stream to be loaded, using the name only to identify it in the result.
+    /// @remark The stream must life long enough for the returned future to become ready.
+    /// @exception PNGError in the future if the stream does not contain a valid PNG.
+    std::future<ImageResult> load(std::istream& stream, std::string name, PNGBatchOptions options = {})
+    {
+        return submit([this, &stream, name = std::move(name), options] {
+            return loadSource(stream, name, options);
+        });
+    }
+
+    /// @brief Queues all files at once, returning a future for each of them in the same order.
+    std::vector<std::future<ImageResult>> load(const std::vector<fs::path>& paths, PNGBatchOptions options = {})
+    {
+        std::vector<std::future<ImageResult>> result;
+        result.reserve(paths.size());
+        for (const auto& path : paths)
+            result.push_back(load(path, options));
+        return result;
+    }
+
+    /// @brief Queues all files at once, calling the callback from the worker thread as soon as each file is done.
+    /// @remark The callback is called concurrently from multiple threads and must therefore be thread-safe.
+    void load(const std::vector<fs::path>& paths, Callback callback, PNGBatchOptions options = {})
+    {
+        auto shared_callback = std::make_shared<Callback>(std::move(callback));
+        for (const auto& path : paths) {
+            submit([this, path, options, shared_callback] {
+                std::promise<ImageResult> promise;
+                try {
+                    promise.set_value(loadFile(path, options));
+                }
+                catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+                (*shared_callback)(promise.get_future());
+            });
+        }
+    }
+
+    /// @brief Queues a PNG file to be loaded with the given border, which replaces any padding in the options.
+    std::future<BorderedImageResult> loadBordered(fs::path path, Border border, PNGBatchOptions options = {})
+    {
+        auto padding = std::visit(imageBorderPadding, border);
+        options.pad_low = padding / 2;
+        options.pad_high = padding - options.pad_low;
+        return submit([this, path = std::move(path), border = std::move(border), options] {
+            auto result = loadFile(path, options);
+            // The image already has room for the border, so it can be filled in place.
+            return BorderedImageResult{std::move(result.name),
+                                       BorderedImage::replaceBorder(border, std::move(result.image)),
+                                       result.decode_time,
+                                       std::move(result.warnings)};
+        });
+    }
+
+    /// @brief Blocks until all queued files are done.
+    void wait()
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [&] { return pending_ == 0; });
+    }
+
+    /// @brief Returns statistics over all files that are done so far.
+    PNGBatchStats stats() const
+    {
+        std::scoped_lock lock(mutex_);
+        auto result = stats_;
+        result.elapsed_time = last_finish_ - first_start_;
+        return result;
+    }
+
+    /// @brief Resets all statistics, usually after calling wait.
+    void resetStats()
+    {
+        std::scoped_lock lock(mutex_);
+        stats_ = {};
+        first_start_ = {};
+        last_finish_ = {};
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Submits a task to the thread pool, keeping track of how many are still pending.
+    template <typename TFunction>
+    auto submit(TFunction function)
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            pending_++;
+        }
+        return thread_pool_->submit([this, function = std::move(function)]() mutable {
+            // Also notifies if the function throws, and does not touch the loader afterwards, so it can be destroyed.
+            struct Done {
+                PNGBatchLoader& loader;
+
+                ~Done()
+                {
+                    std::scoped_lock lock(loader.mutex_);
+                    if (--loader.pending_ == 0)
+                        loader.idle_.notify_all();
+                }
+            } done{*this};
+            return function();
+        });
+    }
+
+    ImageResult loadFile(const fs::path& path, const PNGBatchOptions& options)
+    {
+        MappedFile file(path);
+        if (!file) {
+            auto now = Clock::now();
+            record(now, now, std::nullopt);
+            throw PNGError("Cannot open PNG file: " + path.string());
+        }
+        auto data = file.data();
+        return loadSource(data, path.string(), options);
+    }
+
+    /// @brief Loads a PNG from either a stream or data in memory.
+    template <typename TSource>
+    ImageResult loadSource(TSource& source, std::string name, const PNGBatchOptions& options)
+    {
+        auto start = Clock::now();
+        try {
+            PNGLoader png_loader;
+            std::vector<std::string> warnings;
+            png_loader.on_warning.append([&](const PNGWarningInfo& info) { warnings.push_back(info.message); });
+            png_loader.init(source);
+            auto padding = options.pad_low + options.pad_high;
+            auto data =
+                png_loader.read<v_pixel_format, v_row_alignment>(options.flip, options.pad_low, options.pad_high);
+            Image image(png_loader.size(padding), std::move(data));
+            auto decode_time = record(start, Clock::now(), image.count());
+            return {std::move(name), std::move(image), decode_time, std::move(warnings)};
+        }
+        catch (...) {
+            record(start, Clock::now(), std::nullopt);
+            throw;
+        }
+    }
+
+    /// @brief Adds a single file to the statistics, with a pixel count of nullopt meaning that it failed.
+    std::chrono::nanoseconds record(Clock::time_point start,
+                                    Clock::time_point end,
+                                    std::optional<std::size_t> pixel_count)
+    {
+        std::scoped_lock lock(mutex_);
+        bool first = stats_.file_count == 0 && stats_.failed_count == 0;
+        first_start_ = first ? start : std::min(first_start_, start);
+        last_finish_ = first ? end : std::max(last_finish_, end);
+        if (pixel_count) {
+            stats_.file_count++;
+            stats_.pixel_count += *pixel_count;
+        }
+        else {
+            stats_.failed_count++;
+        }
+        auto decode_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        stats_.decode_time += decode_time;
+        return decode_time;
+    }
+
+    dutils::ThreadPool* thread_pool_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::size_t pending_ = 0;
+    PNGBatchStats stats_;
+    Clock::time_point first_start_;
+    Clock::time_point last_finish_;
+};
+
+} // namespace dang::gl
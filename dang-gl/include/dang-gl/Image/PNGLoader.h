@@ -24,6 +24,18 @@ struct PNGWarningInfo {
 
 using PNGWarningEvent = dutils::Event<PNGWarningInfo>;
 
+/// @brief A band of consecutive rows, which PNGLoader::readRows has decoded so far.
+struct PNGRowBand {
+    /// @brief The index of the first row in memory, which already takes flipping into account.
+    std::size_t first_row;
+    std::size_t row_count;
+    /// @brief The distance between the start of two rows in bytes.
+    std::size_t stride;
+    std::span<const std::byte> data;
+};
+
+using PNGRowCallback = std::function<void(const PNGRowBand&)>;
+
 /// @brief Capable of loading any PNG into a given format using libpng.
 class PNGLoader {
 public:
@@ -31,6 +43,8 @@ public:
     PNGLoader();
     /// @brief Immediately calls init with the given stream.
     explicit PNGLoader(std::istream& stream);
+    /// @brief Immediately calls init with the given data.
+    explicit PNGLoader(std::span<const std::byte> data);
     /// @brief Cleans up the libpng handles.
     ~PNGLoader();
 
@@ -42,6 +56,9 @@ public:
     /// @brief Initializes the info struct with various informations like width and height.
     /// @remark The same stream is reused for a likely read call and must therefore life long enough.
     void init(std::istream& stream);
+    /// @brief Initializes the info struct from PNG data in memory, e.g. a MappedFile, which skips any stream overhead.
+    /// @remark The data is reused for a likely read call and must therefore life long enough.
+    void init(std::span<const std::byte> data);
 
     /// @brief After initialization, returns the width and height of the image.
     dmath::svec2 size(dmath::svec2 padding = {}) const;
@@ -57,6 +74,20 @@ public:
     template <PixelFormat v_pixel_format = PixelFormat::RGBA, std::size_t row_alignment = 4>
     std::unique_ptr<std::byte[]> read(bool flip = false, dmath::svec2 pad_low = {}, dmath::svec2 pad_high = {});
 
+    /// @brief Converts the data into the specified format and writes it into the given buffer, e.g. a mapped PBO.
+    /// @remark Rows are stride bytes apart, which allows for both row alignment and writing into a bigger image.
+    /// @exception PNGError if the buffer is too small to hold all rows.
+    template <PixelFormat v_pixel_format = PixelFormat::RGBA>
+    void readInto(std::span<std::byte> data, std::size_t stride, bool flip = false);
+
+    /// @brief Converts the data into the specified format and calls the callback for every band of rows.
+    /// @remark Only a single band is kept in memory, so that even huge images can be processed with little memory.
+    /// @remark Interlaced images are only complete after the last pass and are therefore decoded as a whole first.
+    /// @param band_rows The maximum number of rows per band, with only the last band possibly being smaller.
+    /// @param flip Whether to flip the top and bottom of the PNG, which reverses both bands and rows in each band.
+    template <PixelFormat v_pixel_format = PixelFormat::RGBA, std::size_t v_row_alignment = 4>
+    void readRows(const PNGRowCallback& callback, std::size_t band_rows = 16, bool flip = false);
+
     /// @brief While errors throw an exception, warnings simply trigger this event.
     PNGWarningEvent on_warning;
 
@@ -80,6 +111,21 @@ private:
     static void warningCallback(png_structp png_ptr, png_const_charp message);
     /// @brief Called by libpng to read a chunk of data from the PNG file.
     static void readCallback(png_structp png_ptr, png_bytep bytes, png_size_t size);
+    /// @brief Called by libpng to read a chunk of data from the PNG in memory.
+    static void readDataCallback(png_structp png_ptr, png_bytep bytes, png_size_t size);
+
+    /// @brief Common initialization after the read function was set.
+    void initInfo();
+
+    /// @brief Sets up all transformations for the given pixel format and marks the PNG as read.
+    template <PixelFormat v_pixel_format>
+    void prepareRead();
+
+    /// @brief Decodes all rows into the given data, which must be big enough.
+    void readAllRows(std::span<std::byte> data, std::size_t stride, bool flip);
+
+    /// @brief Decodes all rows in bands of the given stride.
+    void readBands(const PNGRowCallback& callback, std::size_t band_rows, std::size_t stride, bool flip);
 
     /// @brief Used in initialization to check the libpng pointers.
     template <typename T>
@@ -130,6 +176,10 @@ private:
 
     bool initialized_ = false;
     bool read_ = false;
+    int pass_count_ = 1;
+
+    /// @brief The remaining data, when reading from memory.
+    std::span<const std::byte> data_;
 
     dmath::svec2 size_;
 
@@ -140,6 +190,46 @@ private:
 
 template <PixelFormat v_pixel_format, std::size_t v_row_alignment>
 inline std::unique_ptr<std::byte[]> PNGLoader::read(bool flip, dmath::svec2 pad_low, dmath::svec2 pad_high)
+{
+    prepareRead<v_pixel_format>();
+
+    auto padding = pad_low + pad_high;
+    auto padded_size = size(padding);
+
+    using Pixel = Pixel<v_pixel_format>;
+
+    auto aligned_width = alignedByteWidth<v_pixel_format, v_row_alignment>(padding.x());
+    auto data_offset = pad_low.y() * aligned_width + pad_low.x() * sizeof(Pixel);
+    auto byte_count = byteCount<v_pixel_format, v_row_alignment>(padding);
+    auto image = std::make_unique<std::byte[]>(byte_count);
+
+    for (std::size_t y = 0; y < padded_size.y(); y++)
+        std::uninitialized_default_construct_n(reinterpret_cast<Pixel*>(&image[y * aligned_width]), padded_size.x());
+
+    // Make sure, the caller doesn't need to call the destructor on each pixel.
+    static_assert(std::is_trivially_destructible_v<Pixel>);
+
+    readAllRows(std::span(image.get(), byte_count).subspan(data_offset), aligned_width, flip);
+
+    return image;
+}
+
+template <PixelFormat v_pixel_format>
+inline void PNGLoader::readInto(std::span<std::byte> data, std::size_t stride, bool flip)
+{
+    prepareRead<v_pixel_format>();
+    readAllRows(data, stride, flip);
+}
+
+template <PixelFormat v_pixel_format, std::size_t v_row_alignment>
+inline void PNGLoader::readRows(const PNGRowCallback& callback, std::size_t band_rows, bool flip)
+{
+    prepareRead<v_pixel_format>();
+    readBands(callback, band_rows, alignedByteWidth<v_pixel_format, v_row_alignment>(0), flip);
+}
+
+template <PixelFormat v_pixel_format>
+inline void PNGLoader::prepareRead()
 {
     if (!initialized_)
         throw PNGError("PNG not initialized.");
@@ -167,37 +257,6 @@ inline std::unique_ptr<std::byte[]> PNGLoader::read(bool flip, dmath::svec2 pad_
     png_size_t rowbytes = png_get_rowbytes(png_ptr_, info_ptr_);
     if (rowbytes != size_.x() * pixel_format_component_count_v<v_pixel_format>)
         throw PNGError("Cannot convert PNG to correct format.");
-
-    auto padding = pad_low + pad_high;
-    auto padded_size = size(padding);
-
-    using Pixel = Pixel<v_pixel_format>;
-
-    auto aligned_width = alignedByteWidth<v_pixel_format, v_row_alignment>(padding.x());
-    auto data_offset = pad_low.y() * aligned_width + pad_low.x() * sizeof(Pixel);
-    auto image = std::make_unique<std::byte[]>(byteCount<v_pixel_format, v_row_alignment>(padding));
-    auto base_ptr = reinterpret_cast<png_bytep>(image.get());
-
-    // Fill offsets with the row-pointers to the actual image data.
-    std::vector<png_bytep> offsets(size().y());
-
-    auto fill = [&, ptr = base_ptr + data_offset]() mutable { return std::exchange(ptr, ptr + aligned_width); };
-
-    if (flip)
-        std::generate(offsets.rbegin(), offsets.rend(), fill);
-    else
-        std::generate(offsets.begin(), offsets.end(), fill);
-
-    for (std::size_t y = 0; y < padded_size.y(); y++)
-        std::uninitialized_default_construct_n(reinterpret_cast<Pixel*>(base_ptr + y * aligned_width), padded_size.x());
-
-    // Make sure, the caller doesn't need to call the destructor on each pixel.
-    static_assert(std::is_trivially_destructible_v<Pixel>);
-
-    png_read_image(png_ptr_, offsets.data());
-    png_read_end(png_ptr_, nullptr);
-
-    return image;
 }
 
 template <PixelFormat v_pixel_format>
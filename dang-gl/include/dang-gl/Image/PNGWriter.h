@@ -0,0 +1,183 @@
+#pragma once
+
+#include "dang-gl/Image/PNGLoader.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-gl/global.h"
+#include "dang-math/vector.h"
+#include "dang-utils/enum.h"
+#include "dang-utils/event.h"
+#include "dang-utils/parallel.h"
+
+namespace dang::gl {
+
+/// @brief Which filters libpng may use on each row before compressing it.
+enum class PNGWriteFilter {
+    /// @brief Lets libpng pick the best filter for each row, which gives the smallest files.
+    Adaptive,
+    /// @brief Skips filtering, which is fastest and works best for images with few distinct colors.
+    None,
+    Sub,
+    Up,
+    Average,
+    Paeth,
+
+    COUNT
+};
+
+/// @brief The zlib strategy, which is used to compress the filtered rows.
+enum class PNGWriteStrategy {
+    Default,
+    Filtered,
+    HuffmanOnly,
+    RLE,
+    Fixed,
+
+    COUNT
+};
+
+} // namespace dang::gl
+
+namespace dang::utils {
+
+template <>
+struct enum_count<dang::gl::PNGWriteFilter> : default_enum_count<dang::gl::PNGWriteFilter> {};
+
+template <>
+struct enum_count<dang::gl::PNGWriteStrategy> : default_enum_count<dang::gl::PNGWriteStrategy> {};
+
+} // namespace dang::utils
+
+namespace dang::gl {
+
+/// @brief Options for writing PNGs, which trade encoding speed for file size.
+struct PNGWriteOptions {
+    /// @brief The zlib compression level from 0 (none) to 9 (best).
+    int compression_level = 6;
+    PNGWriteFilter filter = PNGWriteFilter::Adaptive;
+    PNGWriteStrategy strategy = PNGWriteStrategy::Default;
+    /// @brief Whether to flip the top and bottom of the image, which matches Image::loadFromPNG.
+    bool flip = true;
+
+    /// @brief Fast options for screenshots and debug dumps, which still compress reasonably well.
+    static PNGWriteOptions fast() { return {1, PNGWriteFilter::Sub, PNGWriteStrategy::RLE}; }
+};
+
+class PNGWriter;
+
+/// @brief A warning message with a reference to the associated PNGWriter.
+struct PNGWriterWarningInfo {
+    PNGWriter& writer;
+    std::string message;
+};
+
+using PNGWriterWarningEvent = dutils::Event<PNGWriterWarningInfo>;
+
+/// @brief Capable of writing images of unsigned bytes as PNG using libpng.
+/// @remark Errors throw a PNGError, the same as for PNGLoader.
+class PNGWriter {
+public:
+    /// @brief Writes the image to the given stream.
+    /// @exception PNGError if libpng reports an error or the stream cannot be written to.
+    template <typename TImage>
+    void write(std::ostream& stream, const TImage& image, const PNGWriteOptions& options = {})
+    {
+        static_assert(TImage::dim == 2, "Only two-dimensional images can be written as PNG.");
+        static_assert(TImage::pixel_type == PixelType::UNSIGNED_BYTE, "PNG writing only supports unsigned bytes.");
+        constexpr auto layout = pngLayout(TImage::pixel_format);
+        write(stream,
+              static_cast<const std::byte*>(image.data()),
+              image.size(),
+              image.alignedByteWidth(),
+              layout.color_type,
+              layout.bgr,
+              options);
+    }
+
+    /// @brief Writes the image to the given file.
+    /// @exception PNGError if the file cannot be opened.
+    /// @exception PNGError if libpng reports an error or the file cannot be written to.
+    template <typename TImage>
+    void write(const fs::path& path, const TImage& image, const PNGWriteOptions& options = {})
+    {
+        std::ofstream stream(path, std::ios::binary);
+        if (!stream)
+            throw PNGError("Cannot open PNG file for writing: " + path.string());
+        write(stream, image, options);
+    }
+
+    /// @brief While errors throw an exception, warnings simply trigger this event.
+    PNGWriterWarningEvent on_warning;
+
+private:
+    struct PNGLayout {
+        int color_type;
+        bool bgr;
+    };
+
+    /// @brief Maps a pixel format onto a PNG color type, with integer formats being written as is.
+    static constexpr PNGLayout pngLayout(PixelFormat pixel_format)
+    {
+        switch (pixel_format) {
+        case PixelFormat::RED:
+        case PixelFormat::RED_INTEGER:
+            return {PNG_COLOR_TYPE_GRAY, false};
+        case PixelFormat::RG:
+        case PixelFormat::RG_INTEGER:
+            return {PNG_COLOR_TYPE_GRAY_ALPHA, false};
+        case PixelFormat::RGB:
+        case PixelFormat::RGB_INTEGER:
+            return {PNG_COLOR_TYPE_RGB, false};
+        case PixelFormat::BGR:
+        case PixelFormat::BGR_INTEGER:
+            return {PNG_COLOR_TYPE_RGB, true};
+        case PixelFormat::RGBA:
+        case PixelFormat::RGBA_INTEGER:
+            return {PNG_COLOR_TYPE_RGB_ALPHA, false};
+        case PixelFormat::BGRA:
+        case PixelFormat::BGRA_INTEGER:
+            return {PNG_COLOR_TYPE_RGB_ALPHA, true};
+        default:
+            throw PNGError("Unsupported pixel format for PNG.");
+        }
+    }
+
+    /// @brief Writes rows of the given stride, which can include padding at the end of each row.
+    void write(std::ostream& stream,
+               const std::byte* data,
+               dmath::svec2 size,
+               std::size_t stride,
+               int color_type,
+               bool bgr,
+               const PNGWriteOptions& options);
+
+    /// @brief Called by libpng, when an unrecoverable error occurs.
+    static void errorCallback(png_structp png_ptr, png_const_charp message);
+    /// @brief Called by libpng for warning messages.
+    static void warningCallback(png_structp png_ptr, png_const_charp message);
+    /// @brief Called by libpng to write a chunk of data to the stream.
+    static void writeCallback(png_structp png_ptr, png_bytep bytes, png_size_t size);
+    /// @brief Called by libpng to flush the stream.
+    static void flushCallback(png_structp png_ptr);
+};
+
+/// @brief Writes the image to the given file on a thread pool, so that e.g. screenshots do not block a frame.
+/// @remark The image is moved into the task, so pass a copy to keep using it.
+/// @remark The future holds any warnings that libpng reported, as the worker thread does not log them.
+/// @exception PNGError in the future if the file cannot be written.
+template <typename TImage>
+std::future<std::vector<std::string>> writePNGAsync(fs::path path,
+                                                    TImage image,
+                                                    PNGWriteOptions options = {},
+                                                    dutils::ThreadPool& thread_pool = dutils::ThreadPool::shared())
+{
+    return thread_pool.submit([path = std::move(path), image = std::move(image), options] {
+        PNGWriter png_writer;
+        std::vector<std::string> warnings;
+        png_writer.on_warning.append([&](const PNGWriterWarningInfo& info) { warnings.push_back(info.message); });
+        png_writer.write(path, image, options);
+        return warnings;
+    });
+}
+
+} // namespace dang::gl
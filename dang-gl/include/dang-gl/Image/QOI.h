@@ -0,0 +1,78 @@
+#pragma once
+
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-gl/global.h"
+#include "dang-math/vector.h"
+
+namespace dang::gl {
+
+/// @brief Thrown when decoding invalid QOI data or when a QOI file cannot be read or written.
+class QOIError : public std::runtime_error {
+    using runtime_error::runtime_error;
+};
+
+namespace detail {
+
+/// @brief The layout of pixels in memory, which the QOI encoder and decoder can work with directly.
+struct QOILayout {
+    std::size_t channels;
+    bool bgr;
+};
+
+/// @brief Maps a pixel format onto QOI channels, which only supports RGB and RGBA.
+template <PixelFormat v_pixel_format>
+constexpr QOILayout qoi_layout = [] {
+    constexpr auto components = pixel_format_component_count_v<v_pixel_format>;
+    static_assert(components == 3 || components == 4, "QOI only supports RGB(A) and BGR(A).");
+    constexpr bool bgr = v_pixel_format == PixelFormat::BGR || v_pixel_format == PixelFormat::BGR_INTEGER ||
+                         v_pixel_format == PixelFormat::BGRA || v_pixel_format == PixelFormat::BGRA_INTEGER;
+    return QOILayout{components, bgr};
+}();
+
+/// @brief Encodes rows of the given stride, which can include padding at the end of each row.
+std::vector<std::byte> encodeQOI(
+    const std::byte* data, dmath::svec2 size, std::size_t stride, QOILayout layout, bool flip);
+
+/// @brief Returns the size of the image, as stored in the header.
+/// @exception QOIError if the header is invalid.
+dmath::svec2 qoiSize(std::span<const std::byte> qoi);
+
+/// @brief Decodes into rows of the given stride, which must have the size returned by qoiSize.
+/// @exception QOIError if the data is invalid or ends early.
+void decodeQOI(std::span<const std::byte> qoi, std::byte* data, std::size_t stride, QOILayout layout, bool flip);
+
+} // namespace detail
+
+/// @brief Encodes the image using the "Quite OK Image Format", which is a lot faster to encode and decode than PNG.
+/// @remark Meant for debug dumps and caches, for which speed matters more than file size.
+/// @param flip Whether to flip the top and bottom of the image, which matches Image::loadFromPNG.
+template <typename TImage>
+std::vector<std::byte> encodeQOI(const TImage& image, bool flip = true)
+{
+    static_assert(TImage::dim == 2, "Only two-dimensional images can be encoded as QOI.");
+    static_assert(TImage::pixel_type == PixelType::UNSIGNED_BYTE, "QOI only supports unsigned bytes.");
+    return detail::encodeQOI(static_cast<const std::byte*>(image.data()),
+                             image.size(),
+                             image.alignedByteWidth(),
+                             detail::qoi_layout<TImage::pixel_format>,
+                             flip);
+}
+
+/// @brief Decodes QOI data, adding or removing alpha if it does not match the pixel format of the image.
+/// @exception QOIError if the data is invalid or ends early.
+template <typename TImage>
+TImage decodeQOI(std::span<const std::byte> qoi, bool flip = true)
+{
+    static_assert(TImage::dim == 2, "Only two-dimensional images can be decoded from QOI.");
+    static_assert(TImage::pixel_type == PixelType::UNSIGNED_BYTE, "QOI only supports unsigned bytes.");
+    auto image = TImage::uninitialized(detail::qoiSize(qoi));
+    detail::decodeQOI(qoi,
+                      static_cast<std::byte*>(image.data()),
+                      image.alignedByteWidth(),
+                      detail::qoi_layout<TImage::pixel_format>,
+                      flip);
+    return image;
+}
+
+} // namespace dang::gl
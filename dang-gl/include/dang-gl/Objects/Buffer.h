@@ -19,7 +19,7 @@ public:
     ~BufferBase()
     {
         if (*this)
-            objectContext().reset(v_target, handle());
+            release();
     }
 
     BufferBase(const BufferBase&) = delete;
@@ -28,6 +28,9 @@ public:
     /// @brief Binds the buffer to the correct target.
     void bind() const { objectContext().bind(v_target, handle()); }
 
+    /// @brief Unbinds the buffer again, in case of it still being bound.
+    void release() const { objectContext().reset(v_target, handle()); }
+
 protected:
     BufferBase() = default;
 
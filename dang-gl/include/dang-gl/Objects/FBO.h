@@ -115,6 +115,14 @@ public:
     bool isAttached(AttachmentPoint attachment_point) const;
     /// @brief Attaches the given renderbuffer to the specified attachment point.
     void attach(const RBO& rbo, AttachmentPoint attachment_point);
+    /// @brief Attaches a single layer of a mipmap level of an array or 3D texture to the specified attachment point.
+    template <typename TTexture>
+    void attachLayer(const TTexture& texture, AttachmentPoint attachment_point, GLint layer, GLint mipmap_level = 0)
+    {
+        auto size = texture.size();
+        auto level_size = svec2(std::max(size.x() >> mipmap_level, 1), std::max(size.y() >> mipmap_level, 1));
+        attachTextureLayer(texture.handle(), level_size, attachment_point, layer, mipmap_level);
+    }
     /// @brief Detaches the current renderbuffer or texture from the specified attachment point.
     void detach(AttachmentPoint attachment_point);
 
@@ -138,6 +146,13 @@ public:
     void blitToDefault(BufferMask mask = BufferMask::ALL, BlitFilter filter = BlitFilter::Nearest) const;
 
 private:
+    /// @brief Attaches a single layer of the texture with the given handle, which has the given size on that level.
+    void attachTextureLayer(ObjectHandle<ObjectType::Texture> texture,
+                            svec2 size,
+                            AttachmentPoint attachment_point,
+                            GLint layer,
+                            GLint mipmap_level);
+
     /// @brief Used to keep track of the smallest width and height.
     void updateSize(svec2 size);
     /// @brief Updates the given attachment point to being active or not.
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "dang-gl/Objects/Buffer.h"
+#include "dang-gl/Objects/ObjectType.h"
+#include "dang-gl/global.h"
+
+namespace dang::gl {
+
+/// @brief A pixel unpack buffer, which stages pixel data in memory that is owned by OpenGL.
+/// @remark Textures read their data from a bound pixel unpack buffer instead of client memory, which allows uploading
+/// many small images in a few large calls.
+class PBO : public BufferBase<BufferTarget::PixelUnpackBuffer> {
+public:
+    PBO() = default;
+
+    PBO(EmptyObject)
+        : BufferBase<BufferTarget::PixelUnpackBuffer>(empty_object)
+    {}
+
+    ~PBO() = default;
+
+    PBO(const PBO&) = delete;
+    PBO(PBO&&) = default;
+    PBO& operator=(const PBO&) = delete;
+    PBO& operator=(PBO&&) = default;
+
+    /// @brief The number of bytes, that the buffer can hold.
+    std::size_t size() const { return size_; }
+
+    /// @brief Binds the buffer and maps the given number of bytes for writing, discarding all previous contents.
+    /// @remark Grows the buffer if necessary, but never shrinks it, since it is usually reused for similar amounts.
+    std::span<std::byte> map(std::size_t bytes)
+    {
+        assert(bytes > 0);
+        bind();
+        if (bytes > size_) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+            size_ = bytes;
+        }
+        // Invalidating the buffer lets the driver hand out fresh memory, while older uploads might still be pending.
+        auto data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                     0,
+                                     static_cast<GLsizeiptr>(bytes),
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        return {static_cast<std::byte*>(data), bytes};
+    }
+
+    /// @brief Unmaps the buffer, which has to happen before any texture can read from it.
+    /// @remark Returns false if the contents got corrupted while mapped, in which case they have to be written again.
+    bool unmap()
+    {
+        bind();
+        return glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+    }
+
+private:
+    std::size_t size_ = 0;
+};
+
+} // namespace dang::gl
@@ -4,14 +4,17 @@
 #include "dang-gl/Image/PixelFormat.h"
 #include "dang-gl/Image/PixelInternalFormat.h"
 #include "dang-gl/Image/PixelType.h"
+#include "dang-gl/Objects/FBO.h"
 #include "dang-gl/Objects/Object.h"
 #include "dang-gl/Objects/ObjectContext.h"
 #include "dang-gl/Objects/ObjectHandle.h"
 #include "dang-gl/Objects/ObjectType.h"
 #include "dang-gl/Objects/ObjectWrapper.h"
+#include "dang-gl/Objects/PBO.h"
 #include "dang-gl/Objects/TextureContext.h"
 #include "dang-gl/global.h"
 #include "dang-utils/enum.h"
+#include "dang-utils/utils.h"
 
 namespace dang::gl {
 
@@ -247,6 +250,101 @@ public:
         subImage(std::make_index_sequence<v_dim>(), image, offset, mipmap_level);
     }
 
+    /// @brief Modifies a part of the stored texture with pixels, that were staged in a pixel unpack buffer.
+    /// @remark Just like for images, each row of pixels in the buffer is padded to the row alignment.
+    /// @remark The buffer stays bound, so that further calls can read from it as well.
+    template <PixelFormat v_pixel_format, PixelType v_pixel_type, std::size_t v_row_alignment = 4>
+    void modifyFromBuffer(const PBO& buffer,
+                          std::size_t buffer_offset,
+                          svec<v_dim> size,
+                          ivec<v_dim> offset = {},
+                          GLint mipmap_level = 0)
+    {
+        this->bind();
+        buffer.bind();
+        pixelsSubImage<v_pixel_format, v_pixel_type, v_row_alignment>(std::make_index_sequence<v_dim>(),
+                                                                      reinterpret_cast<const void*>(buffer_offset),
+                                                                      size,
+                                                                      offset,
+                                                                      mipmap_level);
+    }
+
+    /// @brief Modifies a part of the stored texture with pixels in client memory, e.g. of a memory mapped file.
+    /// @remark Rows of the given length in pixels are padded to the row alignment, which allows for uploading only part
+    /// of each row, while a row length of zero means, that rows are exactly as long as the size.
+    template <PixelFormat v_pixel_format, PixelType v_pixel_type, std::size_t v_row_alignment = 4>
+    void modifyFromMemory(const void* pixels,
+                          svec<v_dim> size,
+                          ivec<v_dim> offset = {},
+                          GLint mipmap_level = 0,
+                          GLint row_length = 0)
+    {
+        this->bind();
+        context()->unpack_row_length = row_length;
+        pixelsSubImage<v_pixel_format, v_pixel_type, v_row_alignment>(
+            std::make_index_sequence<v_dim>(), pixels, size, offset, mipmap_level);
+        context()->unpack_row_length = 0;
+    }
+
+    /// @brief Reads back part of a mipmap level at the given offset into the given image, which determines the size.
+    /// @remark Allows for reading e.g. a single layer of an array texture, without allocating memory for all of them.
+    /// @remark Attaches one layer after another to a temporary framebuffer, as glGetTextureSubImage needs OpenGL 4.5.
+    template <PixelFormat v_pixel_format, PixelType v_pixel_type, std::size_t v_row_alignment>
+    void readSubImage(Image<v_dim, v_pixel_format, v_pixel_type, v_row_alignment>& image,
+                      ivec<v_dim> offset = {},
+                      GLint mipmap_level = 0) const
+    {
+        static_assert(v_target == TextureTarget::Texture2DArray || v_target == TextureTarget::Texture3D,
+                      "Only layers of array and 3D textures can be read back.");
+        static_assert(v_row_alignment == 1 || v_row_alignment == 2 || v_row_alignment == 4 || v_row_alignment == 8,
+                      "OpenGL only supports image data with row alignments of 1, 2, 4 or 8.");
+        FBO fbo;
+        auto attachment_point = fbo.colorAttachment(0);
+        auto layer_byte_count = image.alignedByteWidth() * image.size().y();
+        context()->pack_alignment = static_cast<GLint>(v_row_alignment);
+        for (std::size_t z = 0; z < image.size().z(); z++) {
+            fbo.attachLayer(*this, attachment_point, offset.z() + static_cast<GLint>(z), mipmap_level);
+            fbo.bind(FramebufferTarget::ReadFramebuffer);
+            glReadPixels(offset.x(),
+                         offset.y(),
+                         static_cast<GLsizei>(image.size().x()),
+                         static_cast<GLsizei>(image.size().y()),
+                         toGLConstant(v_pixel_format),
+                         toGLConstant(v_pixel_type),
+                         static_cast<std::byte*>(image.data()) + z * layer_byte_count);
+        }
+    }
+
+    /// @brief Copies a part of another texture on the GPU, without going through client memory.
+    /// @remark Both textures need compatible internal formats.
+    void copyFrom(const TextureBaseTyped& source,
+                  svec<v_dim> size,
+                  ivec<v_dim> source_offset = {},
+                  ivec<v_dim> offset = {},
+                  GLint source_mipmap_level = 0,
+                  GLint mipmap_level = 0)
+    {
+        // glCopyImageSubData always takes three dimensions, with unused dimensions at an offset of 0 and size of 1.
+        auto component = [](const auto& vector, std::size_t index, GLint fallback) {
+            return index < v_dim ? static_cast<GLint>(vector[index]) : fallback;
+        };
+        glCopyImageSubData(source.handle().unwrap(),
+                           toGLConstant(v_target),
+                           source_mipmap_level,
+                           component(source_offset, 0, 0),
+                           component(source_offset, 1, 0),
+                           component(source_offset, 2, 0),
+                           this->handle().unwrap(),
+                           toGLConstant(v_target),
+                           mipmap_level,
+                           component(offset, 0, 0),
+                           component(offset, 1, 0),
+                           component(offset, 2, 0),
+                           component(size, 0, 1),
+                           component(size, 1, 1),
+                           component(size, 2, 1));
+    }
+
     /// @brief Regenerates all mipmaps from the top level.
     void generateMipmap()
     {
@@ -464,6 +562,26 @@ protected:
                              image.data());
     }
 
+    /// @brief Calls glTexSubImage with raw pixels, which is an offset instead, while a pixel unpack buffer is bound.
+    template <PixelFormat v_pixel_format, PixelType v_pixel_type, std::size_t v_row_alignment, std::size_t... v_indices>
+    void pixelsSubImage(std::index_sequence<v_indices...>,
+                        const void* pixels,
+                        svec<v_dim> size,
+                        ivec<v_dim> offset,
+                        GLint mipmap_level)
+    {
+        static_assert(v_row_alignment == 1 || v_row_alignment == 2 || v_row_alignment == 4 || v_row_alignment == 8,
+                      "OpenGL only supports image data with row alignments of 1, 2, 4 or 8.");
+        context()->unpack_alignment = static_cast<GLint>(v_row_alignment);
+        glTexSubImage<v_dim>(toGLConstant(v_target),
+                             mipmap_level,
+                             offset[v_indices]...,
+                             size[v_indices]...,
+                             toGLConstant(v_pixel_format),
+                             toGLConstant(v_pixel_type),
+                             pixels);
+    }
+
 private:
     svec<v_dim> size_;
 
@@ -574,11 +692,7 @@ private:
     /// size.
     static GLsizei mipmapCount(GLsizei value)
     {
-        // TODO: C++20 use std::bit_width
-        GLsizei result = 1;
-        while (value >>= 1)
-            result++;
-        return result;
+        return std::max(dutils::bit_width(static_cast<std::make_unsigned_t<GLsizei>>(value)), 1);
     }
 
     /// @brief Returns the required count to generate a full mipmap down to 1x1 for the given size.
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "dang-gl/Texturing/TextureAtlasBase.h"
+#include "dang-gl/global.h"
+
+namespace dang::gl {
+
+/// @brief Wraps a texture atlas, so that tiles can be added and removed from any thread, e.g. right after a worker
+/// thread finished loading them.
+/// @remark Tiles are placed right away while holding a lock, so that their handle can be used immediately, while their
+/// pixels stay pending until the GL thread uploads them using updateTexture.
+/// @remark Placement only depends on the order, in which tiles are added, just like for the atlas itself.
+/// @remark Other threads might add tiles at any point, which can change the texture coordinates of all tiles, so tile
+/// handles should only be queried using "access".
+template <typename TAtlas>
+class ConcurrentTextureAtlas {
+public:
+    using Atlas = TAtlas;
+    using BorderedImageData = typename TAtlas::BorderedImageData;
+    using TileHandle = typename TAtlas::TileHandle;
+    using Frozen = typename TAtlas::Frozen;
+
+    explicit ConcurrentTextureAtlas(TAtlas atlas)
+        : atlas_(std::move(atlas))
+        , max_mipmap_levels_(atlas_.limits().max_mipmap_levels)
+    {}
+
+    ConcurrentTextureAtlas(const ConcurrentTextureAtlas&) = delete;
+    ConcurrentTextureAtlas(ConcurrentTextureAtlas&&) = delete;
+    ConcurrentTextureAtlas& operator=(const ConcurrentTextureAtlas&) = delete;
+    ConcurrentTextureAtlas& operator=(ConcurrentTextureAtlas&&) = delete;
+
+    /// @brief Can be called from any thread, which also generates the mipmaps of the tile, before it is placed.
+    /// @remark Generates the maximum number of mipmap levels, as the actual number is only known once all tiles are
+    /// placed, which keeps the GL thread from having to generate them while uploading.
+    [[nodiscard]] TileHandle add(BorderedImageData bordered_image_data)
+    {
+        if (max_mipmap_levels_ > 1)
+            bordered_image_data.generateMipmaps(static_cast<std::size_t>(max_mipmap_levels_));
+        std::scoped_lock lock(mutex_);
+        return atlas_.add(std::move(bordered_image_data));
+    }
+
+    /// @brief Can be called from any thread.
+    [[nodiscard]] bool contains(const TileHandle& tile_handle) const
+    {
+        std::scoped_lock lock(mutex_);
+        return atlas_.contains(tile_handle);
+    }
+
+    /// @brief Can be called from any thread.
+    bool tryRemove(const TileHandle& tile_handle)
+    {
+        std::scoped_lock lock(mutex_);
+        return atlas_.tryRemove(tile_handle);
+    }
+
+    /// @brief Can be called from any thread.
+    void remove(const TileHandle& tile_handle)
+    {
+        std::scoped_lock lock(mutex_);
+        atlas_.remove(tile_handle);
+    }
+
+    /// @brief Can be called from any thread.
+    std::size_t generation() const
+    {
+        std::scoped_lock lock(mutex_);
+        return atlas_.generation();
+    }
+
+    /// @brief Uploads all pending tiles on the GL thread, which blocks other threads from adding tiles in the meantime.
+    TextureAtlasUpdateStats updateTexture()
+    {
+        std::scoped_lock lock(mutex_);
+        return atlas_.updateTexture();
+    }
+
+    /// @brief Defragments the atlas on the GL thread, which blocks other threads from adding tiles in the meantime.
+    TextureAtlasDefragmentStats defragment(std::size_t pixel_budget)
+    {
+        std::scoped_lock lock(mutex_);
+        return atlas_.defragment(pixel_budget);
+    }
+
+    /// @brief Calls the function with the atlas while holding the lock, e.g. to query the texture coordinates of tiles.
+    template <typename TFunction>
+    decltype(auto) access(TFunction&& function)
+    {
+        std::scoped_lock lock(mutex_);
+        return std::forward<TFunction>(function)(atlas_);
+    }
+
+    /// @brief Calls the function with the atlas while holding the lock, e.g. to query the texture coordinates of tiles.
+    template <typename TFunction>
+    decltype(auto) access(TFunction&& function) const
+    {
+        std::scoped_lock lock(mutex_);
+        return std::forward<TFunction>(function)(atlas_);
+    }
+
+    /// @brief Freezes the atlas on the GL thread, after which no more tiles can be added.
+    [[nodiscard]] Frozen freeze() &&
+    {
+        std::scoped_lock lock(mutex_);
+        return std::move(atlas_).freeze();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    TAtlas atlas_;
+    GLsizei max_mipmap_levels_;
+};
+
+} // namespace dang::gl
@@ -3,6 +3,7 @@
 #include "dang-gl/Image/BorderedImage.h"
 #include "dang-gl/Image/PixelFormat.h"
 #include "dang-gl/Image/PixelType.h"
+#include "dang-gl/Objects/PBO.h"
 #include "dang-gl/Objects/Texture.h"
 #include "dang-gl/Texturing/TextureAtlasBase.h"
 #include "dang-gl/Texturing/TextureAtlasUtils.h"
@@ -20,6 +21,8 @@ public:
 
     class BorderedImageData {
     public:
+        using Border = typename BorderedImage::Border;
+
         BorderedImageData(dutils::EnumArray<TSubTextureEnum, BorderedImage> bordered_images)
             : bordered_images_((ensureCompatible(bordered_images), std::move(bordered_images)))
         {}
@@ -44,7 +47,28 @@ public:
                 image.free();
         }
 
+        void generateMipmaps(std::size_t levels)
+        {
+            for (auto& image : bordered_images_)
+                image.generateMipmaps(levels);
+        }
+
+        static BorderedImageData placeholder(const Border& border, dmath::svec2 size)
+        {
+            dutils::EnumArray<TSubTextureEnum, BorderedImage> bordered_images;
+            for (auto& bordered_image : bordered_images)
+                bordered_image = BorderedImage::placeholder(border, size);
+            return BorderedImageData(std::move(bordered_images), Placeholder{});
+        }
+
     private:
+        struct Placeholder {};
+
+        /// @brief Skips the check for empty images, as placeholders have no data.
+        BorderedImageData(dutils::EnumArray<TSubTextureEnum, BorderedImage> bordered_images, Placeholder)
+            : bordered_images_(std::move(bordered_images))
+        {}
+
         void ensureCompatible(const dutils::EnumArray<TSubTextureEnum, BorderedImage>& bordered_images)
         {
             auto size = bordered_images.front().size();
@@ -63,6 +87,11 @@ public:
         dutils::EnumArray<TSubTextureEnum, BorderedImage> bordered_images_;
     };
 
+    using TileRegion = typename TextureAtlasTiles<BorderedImageData>::TileRegion;
+    using LevelImage = Image<3, v_pixel_format, v_pixel_type, v_row_alignment>;
+
+    static constexpr std::size_t texture_count = dutils::enum_count_v<TSubTextureEnum>;
+
     // TODO: Some Texture2DArray related delegates for e.g. min/mag filter.
     //      -> Only a select few are probably important.
     //      -> Do not expose Texture2DArray completely.
@@ -75,21 +104,84 @@ protected:
     bool resize(GLsizei required_size, GLsizei layers, GLsizei mipmap_levels)
     {
         assert(textures_.front().size().x() == textures_.front().size().y());
-        if (required_size == textures_.front().size().x() && layers == textures_.front().size().z())
+        if (required_size == textures_.front().size().x() && layers == textures_.front().size().z() &&
+            mipmap_levels == mipmap_levels_)
             return false;
         // /!\ Resets all texture parameters!
-        for (auto& texture : textures_)
-            texture = Texture2DArray(
+        // Tiles keep their position when the texture grows, so they can be copied on the GPU instead of uploaded.
+        auto kept = mipmap_levels == mipmap_levels_;
+        for (auto& texture : textures_) {
+            auto new_texture = Texture2DArray(
                 {required_size, required_size, layers}, mipmap_levels, pixel_format_internal_v<v_pixel_format>);
-        return true;
+            kept = kept && TextureAtlasUtils::copyLayers(texture, new_texture, mipmap_levels);
+            texture = std::move(new_texture);
+        }
+        mipmap_levels_ = mipmap_levels;
+        return !kept;
     };
 
-    void modify(const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level)
+    TextureAtlasUploads modify(const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level)
     {
-        for (auto sub_texture : dutils::enumerate<TSubTextureEnum>)
-            textures_[sub_texture].modify(bordered_image_data[sub_texture], offset, mipmap_level);
+        auto level = static_cast<std::size_t>(mipmap_level);
+        TextureAtlasUploads uploads;
+        for (auto sub_texture : dutils::enumerate<TSubTextureEnum>) {
+            const auto& image = bordered_image_data[sub_texture].mipmap(level);
+            textures_[sub_texture].modify(image, offset, mipmap_level);
+            uploads += {1, image.byteCount()};
+        }
+        return uploads;
     };
 
+    TextureAtlasUploads modifyRegions(std::span<const TileRegion> regions)
+    {
+        using Image = typename BorderedImage::Image;
+        TextureAtlasUploads uploads;
+        // Each sub texture is staged and uploaded on its own, so that the buffer only needs to hold one of them.
+        for (auto sub_texture : dutils::enumerate<TSubTextureEnum>) {
+            auto get_image = [&](const BorderedImageData& bordered_image_data,
+                                 std::size_t mipmap_level) -> const Image& {
+                return bordered_image_data[sub_texture].mipmap(mipmap_level);
+            };
+            auto offsets = TextureAtlasUtils::stageRegions<Image>(staging_, regions, get_image);
+            for (std::size_t index = 0; index < regions.size(); index++) {
+                const auto& region = regions[index];
+                textures_[sub_texture].template modifyFromBuffer<v_pixel_format, v_pixel_type, v_row_alignment>(
+                    staging_,
+                    offsets[index],
+                    {region.size.x(), region.size.y(), 1},
+                    region.offset,
+                    region.mipmap_level);
+            }
+            uploads += {regions.size(), offsets.back()};
+        }
+        // Textures would keep reading from the buffer instead of client memory.
+        staging_.release();
+        return uploads;
+    }
+
+    void copy(ivec3 from, ivec3 to, svec2 size, GLint mipmap_level)
+    {
+        for (auto& texture : textures_)
+            texture.copyFrom(texture, {size.x(), size.y(), 1}, from, to, mipmap_level, mipmap_level);
+    }
+
+    void readLayer(std::size_t texture_index, LevelImage& image, GLsizei layer, GLint mipmap_level) const
+    {
+        textures_[static_cast<TSubTextureEnum>(texture_index)].readSubImage(image, {0, 0, layer}, mipmap_level);
+    }
+
+    void modifyLayer(std::size_t texture_index,
+                     const void* pixels,
+                     svec2 size,
+                     GLint row_length,
+                     GLsizei layer,
+                     GLint mipmap_level)
+    {
+        textures_[static_cast<TSubTextureEnum>(texture_index)]
+            .template modifyFromMemory<v_pixel_format, v_pixel_type, v_row_alignment>(
+                pixels, {size.x(), size.y(), 1}, {0, 0, layer}, mipmap_level, row_length);
+    }
+
 private:
     template <TSubTextureEnum... v_sub_textures>
     dutils::EnumArray<TSubTextureEnum, Texture2DArray> emptyTextures(
@@ -100,6 +192,8 @@ private:
 
     dutils::EnumArray<TSubTextureEnum, Texture2DArray> textures_ =
         emptyTextures(dutils::makeEnumSequence<TSubTextureEnum>());
+    PBO staging_ = empty_object;
+    GLsizei mipmap_levels_ = 1;
 };
 
 } // namespace detail
@@ -115,9 +209,13 @@ public:
     using Base = TextureAtlasBase<
         detail::TextureAtlasMultiTexture<TSubTextureEnum, v_pixel_format, v_pixel_type, v_row_alignment>>;
 
+    /// @param max_mipmap_levels Generates mipmaps on the CPU, which are uploaded for each tile.
+    /// @param packing How tiles are placed on the layers, which can also pack tiles of mixed sizes onto shared layers.
     explicit MultiTextureAtlas(std::optional<GLsizei> max_texture_size = std::nullopt,
-                               std::optional<GLsizei> max_layer_count = std::nullopt)
-        : Base(TextureAtlasUtils::checkLimits(max_texture_size, max_layer_count))
+                               std::optional<GLsizei> max_layer_count = std::nullopt,
+                               GLsizei max_mipmap_levels = 1,
+                               TextureAtlasPacking packing = TextureAtlasPacking::Grid)
+        : Base(TextureAtlasUtils::checkLimits(max_texture_size, max_layer_count, max_mipmap_levels, packing))
     {}
 };
 
@@ -3,6 +3,7 @@
 #include "dang-gl/Image/BorderedImage.h"
 #include "dang-gl/Image/PixelFormat.h"
 #include "dang-gl/Image/PixelType.h"
+#include "dang-gl/Objects/PBO.h"
 #include "dang-gl/Objects/Texture.h"
 #include "dang-gl/Texturing/TextureAtlasBase.h"
 #include "dang-gl/Texturing/TextureAtlasUtils.h"
@@ -16,6 +17,10 @@ template <PixelFormat v_pixel_format, PixelType v_pixel_type, std::size_t v_row_
 class TextureAtlasSingleTexture {
 public:
     using BorderedImageData = BorderedImage<2, v_pixel_format, v_pixel_type, v_row_alignment>;
+    using TileRegion = typename TextureAtlasTiles<BorderedImageData>::TileRegion;
+    using LevelImage = Image<3, v_pixel_format, v_pixel_type, v_row_alignment>;
+
+    static constexpr std::size_t texture_count = 1;
 
     // TODO: Some Texture2DArray related delegates for e.g. min/mag filter.
     //      -> Only a select few are probably important.
@@ -29,21 +34,62 @@ protected:
     bool resize(GLsizei required_size, GLsizei layers, GLsizei mipmap_levels)
     {
         assert(texture_.size().x() == texture_.size().y());
-        if (required_size == texture_.size().x() && layers == texture_.size().z())
+        if (required_size == texture_.size().x() && layers == texture_.size().z() && mipmap_levels == mipmap_levels_)
             return false;
         // /!\ Resets all texture parameters!
-        texture_ = Texture2DArray(
+        auto texture = Texture2DArray(
             {required_size, required_size, layers}, mipmap_levels, pixel_format_internal_v<v_pixel_format>);
-        return true;
+        // Tiles keep their position when the texture grows, so they can be copied on the GPU instead of uploaded.
+        auto kept = mipmap_levels == mipmap_levels_ && TextureAtlasUtils::copyLayers(texture_, texture, mipmap_levels);
+        texture_ = std::move(texture);
+        mipmap_levels_ = mipmap_levels;
+        return !kept;
     };
 
-    void modify(const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level)
+    TextureAtlasUploads modify(const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level)
     {
-        texture_.modify(bordered_image_data.image(), offset, mipmap_level);
+        const auto& image = bordered_image_data.mipmap(static_cast<std::size_t>(mipmap_level));
+        texture_.modify(image, offset, mipmap_level);
+        return {1, image.byteCount()};
     };
 
+    TextureAtlasUploads modifyRegions(std::span<const TileRegion> regions)
+    {
+        using Image = typename BorderedImageData::Image;
+        auto get_image = [](const BorderedImageData& bordered_image_data, std::size_t mipmap_level) -> const Image& {
+            return bordered_image_data.mipmap(mipmap_level);
+        };
+        auto offsets = TextureAtlasUtils::stageRegions<Image>(staging_, regions, get_image);
+        for (std::size_t index = 0; index < regions.size(); index++) {
+            const auto& region = regions[index];
+            texture_.template modifyFromBuffer<v_pixel_format, v_pixel_type, v_row_alignment>(
+                staging_, offsets[index], {region.size.x(), region.size.y(), 1}, region.offset, region.mipmap_level);
+        }
+        // Textures would keep reading from the buffer instead of client memory.
+        staging_.release();
+        return {regions.size(), offsets.back()};
+    }
+
+    void copy(ivec3 from, ivec3 to, svec2 size, GLint mipmap_level)
+    {
+        texture_.copyFrom(texture_, {size.x(), size.y(), 1}, from, to, mipmap_level, mipmap_level);
+    }
+
+    void readLayer(std::size_t, LevelImage& image, GLsizei layer, GLint mipmap_level) const
+    {
+        texture_.readSubImage(image, {0, 0, layer}, mipmap_level);
+    }
+
+    void modifyLayer(std::size_t, const void* pixels, svec2 size, GLint row_length, GLsizei layer, GLint mipmap_level)
+    {
+        texture_.template modifyFromMemory<v_pixel_format, v_pixel_type, v_row_alignment>(
+            pixels, {size.x(), size.y(), 1}, {0, 0, layer}, mipmap_level, row_length);
+    }
+
 private:
     Texture2DArray texture_ = empty_object;
+    PBO staging_ = empty_object;
+    GLsizei mipmap_levels_ = 1;
 };
 
 } // namespace detail
@@ -56,9 +102,13 @@ class TextureAtlas
 public:
     using Base = TextureAtlasBase<detail::TextureAtlasSingleTexture<v_pixel_format, v_pixel_type, v_row_alignment>>;
 
+    /// @param max_mipmap_levels Generates mipmaps on the CPU, which are uploaded for each tile.
+    /// @param packing How tiles are placed on the layers, which can also pack tiles of mixed sizes onto shared layers.
     explicit TextureAtlas(std::optional<GLsizei> max_texture_size = std::nullopt,
-                          std::optional<GLsizei> max_layer_count = std::nullopt)
-        : Base(TextureAtlasUtils::checkLimits(max_texture_size, max_layer_count))
+                          std::optional<GLsizei> max_layer_count = std::nullopt,
+                          GLsizei max_mipmap_levels = 1,
+                          TextureAtlasPacking packing = TextureAtlasPacking::Grid)
+        : Base(TextureAtlasUtils::checkLimits(max_texture_size, max_layer_count, max_mipmap_levels, packing))
     {}
 };
 
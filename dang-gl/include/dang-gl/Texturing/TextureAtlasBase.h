@@ -1,10 +1,48 @@
 #pragma once
 
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/QOI.h"
+#include "dang-gl/Texturing/TextureAtlasCache.h"
 #include "dang-gl/Texturing/TextureAtlasTiles.h"
 #include "dang-gl/global.h"
+#include "dang-utils/enum.h"
 
 namespace dang::gl {
 
+/// @brief How a texture atlas uploads tiles, which have not been written to the texture yet.
+enum class TextureAtlasUploadMode {
+    /// @brief Uploads each tile and mipmap level with a separate call, straight from client memory.
+    Direct,
+    /// @brief Stages all tiles in a pixel unpack buffer, uploading rectangles of adjacent tiles with a single call.
+    Staged,
+
+    COUNT
+};
+
+} // namespace dang::gl
+
+namespace dang::utils {
+
+template <>
+struct enum_count<dang::gl::TextureAtlasUploadMode> : default_enum_count<dang::gl::TextureAtlasUploadMode> {};
+
+} // namespace dang::utils
+
+namespace dang::gl {
+
+/// @brief The number of calls, that uploaded pixels to the texture, and the number of bytes they uploaded.
+struct TextureAtlasUploads {
+    std::size_t calls = 0;
+    std::size_t bytes = 0;
+
+    TextureAtlasUploads& operator+=(const TextureAtlasUploads& other)
+    {
+        calls += other.calls;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
 /*
 
 The TextureBase concept:
@@ -13,11 +51,64 @@ The TextureBase concept:
 - using BorderedImageData = ...;
 - bool resize(GLsizei required_size, GLsizei layers, GLsizei mipmap_levels)
     -> protected, resizes the texture
-- void modify(const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level)
+    -> returns whether the previous contents were lost, which can be avoided by copying them to the new texture
+- TextureAtlasUploads modify(const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level)
     -> protected, modifies the texture at a given spot
+- TextureAtlasUploads modifyRegions(std::span<const TextureAtlasTiles<BorderedImageData>::TileRegion> regions)
+    -> protected, modifies the texture at all given regions, staging them in a pixel unpack buffer
+- void copy(ivec3 from, ivec3 to, svec2 size, GLint mipmap_level)
+    -> protected, copies a part of the texture to a different position of the same texture on the GPU
+- using LevelImage = Image<3, ...>;
+- static constexpr std::size_t texture_count
+    -> the number of textures, which all share the same layout
+- void readLayer(std::size_t texture_index, LevelImage& image, GLsizei layer, GLint mipmap_level) const
+    -> protected, reads back a single layer of a mipmap level into an image with a depth of one, which is used to save a
+       texture atlas cache
+- void modifyLayer(std::size_t texture_index,
+                   const void* pixels,
+                   svec2 size,
+                   GLint row_length,
+                   GLsizei layer,
+                   GLint mipmap_level)
+    -> protected, modifies part of a layer with pixels of a texture atlas cache, whose rows can be longer than the size
 
 */
 
+namespace detail {
+
+/// @brief The format of a texture atlas cache, which is required to restore tiles on the given texture.
+template <typename TTextureBase>
+TextureAtlasCacheFormat textureAtlasCacheFormat(const TextureAtlasLimits& limits)
+{
+    using LevelImage = typename TTextureBase::LevelImage;
+    return {LevelImage::pixel_format,
+            LevelImage::pixel_type,
+            static_cast<std::uint32_t>(LevelImage::row_alignment),
+            static_cast<std::uint32_t>(TTextureBase::texture_count),
+            limits.max_texture_size,
+            limits.max_mipmap_levels,
+            limits.packing};
+}
+
+/// @brief The number of bytes of a single layer of the given size, including the padding of each row.
+template <typename TTextureBase>
+std::size_t textureAtlasLayerByteCount(GLsizei size)
+{
+    using LevelImage = typename TTextureBase::LevelImage;
+    auto byte_width = static_cast<std::size_t>(size) * sizeof(typename LevelImage::Pixel);
+    auto aligned_byte_width = (byte_width - 1) / LevelImage::row_alignment * LevelImage::row_alignment +
+                              LevelImage::row_alignment;
+    return aligned_byte_width * static_cast<std::size_t>(size);
+}
+
+/// @brief The width and height of a mipmap level.
+inline GLsizei textureAtlasLevelSize(GLsizei size, GLint mipmap_level)
+{
+    return std::max(size >> mipmap_level, GLsizei{1});
+}
+
+} // namespace detail
+
 template <typename TTextureBase>
 class BasicFrozenTextureAtlas;
 
@@ -29,6 +120,16 @@ public:
     using TileHandle = typename Tiles::TileHandle;
     using Frozen = BasicFrozenTextureAtlas<TTextureBase>;
 
+    /// @brief The result of freezeCached, with the handles of all tiles in the same order as their sources.
+    struct CachedFreeze {
+        Frozen atlas;
+        std::vector<TileHandle> tile_handles;
+        /// @brief The number of tiles, whose pixels were uploaded straight from the cache.
+        std::size_t restored_tiles = 0;
+        /// @brief The number of tiles, that had to be loaded, because they changed or were missing from the cache.
+        std::size_t loaded_tiles = 0;
+    };
+
     TextureAtlasBase(const TextureAtlasLimits& limits)
         : tiles_(limits)
     {}
@@ -43,26 +144,213 @@ public:
     bool tryRemove(const TileHandle& tile_handle) { return tiles_.tryRemove(tile_handle); }
     void remove(const TileHandle& tile_handle) { return tiles_.remove(tile_handle); }
 
-    void updateTexture() { return updateTextureHelper<false>(); }
+    /// @brief The limits, that the atlas was created with.
+    const TextureAtlasLimits& limits() const { return tiles_.limits(); }
+
+    /// @brief How new tiles are uploaded, which is direct by default.
+    TextureAtlasUploadMode uploadMode() const { return upload_mode_; }
+    void setUploadMode(TextureAtlasUploadMode upload_mode) { upload_mode_ = upload_mode; }
+
+    /// @brief Uploads all new tiles, returning what the update had to do.
+    TextureAtlasUpdateStats updateTexture() { return updateTextureHelper<false>(); }
+
+    /// @brief Moves tiles into gaps and off of sparse layers, copying them on the GPU, until the budget is used up.
+    /// @remark Meant to be called once per frame with a small budget, which keeps long-running sessions compact.
+    /// @remark The next call to updateTexture shrinks the texture and uploads tiles, that could not be copied.
+    TextureAtlasDefragmentStats defragment(std::size_t pixel_budget)
+    {
+        auto copy = [&](ivec3 from, ivec3 to, svec2 size, GLint mipmap_level) {
+            this->copy(from, to, size, mipmap_level);
+        };
+        return tiles_.defragment(copy, pixel_budget);
+    }
+
+    /// @brief Changes whenever the texture coordinates of any tile change, which means they have to be queried again.
+    std::size_t generation() const { return tiles_.generation(); }
     Frozen freeze() && { return updateTextureHelper<true>(); }
 
+    /// @brief Restores all tiles, whose sources did not change, from the cache and only loads the remaining ones.
+    /// @remark Restored tiles keep their placement, which allows for uploading whole layers from the mapped file.
+    /// @remark Calls "load" with the index of each source, that changed or is missing, which has to return the
+    /// BorderedImageData of that tile, which is then packed into the space, that is still free.
+    /// @remark Loads all tiles if the cache does not match the format of this atlas or would lack mipmap levels.
+    /// @exception std::invalid_argument if the atlas already contains tiles.
+    /// @exception QOIError if the compressed pixels of the cache are invalid.
+    template <typename TLoad>
+    [[nodiscard]] CachedFreeze freezeCached(const TextureAtlasCache& cache,
+                                            std::span<const TextureAtlasCacheSource> sources,
+                                            TLoad&& load) &&
+    {
+        if (!tiles_.empty())
+            throw std::invalid_argument("Only an empty texture atlas can be restored from a cache.");
+
+        std::vector<TileHandle> tile_handles(sources.size());
+        std::vector<std::size_t> restored;
+        // Maps the layers of the cache onto consecutive layers, as layers without any remaining tiles are skipped.
+        std::map<GLsizei, GLsizei> layers;
+        if (compatible(cache)) {
+            std::vector<std::pair<const TextureAtlasCacheTile*, std::size_t>> cached_tiles;
+            for (std::size_t index = 0; index < sources.size(); index++) {
+                if (auto cached_tile = cache.find(sources[index]))
+                    cached_tiles.emplace_back(cached_tile, index);
+            }
+            // Packed layers rely on tiles being restored from bottom to top.
+            std::sort(cached_tiles.begin(), cached_tiles.end(), [](const auto& lhs, const auto& rhs) {
+                const auto& [lhs_tile, lhs_index] = lhs;
+                const auto& [rhs_tile, rhs_index] = rhs;
+                return std::tuple(lhs_tile->layer, lhs_tile->position.y(), lhs_tile->position.x()) <
+                       std::tuple(rhs_tile->layer, rhs_tile->position.y(), rhs_tile->position.x());
+            });
+            for (const auto& [cached_tile, index] : cached_tiles) {
+                auto border = detail::loadBorder<typename BorderedImageData::Border>(cached_tile->border_style,
+                                                                                     cached_tile->border_color);
+                if (!border)
+                    continue;
+                auto layer = layers.find(cached_tile->layer);
+                auto target_layer = layer != layers.end() ? layer->second : static_cast<GLsizei>(layers.size());
+                try {
+                    auto size = static_cast<dmath::svec2>(cached_tile->size);
+                    auto placeholder = BorderedImageData::placeholder(*border, size);
+                    tile_handles[index] = tiles_.restore(std::move(placeholder), target_layer, cached_tile->position);
+                }
+                catch (const std::invalid_argument&) {
+                    // Tiles that do not fit with the configured limits anymore are simply loaded instead.
+                    continue;
+                }
+                layers.emplace(cached_tile->layer, target_layer);
+                restored.push_back(index);
+            }
+        }
+
+        std::size_t loaded_tiles = 0;
+        for (std::size_t index = 0; index < sources.size(); index++) {
+            if (tile_handles[index])
+                continue;
+            tile_handles[index] = tiles_.add(load(index));
+            loaded_tiles++;
+        }
+
+        if (tiles_.mipmapLevels() > cache.layout().mipmap_levels) {
+            // Restored tiles lack the pixels of the additional mipmap levels, so they have to be loaded after all.
+            for (auto index : restored) {
+                tiles_.remove(tile_handles[index]);
+                tile_handles[index] = tiles_.add(load(index));
+            }
+            loaded_tiles += restored.size();
+            restored.clear();
+            layers.clear();
+        }
+
+        auto resize = [&](GLsizei required_size, GLsizei layer_count, GLsizei mipmap_levels) {
+            return this->resize(required_size, layer_count, mipmap_levels);
+        };
+        tiles_.resizeTexture(resize);
+        uploadCachedLayers(cache, layers);
+        for (auto index : restored)
+            tiles_.markWritten(tile_handles[index]);
+
+        auto restored_tiles = restored.size();
+        return {std::move(*this).freeze(), std::move(tile_handles), restored_tiles, loaded_tiles};
+    }
+
 private:
-    template <bool v_freeze>
-    std::conditional_t<v_freeze, Frozen, void> updateTextureHelper()
+    /// @brief Whether the cache is valid and matches the format of this atlas, including the size of all pixels.
+    bool compatible(const TextureAtlasCache& cache) const
     {
-        // TODO: C++20 replace with std::bind_front
-        using namespace std::placeholders;
+        if (!cache)
+            return false;
+        const auto& layout = cache.layout();
+        if (layout.format != detail::textureAtlasCacheFormat<TTextureBase>(tiles_.limits()) ||
+            layout.atlas_size > tiles_.limits().max_texture_size)
+            return false;
 
-        auto resize = std::bind(&TextureAtlasBase::resize, this, _1, _2, _3);
-        auto modify = std::bind(&TextureAtlasBase::modify, this, _1, _2, _3);
+        using LevelImage = typename TTextureBase::LevelImage;
+        constexpr auto qoi = texture_atlas_cache_qoi_v<LevelImage::pixel_format, LevelImage::pixel_type>;
+        if (layout.compression == TextureAtlasCacheCompression::QOI && !qoi)
+            return false;
 
-        if constexpr (v_freeze)
-            return Frozen(std::move(tiles_).freeze(resize, modify), std::move(*this));
-        else
-            tiles_.updateTexture(resize, modify);
+        for (std::size_t texture_index = 0; texture_index < TTextureBase::texture_count; texture_index++) {
+            for (GLint level = 0; level < layout.mipmap_levels; level++) {
+                auto size = detail::textureAtlasLevelSize(layout.atlas_size, level);
+                for (GLsizei layer = 0; layer < layout.layers; layer++) {
+                    auto pixels = cache.pixels(texture_index, level, layer);
+                    if (layout.compression == TextureAtlasCacheCompression::None) {
+                        if (pixels.size() != detail::textureAtlasLayerByteCount<TTextureBase>(size))
+                            return false;
+                    }
+                    else {
+                        try {
+                            if (static_cast<svec2>(detail::qoiSize(pixels)) != svec2(size))
+                                return false;
+                        }
+                        catch (const QOIError&) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /// @brief Uploads the given layers of the cache for all mipmap levels of the texture.
+    /// @remark The texture can be smaller than the cache, as long as it still covers all restored tiles.
+    void uploadCachedLayers(const TextureAtlasCache& cache, const std::map<GLsizei, GLsizei>& layers)
+    {
+        const auto& layout = cache.layout();
+        for (std::size_t texture_index = 0; texture_index < TTextureBase::texture_count; texture_index++) {
+            for (GLint level = 0; level < tiles_.mipmapLevels(); level++) {
+                auto cached_size = detail::textureAtlasLevelSize(layout.atlas_size, level);
+                auto size = std::min(cached_size, detail::textureAtlasLevelSize(tiles_.atlasSize(), level));
+                for (const auto& [cached_layer, layer] : layers) {
+                    auto pixels = cache.pixels(texture_index, level, cached_layer);
+                    if (layout.compression == TextureAtlasCacheCompression::None) {
+                        this->modifyLayer(texture_index, pixels.data(), svec2(size), cached_size, layer, level);
+                        continue;
+                    }
+                    using LevelImage = typename TTextureBase::LevelImage;
+                    if constexpr (texture_atlas_cache_qoi_v<LevelImage::pixel_format, LevelImage::pixel_type>) {
+                        using LayerImage =
+                            Image<2, LevelImage::pixel_format, LevelImage::pixel_type, LevelImage::row_alignment>;
+                        auto image = decodeQOI<LayerImage>(pixels, false);
+                        this->modifyLayer(texture_index, image.data(), svec2(size), cached_size, layer, level);
+                    }
+                }
+            }
+        }
+    }
+
+    template <bool v_freeze>
+    std::conditional_t<v_freeze, Frozen, TextureAtlasUpdateStats> updateTextureHelper()
+    {
+        TextureAtlasUploads uploads;
+        auto resize = [&](GLsizei required_size, GLsizei layers, GLsizei mipmap_levels) {
+            return this->resize(required_size, layers, mipmap_levels);
+        };
+        auto modify = [&](const BorderedImageData& bordered_image_data, ivec3 offset, GLint mipmap_level) {
+            uploads += this->modify(bordered_image_data, offset, mipmap_level);
+        };
+        auto modify_regions = [&](std::span<const typename Tiles::TileRegion> regions) {
+            uploads += this->modifyRegions(regions);
+        };
+
+        auto staged = upload_mode_ == TextureAtlasUploadMode::Staged;
+        if constexpr (v_freeze) {
+            auto tiles = staged ? std::move(tiles_).freezeRegions(resize, modify_regions)
+                                : std::move(tiles_).freeze(resize, modify);
+            return Frozen(std::move(tiles), std::move(*this));
+        }
+        else {
+            auto stats = staged ? tiles_.updateTextureRegions(resize, modify_regions)
+                                : tiles_.updateTexture(resize, modify);
+            stats.upload_calls = uploads.calls;
+            stats.uploaded_bytes = uploads.bytes;
+            return stats;
+        }
     }
 
     Tiles tiles_;
+    TextureAtlasUploadMode upload_mode_ = TextureAtlasUploadMode::Direct;
 };
 
 template <typename TTextureBase>
@@ -76,6 +364,72 @@ public:
 
     [[nodiscard]] bool contains(const TileHandle& tile_handle) const { return tiles_.contains(tile_handle); }
 
+    /// @brief Saves the texture along with the placement of the given tiles, which freezeCached can restore later on.
+    /// @remark Reads back the whole texture, so it should only be saved, when the cache was not up to date.
+    /// @exception std::invalid_argument if there is not exactly one source for each tile handle.
+    /// @exception std::invalid_argument if a tile does not belong to this atlas.
+    /// @exception std::invalid_argument if the compression is not supported by the pixel format.
+    /// @exception TextureAtlasCacheError if the cache cannot be written.
+    void saveCache(const fs::path& path,
+                   std::span<const TextureAtlasCacheSource> sources,
+                   std::span<const TileHandle> tile_handles,
+                   TextureAtlasCacheCompression compression = TextureAtlasCacheCompression::None) const
+    {
+        using LevelImage = typename TTextureBase::LevelImage;
+        constexpr auto qoi = texture_atlas_cache_qoi_v<LevelImage::pixel_format, LevelImage::pixel_type>;
+        if (compression == TextureAtlasCacheCompression::QOI && !qoi)
+            throw std::invalid_argument("QOI only supports RGB(A) with unsigned bytes.");
+        if (sources.size() != tile_handles.size())
+            throw std::invalid_argument("Each tile requires exactly one source.");
+
+        TextureAtlasCacheLayout layout;
+        layout.format = detail::textureAtlasCacheFormat<TTextureBase>(tiles_.limits());
+        layout.atlas_size = tiles_.atlasSize();
+        layout.mipmap_levels = tiles_.mipmapLevels();
+        layout.compression = compression;
+        for (std::size_t index = 0; index < tile_handles.size(); index++) {
+            const auto& tile_handle = tile_handles[index];
+            if (!tiles_.contains(tile_handle))
+                throw std::invalid_argument("Tile does not belong to this atlas.");
+            auto [border_style, border_color] = detail::saveBorder(tile_handle.border());
+            layout.tiles.push_back({sources[index],
+                                    tile_handle.layer(),
+                                    tile_handle.pixelPos(),
+                                    static_cast<svec2>(tile_handle.pixelSize()),
+                                    border_style,
+                                    std::move(border_color)});
+            layout.layers = std::max(layout.layers, tile_handle.layer() + 1);
+        }
+
+        TextureAtlasCacheWriter writer(path, layout);
+        for (std::size_t texture_index = 0; texture_index < TTextureBase::texture_count; texture_index++) {
+            for (GLint level = 0; level < layout.mipmap_levels; level++) {
+                // Layers are read back one at a time, as the whole level can easily take up gigabytes.
+                auto size = detail::textureAtlasLevelSize(layout.atlas_size, level);
+                // Zeroed, as reading back skips the padding at the end of each row, which ends up in the file as well.
+                auto byte_count = detail::textureAtlasLayerByteCount<TTextureBase>(size);
+                auto image = LevelImage(static_cast<typename LevelImage::Size>(svec3(size, size, 1)),
+                                        std::make_unique<std::byte[]>(byte_count));
+                auto pixels = std::span(static_cast<const std::byte*>(image.data()), byte_count);
+                for (GLsizei layer = 0; layer < layout.layers; layer++) {
+                    this->readLayer(texture_index, image, layer, level);
+                    if constexpr (qoi) {
+                        if (compression == TextureAtlasCacheCompression::QOI) {
+                            writer.write(detail::encodeQOI(pixels.data(),
+                                                           dmath::svec2(static_cast<std::size_t>(size)),
+                                                           image.alignedByteWidth(),
+                                                           detail::qoi_layout<LevelImage::pixel_format>,
+                                                           false));
+                            continue;
+                        }
+                    }
+                    writer.write(pixels);
+                }
+            }
+        }
+        writer.finish();
+    }
+
 private:
     BasicFrozenTextureAtlas(Tiles&& tiles, TTextureBase&& texture)
         : TTextureBase(std::move(texture))
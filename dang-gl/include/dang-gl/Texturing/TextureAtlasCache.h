@@ -0,0 +1,217 @@
+#pragma once
+
+#include "dang-gl/Image/MappedFile.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-gl/Math/MathTypes.h"
+#include "dang-gl/Texturing/TextureAtlasTiles.h"
+#include "dang-gl/global.h"
+#include "dang-utils/enum.h"
+
+namespace dang::gl {
+
+/// @brief How the pixels of each layer are stored in a texture atlas cache.
+enum class TextureAtlasCacheCompression {
+    /// @brief Stores raw pixels, which are uploaded straight from the memory mapped file.
+    None,
+    /// @brief Compresses each layer using QOI, which only supports RGB(A) with unsigned bytes.
+    QOI,
+
+    COUNT
+};
+
+} // namespace dang::gl
+
+namespace dang::utils {
+
+template <>
+struct enum_count<dang::gl::TextureAtlasCacheCompression>
+    : default_enum_count<dang::gl::TextureAtlasCacheCompression> {};
+
+} // namespace dang::utils
+
+namespace dang::gl {
+
+/// @brief Whether layers of the given format can be compressed using QOI.
+template <PixelFormat v_pixel_format, PixelType v_pixel_type>
+inline constexpr bool texture_atlas_cache_qoi_v =
+    v_pixel_type == PixelType::UNSIGNED_BYTE &&
+    (pixel_format_component_count_v<v_pixel_format> == 3 || pixel_format_component_count_v<v_pixel_format> == 4);
+
+/// @brief Thrown when a texture atlas cache cannot be written.
+class TextureAtlasCacheError : public std::runtime_error {
+    using runtime_error::runtime_error;
+};
+
+/// @brief Identifies the source of a tile, usually by its file name, along with a hash of its content.
+struct TextureAtlasCacheSource {
+    std::string name;
+    std::uint64_t hash = 0;
+};
+
+/// @brief Hashes the content of a source, e.g. of a memory mapped PNG file, using 64-bit FNV-1a.
+/// @remark Hashing a file is a lot faster than decoding it, which is only necessary once its hash changed.
+std::uint64_t hashTextureAtlasSource(std::span<const std::byte> data);
+
+/// @brief Everything that has to match, for a texture atlas to use a cache.
+struct TextureAtlasCacheFormat {
+    PixelFormat pixel_format = PixelFormat::RGBA;
+    PixelType pixel_type = PixelType::UNSIGNED_BYTE;
+    std::uint32_t row_alignment = 4;
+    /// @brief The number of textures, that share the same layout, e.g. for each sub texture of a multi texture atlas.
+    std::uint32_t texture_count = 1;
+    GLsizei max_texture_size = 0;
+    GLsizei max_mipmap_levels = 1;
+    TextureAtlasPacking packing = TextureAtlasPacking::Grid;
+
+    friend bool operator==(const TextureAtlasCacheFormat&, const TextureAtlasCacheFormat&) = default;
+};
+
+/// @brief The placement of a single tile in a texture atlas cache.
+struct TextureAtlasCacheTile {
+    TextureAtlasCacheSource source;
+    GLsizei layer = 0;
+    svec2 position;
+    /// @brief The size of the image, including its border.
+    svec2 size;
+    /// @brief The index of the border style, which is followed by the color for solid borders.
+    std::uint32_t border_style = 0;
+    std::vector<std::byte> border_color;
+};
+
+/// @brief Describes the texture of a texture atlas cache and where each tile is placed on it.
+struct TextureAtlasCacheLayout {
+    TextureAtlasCacheFormat format;
+    GLsizei atlas_size = 0;
+    GLsizei layers = 0;
+    GLsizei mipmap_levels = 0;
+    TextureAtlasCacheCompression compression = TextureAtlasCacheCompression::None;
+    std::vector<TextureAtlasCacheTile> tiles;
+
+    /// @brief The number of pixel blocks, with one for each texture, mipmap level and layer.
+    std::size_t blockCount() const;
+};
+
+/// @brief A texture atlas cache, which is mapped into memory, so that its layers can be uploaded without copying them.
+/// @remark Similar to MappedFile, a missing or invalid file does not throw, but results in an empty cache instead.
+class TextureAtlasCache {
+public:
+    /// @brief Creates an empty cache, which does not contain any tiles.
+    TextureAtlasCache() = default;
+    /// @brief Maps and reads the cache at the given path, which can be checked for success using operator bool.
+    explicit TextureAtlasCache(const fs::path& path);
+
+    /// @brief Whether the file could be read as a valid cache.
+    explicit operator bool() const { return valid_; }
+
+    /// @brief The layout of the cached texture, including all of its tiles.
+    const TextureAtlasCacheLayout& layout() const { return layout_; }
+
+    /// @brief The pixels of a single layer, which are compressed as specified by the layout.
+    /// @remark Uncompressed rows are padded to the row alignment, just like the rows of an image.
+    std::span<const std::byte> pixels(std::size_t texture_index, GLint mipmap_level, GLsizei layer) const;
+
+    /// @brief Finds the tile of the given source, as long as its hash still matches.
+    const TextureAtlasCacheTile* find(const TextureAtlasCacheSource& source) const;
+
+    /// @brief Whether the cache contains exactly the given sources with matching hashes.
+    bool upToDate(std::span<const TextureAtlasCacheSource> sources) const;
+
+private:
+    MappedFile file_;
+    bool valid_ = false;
+    TextureAtlasCacheLayout layout_;
+    std::vector<std::span<const std::byte>> blocks_;
+    std::unordered_map<std::string_view, std::size_t> tile_indices_;
+};
+
+/// @brief Writes a texture atlas cache, which is only moved into place once all pixels were written.
+class TextureAtlasCacheWriter {
+public:
+    /// @brief Starts writing the layout to a temporary file next to the given path.
+    /// @exception TextureAtlasCacheError if the file cannot be opened or written to.
+    TextureAtlasCacheWriter(const fs::path& path, const TextureAtlasCacheLayout& layout);
+    /// @brief Removes the temporary file again, unless the cache was finished.
+    ~TextureAtlasCacheWriter();
+
+    TextureAtlasCacheWriter(const TextureAtlasCacheWriter&) = delete;
+    TextureAtlasCacheWriter(TextureAtlasCacheWriter&&) = delete;
+    TextureAtlasCacheWriter& operator=(const TextureAtlasCacheWriter&) = delete;
+    TextureAtlasCacheWriter& operator=(TextureAtlasCacheWriter&&) = delete;
+
+    /// @brief Appends the pixels of the next block, going through all layers of each mipmap level of each texture.
+    /// @exception TextureAtlasCacheError if the file cannot be written to.
+    void write(std::span<const std::byte> pixels);
+
+    /// @brief Replaces the file at the given path with the written cache.
+    /// @exception std::logic_error if not all blocks of pixels were written.
+    /// @exception TextureAtlasCacheError if the file cannot be written to or moved into place.
+    void finish();
+
+private:
+    fs::path path_;
+    fs::path temporary_path_;
+    std::ofstream stream_;
+    std::size_t remaining_blocks_;
+    bool finished_ = false;
+};
+
+namespace detail {
+
+/// @brief Returns the index of the border style and the bytes of the color of solid borders.
+template <typename TBorder>
+std::pair<std::uint32_t, std::vector<std::byte>> saveBorder(const TBorder& border)
+{
+    auto color = std::visit(
+        [](const auto& style) {
+            using Style = std::remove_cvref_t<decltype(style)>;
+            if constexpr (std::is_empty_v<Style>)
+                return std::vector<std::byte>();
+            else {
+                static_assert(std::is_trivially_copyable_v<Style>);
+                auto bytes = reinterpret_cast<const std::byte*>(&style);
+                return std::vector<std::byte>(bytes, bytes + sizeof(Style));
+            }
+        },
+        border);
+    return {static_cast<std::uint32_t>(border.index()), std::move(color)};
+}
+
+/// @brief Constructs the border style with the given index, as long as the color has the right size.
+template <typename TBorder, std::size_t v_index>
+void loadBorderStyle(std::optional<TBorder>& result, std::uint32_t style_index, std::span<const std::byte> color)
+{
+    using Style = std::variant_alternative_t<v_index, TBorder>;
+    if (style_index != v_index)
+        return;
+    if constexpr (std::is_empty_v<Style>) {
+        if (color.empty())
+            result = Style();
+    }
+    else if (color.size() == sizeof(Style)) {
+        Style style;
+        std::memcpy(&style, color.data(), sizeof(Style));
+        result = style;
+    }
+}
+
+template <typename TBorder, std::size_t... v_indices>
+std::optional<TBorder> loadBorder(std::uint32_t style_index,
+                                  std::span<const std::byte> color,
+                                  std::index_sequence<v_indices...>)
+{
+    std::optional<TBorder> result;
+    (loadBorderStyle<TBorder, v_indices>(result, style_index, color), ...);
+    return result;
+}
+
+/// @brief Restores a border, that was saved using saveBorder, returning nothing if the style or color is invalid.
+template <typename TBorder>
+std::optional<TBorder> loadBorder(std::uint32_t style_index, std::span<const std::byte> color)
+{
+    return loadBorder<TBorder>(style_index, color, std::make_index_sequence<std::variant_size_v<TBorder>>());
+}
+
+} // namespace detail
+
+} // namespace dang::gl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dang-gl/Math/MathTypes.h"
+#include "dang-gl/Texturing/TexturePacker.h"
 #include "dang-gl/global.h"
 #include "dang-utils/utils.h"
 
@@ -22,6 +23,13 @@ The BorderedImageData concept:
     -> image size
 - void free()
     -> frees all data, but leaves the size
+- void generateMipmaps(std::size_t levels)
+    -> prepares data for the given number of mipmap levels, which are then modified one after another
+- using Border = ...;
+- const Border& border() const
+    -> the border of the image, only required to save tiles to a cache
+- static TBorderedImageData placeholder(const Border& border, dmath::svec2 size)
+    -> data without any pixels, only required to restore tiles from a cache
 
 */
 
@@ -29,26 +37,85 @@ The BorderedImageData concept:
 struct TextureAtlasLimits {
     GLsizei max_texture_size;
     GLsizei max_layer_count;
+    /// @brief Further limited, so that even the smallest tiles keep at least a single pixel.
+    GLsizei max_mipmap_levels = 1;
+    /// @brief How tiles are placed on the layers of the texture.
+    TextureAtlasPacking packing = TextureAtlasPacking::Grid;
 };
 
-/// @brief Can store a large number of texture tiles in multiple layers of grids.
+/// @brief What a single update of the texture atlas had to do.
+struct TextureAtlasUpdateStats {
+    /// @brief Whether the texture had to be resized.
+    bool resized = false;
+    /// @brief Whether resizing lost the previous contents of the texture, so that all tiles had to be uploaded again.
+    bool contents_lost = false;
+    /// @brief The number of uploaded tiles, each including all of its mipmap levels.
+    std::size_t uploaded_tiles = 0;
+    /// @brief The number of calls that uploaded pixels, which is only known to the texture atlas itself.
+    std::size_t upload_calls = 0;
+    /// @brief The number of bytes uploaded from client memory, which is only known to the texture atlas itself.
+    std::size_t uploaded_bytes = 0;
+};
+
+/// @brief What a single call to defragment the texture atlas did.
+struct TextureAtlasDefragmentStats {
+    /// @brief The number of tiles, that were moved into a gap or onto a different layer.
+    std::size_t moved_tiles = 0;
+    /// @brief The number of layers, that were moved into the place of a layer that was freed up.
+    std::size_t moved_layers = 0;
+    /// @brief The number of pixels on the base level of all moved tiles and layers.
+    std::size_t moved_pixels = 0;
+    /// @brief Whether there is nothing left to defragment, so that further calls won't do anything.
+    bool finished = false;
+};
+
+/// @brief Can store a large number of texture tiles in multiple layers, either in grids or packed tightly.
 /// @remark Meant for use with a 2D array texture, but has no hard dependency on it.
 template <typename TBorderedImageData>
 class TextureAtlasTiles {
 public:
+    /// @brief A single tile of a region with its offset in pixels, relative to the region itself.
+    struct RegionTile {
+        const TBorderedImageData* bordered_image_data;
+        svec2 offset;
+    };
+
+    /// @brief A rectangle of adjacent tiles on a single layer and mipmap level, which can be uploaded all at once.
+    /// @remark Each tile has a cell of the same size, which can be bigger than the image of the tile itself.
+    struct TileRegion {
+        /// @brief The offset in pixels on the mipmap level, with the layer as z.
+        ivec3 offset;
+        /// @brief The size in pixels on the mipmap level.
+        svec2 size;
+        /// @brief The size of a single cell in pixels on the mipmap level.
+        svec2 cell_size;
+        GLint mipmap_level = 0;
+        /// @brief All tiles, whose cells cover the region completely.
+        std::vector<RegionTile> tiles;
+    };
+
     /// @brief A function that is called with required size (width and height), layers and mipmap levels.
-    /// @remark Returns whether actual resizing occurred.
+    /// @remark Returns whether the previous contents of the texture were lost, so that all tiles have to be uploaded.
     using TextureResizeFunction = std::function<bool(GLsizei, GLsizei, GLsizei)>;
 
     /// @brief A function that uploads the image to a specific position and mipmap level of a texture.
     using TextureModifyFunction = std::function<void(const TBorderedImageData&, ivec3, GLint)>;
 
+    /// @brief A function that uploads a list of regions, which can span multiple layers and mipmap levels.
+    using TextureModifyRegionsFunction = std::function<void(std::span<const TileRegion>)>;
+
+    /// @brief A function that copies a part of a mipmap level to a different position on the GPU.
+    /// @remark Called with the source offset, destination offset, size and mipmap level.
+    using TextureCopyFunction = std::function<void(ivec3, ivec3, svec2, GLint)>;
+
     class TileHandle;
 
 private:
     /// @brief Atlas information which is stored in a unique_ptr, so that it can be shared with all TileData instances.
     struct AtlasInfo {
         GLsizei atlas_size;
+        /// @brief Changes whenever the texture coordinates of any tile change.
+        std::size_t generation = 0;
     };
 
     /// @brief Information about the placement of a tile, including whether it has been written to the texture yet.
@@ -57,17 +124,21 @@ private:
         std::size_t index = 0;
         /// @brief The position where the write this tile in the array texture.
         svec3 position;
+        /// @brief The size of the space, that is reserved for this tile, which can be bigger than the tile itself.
+        svec2 size;
         /// @brief Whether this tile has been written to the array texture yet.
         bool written = false;
 
         TilePlacement() = default;
 
         /// @param index The index of this tile in the layer.
-        /// @param layer The index of the layer itself, determining the z position.
         /// @param position The x and y coordinates of the position.
-        TilePlacement(std::size_t index, svec2 position, GLsizei layer)
+        /// @param size The size of the space, that is reserved for this tile.
+        /// @param layer The index of the layer itself, determining the z position.
+        TilePlacement(std::size_t index, svec2 position, svec2 size, GLsizei layer)
             : index(index)
             , position(position.x(), position.y(), layer)
+            , size(size)
         {}
     };
 
@@ -76,6 +147,8 @@ private:
         TBorderedImageData bordered_image_data;
         TilePlacement placement;
         std::shared_ptr<const AtlasInfo> atlas_info;
+        /// @brief The index in the list of all tiles of the atlas, allowing lookup and removal in constant time.
+        std::size_t slot = 0;
 
         TileData(TBorderedImageData&& bordered_image_data, std::shared_ptr<const AtlasInfo> atlas_info)
             : bordered_image_data(std::move(bordered_image_data))
@@ -92,17 +165,25 @@ private:
     /// @brief A single layer in the array texture, storing a list of references to tiles.
     class Layer {
     public:
-        /// @brief Creates a new layer with the given tile size, specified as log2.
+        /// @brief Creates a new layer with a grid for tiles of the given size, specified as log2.
         explicit Layer(const svec2& tile_size_log2, std::size_t max_texture_size)
             : tile_size_log2_(tile_size_log2)
             , max_tiles_(calculateMaxTiles(max_texture_size))
         {}
 
+        /// @brief Creates a new layer, which packs tiles of any size using the given packer.
+        explicit Layer(TexturePacker packer)
+            : packer_(std::move(packer))
+        {}
+
         Layer(const Layer&) = delete;
         Layer(Layer&&) = default;
         Layer& operator=(const Layer&) = delete;
         Layer& operator=(Layer&&) = default;
 
+        /// @brief Whether tiles of any size are packed onto the layer, rather than placed in a grid.
+        bool packed() const { return packer_.has_value(); }
+
         /// @brief Returns the log2 of the pixel size of a tile.
         svec2 tileSizeLog2() const { return tile_size_log2_; }
         /// @brief Returns the pixel size of a single tile.
@@ -119,71 +200,286 @@ private:
         }
 
         /// @brief Calculates the required texture size to fit all tiles.
-        GLsizei requiredTextureSize() const { return tileSize().maxValue() << requiredGridSizeLog2(); }
+        GLsizei requiredTextureSize() const
+        {
+            if (packer_)
+                return packer_->size();
+            return tileSize().maxValue() << requiredGridSizeLog2();
+        }
 
         /// @brief Whether the grid is empty.
         bool empty() const { return tiles_.empty(); }
 
-        /// @brief Whether the grid is filled completely.
-        bool full() const { return first_free_tile_ == max_tiles_; }
+        /// @brief The number of tiles on the layer, not counting any gaps.
+        std::size_t tileCount() const { return tiles_.size() - free_indices_.size(); }
+
+        /// @brief The number of tiles, that can still be added to the grid, which is unknown for packed layers.
+        std::size_t freeTileCount() const { return packer_ ? 0 : max_tiles_ - tileCount(); }
+
+        /// @brief The area of all tiles on a packed layer, including their alignment.
+        std::size_t packedArea() const { return packed_area_; }
 
-        /// @brief Places a single tile in the grid, filling potential gaps that appeared after removing tiles.
+        /// @brief The tile with the highest index, which is the first to be moved when defragmenting.
+        TileData* lastTile() const { return tiles_.empty() ? nullptr : tiles_.back(); }
+
+        /// @brief The index of the first gap, which the last tile could be moved into.
+        std::optional<std::size_t> firstGap() const
+        {
+            if (free_indices_.empty())
+                return std::nullopt;
+            return *free_indices_.begin();
+        }
+
+        /// @brief Whether the grid is filled completely, which is never the case for packed layers.
+        bool full() const { return !packer_ && free_indices_.empty() && tiles_.size() == max_tiles_; }
+
+        /// @brief Places a single tile in the grid, filling the first of the gaps that appeared after removing tiles.
         void addTile(TileData& tile, GLsizei layer)
         {
-            assert(!full());
-            tile.placement = TilePlacement(first_free_tile_, tileSize() * indexToPosition(first_free_tile_), layer);
-
-            // find next free tile
-            if (first_free_tile_ < tiles_.size()) {
-                auto first = begin(tiles_) + first_free_tile_ + 1;
-                auto iter = std::find(first, end(tiles_), &tile);
-                first_free_tile_ = static_cast<std::size_t>(std::distance(begin(tiles_), iter));
-            }
-            else {
-                tiles_.push_back(&tile);
-                first_free_tile_++;
+            assert(!packer_ && !full());
+            auto index = storeTile(tile);
+            tile.placement = TilePlacement(index, tileSize() * indexToPosition(index), tileSize(), layer);
+        }
+
+        /// @brief Packs a single tile onto the layer, which fails if there is not enough space left.
+        bool tryPackTile(TileData& tile, GLsizei layer)
+        {
+            assert(packer_);
+            auto size = static_cast<svec2>(tile.bordered_image_data.size());
+            auto position = packer_->insert(size);
+            if (!position)
+                return false;
+            auto index = storeTile(tile);
+            tile.placement = TilePlacement(index, *position, packer_->alignedSize(size), layer);
+            packed_area_ += static_cast<std::size_t>(tile.placement.size.product());
+            return true;
+        }
+
+        /// @brief Places a single tile at the given position, as long as it is free, which is used to restore tiles.
+        /// @remark Packed layers rely on tiles being placed from bottom to top.
+        bool tryPlaceTile(TileData& tile, svec2 position, GLsizei layer)
+        {
+            auto size = static_cast<svec2>(tile.bordered_image_data.size());
+            if (packer_) {
+                if (!packer_->canReserve(position, size))
+                    return false;
+                packer_->reserve(position, size);
+                auto index = storeTile(tile, tiles_.size());
+                tile.placement = TilePlacement(index, position, packer_->alignedSize(size), layer);
+                packed_area_ += static_cast<std::size_t>(tile.placement.size.product());
+                return true;
             }
+            if (position % tileSize() != svec2())
+                return false;
+            auto index = positionToIndex(position / tileSize());
+            if (index >= max_tiles_ || (index < tiles_.size() && tiles_[index] != nullptr))
+                return false;
+            storeTile(tile, index);
+            tile.placement = TilePlacement(index, position, tileSize(), layer);
+            return true;
         }
 
-        /// @brief Removes a single tile, opening a gap, as all other tiles stay untouched.
-        void removeTile(TileData& tile)
+        /// @brief Removes the tile with the given placement, opening a gap, as all other tiles stay untouched.
+        void removeTile(const TilePlacement& placement)
         {
-            auto index = tile.placement.index;
-            first_free_tile_ = std::min(first_free_tile_, index);
+            if (packer_) {
+                packer_->remove(placement.position.xy(), placement.size);
+                packed_area_ -= static_cast<std::size_t>(placement.size.product());
+            }
+            auto index = placement.index;
             tiles_[index] = nullptr;
-            auto last_not_null = std::find_if(rbegin(tiles_), rend(tiles_), [](auto tile) { return tile != nullptr; });
-            tiles_.erase(last_not_null.base(), end(tiles_));
+            free_indices_.insert(index);
+            // Gaps at the end are dropped, so that the layer can shrink again.
+            while (!tiles_.empty() && tiles_.back() == nullptr) {
+                free_indices_.erase(tiles_.size() - 1);
+                tiles_.pop_back();
+            }
         }
 
-        /// @brief Draws all tiles that haven't been written yet and optionally frees their resources.
-        void drawTiles(const TextureModifyFunction& modify, bool freeze) const
+        /// @brief Draws all tiles that haven't been written yet.
+        /// @remark Returns the number of tiles that were drawn.
+        template <typename TModify>
+        std::size_t drawTiles(TModify& modify, GLsizei mipmap_levels) const
         {
+            std::size_t drawn = 0;
             for (auto tile : tiles_) {
-                if (tile == nullptr)
+                if (tile == nullptr || tile->placement.written)
+                    continue;
+                drawTile(*tile, modify, mipmap_levels);
+                drawn++;
+            }
+            return drawn;
+        }
+
+        /// @brief Groups all tiles that haven't been written yet into as few rectangles as possible for each level.
+        /// @remark Also adds these tiles to "pending", so that they can be marked as written once they are uploaded.
+        void collectRegions(std::vector<TileRegion>& regions,
+                            std::vector<TileData*>& pending,
+                            GLsizei mipmap_levels) const
+        {
+            auto first_pending = pending.size();
+            for (auto tile : tiles_) {
+                if (tile == nullptr || tile->placement.written)
                     continue;
-                if (!tile->placement.written) {
-                    drawTile(*tile, modify);
-                    assert(tile->placement.written);
+                assert(tile->bordered_image_data);
+                if (mipmap_levels > 1)
+                    tile->bordered_image_data.generateMipmaps(static_cast<std::size_t>(mipmap_levels));
+                pending.push_back(tile);
+            }
+            auto unwritten = std::span(pending).subspan(first_pending);
+            if (unwritten.empty())
+                return;
+
+            // Tiles of different sizes don't line up, so each one is uploaded on its own.
+            if (packer_) {
+                for (GLint level = 0; level < mipmap_levels; level++) {
+                    for (auto tile : unwritten) {
+                        const auto& placement = tile->placement;
+                        auto& region = regions.emplace_back();
+                        region.offset = ivec3(
+                            placement.position.x() >> level, placement.position.y() >> level, placement.position.z());
+                        region.size = svec2(placement.size.x() >> level, placement.size.y() >> level);
+                        region.cell_size = region.size;
+                        region.mipmap_level = level;
+                        region.tiles.push_back({&tile->bordered_image_data, svec2()});
+                    }
+                }
+                return;
+            }
+
+            auto tile_size = tileSize();
+            auto cell = [&](const TileData* tile) { return tile->placement.position.xy() / tile_size; };
+            std::vector<TileData*> sorted(unwritten.begin(), unwritten.end());
+            std::sort(sorted.begin(), sorted.end(), [&](const TileData* lhs, const TileData* rhs) {
+                return cell(lhs).yx() < cell(rhs).yx();
+            });
+
+            // Runs of horizontally adjacent cells extend a rectangle, that covers the same columns in the row above.
+            struct Rectangle {
+                svec2 low;
+                svec2 high;
+                std::vector<const TileData*> tiles;
+            };
+            std::vector<Rectangle> rectangles;
+            using Columns = std::pair<GLsizei, GLsizei>;
+            std::map<Columns, std::size_t> previous_row;
+            std::map<Columns, std::size_t> current_row;
+            auto row = cell(sorted.front()).y();
+
+            for (std::size_t begin = 0; begin < sorted.size();) {
+                auto first = cell(sorted[begin]);
+                auto end = begin + 1;
+                while (end < sorted.size() && cell(sorted[end]) == first + svec2(static_cast<GLsizei>(end - begin), 0))
+                    end++;
+
+                if (first.y() != row) {
+                    previous_row = std::exchange(current_row, {});
+                    row = first.y();
+                }
+                auto columns = Columns(first.x(), first.x() + static_cast<GLsizei>(end - begin));
+                auto above = previous_row.find(columns);
+                std::size_t index;
+                if (above != previous_row.end() && rectangles[above->second].high.y() == row) {
+                    index = above->second;
+                    rectangles[index].high.y()++;
                 }
-                if (freeze)
-                    tile->bordered_image_data.free();
+                else {
+                    index = rectangles.size();
+                    rectangles.push_back({first, svec2(columns.second, row + 1), {}});
+                }
+                auto& tiles = rectangles[index].tiles;
+                tiles.insert(tiles.end(), sorted.begin() + begin, sorted.begin() + end);
+                current_row[columns] = index;
+                begin = end;
+            }
+
+            auto layer = static_cast<GLint>(sorted.front()->placement.position.z());
+            for (GLint level = 0; level < mipmap_levels; level++) {
+                auto cell_size = svec2(tile_size.x() >> level, tile_size.y() >> level);
+                for (const auto& rectangle : rectangles) {
+                    auto& region = regions.emplace_back();
+                    auto offset = rectangle.low * cell_size;
+                    region.offset = ivec3(offset.x(), offset.y(), layer);
+                    region.size = (rectangle.high - rectangle.low) * cell_size;
+                    region.cell_size = cell_size;
+                    region.mipmap_level = level;
+                    region.tiles.reserve(rectangle.tiles.size());
+                    for (auto tile : rectangle.tiles)
+                        region.tiles.push_back({&tile->bordered_image_data, (cell(tile) - rectangle.low) * cell_size});
+                }
+            }
+        }
+
+        /// @brief Frees the image data of all tiles, which have to be written already.
+        void freeTiles() const
+        {
+            for (auto tile : tiles_) {
+                if (tile == nullptr)
+                    continue;
+                assert(tile->placement.written);
+                tile->bordered_image_data.free();
             }
         }
 
-        /// @brief Shifts all tiles in the layer down by one.
+        /// @brief Shifts all tiles in the layer down by one, which means they have to be written again.
         void shiftDown()
         {
-            for (auto tile : tiles_)
-                if (tile)
+            for (auto tile : tiles_) {
+                if (tile) {
                     tile->placement.position.z()--;
+                    tile->placement.written = false;
+                }
+            }
+        }
+
+        /// @brief Moves all tiles to the given layer, which only keeps them written, if the layer was copied.
+        void moveTo(GLsizei layer, bool copied)
+        {
+            for (auto tile : tiles_) {
+                if (tile) {
+                    tile->placement.position.z() = layer;
+                    tile->placement.written = tile->placement.written && copied;
+                }
+            }
         }
 
     private:
-        /// @brief Draws a single tile onto the texture.
-        void drawTile(TileData& tile, const TextureModifyFunction& modify) const
+        /// @brief Stores the tile in the first gap or at the end, returning its index.
+        std::size_t storeTile(TileData& tile)
+        {
+            if (free_indices_.empty()) {
+                tiles_.push_back(&tile);
+                return tiles_.size() - 1;
+            }
+            auto index = free_indices_.extract(free_indices_.begin()).value();
+            tiles_[index] = &tile;
+            return index;
+        }
+
+        /// @brief Stores the tile at the given index, turning any skipped indices into gaps.
+        std::size_t storeTile(TileData& tile, std::size_t index)
+        {
+            while (tiles_.size() <= index) {
+                free_indices_.insert(tiles_.size());
+                tiles_.push_back(nullptr);
+            }
+            free_indices_.erase(index);
+            tiles_[index] = &tile;
+            return index;
+        }
+
+        /// @brief Draws a single tile onto the texture, including all of its mipmap levels.
+        template <typename TModify>
+        void drawTile(TileData& tile, TModify& modify, GLsizei mipmap_levels) const
         {
             assert(tile.bordered_image_data);
-            modify(tile.bordered_image_data, tile.placement.position, 0); // TODO: Mipmapping
+            if (mipmap_levels > 1)
+                tile.bordered_image_data.generateMipmaps(static_cast<std::size_t>(mipmap_levels));
+            const auto& position = tile.placement.position;
+            for (GLint level = 0; level < mipmap_levels; level++) {
+                auto offset = ivec3(position.x() >> level, position.y() >> level, position.z());
+                modify(tile.bordered_image_data, offset, level);
+            }
             tile.placement.written = true;
         }
 
@@ -201,8 +497,9 @@ private:
         {
             auto size_diff_log2 = std::abs(tile_size_log2_.x() - tile_size_log2_.y());
             auto flip = tile_size_log2_.x() < tile_size_log2_.y();
-            auto x = static_cast<GLsizei>(dutils::removeOddBits(index >> size_diff_log2));
-            auto y = static_cast<GLsizei>(dutils::removeOddBits(index >> (size_diff_log2 + 1)));
+            auto [morton_x, morton_y] = dutils::mortonDecode2(index >> size_diff_log2);
+            auto x = static_cast<GLsizei>(morton_x);
+            auto y = static_cast<GLsizei>(morton_y);
             y <<= size_diff_log2;
             y |= index & ~(~std::size_t{0} << size_diff_log2);
             return flip ? svec2(y, x) : svec2(x, y);
@@ -216,15 +513,19 @@ private:
             position = flip ? position.yx() : position;
             auto result = position.y() & ~(~std::size_t{0} << size_diff_log2);
             position.y() >>= size_diff_log2;
-            result |= dutils::interleaveZeros(static_cast<std::size_t>(position.x())) << size_diff_log2;
-            result |= dutils::interleaveZeros(static_cast<std::size_t>(position.y())) << (size_diff_log2 + 1);
+            result |= dutils::mortonEncode2(static_cast<std::size_t>(position.x()),
+                                            static_cast<std::size_t>(position.y()))
+                      << size_diff_log2;
             return result;
         }
 
         svec2 tile_size_log2_;
         std::vector<TileData*> tiles_;
-        std::size_t first_free_tile_ = 0;
-        std::size_t max_tiles_;
+        /// @brief The indices of all gaps, which are filled starting with the lowest index to keep the grid compact.
+        std::set<std::size_t> free_indices_;
+        std::size_t max_tiles_ = 0;
+        std::optional<TexturePacker> packer_;
+        std::size_t packed_area_ = 0;
     };
 
 public:
@@ -265,6 +566,9 @@ public:
 
         auto layer() const { return dataOrThrow().placement.position.z(); }
 
+        /// @brief The border of the image, which is stored in texture atlas caches.
+        const auto& border() const { return dataOrThrow().bordered_image_data.border(); }
+
     private:
         TileHandle(const std::shared_ptr<const TileData>& data)
             : data_(data)
@@ -282,6 +586,7 @@ public:
 
     /// @brief Creates a new instance of TextureAtlasTiles with the given maximum dimensions.
     /// @exception std::invalid_argument if either maximum is less than zero.
+    /// @exception std::invalid_argument if the maximum mipmap levels are less than one.
     TextureAtlasTiles(const TextureAtlasLimits& limits)
         : limits_(limits)
     {
@@ -289,6 +594,8 @@ public:
             throw std::invalid_argument("Maximum texture size cannot be negative.");
         if (limits.max_layer_count < 0)
             throw std::invalid_argument("Maximum layer count cannot be negative.");
+        if (limits.max_mipmap_levels < 1)
+            throw std::invalid_argument("Maximum mipmap levels must be at least one.");
     }
 
     TextureAtlasTiles(const TextureAtlasTiles&) = delete;
@@ -311,7 +618,7 @@ public:
     {
         if (!tile_handle)
             throw std::invalid_argument("Tile handle is empty.");
-        return std::find(tiles_.begin(), tiles_.end(), tile_handle.data_) != tiles_.end();
+        return slotOf(tile_handle.data_).has_value();
     }
 
     /// @brief Removes the given tile, returning false if it does not belong to this atlas.
@@ -332,21 +639,135 @@ public:
             throw std::invalid_argument("Tile does not belong to this atlas.");
     }
 
-    /// @brief Calls "resize" with the current size and uses "modify" to upload the texture data.
-    void updateTexture(const TextureResizeFunction& resize, const TextureModifyFunction& modify)
+    /// @brief Adds a tile without image data at the given position of a layer, as restored from a cache.
+    /// @remark The layer has to exist already or be the next one, and packed tiles have to be restored from bottom to
+    /// top.
+    /// @remark Restored tiles still have to be marked as written, once the pixels of their layer are uploaded.
+    /// @exception std::invalid_argument if the data has no size or is too big.
+    /// @exception std::invalid_argument if the layer is neither an existing nor the next layer.
+    /// @exception std::invalid_argument if the tile cannot be placed at the given position.
+    [[nodiscard]] TileHandle restore(TBorderedImageData placeholder, GLsizei layer, svec2 position)
+    {
+        auto size = static_cast<svec2>(placeholder.size());
+        if (size.lessThanEqual(0).any() || (position + size).greaterThan(limits_.max_texture_size).any())
+            throw std::invalid_argument("Restored tile does not fit on the texture atlas.");
+        auto layer_index = static_cast<std::size_t>(layer);
+        if (layer < 0 || layer_index > layers_.size() || layer >= limits_.max_layer_count)
+            throw std::invalid_argument("Restored tile must be placed on an existing or the next layer.");
+
+        auto tile = std::make_shared<TileData>(std::move(placeholder), atlas_info_);
+        if (layer_index == layers_.size()) {
+            if (limits_.packing == TextureAtlasPacking::Grid)
+                layers_.emplace_back(tileSizeLog2(size), limits_.max_texture_size);
+            else
+                layers_.emplace_back(TexturePacker(limits_.packing, packingAlignment(), limits_.max_texture_size));
+        }
+        auto& target = layers_[layer_index];
+        auto matches = target.packed() || target.tileSizeLog2() == tileSizeLog2(size);
+        if (!matches || !target.tryPlaceTile(*tile, position, layer)) {
+            if (target.empty())
+                layers_.pop_back();
+            throw std::invalid_argument("Restored tile cannot be placed at " + position.format() + ".");
+        }
+        tile->slot = tiles_.size();
+        const auto& result = tiles_.emplace_back(std::move(tile));
+        updateFreeLayers(layer_index);
+        updateAtlasSize();
+        return TileHandle(result);
+    }
+
+    /// @brief Marks a restored tile as written, once the pixels of its layer were uploaded.
+    /// @exception std::invalid_argument if the handle is empty.
+    /// @exception std::invalid_argument if the tile does not belong to this atlas.
+    void markWritten(const TileHandle& tile_handle)
+    {
+        if (!tile_handle)
+            throw std::invalid_argument("Tile handle is empty.");
+        auto slot = slotOf(tile_handle.data_);
+        if (!slot)
+            throw std::invalid_argument("Tile does not belong to this atlas.");
+        tiles_[*slot]->placement.written = true;
+    }
+
+    /// @brief Only calls "resize" with the current size, without uploading any tiles.
+    /// @remark Allows for uploading the pixels of restored tiles, before the remaining tiles are uploaded.
+    template <typename TResize>
+    TextureAtlasUpdateStats resizeTexture(TResize&& resize)
+    {
+        return ensureTextureSize(resize);
+    }
+
+    /// @brief Calls "resize" with the current size and uses "modify" to upload all tiles that are not written yet.
+    /// @remark Takes any callable matching TextureResizeFunction and TextureModifyFunction, which are called directly.
+    /// @remark Only the upload_calls and uploaded_bytes of the returned stats are left at zero, as only "modify" knows
+    /// about them.
+    template <typename TResize, typename TModify>
+    TextureAtlasUpdateStats updateTexture(TResize&& resize, TModify&& modify)
     {
-        ensureTextureSize(resize);
+        auto stats = ensureTextureSize(resize);
         for (auto& layer : layers_)
-            layer.drawTiles(modify, false);
+            stats.uploaded_tiles += layer.drawTiles(modify, mipmapLevels());
+        return stats;
+    }
+
+    /// @brief Similar to updateTexture, but uploads adjacent tiles together with a single call to "modify_regions".
+    /// @remark Takes any callable matching TextureResizeFunction and TextureModifyRegionsFunction.
+    template <typename TResize, typename TModifyRegions>
+    TextureAtlasUpdateStats updateTextureRegions(TResize&& resize, TModifyRegions&& modify_regions)
+    {
+        auto stats = ensureTextureSize(resize);
+        stats.uploaded_tiles = drawRegions(modify_regions);
+        return stats;
     }
 
+    /// @brief Moves tiles into gaps and off of sparse layers, until tiles worth the given number of pixels were moved.
+    /// @remark Takes any callable matching TextureCopyFunction, which copies tiles that were already written.
+    /// @remark Tiles that lie outside of the texture are uploaded again by the next update instead.
+    /// @remark Moves at least a single tile or layer, so that even big tiles get moved eventually.
+    /// @remark Once finished, the next update shrinks the texture as far as possible, instead of waiting until no more
+    /// than a quarter of it is in use.
+    template <typename TCopy>
+    TextureAtlasDefragmentStats defragment(TCopy&& copy, std::size_t pixel_budget)
+    {
+        TextureAtlasDefragmentStats stats;
+        // Packed layers can run out of space for tiles of another layer, which is only tried once per call.
+        std::set<std::size_t> stuck_layers;
+        while (stats.moved_tiles + stats.moved_layers == 0 || stats.moved_pixels < pixel_budget) {
+            if (!evacuateLayer(copy, stats, stuck_layers) && !fillGap(copy, stats)) {
+                stats.finished = true;
+                break;
+            }
+        }
+        if (stats.moved_tiles + stats.moved_layers > 0) {
+            atlas_info_->generation++;
+            rebuildFreeLayers();
+        }
+        shrink_texture_ = stats.finished;
+        updateAtlasSize(shrink_texture_);
+        return stats;
+    }
+
+    /// @brief Changes whenever the texture coordinates of any tile change, which means they have to be queried again.
+    std::size_t generation() const { return atlas_info_->generation; }
+
     /// @brief Similar to updateTexture, but also frees image data and returns a frozen atlas.
-    [[nodiscard]] FrozenTextureAtlasTiles<TBorderedImageData> freeze(const TextureResizeFunction& resize,
-                                                                     const TextureModifyFunction& modify) &&
+    template <typename TResize, typename TModify>
+    [[nodiscard]] FrozenTextureAtlasTiles<TBorderedImageData> freeze(TResize&& resize, TModify&& modify) &&
     {
-        ensureTextureSize(resize);
+        updateTexture(resize, modify);
         for (auto& layer : layers_)
-            layer.drawTiles(modify, true);
+            layer.freeTiles();
+        return FrozenTextureAtlasTiles<TBorderedImageData>(std::move(*this));
+    }
+
+    /// @brief Similar to updateTextureRegions, but also frees image data and returns a frozen atlas.
+    template <typename TResize, typename TModifyRegions>
+    [[nodiscard]] FrozenTextureAtlasTiles<TBorderedImageData> freezeRegions(TResize&& resize,
+                                                                            TModifyRegions&& modify_regions) &&
+    {
+        updateTextureRegions(resize, modify_regions);
+        for (auto& layer : layers_)
+            layer.freeTiles();
         return FrozenTextureAtlasTiles<TBorderedImageData>(std::move(*this));
     }
 
@@ -358,16 +779,233 @@ public:
     /// @brief Whether there are no tiles on the atlas.
     bool empty() const { return tiles_.empty(); }
 
+    /// @brief The number of mipmap levels, for which even the smallest tiles keep at least a single pixel.
+    GLsizei mipmapLevels() const
+    {
+        auto result = limits_.max_mipmap_levels;
+        // Packed tiles are aligned, so that they keep at least a single pixel on every level.
+        if (limits_.packing != TextureAtlasPacking::Grid)
+            return std::min(result, dutils::ilog2(static_cast<std::make_unsigned_t<GLsizei>>(packingAlignment())) + 1);
+        for (const auto& layer : layers_)
+            result = std::min(result, layer.tileSizeLog2().minValue() + 1);
+        return result;
+    }
+
+    /// @brief The number of layers of the texture, which can be more than the number of layers actually in use.
+    GLsizei textureLayers() const { return texture_layers_; }
+
+    /// @brief The width and height of the atlas in pixels, which is used for the texture coordinates of all tiles.
+    GLsizei atlasSize() const { return atlas_info_->atlas_size; }
+
+    /// @brief The limits, that the atlas was created with.
+    const TextureAtlasLimits& limits() const { return limits_; }
+
 private:
-    /// @brief Calls "resize" to resize the texture and invalidates all tiles if a resize occurred.
-    void ensureTextureSize(const TextureResizeFunction& resize)
+    /// @brief Calls "resize" to resize the texture and invalidates all tiles if the texture lost its contents.
+    /// @remark Layers grow geometrically, so that the texture is only resized a logarithmic number of times.
+    template <typename TResize>
+    TextureAtlasUpdateStats ensureTextureSize(TResize& resize)
     {
-        auto required_size = maxLayerSize();
-        auto layers = static_cast<GLsizei>(layers_.size());
-        if (!resize(required_size, layers, 1))
-            return;
-        for (const auto& tile : tiles_)
-            tile->placement.written = false;
+        auto size = atlas_info_->atlas_size;
+        auto layers = textureCapacity(
+            texture_layers_, static_cast<GLsizei>(layers_.size()), limits_.max_layer_count, shrink_texture_);
+        shrink_texture_ = false;
+        auto mipmap_levels = mipmapLevels();
+
+        TextureAtlasUpdateStats stats;
+        stats.resized = size != texture_size_ || layers != texture_layers_ || mipmap_levels != texture_mipmap_levels_;
+        stats.contents_lost = resize(size, layers, mipmap_levels);
+        texture_size_ = size;
+        texture_layers_ = layers;
+        texture_mipmap_levels_ = mipmap_levels;
+        if (stats.contents_lost) {
+            for (const auto& tile : tiles_)
+                tile->placement.written = false;
+        }
+        return stats;
+    }
+
+    /// @brief Uploads all tiles that haven't been written yet as regions, returning the number of uploaded tiles.
+    template <typename TModifyRegions>
+    std::size_t drawRegions(TModifyRegions& modify_regions)
+    {
+        std::vector<TileRegion> regions;
+        std::vector<TileData*> pending;
+        for (const auto& layer : layers_)
+            layer.collectRegions(regions, pending, mipmapLevels());
+        if (!regions.empty())
+            modify_regions(std::span<const TileRegion>(regions));
+        for (auto tile : pending)
+            tile->placement.written = true;
+        return pending.size();
+    }
+
+    /// @brief The alignment of packed tiles, which allows for the maximum number of mipmap levels.
+    GLsizei packingAlignment() const
+    {
+        auto max_size_log2 = dutils::ilog2(static_cast<std::make_unsigned_t<GLsizei>>(limits_.max_texture_size));
+        return GLsizei{1} << std::min(limits_.max_mipmap_levels - 1, max_size_log2);
+    }
+
+    /// @brief Grows to the next power of two, but only shrinks once no more than a quarter is required.
+    /// @remark This keeps the texture from being resized back and forth, when tiles are added and removed repeatedly.
+    /// @remark With "shrink" set, it shrinks to the next power of two right away, which is used after defragmenting.
+    static GLsizei textureCapacity(GLsizei current, GLsizei required, GLsizei maximum, bool shrink = false)
+    {
+        if (required == 0)
+            return 0;
+        if (!shrink && required <= current && required > current / 4)
+            return current;
+        auto unsigned_required = static_cast<std::make_unsigned_t<GLsizei>>(required);
+        return std::min(GLsizei{1} << dutils::ilog2ceil(unsigned_required), maximum);
+    }
+
+    /// @brief Updates the size of the atlas, which tile handles use to calculate their texture coordinates.
+    void updateAtlasSize(bool shrink = false)
+    {
+        auto atlas_size = textureCapacity(atlas_info_->atlas_size, maxLayerSize(), limits_.max_texture_size, shrink);
+        if (atlas_size != atlas_info_->atlas_size && !tiles_.empty())
+            atlas_info_->generation++;
+        atlas_info_->atlas_size = atlas_size;
+    }
+
+    /// @brief Whether the given area was part of the texture, when it was last resized.
+    bool insideTexture(svec3 position, svec2 size) const
+    {
+        return position.z() < texture_layers_ && (position.xy() + size).lessThanEqual(texture_size_).all();
+    }
+
+    /// @brief Copies a tile, that was already written, to its new placement or has it uploaded again otherwise.
+    template <typename TCopy>
+    void relocateTile(TileData& tile, const TilePlacement& from, TCopy& copy, TextureAtlasDefragmentStats& stats)
+    {
+        auto& to = tile.placement;
+        to.written = from.written && insideTexture(from.position, from.size) && insideTexture(to.position, to.size);
+        if (to.written) {
+            for (GLint level = 0; level < texture_mipmap_levels_; level++) {
+                auto shift = [&](svec3 position) {
+                    return ivec3(position.x() >> level, position.y() >> level, position.z());
+                };
+                auto size = svec2(to.size.x() >> level, to.size.y() >> level);
+                copy(shift(from.position), shift(to.position), size, level);
+            }
+        }
+        stats.moved_tiles++;
+        stats.moved_pixels += static_cast<std::size_t>(to.size.product());
+    }
+
+    /// @brief Moves a single tile off of the layer with the fewest tiles, whose tiles fit onto the other layers.
+    /// @remark Once that layer is empty, the last layer takes its place, so that the other layers stay untouched.
+    template <typename TCopy>
+    bool evacuateLayer(TCopy& copy, TextureAtlasDefragmentStats& stats, std::set<std::size_t>& stuck_layers)
+    {
+        auto source_index = evacuationSource(stuck_layers);
+        if (!source_index)
+            return false;
+        auto& source = layers_[*source_index];
+        auto& tile = *source.lastTile();
+        auto from = tile.placement;
+
+        if (source.packed()) {
+            if (!packTileOntoOtherLayer(tile, *source_index)) {
+                stuck_layers.insert(*source_index);
+                return true;
+            }
+        }
+        else {
+            std::size_t target_index = 0;
+            while (target_index == *source_index || layers_[target_index].tileSizeLog2() != source.tileSizeLog2() ||
+                   layers_[target_index].full())
+                target_index++;
+            layers_[target_index].addTile(tile, static_cast<GLsizei>(target_index));
+        }
+        source.removeTile(from);
+        relocateTile(tile, from, copy, stats);
+
+        if (source.empty())
+            removeEmptyLayer(*source_index, copy, stats);
+        return true;
+    }
+
+    /// @brief Finds the layer with the fewest tiles, that could all be moved onto the other layers.
+    /// @remark Grid layers only check if enough tiles of the same size are free, while packed layers check the area.
+    std::optional<std::size_t> evacuationSource(const std::set<std::size_t>& stuck_layers) const
+    {
+        if (layers_.size() < 2)
+            return std::nullopt;
+
+        auto layer_area = static_cast<std::size_t>(dutils::sqr(limits_.max_texture_size));
+        auto freeSpace = [&](const Layer& layer) {
+            return layer.packed() ? layer_area - layer.packedArea() : layer.freeTileCount();
+        };
+        auto usedSpace = [&](const Layer& layer) { return layer.packed() ? layer.packedArea() : layer.tileCount(); };
+
+        // Packed layers share their space with tiles of any size, which is why they all end up in the same group.
+        std::map<svec2, std::size_t> free_space;
+        for (const auto& layer : layers_)
+            free_space[layer.tileSizeLog2()] += freeSpace(layer);
+
+        std::optional<std::size_t> result;
+        for (std::size_t layer_index = 0; layer_index < layers_.size(); layer_index++) {
+            const auto& layer = layers_[layer_index];
+            if (stuck_layers.contains(layer_index))
+                continue;
+            auto fits = usedSpace(layer) <= free_space[layer.tileSizeLog2()] - freeSpace(layer);
+            if (fits && (!result || layer.tileCount() <= layers_[*result].tileCount()))
+                result = layer_index;
+        }
+        return result;
+    }
+
+    /// @brief Packs the tile onto the first layer other than the given one, that has enough space left.
+    bool packTileOntoOtherLayer(TileData& tile, std::size_t excluded_layer)
+    {
+        for (std::size_t layer_index = 0; layer_index < layers_.size(); layer_index++)
+            if (layer_index != excluded_layer &&
+                layers_[layer_index].tryPackTile(tile, static_cast<GLsizei>(layer_index)))
+                return true;
+        return false;
+    }
+
+    /// @brief Removes an empty layer, moving the last layer into its place.
+    template <typename TCopy>
+    void removeEmptyLayer(std::size_t layer_index, TCopy& copy, TextureAtlasDefragmentStats& stats)
+    {
+        auto last_index = layers_.size() - 1;
+        if (layer_index != last_index) {
+            auto from = static_cast<GLsizei>(last_index);
+            auto to = static_cast<GLsizei>(layer_index);
+            auto copied = from < texture_layers_;
+            if (copied) {
+                for (GLint level = 0; level < texture_mipmap_levels_; level++) {
+                    auto level_size = std::max(texture_size_ >> level, 1);
+                    copy(ivec3(0, 0, from), ivec3(0, 0, to), svec2(level_size), level);
+                }
+            }
+            layers_[last_index].moveTo(to, copied);
+            layers_[layer_index] = std::move(layers_[last_index]);
+            stats.moved_layers++;
+            stats.moved_pixels += static_cast<std::size_t>(dutils::sqr(texture_size_));
+        }
+        layers_.pop_back();
+    }
+
+    /// @brief Moves the last tile of a grid layer into its first gap, so that the grid can shrink.
+    template <typename TCopy>
+    bool fillGap(TCopy& copy, TextureAtlasDefragmentStats& stats)
+    {
+        for (std::size_t layer_index = 0; layer_index < layers_.size(); layer_index++) {
+            auto& layer = layers_[layer_index];
+            if (layer.packed() || !layer.firstGap())
+                continue;
+            auto& tile = *layer.lastTile();
+            auto from = tile.placement;
+            layer.removeTile(from);
+            layer.addTile(tile, static_cast<GLsizei>(layer_index));
+            relocateTile(tile, from, copy, stats);
+            return true;
+        }
+        return false;
     }
 
     /// @brief Finds the maximum layer size.
@@ -381,25 +1019,63 @@ private:
 
     using LayerResult = std::pair<TextureAtlasTiles<TBorderedImageData>::Layer*, std::size_t>;
 
+    /// @brief The log2 of the grid cells, that tiles of the given size are placed in.
+    static svec2 tileSizeLog2(const svec2& size)
+    {
+        auto unsigned_width = static_cast<std::make_unsigned_t<GLsizei>>(size.x());
+        auto unsigned_height = static_cast<std::make_unsigned_t<GLsizei>>(size.y());
+        return {static_cast<GLsizei>(dutils::ilog2ceil(unsigned_width)),
+                static_cast<GLsizei>(dutils::ilog2ceil(unsigned_height))};
+    }
+
     /// @brief Returns a pointer to a (possibly newly created) layer for the given tile size and its index.
     /// @remark The pointer can be null, in which case a new layer would have exceeded the maximum layer count.
     LayerResult layerForTile(const svec2& size)
     {
-        auto unsigned_width = static_cast<std::make_unsigned_t<GLsizei>>(size.x());
-        auto unsigned_height = static_cast<std::make_unsigned_t<GLsizei>>(size.y());
-        auto tile_size_log2 = svec2(static_cast<GLsizei>(dutils::ilog2ceil(unsigned_width)),
-                                    static_cast<GLsizei>(dutils::ilog2ceil(unsigned_height)));
-        auto layer_iter = std::find_if(begin(layers_), end(layers_), [&](const Layer& layer) {
-            return !layer.full() && layer.tileSizeLog2() == tile_size_log2;
-        });
-        auto layer_index = std::distance(begin(layers_), layer_iter);
-        if (layer_iter != end(layers_))
-            return {&*layer_iter, layer_index};
-        if (layer_index >= limits_.max_layer_count)
+        auto tile_size_log2 = tileSizeLog2(size);
+        auto& free_layers = free_layers_[tile_size_log2];
+        if (!free_layers.empty()) {
+            auto layer_index = *free_layers.begin();
+            return {&layers_[layer_index], layer_index};
+        }
+        auto layer_index = layers_.size();
+        if (layer_index >= static_cast<std::size_t>(limits_.max_layer_count))
             return {nullptr, 0};
+        free_layers.insert(layer_index);
         return {&layers_.emplace_back(tile_size_log2, limits_.max_texture_size), layer_index};
     }
 
+    /// @brief Keeps the index of layers with free space up to date, after a tile was added to or removed from a layer.
+    void updateFreeLayers(std::size_t layer_index)
+    {
+        const auto& layer = layers_[layer_index];
+        if (layer.packed())
+            return;
+        auto& free_layers = free_layers_[layer.tileSizeLog2()];
+        if (layer.full())
+            free_layers.erase(layer_index);
+        else
+            free_layers.insert(layer_index);
+    }
+
+    /// @brief Rebuilds the index of layers with free space, which is necessary once a layer is removed entirely.
+    void rebuildFreeLayers()
+    {
+        free_layers_.clear();
+        for (std::size_t layer_index = 0; layer_index < layers_.size(); layer_index++)
+            if (!layers_[layer_index].packed() && !layers_[layer_index].full())
+                free_layers_[layers_[layer_index].tileSizeLog2()].insert(layer_index);
+    }
+
+    /// @brief Returns the slot of the given tile, if it belongs to this atlas.
+    std::optional<std::size_t> slotOf(const std::shared_ptr<const TileData>& tile_data) const
+    {
+        auto slot = tile_data->slot;
+        if (slot < tiles_.size() && tiles_[slot] == tile_data)
+            return slot;
+        return std::nullopt;
+    }
+
     /// @brief Creates a new tile and adds it to a (possibly newly created) layer.
     /// @exception std::invalid_argument if the image does not contain any data.
     /// @exception std::invalid_argument if the image is too big.
@@ -415,34 +1091,73 @@ private:
             throw std::invalid_argument("Image is too big for texture atlas. (" + size.format() + " > " +
                                         std::to_string(limits_.max_texture_size) + ")");
 
+        if (limits_.packing != TextureAtlasPacking::Grid) {
+            auto tile = std::make_shared<TileData>(std::move(bordered_image_data), atlas_info_);
+            if (!packTile(*tile))
+                throw std::length_error("Too many texture atlas layers. (max " +
+                                        std::to_string(limits_.max_layer_count) + ")");
+            tile->slot = tiles_.size();
+            const auto& result = tiles_.emplace_back(std::move(tile));
+            updateAtlasSize();
+            return result;
+        }
+
         auto [layer, index] = layerForTile(static_cast<svec2>(size));
         if (!layer)
             throw std::length_error("Too many texture atlas layers. (max " + std::to_string(limits_.max_layer_count) +
                                     ")");
 
         const auto& tile = tiles_.emplace_back(std::make_shared<TileData>(std::move(bordered_image_data), atlas_info_));
+        tile->slot = tiles_.size() - 1;
         layer->addTile(*tile, static_cast<GLsizei>(index));
-        atlas_info_->atlas_size = maxLayerSize();
+        updateFreeLayers(index);
+        updateAtlasSize();
         return tile;
     }
 
+    /// @brief Packs the tile onto the first layer with enough space left, adding a new layer if there is none.
+    /// @remark Returns false if a new layer would exceed the maximum layer count.
+    bool packTile(TileData& tile)
+    {
+        for (std::size_t layer_index = 0; layer_index < layers_.size(); layer_index++)
+            if (layers_[layer_index].tryPackTile(tile, static_cast<GLsizei>(layer_index)))
+                return true;
+        if (layers_.size() >= static_cast<std::size_t>(limits_.max_layer_count))
+            return false;
+        auto packer = TexturePacker(limits_.packing, packingAlignment(), limits_.max_texture_size);
+        auto& layer = layers_.emplace_back(std::move(packer));
+        return layer.tryPackTile(tile, static_cast<GLsizei>(layers_.size() - 1));
+    }
+
     /// @brief Removes a tile from the atlas and returns true if it existed.
+    /// @remark The last tile takes the place of the removed one, so that no other tiles have to be moved.
     bool removeTile(const std::shared_ptr<const TileData>& tile_data)
     {
-        auto iter = std::find(tiles_.begin(), tiles_.end(), tile_data);
-        if (iter == tiles_.end())
+        auto slot = slotOf(tile_data);
+        if (!slot)
             return false;
-        auto tile_ptr = *iter;
-        auto layer_index = tile_ptr->placement.position.z();
+        auto tile_ptr = std::move(tiles_[*slot]);
+        if (*slot != tiles_.size() - 1) {
+            tiles_[*slot] = std::move(tiles_.back());
+            tiles_[*slot]->slot = *slot;
+        }
+        tiles_.pop_back();
+
+        auto layer_index = static_cast<std::size_t>(tile_ptr->placement.position.z());
         auto& layer = layers_[layer_index];
-        layer.removeTile(*tile_ptr);
-        tiles_.erase(iter);
+        layer.removeTile(tile_ptr->placement);
         if (layer.empty()) {
             layers_.erase(begin(layers_) + layer_index);
             for (auto layer_iter = begin(layers_) + layer_index; layer_iter != end(layers_); layer_iter++)
                 layer_iter->shiftDown();
+            if (layer_index < layers_.size())
+                atlas_info_->generation++;
+            rebuildFreeLayers();
+        }
+        else {
+            updateFreeLayers(layer_index);
         }
-        atlas_info_->atlas_size = maxLayerSize();
+        updateAtlasSize();
         return true;
     }
 
@@ -450,6 +1165,14 @@ private:
     std::shared_ptr<AtlasInfo> atlas_info_ = std::make_shared<AtlasInfo>();
     std::vector<std::shared_ptr<TileData>> tiles_;
     std::vector<Layer> layers_;
+    /// @brief The indices of all layers with free space, grouped by the log2 of their tile size.
+    std::map<svec2, std::set<std::size_t>> free_layers_;
+    /// @brief The last size, layer count and mipmap levels of the texture, as passed to "resize".
+    GLsizei texture_size_ = 0;
+    GLsizei texture_layers_ = 0;
+    GLsizei texture_mipmap_levels_ = 0;
+    /// @brief Set by a finished defragmentation, so that the next update shrinks the texture as far as possible.
+    bool shrink_texture_ = false;
 };
 
 /// @brief A facade over a texture atlas, whose image data has been freed, preventing further modifications.
@@ -467,6 +1190,11 @@ public:
 
     [[nodiscard]] bool contains(const TileHandle& tile_handle) const { return tiles_.contains(tile_handle); }
 
+    GLsizei mipmapLevels() const { return tiles_.mipmapLevels(); }
+    GLsizei textureLayers() const { return tiles_.textureLayers(); }
+    GLsizei atlasSize() const { return tiles_.atlasSize(); }
+    const TextureAtlasLimits& limits() const { return tiles_.limits(); }
+
 private:
     FrozenTextureAtlasTiles(TextureAtlasTiles<TBorderedImageData>&& tiles)
         : tiles_(std::move(tiles))
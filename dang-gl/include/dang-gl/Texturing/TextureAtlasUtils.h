@@ -1,5 +1,8 @@
 #pragma once
 
+#include "dang-gl/Math/MathTypes.h"
+#include "dang-gl/Objects/PBO.h"
+#include "dang-gl/Objects/Texture.h"
 #include "dang-gl/Texturing/TextureAtlasTiles.h"
 #include "dang-gl/global.h"
 
@@ -8,6 +11,71 @@ namespace dang::gl::TextureAtlasUtils {
 GLsizei checkMaxTextureSize(std::optional<GLsizei> max_texture_size);
 GLsizei checkMaxLayerCount(std::optional<GLsizei> max_layer_count);
 
-TextureAtlasLimits checkLimits(std::optional<GLsizei> max_texture_size, std::optional<GLsizei> max_layer_count);
+TextureAtlasLimits checkLimits(std::optional<GLsizei> max_texture_size,
+                               std::optional<GLsizei> max_layer_count,
+                               GLsizei max_mipmap_levels = 1,
+                               TextureAtlasPacking packing = TextureAtlasPacking::Grid);
+
+/// @brief Copies all layers and mipmap levels that both textures have in common on the GPU.
+/// @remark Returns false if there was nothing to copy, since the old texture is empty.
+bool copyLayers(const Texture2DArray& from, Texture2DArray& to, GLsizei mipmap_levels);
+
+/// @brief The number of bytes of a single row of pixels in a staged region, which is padded to the row alignment.
+template <typename TImage>
+std::size_t stagedRowBytes(GLsizei width)
+{
+    auto byte_width = static_cast<std::size_t>(width) * sizeof(typename TImage::Pixel);
+    return (byte_width + TImage::row_alignment - 1) / TImage::row_alignment * TImage::row_alignment;
+}
+
+/// @brief Writes the images of all tiles in a region row by row, filling the rest of each cell with zeros.
+/// @remark "get_image" is called with the bordered image data of a tile and the mipmap level of the region.
+template <typename TImage, typename TRegion, typename TGetImage>
+void stageRegion(std::span<std::byte> memory, const TRegion& region, const TGetImage& get_image)
+{
+    auto row_bytes = stagedRowBytes<TImage>(region.size.x());
+    auto cell_bytes = static_cast<std::size_t>(region.cell_size.x()) * sizeof(typename TImage::Pixel);
+    auto cell_rows = static_cast<std::size_t>(region.cell_size.y());
+    assert(memory.size() >= row_bytes * static_cast<std::size_t>(region.size.y()));
+    for (const auto& tile : region.tiles) {
+        const TImage& image = get_image(*tile.bordered_image_data, static_cast<std::size_t>(region.mipmap_level));
+        auto cell = memory.data() + static_cast<std::size_t>(tile.offset.y()) * row_bytes +
+                    static_cast<std::size_t>(tile.offset.x()) * sizeof(typename TImage::Pixel);
+        for (std::size_t y = 0; y < cell_rows; y++) {
+            auto row = cell + y * row_bytes;
+            auto image_bytes = y < image.size().y() ? image.byteWidth() : 0;
+            assert(image_bytes <= cell_bytes);
+            auto image_row = static_cast<const std::byte*>(image.data()) + y * image.alignedByteWidth();
+            if (image_bytes > 0)
+                std::memcpy(row, image_row, image_bytes);
+            std::memset(row + image_bytes, 0, cell_bytes - image_bytes);
+        }
+    }
+}
+
+/// @brief Writes all regions one after another into the staging buffer, which is created on first use.
+/// @remark Returns the offset of each region in the buffer, followed by the total number of bytes.
+template <typename TImage, typename TRegion, typename TGetImage>
+std::vector<std::size_t> stageRegions(PBO& staging, std::span<const TRegion> regions, const TGetImage& get_image)
+{
+    std::vector<std::size_t> offsets;
+    offsets.reserve(regions.size() + 1);
+    std::size_t bytes = 0;
+    for (const auto& region : regions) {
+        offsets.push_back(bytes);
+        bytes += stagedRowBytes<TImage>(region.size.x()) * static_cast<std::size_t>(region.size.y());
+    }
+    offsets.push_back(bytes);
+
+    if (!staging)
+        staging = PBO();
+    // Unmapping can fail if the memory got lost in the meantime, in which case it has to be written again.
+    do {
+        auto memory = staging.map(bytes);
+        for (std::size_t index = 0; index < regions.size(); index++)
+            stageRegion<TImage>(memory.subspan(offsets[index]), regions[index], get_image);
+    } while (!staging.unmap());
+    return offsets;
+}
 
 } // namespace dang::gl::TextureAtlasUtils
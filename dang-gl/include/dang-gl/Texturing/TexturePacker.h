@@ -0,0 +1,156 @@
+#pragma once
+
+#include "dang-gl/Math/MathTypes.h"
+#include "dang-gl/global.h"
+#include "dang-utils/enum.h"
+
+namespace dang::gl {
+
+/// @brief How a texture atlas places its tiles on the layers of the texture.
+enum class TextureAtlasPacking {
+    /// @brief Rounds each tile up to a power of two and places it in a grid, with separate layers for each size.
+    Grid,
+    /// @brief Places each tile as low as possible on top of the tiles below, which is fast and works well for tiles of
+    /// similar height, like glyphs of a font.
+    Skyline,
+    /// @brief Keeps track of all maximal free rectangles, which packs the tightest, but gets slower with many tiles.
+    MaxRects,
+
+    COUNT
+};
+
+} // namespace dang::gl
+
+namespace dang::utils {
+
+template <>
+struct enum_count<dang::gl::TextureAtlasPacking> : default_enum_count<dang::gl::TextureAtlasPacking> {};
+
+} // namespace dang::utils
+
+namespace dang::gl {
+
+/// @brief Packs rectangles of any size into a square bin, using the skyline bottom-left heuristic.
+/// @remark Space below the skyline, that can no longer be reached, as well as removed rectangles, end up in a list of
+/// free rectangles, which is checked first.
+class SkylinePacker {
+public:
+    explicit SkylinePacker(GLsizei size = 0);
+
+    /// @brief The width and height of the bin.
+    GLsizei size() const { return size_; }
+
+    /// @brief Grows the bin to the given size, keeping all rectangles in place.
+    void grow(GLsizei size);
+
+    /// @brief Returns the position of a newly placed rectangle of the given size or nothing if it does not fit.
+    std::optional<svec2> insert(svec2 size);
+
+    /// @brief Whether the given rectangle can be reserved, as it lies on or above the skyline and outside of all free
+    /// rectangles.
+    /// @remark Space outside of the bin counts as free, since growing the bin adds it on top of the skyline.
+    bool canReserve(const sbounds2& bounds) const;
+
+    /// @brief Marks the given rectangle as used, which has to lie on or above the skyline.
+    /// @remark This holds true for rectangles of an existing packing, as long as they are reserved from bottom to top.
+    void reserve(const sbounds2& bounds);
+
+    /// @brief Frees the given rectangle again.
+    void remove(const sbounds2& bounds);
+
+private:
+    /// @brief A horizontal segment of the skyline, which covers everything below it.
+    struct Segment {
+        GLsizei x;
+        GLsizei y;
+        GLsizei width;
+    };
+
+    /// @brief Places the rectangle in the smallest free rectangle it fits into, splitting off the remaining space.
+    std::optional<svec2> insertFree(svec2 size);
+    /// @brief Places the rectangle on the skyline, so that its top ends up as low as possible.
+    std::optional<svec2> insertSkyline(svec2 size);
+    /// @brief Raises the skyline above the rectangle, starting at the given segment, which has to start at its left.
+    void placeSkyline(std::size_t segment_index, const sbounds2& bounds);
+
+    /// @brief Returns the height at which a rectangle of the given width can be placed on the given segment.
+    std::optional<GLsizei> fitSkyline(std::size_t segment_index, GLsizei width, GLsizei height) const;
+
+    GLsizei size_;
+    std::vector<Segment> segments_;
+    std::vector<sbounds2> free_;
+};
+
+/// @brief Packs rectangles of any size into a square bin, by keeping track of all maximal free rectangles.
+/// @remark Places each rectangle, where the shorter side leaves the least space, as described by Jukka Jylänki.
+class MaxRectsPacker {
+public:
+    explicit MaxRectsPacker(GLsizei size = 0);
+
+    /// @brief The width and height of the bin.
+    GLsizei size() const { return size_; }
+
+    /// @brief Grows the bin to the given size, keeping all rectangles in place.
+    void grow(GLsizei size);
+
+    /// @brief Returns the position of a newly placed rectangle of the given size or nothing if it does not fit.
+    std::optional<svec2> insert(svec2 size);
+
+    /// @brief Whether the given rectangle lies within a single free rectangle, so that it can be reserved.
+    /// @remark Space outside of the bin counts as free, since growing the bin adds it to the free rectangles.
+    /// @remark Free space, that is split across rectangles which were never merged, is rejected, even if it is free.
+    bool canReserve(const sbounds2& bounds) const;
+
+    /// @brief Marks the given rectangle as used, splitting all free rectangles that overlap it.
+    void reserve(const sbounds2& bounds);
+
+    /// @brief Frees the given rectangle again, merging it with free rectangles that share a whole edge.
+    void remove(const sbounds2& bounds);
+
+private:
+    /// @brief Adds a new free rectangle, unless it is contained in one that already exists.
+    void addFree(const sbounds2& bounds);
+
+    GLsizei size_;
+    std::vector<sbounds2> free_;
+};
+
+/// @brief Packs tiles of any size onto a single square layer, which doubles in size up to a maximum when necessary.
+/// @remark Both size and position of all tiles are multiples of the alignment, so that they stay aligned on mipmaps.
+class TexturePacker {
+public:
+    /// @exception std::invalid_argument if the packing is TextureAtlasPacking::Grid, which does not use a packer.
+    TexturePacker(TextureAtlasPacking packing, GLsizei alignment, GLsizei max_size);
+
+    /// @brief The alignment for the size and position of all tiles.
+    GLsizei alignment() const { return alignment_; }
+
+    /// @brief The current size of the layer, which is zero while the layer is still empty.
+    GLsizei size() const;
+
+    /// @brief Rounds the given size up to a multiple of the alignment.
+    svec2 alignedSize(svec2 size) const;
+
+    /// @brief Places a tile of the given size, growing the layer if necessary, and returns its position.
+    /// @remark Returns nothing if the tile does not fit, even if the layer grew to its maximum size.
+    std::optional<svec2> insert(svec2 size);
+
+    /// @brief Whether the space of a tile at the given position is aligned, fits on the layer and is still free.
+    bool canReserve(svec2 position, svec2 size) const;
+
+    /// @brief Marks the space of a tile at the given position as used, growing the layer if necessary.
+    /// @remark Used to restore tiles of an existing packing, which have to be reserved from bottom to top.
+    void reserve(svec2 position, svec2 size);
+
+    /// @brief Frees the space of a tile, which was placed at the given position with the given size.
+    void remove(svec2 position, svec2 size);
+
+private:
+    GLsizei alignment_;
+    GLsizei max_size_;
+    std::variant<SkylinePacker, MaxRectsPacker> packer_;
+    /// @brief The size in units of the last tile that did not fit, until space is freed again.
+    std::optional<svec2> no_fit_;
+};
+
+} // namespace dang::gl
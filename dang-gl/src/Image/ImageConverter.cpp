@@ -0,0 +1,245 @@
+#include "dang-gl/Image/ImageConverter.h"
+
+#include "dang-math/simd.h"
+
+namespace dang::gl::detail {
+
+namespace {
+
+float srgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSRGB(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+/// @brief Premultiplies a single component with alpha, rounding to the nearest integer without any division.
+GLubyte premultiplyComponent(unsigned component, unsigned alpha)
+{
+    auto value = component * alpha + 128;
+    return static_cast<GLubyte>((value + (value >> 8)) >> 8);
+}
+
+} // namespace
+
+float halfToFloat(GLhalf value)
+{
+    std::uint32_t sign = (value & 0x8000u) << 16;
+    std::uint32_t exponent = (value >> 10) & 0x1Fu;
+    std::uint32_t mantissa = value & 0x3FFu;
+    if (exponent == 0x1F)
+        return std::bit_cast<float>(sign | 0x7F800000u | mantissa << 13);
+    if (exponent != 0)
+        return std::bit_cast<float>(sign | (exponent + 112) << 23 | mantissa << 13);
+    // Subnormals (and zero) are a multiple of the smallest subnormal, which is exactly representable as float.
+    auto result = static_cast<float>(mantissa) * 0x1p-24f;
+    return sign ? -result : result;
+}
+
+GLhalf floatToHalf(float value)
+{
+    auto bits = std::bit_cast<std::uint32_t>(value);
+    std::uint32_t sign = (bits >> 16) & 0x8000u;
+    std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    // Infinity and NaN, which stays a (quiet) NaN.
+    if (magnitude >= 0x7F800000u)
+        return static_cast<GLhalf>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+    // Everything from halfway between the largest half and the next power of two rounds to infinity.
+    if (magnitude >= 0x477FF000u)
+        return static_cast<GLhalf>(sign | 0x7C00u);
+    // Subnormal halves, which are rounded to nearest even by the default floating point environment.
+    if (magnitude < 0x38800000u)
+        return static_cast<GLhalf>(sign | static_cast<std::uint32_t>(std::nearbyint(std::bit_cast<float>(magnitude) *
+                                                                                    0x1p24f)));
+
+    // Rebias the exponent and round the mantissa to nearest even, which might carry over into the exponent.
+    auto result = (magnitude - 0x38000000u) >> 13;
+    auto remainder = magnitude & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1)))
+        result++;
+    return static_cast<GLhalf>(sign | result);
+}
+
+const std::array<float, 256>& srgbToLinearTable()
+{
+    static const auto table = [] {
+        std::array<float, 256> result;
+        for (std::size_t i = 0; i < result.size(); i++)
+            result[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+        return result;
+    }();
+    return table;
+}
+
+void applyStages(std::span<const ImageConversionStage> stages, std::span<dmath::vec4> pixels)
+{
+    for (auto stage : stages) {
+        switch (stage) {
+        case ImageConversionStage::SRGBToLinear:
+            for (auto& pixel : pixels)
+                for (std::size_t i = 0; i < 3; i++)
+                    pixel[i] = srgbToLinear(pixel[i]);
+            break;
+        case ImageConversionStage::LinearToSRGB:
+            for (auto& pixel : pixels)
+                for (std::size_t i = 0; i < 3; i++)
+                    pixel[i] = linearToSRGB(pixel[i]);
+            break;
+        case ImageConversionStage::PremultiplyAlpha:
+            for (auto& pixel : pixels)
+                for (std::size_t i = 0; i < 3; i++)
+                    pixel[i] *= pixel.w();
+            break;
+        case ImageConversionStage::UnpremultiplyAlpha:
+            // Fully transparent pixels lost their color, so they simply stay black.
+            for (auto& pixel : pixels)
+                for (std::size_t i = 0; i < 3; i++)
+                    pixel[i] = pixel.w() > 0.0f ? pixel[i] / pixel.w() : 0.0f;
+            break;
+        case ImageConversionStage::COUNT:
+            break;
+        }
+    }
+}
+
+void swapRedBlue(const GLubyte* from, GLubyte* to, std::size_t count)
+{
+    std::size_t i = 0;
+#ifdef DANG_MATH_SSE2
+    auto green_alpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+    auto low_byte = _mm_set1_epi32(0xFF);
+    for (; i + 4 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i * 4));
+        auto red_blue = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), low_byte),
+                                     _mm_slli_epi32(_mm_and_si128(pixels, low_byte), 16));
+        auto result = _mm_or_si128(_mm_and_si128(pixels, green_alpha), red_blue);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i * 4), result);
+    }
+#endif
+    for (; i < count; i++) {
+        auto red = from[i * 4];
+        to[i * 4] = from[i * 4 + 2];
+        to[i * 4 + 1] = from[i * 4 + 1];
+        to[i * 4 + 2] = red;
+        to[i * 4 + 3] = from[i * 4 + 3];
+    }
+}
+
+void addAlpha(const GLubyte* from, GLubyte* to, std::size_t count, bool swap_red_blue)
+{
+    std::size_t i = 0;
+#ifdef DANG_MATH_SSSE3
+    // Loads 16 bytes to use 12 of them, so it stops early enough to not read past the end.
+    auto shuffle = swap_red_blue ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                                 : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    for (; i + 6 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i * 3));
+        auto result = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i * 4), result);
+    }
+#endif
+    for (; i < count; i++) {
+        to[i * 4] = from[i * 3 + (swap_red_blue ? 2 : 0)];
+        to[i * 4 + 1] = from[i * 3 + 1];
+        to[i * 4 + 2] = from[i * 3 + (swap_red_blue ? 0 : 2)];
+        to[i * 4 + 3] = 0xFF;
+    }
+}
+
+void removeAlpha(const GLubyte* from, GLubyte* to, std::size_t count, bool swap_red_blue)
+{
+    std::size_t i = 0;
+#ifdef DANG_MATH_SSSE3
+    // Stores 16 bytes of which only 12 are used, so it stops early enough to not write past the end.
+    auto shuffle = swap_red_blue ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                                 : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (; i + 6 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i * 3), _mm_shuffle_epi8(pixels, shuffle));
+    }
+#endif
+    for (; i < count; i++) {
+        to[i * 3] = from[i * 4 + (swap_red_blue ? 2 : 0)];
+        to[i * 3 + 1] = from[i * 4 + 1];
+        to[i * 3 + 2] = from[i * 4 + (swap_red_blue ? 0 : 2)];
+    }
+}
+
+void grayToRGBA(const GLubyte* from, GLubyte* to, std::size_t count)
+{
+    std::size_t i = 0;
+#ifdef DANG_MATH_SSSE3
+    auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    auto shuffle0 = _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1);
+    auto four = _mm_set1_epi32(0x00040404);
+    for (; i + 16 <= count; i += 16) {
+        auto grays = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        auto shuffle = shuffle0;
+        for (std::size_t part = 0; part < 4; part++) {
+            auto result = _mm_or_si128(_mm_shuffle_epi8(grays, shuffle), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(to + (i + part * 4) * 4), result);
+            shuffle = _mm_add_epi8(shuffle, four);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        to[i * 4] = to[i * 4 + 1] = to[i * 4 + 2] = from[i];
+        to[i * 4 + 3] = 0xFF;
+    }
+}
+
+void narrowToByte(const GLushort* from, GLubyte* to, std::size_t component_count)
+{
+    // Rounds value / 257 to the nearest integer, which is exact for all 16-bit values.
+    std::size_t i = 0;
+#ifdef DANG_MATH_SSE2
+    auto factor = _mm_set1_epi16(static_cast<short>(0xFF01));
+    auto half = _mm_set1_epi16(0x80);
+    auto narrow = [&](__m128i values) {
+        return _mm_srli_epi16(_mm_add_epi16(_mm_mulhi_epu16(values, factor), half), 8);
+    };
+    for (; i + 16 <= component_count; i += 16) {
+        auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i), _mm_packus_epi16(narrow(low), narrow(high)));
+    }
+#endif
+    for (; i < component_count; i++)
+        to[i] = static_cast<GLubyte>(((from[i] * 0xFF01u >> 16) + 0x80u) >> 8);
+}
+
+void premultiplyAlpha(const GLubyte* from, GLubyte* to, std::size_t count)
+{
+    std::size_t i = 0;
+#ifdef DANG_MATH_SSE2
+    auto zero = _mm_setzero_si128();
+    auto half = _mm_set1_epi16(128);
+    auto alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    auto premultiply = [&](__m128i pixels) {
+        auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        auto value = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), half);
+        return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+    };
+    for (; i + 4 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i * 4));
+        auto low = premultiply(_mm_unpacklo_epi8(pixels, zero));
+        auto high = premultiply(_mm_unpackhi_epi8(pixels, zero));
+        auto result = _mm_or_si128(_mm_andnot_si128(alpha_mask, _mm_packus_epi16(low, high)),
+                                   _mm_and_si128(pixels, alpha_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i * 4), result);
+    }
+#endif
+    for (; i < count; i++) {
+        auto alpha = from[i * 4 + 3];
+        for (std::size_t component = 0; component < 3; component++)
+            to[i * 4 + component] = premultiplyComponent(from[i * 4 + component], alpha);
+        to[i * 4 + 3] = alpha;
+    }
+}
+
+} // namespace dang::gl::detail
@@ -0,0 +1,207 @@
+#include "dang-gl/Image/ImageMipmaps.h"
+
+#include "dang-math/simd.h"
+#include "dang-math/utils.h"
+
+namespace dang::gl::detail {
+
+namespace {
+
+/// @brief The radius of the filter in pixels of the smaller level.
+double filterRadius(MipmapFilter filter)
+{
+    switch (filter) {
+    case MipmapFilter::Box:
+        return 0.5;
+    case MipmapFilter::Kaiser:
+    case MipmapFilter::Lanczos:
+        return 3.0;
+    case MipmapFilter::COUNT:
+        break;
+    }
+    throw std::invalid_argument("Invalid mipmap filter.");
+}
+
+double sinc(double x)
+{
+    if (x == 0.0)
+        return 1.0;
+    x *= dmath::pi_v<double>;
+    return std::sin(x) / x;
+}
+
+/// @brief The zeroth order modified Bessel function of the first kind, which the Kaiser window is based on.
+double besselI0(double x)
+{
+    double result = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        auto factor = x / (2.0 * k);
+        term *= factor * factor;
+        result += term;
+    }
+    return result;
+}
+
+/// @brief The unnormalized weight of a pixel at the given distance in pixels of the smaller level.
+double filterWeight(MipmapFilter filter, double distance)
+{
+    auto radius = filterRadius(filter);
+    if (std::abs(distance) >= radius)
+        return 0.0;
+
+    switch (filter) {
+    case MipmapFilter::Box:
+        return 1.0;
+    case MipmapFilter::Kaiser: {
+        constexpr double alpha = 4.0;
+        auto t = distance / radius;
+        return sinc(distance) * besselI0(alpha * std::sqrt(1.0 - t * t)) / besselI0(alpha);
+    }
+    case MipmapFilter::Lanczos:
+        return sinc(distance) * sinc(distance / radius);
+    case MipmapFilter::COUNT:
+        break;
+    }
+    throw std::invalid_argument("Invalid mipmap filter.");
+}
+
+/// @brief Which pixels of a single axis contribute to each pixel of the smaller level and by how much.
+struct AxisTaps {
+    std::size_t length;
+    std::size_t tap_count;
+    std::vector<std::size_t> indices;
+    std::vector<float> weights;
+};
+
+/// @brief Returns the index of the pixel at the given position, which is either wrapped around or clamped.
+std::size_t edgeIndex(double position, std::size_t length, MipmapEdge edge)
+{
+    // Periods of less than a pixel no longer resemble the original image and are simply clamped.
+    if (edge.wrap_size >= 1.0) {
+        auto offset = std::fmod(position - edge.wrap_offset, edge.wrap_size);
+        position = edge.wrap_offset + (offset < 0.0 ? offset + edge.wrap_size : offset);
+    }
+    return static_cast<std::size_t>(std::clamp(std::floor(position), 0.0, static_cast<double>(length - 1)));
+}
+
+AxisTaps axisTaps(std::size_t from_length, MipmapEdge edge, MipmapFilter filter)
+{
+    auto radius = static_cast<std::size_t>(std::ceil(filterRadius(filter) * 2.0));
+
+    AxisTaps result;
+    result.length = std::max(from_length / 2, std::size_t{1});
+    result.tap_count = radius * 2;
+    result.indices.resize(result.length * result.tap_count);
+    result.weights.resize(result.length * result.tap_count);
+
+    for (std::size_t i = 0; i < result.length; i++) {
+        // Pixel centers lie at half pixels, which places the center of the smaller pixel in between two pixels.
+        auto center = static_cast<double>(2 * i + 1);
+        auto first = center - static_cast<double>(radius) + 0.5;
+
+        double total = 0.0;
+        for (std::size_t tap = 0; tap < result.tap_count; tap++) {
+            auto position = first + static_cast<double>(tap);
+            auto weight = filterWeight(filter, (position - center) / 2.0);
+            result.indices[i * result.tap_count + tap] = edgeIndex(position, from_length, edge);
+            result.weights[i * result.tap_count + tap] = static_cast<float>(weight);
+            total += weight;
+        }
+
+        for (std::size_t tap = 0; tap < result.tap_count; tap++)
+            result.weights[i * result.tap_count + tap] /= static_cast<float>(total);
+    }
+
+    return result;
+}
+
+} // namespace
+
+std::vector<dmath::vec4> downsampleMipmap(std::span<const dmath::vec4> pixels,
+                                          std::span<const std::size_t> size,
+                                          std::span<const MipmapEdge> edges,
+                                          MipmapFilter filter)
+{
+    assert(size.size() == edges.size());
+
+    // Each axis is filtered separately, with all axes in front being contiguous and all axes after it being lines.
+    std::vector<dmath::vec4> result;
+    auto from = pixels;
+    std::size_t inner = 1;
+    auto count = pixels.size();
+
+    for (std::size_t axis = 0; axis < size.size(); axis++) {
+        auto from_length = size[axis];
+        auto outer = count / (inner * from_length);
+        auto taps = axisTaps(from_length, edges[axis], filter);
+
+        std::vector<dmath::vec4> filtered(outer * taps.length * inner);
+        auto min_lines = std::max(ImageConverter::min_pixels_per_thread / (inner * taps.tap_count), std::size_t{1});
+        dutils::parallelFor(outer * taps.length, min_lines, [&](std::size_t begin, std::size_t end) {
+            for (auto line = begin; line < end; line++) {
+                auto line_outer = line / taps.length;
+                auto line_index = line % taps.length;
+                auto to = filtered.data() + line * inner;
+                for (std::size_t tap = 0; tap < taps.tap_count; tap++) {
+                    auto tap_index = line_index * taps.tap_count + tap;
+                    auto weight = taps.weights[tap_index];
+                    if (weight == 0.0f)
+                        continue;
+                    auto tap_from = from.data() + (line_outer * from_length + taps.indices[tap_index]) * inner;
+                    for (std::size_t i = 0; i < inner; i++)
+                        to[i] += tap_from[i] * weight;
+                }
+            }
+        });
+
+        result = std::move(filtered);
+        from = result;
+        inner *= taps.length;
+        count = result.size();
+    }
+
+    return result;
+}
+
+void boxDownsampleRGBA8(
+    const GLubyte* from, std::size_t from_stride, GLubyte* to, std::size_t to_stride, dmath::svec2 to_size)
+{
+    auto width = to_size.x();
+    auto min_rows = std::max(ImageConverter::min_pixels_per_thread / width, std::size_t{1});
+    dutils::parallelFor(to_size.y(), min_rows, [&](std::size_t begin, std::size_t end) {
+        for (auto y = begin; y < end; y++) {
+            auto top = from + 2 * y * from_stride;
+            auto bottom = top + from_stride;
+            auto row = to + y * to_stride;
+
+            std::size_t x = 0;
+#ifdef DANG_MATH_SSE2
+            auto zero = _mm_setzero_si128();
+            auto two = _mm_set1_epi16(2);
+            // Sums up four pixels of both rows into two pixels, which end up as 16-bit components.
+            auto average = [&](std::size_t offset) {
+                auto top_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + offset));
+                auto bottom_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + offset));
+                auto low = _mm_add_epi16(_mm_unpacklo_epi8(top_pixels, zero), _mm_unpacklo_epi8(bottom_pixels, zero));
+                auto high = _mm_add_epi16(_mm_unpackhi_epi8(top_pixels, zero), _mm_unpackhi_epi8(bottom_pixels, zero));
+                low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+                high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+                return _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), two), 2);
+            };
+            for (; x + 4 <= width; x += 4) {
+                auto result = _mm_packus_epi16(average(x * 8), average(x * 8 + 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x * 4), result);
+            }
+#endif
+            for (; x < width; x++) {
+                for (std::size_t i = 0; i < 4; i++) {
+                    auto sum = top[x * 8 + i] + top[x * 8 + 4 + i] + bottom[x * 8 + i] + bottom[x * 8 + 4 + i];
+                    row[x * 4 + i] = static_cast<GLubyte>((sum + 2) >> 2);
+                }
+            }
+        }
+    });
+}
+
+} // namespace dang::gl::detail
@@ -0,0 +1,108 @@
+#include "dang-gl/Image/MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dang::gl {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const fs::path& path)
+{
+    auto file = CreateFileW(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size)) {
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        // Empty files cannot be mapped, but are still opened successfully.
+        if (size_ == 0) {
+            open_ = true;
+        }
+        else if (auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+            // The view keeps the mapping alive on its own.
+            data_ = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            open_ = data_ != nullptr;
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    if (!open_)
+        size_ = 0;
+}
+
+void MappedFile::unmap()
+{
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+}
+
+#else
+
+MappedFile::MappedFile(const fs::path& path)
+{
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file == -1)
+        return;
+
+    struct stat status;
+    if (fstat(file, &status) == 0) {
+        size_ = static_cast<std::size_t>(status.st_size);
+        // Empty files cannot be mapped, but are still opened successfully.
+        if (size_ == 0) {
+            open_ = true;
+        }
+        else if (auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0); data != MAP_FAILED) {
+            // Hint to the kernel, that the file is read from front to back, so that it can read ahead aggressively.
+            posix_madvise(data, size_, POSIX_MADV_SEQUENTIAL);
+            data_ = static_cast<const std::byte*>(data);
+            open_ = true;
+        }
+    }
+    // The mapping stays valid after closing the file.
+    ::close(file);
+    if (!open_)
+        size_ = 0;
+}
+
+void MappedFile::unmap()
+{
+    if (data_ != nullptr)
+        munmap(const_cast<std::byte*>(data_), size_);
+}
+
+#endif
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : open_(std::exchange(other.open_, false))
+    , data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    unmap();
+    open_ = std::exchange(other.open_, false);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+}
+
+} // namespace dang::gl
@@ -0,0 +1,17 @@
+#include "dang-gl/Image/PNGBatchLoader.h"
+
+namespace dang::gl {
+
+double PNGBatchStats::filesPerSecond() const
+{
+    auto seconds = std::chrono::duration<double>(elapsed_time).count();
+    return seconds > 0.0 ? file_count / seconds : 0.0;
+}
+
+double PNGBatchStats::megapixelsPerSecond() const
+{
+    auto seconds = std::chrono::duration<double>(elapsed_time).count();
+    return seconds > 0.0 ? pixel_count / seconds / 1'000'000.0 : 0.0;
+}
+
+} // namespace dang::gl
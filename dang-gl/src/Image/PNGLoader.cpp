@@ -20,6 +20,12 @@ PNGLoader::PNGLoader(std::istream& stream)
     init(stream);
 }
 
+PNGLoader::PNGLoader(std::span<const std::byte> data)
+    : PNGLoader()
+{
+    init(data);
+}
+
 PNGLoader::~PNGLoader() { cleanup(); }
 
 void PNGLoader::init(std::istream& stream)
@@ -30,12 +36,29 @@ void PNGLoader::init(std::istream& stream)
     initialized_ = true;
 
     png_set_read_fn(png_ptr_, &stream, readCallback);
+    initInfo();
+}
+
+void PNGLoader::init(std::span<const std::byte> data)
+{
+    if (initialized_)
+        throw PNGError("PNG already initialized.");
+
+    initialized_ = true;
+
+    data_ = data;
+    png_set_read_fn(png_ptr_, &data_, readDataCallback);
+    initInfo();
+}
+
+void PNGLoader::initInfo()
+{
     png_read_info(png_ptr_, info_ptr_);
 
     size_.x() = png_get_image_width(png_ptr_, info_ptr_);
     size_.y() = png_get_image_height(png_ptr_, info_ptr_);
 
-    png_set_interlace_handling(png_ptr_);
+    pass_count_ = png_set_interlace_handling(png_ptr_);
 }
 
 dmath::svec2 PNGLoader::size(dmath::svec2 padding) const { return size_ + padding; }
@@ -61,6 +84,52 @@ void PNGLoader::handleBitDepth()
     }
 }
 
+void PNGLoader::readAllRows(std::span<std::byte> data, std::size_t stride, bool flip)
+{
+    auto row_bytes = png_get_rowbytes(png_ptr_, info_ptr_);
+    if (stride < row_bytes)
+        throw PNGError("Stride too small for PNG rows.");
+    if (size_.y() > 0 && data.size() < (size_.y() - 1) * stride + row_bytes)
+        throw PNGError("Buffer too small for PNG.");
+
+    // Later passes of interlaced images combine with the rows of previous passes.
+    auto base_ptr = reinterpret_cast<png_bytep>(data.data());
+    for (int pass = 0; pass < pass_count_; pass++)
+        for (std::size_t y = 0; y < size_.y(); y++)
+            png_read_row(png_ptr_, base_ptr + (flip ? size_.y() - 1 - y : y) * stride, nullptr);
+    png_read_end(png_ptr_, nullptr);
+}
+
+void PNGLoader::readBands(const PNGRowCallback& callback, std::size_t band_rows, std::size_t stride, bool flip)
+{
+    assert(band_rows > 0);
+    auto height = size_.y();
+
+    if (pass_count_ > 1) {
+        // Rows of interlaced images are only complete after the last pass.
+        auto data = std::make_unique_for_overwrite<std::byte[]>(height * stride);
+        auto span = std::span(data.get(), height * stride);
+        readAllRows(span, stride, flip);
+        for (std::size_t first_row = 0; first_row < height; first_row += band_rows) {
+            auto row_count = std::min(band_rows, height - first_row);
+            callback({first_row, row_count, stride, span.subspan(first_row * stride, row_count * stride)});
+        }
+        return;
+    }
+
+    auto band = std::make_unique_for_overwrite<std::byte[]>(std::min(band_rows, height) * stride);
+    auto band_ptr = reinterpret_cast<png_bytep>(band.get());
+    for (std::size_t decoded = 0; decoded < height;) {
+        auto row_count = std::min(band_rows, height - decoded);
+        for (std::size_t row = 0; row < row_count; row++)
+            png_read_row(png_ptr_, band_ptr + (flip ? row_count - 1 - row : row) * stride, nullptr);
+        auto first_row = flip ? height - decoded - row_count : decoded;
+        callback({first_row, row_count, stride, std::span(band.get(), row_count * stride)});
+        decoded += row_count;
+    }
+    png_read_end(png_ptr_, nullptr);
+}
+
 void PNGLoader::errorCallback(png_structp, png_const_charp message) { throw PNGError(message); }
 
 void PNGLoader::warningCallback(png_structp png_ptr, png_const_charp message)
@@ -71,11 +140,20 @@ void PNGLoader::warningCallback(png_structp png_ptr, png_const_charp message)
 
 void PNGLoader::readCallback(png_structp png_ptr, png_bytep bytes, png_size_t size)
 {
-    auto& stream = *static_cast<std::ifstream*>(png_get_io_ptr(png_ptr));
+    auto& stream = *static_cast<std::istream*>(png_get_io_ptr(png_ptr));
     if (!stream.read(reinterpret_cast<char*>(bytes), size))
         throw PNGError("Unexpected eof while reading PNG.");
 }
 
+void PNGLoader::readDataCallback(png_structp png_ptr, png_bytep bytes, png_size_t size)
+{
+    auto& data = *static_cast<std::span<const std::byte>*>(png_get_io_ptr(png_ptr));
+    if (data.size() < size)
+        throw PNGError("Unexpected eof while reading PNG.");
+    std::memcpy(bytes, data.data(), size);
+    data = data.subspan(size);
+}
+
 void PNGLoader::cleanup() { png_destroy_read_struct(&png_ptr_, &info_ptr_, nullptr); }
 
 } // namespace dang::gl
@@ -0,0 +1,130 @@
+#include "dang-gl/Image/PNGWriter.h"
+
+#include "zlib.h"
+
+namespace dang::gl {
+
+namespace {
+
+int pngFilter(PNGWriteFilter filter)
+{
+    switch (filter) {
+    case PNGWriteFilter::Adaptive:
+        return PNG_ALL_FILTERS;
+    case PNGWriteFilter::None:
+        return PNG_FILTER_NONE;
+    case PNGWriteFilter::Sub:
+        return PNG_FILTER_SUB;
+    case PNGWriteFilter::Up:
+        return PNG_FILTER_UP;
+    case PNGWriteFilter::Average:
+        return PNG_FILTER_AVG;
+    case PNGWriteFilter::Paeth:
+        return PNG_FILTER_PAETH;
+    case PNGWriteFilter::COUNT:
+        break;
+    }
+    throw PNGError("Invalid PNG filter.");
+}
+
+int zlibStrategy(PNGWriteStrategy strategy)
+{
+    switch (strategy) {
+    case PNGWriteStrategy::Default:
+        return Z_DEFAULT_STRATEGY;
+    case PNGWriteStrategy::Filtered:
+        return Z_FILTERED;
+    case PNGWriteStrategy::HuffmanOnly:
+        return Z_HUFFMAN_ONLY;
+    case PNGWriteStrategy::RLE:
+        return Z_RLE;
+    case PNGWriteStrategy::Fixed:
+        return Z_FIXED;
+    case PNGWriteStrategy::COUNT:
+        break;
+    }
+    throw PNGError("Invalid PNG compression strategy.");
+}
+
+} // namespace
+
+void PNGWriter::write(std::ostream& stream,
+                      const std::byte* data,
+                      dmath::svec2 size,
+                      std::size_t stride,
+                      int color_type,
+                      bool bgr,
+                      const PNGWriteOptions& options)
+{
+    if (options.compression_level < 0 || options.compression_level > 9)
+        throw PNGError("PNG compression level must be in range [0, 9].");
+
+    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, this, errorCallback, warningCallback);
+    if (png_ptr == nullptr)
+        throw PNGError("Could not initialize libpng.");
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+
+    struct Cleanup {
+        png_structp& png_ptr;
+        png_infop& info_ptr;
+
+        ~Cleanup() { png_destroy_write_struct(&png_ptr, &info_ptr); }
+    } cleanup{png_ptr, info_ptr};
+
+    if (info_ptr == nullptr)
+        throw PNGError("Could not initialize libpng.");
+
+    png_set_write_fn(png_ptr, &stream, writeCallback, flushCallback);
+    png_set_compression_level(png_ptr, options.compression_level);
+    png_set_compression_strategy(png_ptr, zlibStrategy(options.strategy));
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, pngFilter(options.filter));
+
+    png_set_IHDR(png_ptr,
+                 info_ptr,
+                 static_cast<png_uint_32>(size.x()),
+                 static_cast<png_uint_32>(size.y()),
+                 8,
+                 color_type,
+                 PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_BASE,
+                 PNG_FILTER_TYPE_BASE);
+    png_write_info(png_ptr, info_ptr);
+    if (bgr)
+        png_set_bgr(png_ptr);
+
+    std::vector<png_bytep> rows(size.y());
+    // libpng never writes to the rows, it simply lacks a const overload.
+    auto fill = [row = reinterpret_cast<png_bytep>(const_cast<std::byte*>(data)), stride]() mutable {
+        return std::exchange(row, row + stride);
+    };
+    if (options.flip)
+        std::generate(rows.rbegin(), rows.rend(), fill);
+    else
+        std::generate(rows.begin(), rows.end(), fill);
+
+    png_write_image(png_ptr, rows.data());
+    png_write_end(png_ptr, nullptr);
+}
+
+void PNGWriter::errorCallback(png_structp, png_const_charp message) { throw PNGError(message); }
+
+void PNGWriter::warningCallback(png_structp png_ptr, png_const_charp message)
+{
+    auto& png_writer = *static_cast<PNGWriter*>(png_get_error_ptr(png_ptr));
+    png_writer.on_warning({png_writer, message});
+}
+
+void PNGWriter::writeCallback(png_structp png_ptr, png_bytep bytes, png_size_t size)
+{
+    auto& stream = *static_cast<std::ostream*>(png_get_io_ptr(png_ptr));
+    if (!stream.write(reinterpret_cast<const char*>(bytes), size))
+        throw PNGError("Could not write PNG.");
+}
+
+void PNGWriter::flushCallback(png_structp png_ptr)
+{
+    auto& stream = *static_cast<std::ostream*>(png_get_io_ptr(png_ptr));
+    stream.flush();
+}
+
+} // namespace dang::gl
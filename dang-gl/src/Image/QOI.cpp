@@ -0,0 +1,238 @@
+#include "dang-gl/Image/QOI.h"
+
+namespace dang::gl::detail {
+
+namespace {
+
+// See https://qoiformat.org/qoi-specification.pdf for details on the format.
+
+constexpr std::uint8_t op_index = 0x00;
+constexpr std::uint8_t op_diff = 0x40;
+constexpr std::uint8_t op_luma = 0x80;
+constexpr std::uint8_t op_run = 0xC0;
+constexpr std::uint8_t op_rgb = 0xFE;
+constexpr std::uint8_t op_rgba = 0xFF;
+constexpr std::uint8_t op_mask = 0xC0;
+
+constexpr std::array<std::uint8_t, 4> magic{'q', 'o', 'i', 'f'};
+constexpr std::size_t header_size = 14;
+constexpr std::array<std::uint8_t, 8> end_marker{0, 0, 0, 0, 0, 0, 0, 1};
+constexpr std::size_t max_run = 62;
+
+/// @brief The same limit as the reference implementation, to not allocate arbitrary amounts of memory on bad input.
+constexpr std::size_t max_pixels = 400'000'000;
+
+struct Color {
+    std::uint8_t r = 0;
+    std::uint8_t g = 0;
+    std::uint8_t b = 0;
+    std::uint8_t a = 255;
+
+    friend bool operator==(const Color&, const Color&) = default;
+};
+
+std::size_t hash(Color color) { return (color.r * 3 + color.g * 5 + color.b * 7 + color.a * 11) % 64; }
+
+Color readColor(const std::uint8_t* pixel, QOILayout layout)
+{
+    Color color{pixel[0], pixel[1], pixel[2], layout.channels == 4 ? pixel[3] : std::uint8_t{255}};
+    if (layout.bgr)
+        std::swap(color.r, color.b);
+    return color;
+}
+
+void writeColor(std::uint8_t* pixel, Color color, QOILayout layout)
+{
+    pixel[0] = layout.bgr ? color.b : color.r;
+    pixel[1] = color.g;
+    pixel[2] = layout.bgr ? color.r : color.b;
+    if (layout.channels == 4)
+        pixel[3] = color.a;
+}
+
+void writeBigEndian(std::uint8_t*& out, std::uint32_t value)
+{
+    *out++ = static_cast<std::uint8_t>(value >> 24);
+    *out++ = static_cast<std::uint8_t>(value >> 16);
+    *out++ = static_cast<std::uint8_t>(value >> 8);
+    *out++ = static_cast<std::uint8_t>(value);
+}
+
+std::uint32_t readBigEndian(const std::uint8_t* in)
+{
+    return std::uint32_t{in[0]} << 24 | std::uint32_t{in[1]} << 16 | std::uint32_t{in[2]} << 8 | std::uint32_t{in[3]};
+}
+
+/// @brief Returns the row with the given index, counting from the bottom when flipping.
+template <typename T>
+T* row(T* data, dmath::svec2 size, std::size_t stride, std::size_t y, bool flip)
+{
+    return data + (flip ? size.y() - 1 - y : y) * stride;
+}
+
+} // namespace
+
+std::vector<std::byte> encodeQOI(
+    const std::byte* data, dmath::svec2 size, std::size_t stride, QOILayout layout, bool flip)
+{
+    if (size.x() > std::numeric_limits<std::uint32_t>::max() || size.y() > std::numeric_limits<std::uint32_t>::max())
+        throw QOIError("Image too big for QOI.");
+
+    // Every pixel takes at most one byte more than its channels, which is only resized once at the very end.
+    std::vector<std::byte> result(header_size + size.product() * (layout.channels + 1) + end_marker.size());
+    auto out = reinterpret_cast<std::uint8_t*>(result.data());
+
+    out = std::copy(magic.begin(), magic.end(), out);
+    writeBigEndian(out, static_cast<std::uint32_t>(size.x()));
+    writeBigEndian(out, static_cast<std::uint32_t>(size.y()));
+    *out++ = static_cast<std::uint8_t>(layout.channels);
+    // sRGB with linear alpha, which is just informative.
+    *out++ = 0;
+
+    std::array<Color, 64> index{};
+    index.fill({0, 0, 0, 0});
+    Color previous;
+    std::size_t run = 0;
+
+    auto in_data = reinterpret_cast<const std::uint8_t*>(data);
+    for (std::size_t y = 0; y < size.y(); y++) {
+        auto pixel = row(in_data, size, stride, y, flip);
+        for (std::size_t x = 0; x < size.x(); x++, pixel += layout.channels) {
+            auto color = readColor(pixel, layout);
+            if (color == previous) {
+                if (++run == max_run) {
+                    *out++ = static_cast<std::uint8_t>(op_run | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                *out++ = static_cast<std::uint8_t>(op_run | (run - 1));
+                run = 0;
+            }
+
+            auto& indexed = index[hash(color)];
+            if (indexed == color) {
+                *out++ = static_cast<std::uint8_t>(op_index | hash(color));
+            }
+            else if (color.a != previous.a) {
+                indexed = color;
+                *out++ = op_rgba;
+                *out++ = color.r;
+                *out++ = color.g;
+                *out++ = color.b;
+                *out++ = color.a;
+            }
+            else {
+                indexed = color;
+                auto dr = static_cast<std::int8_t>(color.r - previous.r);
+                auto dg = static_cast<std::int8_t>(color.g - previous.g);
+                auto db = static_cast<std::int8_t>(color.b - previous.b);
+                auto dr_dg = dr - dg;
+                auto db_dg = db - dg;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    *out++ = static_cast<std::uint8_t>(op_diff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                }
+                else if (dr_dg >= -8 && dr_dg <= 7 && dg >= -32 && dg <= 31 && db_dg >= -8 && db_dg <= 7) {
+                    *out++ = static_cast<std::uint8_t>(op_luma | (dg + 32));
+                    *out++ = static_cast<std::uint8_t>((dr_dg + 8) << 4 | (db_dg + 8));
+                }
+                else {
+                    *out++ = op_rgb;
+                    *out++ = color.r;
+                    *out++ = color.g;
+                    *out++ = color.b;
+                }
+            }
+            previous = color;
+        }
+    }
+    if (run > 0)
+        *out++ = static_cast<std::uint8_t>(op_run | (run - 1));
+
+    out = std::copy(end_marker.begin(), end_marker.end(), out);
+    result.resize(reinterpret_cast<std::byte*>(out) - result.data());
+    return result;
+}
+
+dmath::svec2 qoiSize(std::span<const std::byte> qoi)
+{
+    if (qoi.size() < header_size + end_marker.size())
+        throw QOIError("QOI data too short.");
+
+    auto in = reinterpret_cast<const std::uint8_t*>(qoi.data());
+    if (!std::equal(magic.begin(), magic.end(), in))
+        throw QOIError("Invalid QOI magic.");
+    if (in[12] != 3 && in[12] != 4)
+        throw QOIError("Invalid QOI channel count.");
+    if (in[13] > 1)
+        throw QOIError("Invalid QOI colorspace.");
+
+    dmath::svec2 size(readBigEndian(in + 4), readBigEndian(in + 8));
+    if (size.y() != 0 && size.x() > max_pixels / size.y())
+        throw QOIError("QOI image too big.");
+    return size;
+}
+
+void decodeQOI(std::span<const std::byte> qoi, std::byte* data, std::size_t stride, QOILayout layout, bool flip)
+{
+    auto size = qoiSize(qoi);
+    auto in = reinterpret_cast<const std::uint8_t*>(qoi.data());
+    // Ops take at most 5 bytes, which always fit in front of the end marker.
+    auto chunks_end = in + qoi.size() - end_marker.size();
+    in += header_size;
+
+    std::array<Color, 64> index{};
+    index.fill({0, 0, 0, 0});
+    Color color;
+    std::size_t run = 0;
+
+    auto out_data = reinterpret_cast<std::uint8_t*>(data);
+    for (std::size_t y = 0; y < size.y(); y++) {
+        auto pixel = row(out_data, size, stride, y, flip);
+        for (std::size_t x = 0; x < size.x(); x++, pixel += layout.channels) {
+            if (run > 0) {
+                run--;
+            }
+            else {
+                if (in >= chunks_end)
+                    throw QOIError("Unexpected end of QOI data.");
+
+                auto op = *in++;
+                if (op == op_rgb) {
+                    color.r = in[0];
+                    color.g = in[1];
+                    color.b = in[2];
+                    in += 3;
+                }
+                else if (op == op_rgba) {
+                    color = {in[0], in[1], in[2], in[3]};
+                    in += 4;
+                }
+                else if ((op & op_mask) == op_index) {
+                    color = index[op];
+                }
+                else if ((op & op_mask) == op_diff) {
+                    color.r = static_cast<std::uint8_t>(color.r + ((op >> 4) & 0x03) - 2);
+                    color.g = static_cast<std::uint8_t>(color.g + ((op >> 2) & 0x03) - 2);
+                    color.b = static_cast<std::uint8_t>(color.b + (op & 0x03) - 2);
+                }
+                else if ((op & op_mask) == op_luma) {
+                    auto next = *in++;
+                    auto dg = (op & 0x3F) - 32;
+                    color.r = static_cast<std::uint8_t>(color.r + dg - 8 + ((next >> 4) & 0x0F));
+                    color.g = static_cast<std::uint8_t>(color.g + dg);
+                    color.b = static_cast<std::uint8_t>(color.b + dg - 8 + (next & 0x0F));
+                }
+                else {
+                    run = op & 0x3F;
+                }
+                index[hash(color)] = color;
+            }
+            writeColor(pixel, color, layout);
+        }
+    }
+}
+
+} // namespace dang::gl::detail
@@ -78,6 +78,19 @@ void FBO::attach(const RBO& rbo, AttachmentPoint attachment_point)
     updateAttachmentPoint(attachment_point, true);
 }
 
+void FBO::attachTextureLayer(ObjectHandle<ObjectType::Texture> texture,
+                             svec2 size,
+                             AttachmentPoint attachment_point,
+                             GLint layer,
+                             GLint mipmap_level)
+{
+    auto target = FramebufferTarget::DrawFramebuffer;
+    bind(target);
+    glFramebufferTextureLayer(toGLConstant(target), attachment_point, texture.unwrap(), mipmap_level, layer);
+    updateSize(size);
+    updateAttachmentPoint(attachment_point, true);
+}
+
 void FBO::detach(AttachmentPoint attachment_point)
 {
     auto target = FramebufferTarget::DrawFramebuffer;
@@ -0,0 +1 @@
+#include "dang-gl/Objects/PBO.h"
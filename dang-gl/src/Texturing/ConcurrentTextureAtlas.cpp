@@ -0,0 +1 @@
+#include "dang-gl/Texturing/ConcurrentTextureAtlas.h"
@@ -0,0 +1,279 @@
+#include "dang-gl/Texturing/TextureAtlasCache.h"
+
+namespace dang::gl {
+
+namespace {
+
+constexpr std::array<char, 8> magic{'D', 'G', 'L', 'A', 'T', 'L', 'A', 'S'};
+constexpr std::uint32_t version = 1;
+/// @brief Values are stored in native byte order, which is detected using this marker.
+constexpr std::uint32_t byte_order = 0x01020304;
+/// @brief Pixels start at a multiple of this, so that they can be uploaded straight from the mapped file.
+constexpr std::size_t block_alignment = 8;
+
+/// @brief Reads values from memory, which fails instead of reading past the end.
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> data)
+        : data_(data)
+    {}
+
+    explicit operator bool() const { return !failed_; }
+
+    template <typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T result{};
+        auto bytes = readBytes(sizeof(T));
+        if (!failed_)
+            std::memcpy(&result, bytes.data(), sizeof(T));
+        return result;
+    }
+
+    std::span<const std::byte> readBytes(std::uint64_t count)
+    {
+        if (failed_ || count > data_.size() - offset_) {
+            failed_ = true;
+            return {};
+        }
+        auto result = data_.subspan(offset_, static_cast<std::size_t>(count));
+        offset_ += result.size();
+        return result;
+    }
+
+    void align()
+    {
+        auto padding = (block_alignment - offset_ % block_alignment) % block_alignment;
+        readBytes(padding);
+    }
+
+    std::size_t remaining() const { return data_.size() - offset_; }
+
+private:
+    std::span<const std::byte> data_;
+    std::size_t offset_ = 0;
+    bool failed_ = false;
+};
+
+template <typename T>
+void writeValue(std::ostream& stream, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeBytes(std::ostream& stream, std::span<const std::byte> bytes)
+{
+    stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void writePadding(std::ostream& stream)
+{
+    auto offset = static_cast<std::size_t>(stream.tellp());
+    auto padding = (block_alignment - offset % block_alignment) % block_alignment;
+    for (std::size_t i = 0; i < padding; i++)
+        stream.put(0);
+}
+
+/// @brief Reads the layout, returning nothing if anything is invalid.
+std::optional<TextureAtlasCacheLayout> readLayout(Reader& reader)
+{
+    if (reader.read<std::array<char, 8>>() != magic || reader.read<std::uint32_t>() != version ||
+        reader.read<std::uint32_t>() != byte_order)
+        return std::nullopt;
+
+    TextureAtlasCacheLayout layout;
+    auto& format = layout.format;
+    format.pixel_format = reader.read<PixelFormat>();
+    format.pixel_type = reader.read<PixelType>();
+    format.row_alignment = reader.read<std::uint32_t>();
+    format.texture_count = reader.read<std::uint32_t>();
+    format.max_texture_size = reader.read<GLsizei>();
+    format.max_mipmap_levels = reader.read<GLsizei>();
+    format.packing = reader.read<TextureAtlasPacking>();
+    layout.atlas_size = reader.read<GLsizei>();
+    layout.layers = reader.read<GLsizei>();
+    layout.mipmap_levels = reader.read<GLsizei>();
+    layout.compression = reader.read<TextureAtlasCacheCompression>();
+    if (!reader || layout.atlas_size < 0 || layout.layers < 0 || layout.mipmap_levels < 0 ||
+        layout.compression < TextureAtlasCacheCompression::None ||
+        layout.compression >= TextureAtlasCacheCompression::COUNT)
+        return std::nullopt;
+
+    auto tile_count = reader.read<std::uint64_t>();
+    // Each tile takes up a lot more than a single byte, which keeps invalid counts from allocating too much memory.
+    if (!reader || tile_count > reader.remaining())
+        return std::nullopt;
+    layout.tiles.resize(static_cast<std::size_t>(tile_count));
+    for (auto& tile : layout.tiles) {
+        auto name = reader.readBytes(reader.read<std::uint32_t>());
+        tile.source.name.assign(reinterpret_cast<const char*>(name.data()), name.size());
+        tile.source.hash = reader.read<std::uint64_t>();
+        tile.layer = reader.read<GLsizei>();
+        tile.position = reader.read<svec2>();
+        tile.size = reader.read<svec2>();
+        tile.border_style = reader.read<std::uint32_t>();
+        auto border_color = reader.readBytes(reader.read<std::uint32_t>());
+        tile.border_color.assign(border_color.begin(), border_color.end());
+        auto inside = tile.position.greaterThanEqual(0).all() && tile.size.greaterThan(0).all() &&
+                      (tile.position + tile.size).lessThanEqual(layout.atlas_size).all();
+        if (!reader || tile.layer < 0 || tile.layer >= layout.layers || !inside)
+            return std::nullopt;
+    }
+    return layout;
+}
+
+} // namespace
+
+std::uint64_t hashTextureAtlasSource(std::span<const std::byte> data)
+{
+    std::uint64_t hash = 0xCBF29CE484222325;
+    for (auto byte : data) {
+        hash ^= static_cast<std::uint64_t>(byte);
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+std::size_t TextureAtlasCacheLayout::blockCount() const
+{
+    return format.texture_count * static_cast<std::size_t>(mipmap_levels) * static_cast<std::size_t>(layers);
+}
+
+TextureAtlasCache::TextureAtlasCache(const fs::path& path)
+    : file_(path)
+{
+    if (!file_)
+        return;
+    Reader reader(file_.data());
+    auto layout = readLayout(reader);
+    if (!layout)
+        return;
+
+    // Each block takes up at least its size, which keeps invalid counts from allocating too much memory.
+    auto block_count = layout->blockCount();
+    if (block_count > reader.remaining() / sizeof(std::uint64_t))
+        return;
+    blocks_.reserve(block_count);
+    for (std::size_t index = 0; index < block_count; index++) {
+        reader.align();
+        auto size = reader.read<std::uint64_t>();
+        blocks_.push_back(reader.readBytes(size));
+    }
+    if (!reader) {
+        blocks_.clear();
+        return;
+    }
+
+    layout_ = std::move(*layout);
+    for (std::size_t index = 0; index < layout_.tiles.size(); index++)
+        tile_indices_.emplace(layout_.tiles[index].source.name, index);
+    valid_ = true;
+}
+
+std::span<const std::byte> TextureAtlasCache::pixels(std::size_t texture_index, GLint mipmap_level, GLsizei layer) const
+{
+    assert(texture_index < layout_.format.texture_count);
+    assert(mipmap_level >= 0 && mipmap_level < layout_.mipmap_levels);
+    assert(layer >= 0 && layer < layout_.layers);
+    auto level_index = texture_index * static_cast<std::size_t>(layout_.mipmap_levels) +
+                       static_cast<std::size_t>(mipmap_level);
+    return blocks_[level_index * static_cast<std::size_t>(layout_.layers) + static_cast<std::size_t>(layer)];
+}
+
+const TextureAtlasCacheTile* TextureAtlasCache::find(const TextureAtlasCacheSource& source) const
+{
+    auto iter = tile_indices_.find(source.name);
+    if (iter == tile_indices_.end())
+        return nullptr;
+    const auto& tile = layout_.tiles[iter->second];
+    return tile.source.hash == source.hash ? &tile : nullptr;
+}
+
+bool TextureAtlasCache::upToDate(std::span<const TextureAtlasCacheSource> sources) const
+{
+    if (!valid_ || sources.size() != layout_.tiles.size())
+        return false;
+    return std::all_of(sources.begin(), sources.end(), [&](const TextureAtlasCacheSource& source) {
+        return find(source) != nullptr;
+    });
+}
+
+TextureAtlasCacheWriter::TextureAtlasCacheWriter(const fs::path& path, const TextureAtlasCacheLayout& layout)
+    : path_(path)
+    , temporary_path_(fs::path(path).concat(".tmp"))
+    , stream_(temporary_path_, std::ios::binary)
+    , remaining_blocks_(layout.blockCount())
+{
+    if (!stream_)
+        throw TextureAtlasCacheError("Cannot open texture atlas cache for writing: " + temporary_path_.string());
+
+    writeValue(stream_, magic);
+    writeValue(stream_, version);
+    writeValue(stream_, byte_order);
+    const auto& format = layout.format;
+    writeValue(stream_, format.pixel_format);
+    writeValue(stream_, format.pixel_type);
+    writeValue(stream_, format.row_alignment);
+    writeValue(stream_, format.texture_count);
+    writeValue(stream_, format.max_texture_size);
+    writeValue(stream_, format.max_mipmap_levels);
+    writeValue(stream_, format.packing);
+    writeValue(stream_, layout.atlas_size);
+    writeValue(stream_, layout.layers);
+    writeValue(stream_, layout.mipmap_levels);
+    writeValue(stream_, layout.compression);
+
+    writeValue(stream_, static_cast<std::uint64_t>(layout.tiles.size()));
+    for (const auto& tile : layout.tiles) {
+        writeValue(stream_, static_cast<std::uint32_t>(tile.source.name.size()));
+        writeBytes(stream_, std::as_bytes(std::span(tile.source.name)));
+        writeValue(stream_, tile.source.hash);
+        writeValue(stream_, tile.layer);
+        writeValue(stream_, tile.position);
+        writeValue(stream_, tile.size);
+        writeValue(stream_, tile.border_style);
+        writeValue(stream_, static_cast<std::uint32_t>(tile.border_color.size()));
+        writeBytes(stream_, tile.border_color);
+    }
+    if (!stream_)
+        throw TextureAtlasCacheError("Cannot write texture atlas cache: " + temporary_path_.string());
+}
+
+TextureAtlasCacheWriter::~TextureAtlasCacheWriter()
+{
+    if (finished_)
+        return;
+    stream_.close();
+    std::error_code error;
+    fs::remove(temporary_path_, error);
+}
+
+void TextureAtlasCacheWriter::write(std::span<const std::byte> pixels)
+{
+    if (remaining_blocks_ == 0)
+        throw std::logic_error("All blocks of the texture atlas cache were written already.");
+    writePadding(stream_);
+    writeValue(stream_, static_cast<std::uint64_t>(pixels.size()));
+    writeBytes(stream_, pixels);
+    if (!stream_)
+        throw TextureAtlasCacheError("Cannot write texture atlas cache: " + temporary_path_.string());
+    remaining_blocks_--;
+}
+
+void TextureAtlasCacheWriter::finish()
+{
+    if (remaining_blocks_ != 0)
+        throw std::logic_error("Not all blocks of the texture atlas cache were written.");
+    stream_.close();
+    if (!stream_)
+        throw TextureAtlasCacheError("Cannot write texture atlas cache: " + temporary_path_.string());
+    std::error_code error;
+    fs::rename(temporary_path_, path_, error);
+    if (error)
+        throw TextureAtlasCacheError("Cannot move texture atlas cache into place: " + path_.string());
+    finished_ = true;
+}
+
+} // namespace dang::gl
@@ -30,9 +30,24 @@ GLsizei checkMaxLayerCount(std::optional<GLsizei> max_layer_count)
     return *max_layer_count;
 }
 
-TextureAtlasLimits checkLimits(std::optional<GLsizei> max_texture_size, std::optional<GLsizei> max_layer_count)
+TextureAtlasLimits checkLimits(std::optional<GLsizei> max_texture_size,
+                               std::optional<GLsizei> max_layer_count,
+                               GLsizei max_mipmap_levels,
+                               TextureAtlasPacking packing)
 {
-    return {checkMaxTextureSize(max_texture_size), checkMaxLayerCount(max_layer_count)};
+    return {checkMaxTextureSize(max_texture_size), checkMaxLayerCount(max_layer_count), max_mipmap_levels, packing};
+}
+
+bool copyLayers(const Texture2DArray& from, Texture2DArray& to, GLsizei mipmap_levels)
+{
+    auto size = from.size().min(to.size());
+    if (!from || size.product() == 0)
+        return false;
+    for (GLint level = 0; level < mipmap_levels; level++) {
+        auto level_size = svec3(std::max(size.x() >> level, 1), std::max(size.y() >> level, 1), size.z());
+        to.copyFrom(from, level_size, {}, {}, level, level);
+    }
+    return true;
 }
 
 } // namespace dang::gl::TextureAtlasUtils
@@ -0,0 +1,399 @@
+#include "dang-gl/Texturing/TexturePacker.h"
+
+namespace dang::gl {
+
+namespace {
+
+/// @brief Splits the space, that is left over after placing a rectangle in the corner of a free one, along the shorter
+/// axis, which keeps the bigger of both parts as large as possible.
+void splitFree(std::vector<sbounds2>& free, const sbounds2& bounds, svec2 size)
+{
+    auto corner = bounds.low + size;
+    auto leftover = bounds.size() - size;
+    sbounds2 right;
+    sbounds2 top;
+    if (leftover.x() < leftover.y()) {
+        right = {{corner.x(), bounds.low.y()}, {bounds.high.x(), corner.y()}};
+        top = {{bounds.low.x(), corner.y()}, bounds.high};
+    }
+    else {
+        right = {{corner.x(), bounds.low.y()}, bounds.high};
+        top = {{bounds.low.x(), corner.y()}, {corner.x(), bounds.high.y()}};
+    }
+    if (right.size().product() > 0)
+        free.push_back(right);
+    if (top.size().product() > 0)
+        free.push_back(top);
+}
+
+/// @brief Whether both rectangles share a whole edge, so that they can be merged into a single one.
+bool sharesEdge(const sbounds2& lhs, const sbounds2& rhs)
+{
+    auto same_columns = lhs.low.x() == rhs.low.x() && lhs.high.x() == rhs.high.x();
+    auto same_rows = lhs.low.y() == rhs.low.y() && lhs.high.y() == rhs.high.y();
+    return (same_columns && (lhs.high.y() == rhs.low.y() || rhs.high.y() == lhs.low.y())) ||
+           (same_rows && (lhs.high.x() == rhs.low.x() || rhs.high.x() == lhs.low.x()));
+}
+
+} // namespace
+
+SkylinePacker::SkylinePacker(GLsizei size)
+    : size_(0)
+{
+    grow(size);
+}
+
+void SkylinePacker::grow(GLsizei size)
+{
+    assert(size >= size_);
+    if (size == size_)
+        return;
+    // Space to the right is still empty, while space above is simply covered by the taller bin.
+    if (!segments_.empty() && segments_.back().y == 0)
+        segments_.back().width += size - size_;
+    else
+        segments_.push_back({size_, 0, size - size_});
+    size_ = size;
+}
+
+std::optional<svec2> SkylinePacker::insert(svec2 size)
+{
+    assert(size.greaterThan(0).all());
+    if (auto position = insertFree(size))
+        return position;
+    return insertSkyline(size);
+}
+
+void SkylinePacker::remove(const sbounds2& bounds) { free_.push_back(bounds); }
+
+std::optional<svec2> SkylinePacker::insertFree(svec2 size)
+{
+    auto best = free_.end();
+    GLsizei best_area = 0;
+    for (auto iter = free_.begin(); iter != free_.end(); ++iter) {
+        if (iter->size().lessThan(size).any())
+            continue;
+        auto area = iter->size().product();
+        if (best == free_.end() || area < best_area) {
+            best = iter;
+            best_area = area;
+        }
+    }
+    if (best == free_.end())
+        return std::nullopt;
+
+    auto bounds = *best;
+    *best = free_.back();
+    free_.pop_back();
+    splitFree(free_, bounds, size);
+    return bounds.low;
+}
+
+std::optional<svec2> SkylinePacker::insertSkyline(svec2 size)
+{
+    std::optional<std::size_t> best_index;
+    GLsizei best_y = 0;
+    for (std::size_t index = 0; index < segments_.size(); index++) {
+        auto y = fitSkyline(index, size.x(), size.y());
+        if (y && (!best_index || *y < best_y)) {
+            best_index = index;
+            best_y = *y;
+        }
+    }
+    if (!best_index)
+        return std::nullopt;
+
+    auto position = svec2(segments_[*best_index].x, best_y);
+    placeSkyline(*best_index, {position, position + size});
+    return position;
+}
+
+bool SkylinePacker::canReserve(const sbounds2& bounds) const
+{
+    for (const auto& segment : segments_) {
+        auto covers = segment.x < bounds.high.x() && bounds.low.x() < segment.x + segment.width;
+        if (covers && segment.y > bounds.low.y())
+            return false;
+    }
+    return std::none_of(free_.begin(), free_.end(), [&](const sbounds2& free) { return free.overlaps(bounds); });
+}
+
+void SkylinePacker::reserve(const sbounds2& bounds)
+{
+    auto index = std::size_t{0};
+    while (segments_[index].x + segments_[index].width <= bounds.low.x())
+        index++;
+    // The segment is split, so that the rectangle starts at the beginning of a segment.
+    auto& segment = segments_[index];
+    if (segment.x < bounds.low.x()) {
+        auto right = Segment{bounds.low.x(), segment.y, segment.x + segment.width - bounds.low.x()};
+        segment.width = bounds.low.x() - segment.x;
+        segments_.insert(segments_.begin() + static_cast<std::ptrdiff_t>(++index), right);
+    }
+    placeSkyline(index, bounds);
+}
+
+void SkylinePacker::placeSkyline(std::size_t segment_index, const sbounds2& bounds)
+{
+    assert(segments_[segment_index].x == bounds.low.x());
+    auto right = bounds.high.x();
+
+    // Everything between the segments below and the bottom of the rectangle can no longer be reached from the top.
+    auto index = segment_index;
+    while (index < segments_.size() && segments_[index].x < right) {
+        auto& segment = segments_[index];
+        auto segment_right = segment.x + segment.width;
+        assert(segment.y <= bounds.low.y());
+        if (segment.y < bounds.low.y())
+            free_.push_back({{segment.x, segment.y}, {std::min(segment_right, right), bounds.low.y()}});
+        if (segment_right <= right) {
+            segments_.erase(segments_.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+        else {
+            segment.width = segment_right - right;
+            segment.x = right;
+            break;
+        }
+    }
+    auto inserted = segments_.insert(segments_.begin() + static_cast<std::ptrdiff_t>(segment_index),
+                                     {bounds.low.x(), bounds.high.y(), bounds.size().x()});
+
+    // Neighbouring segments of the same height are merged, which keeps the number of segments low.
+    auto merge = [&](std::vector<Segment>::iterator left) {
+        auto next = left + 1;
+        if (next == segments_.end() || left->y != next->y)
+            return false;
+        left->width += next->width;
+        segments_.erase(next);
+        return true;
+    };
+    if (inserted != segments_.begin() && merge(inserted - 1))
+        inserted--;
+    merge(inserted);
+}
+
+std::optional<GLsizei> SkylinePacker::fitSkyline(std::size_t segment_index, GLsizei width, GLsizei height) const
+{
+    if (segments_[segment_index].x + width > size_)
+        return std::nullopt;
+    GLsizei y = 0;
+    for (auto index = segment_index; width > 0; index++) {
+        y = std::max(y, segments_[index].y);
+        if (y + height > size_)
+            return std::nullopt;
+        width -= segments_[index].width;
+    }
+    return y;
+}
+
+MaxRectsPacker::MaxRectsPacker(GLsizei size)
+    : size_(0)
+{
+    grow(size);
+}
+
+void MaxRectsPacker::grow(GLsizei size)
+{
+    assert(size >= size_);
+    if (size == size_)
+        return;
+    // Free rectangles along the edges simply extend into the new space, while the rest of it is free as a whole.
+    for (auto& free : free_) {
+        if (free.high.x() == size_)
+            free.high.x() = size;
+        if (free.high.y() == size_)
+            free.high.y() = size;
+    }
+    addFree({{size_, 0}, {size, size}});
+    addFree({{0, size_}, {size, size}});
+    size_ = size;
+}
+
+std::optional<svec2> MaxRectsPacker::insert(svec2 size)
+{
+    assert(size.greaterThan(0).all());
+    std::optional<svec2> best;
+    auto best_fit = std::tuple(GLsizei{}, GLsizei{}, svec2{});
+    for (const auto& free : free_) {
+        auto leftover = free.size() - size;
+        if (leftover.lessThan(0).any())
+            continue;
+        // Ties are broken by position, so that rectangles stay close to the bottom left corner.
+        auto fit = std::tuple(leftover.minValue(), leftover.maxValue(), free.low.yx());
+        if (!best || fit < best_fit) {
+            best = free.low;
+            best_fit = fit;
+        }
+    }
+    if (!best)
+        return std::nullopt;
+    reserve({*best, *best + size});
+    return best;
+}
+
+bool MaxRectsPacker::canReserve(const sbounds2& bounds) const
+{
+    // Free rectangles along the edges extend into the space, that growing the bin would add.
+    constexpr auto unbounded = std::numeric_limits<GLsizei>::max();
+    if (bounds.low.x() >= size_ || bounds.low.y() >= size_)
+        return true;
+    return std::any_of(free_.begin(), free_.end(), [&](sbounds2 free) {
+        if (free.high.x() == size_)
+            free.high.x() = unbounded;
+        if (free.high.y() == size_)
+            free.high.y() = unbounded;
+        return free.contains(bounds);
+    });
+}
+
+void MaxRectsPacker::reserve(const sbounds2& placed)
+{
+    std::vector<sbounds2> split;
+    for (std::size_t index = 0; index < free_.size();) {
+        auto free = free_[index];
+        if (!free.overlaps(placed)) {
+            index++;
+            continue;
+        }
+        if (placed.low.x() > free.low.x())
+            split.push_back({free.low, {placed.low.x(), free.high.y()}});
+        if (placed.high.x() < free.high.x())
+            split.push_back({{placed.high.x(), free.low.y()}, free.high});
+        if (placed.low.y() > free.low.y())
+            split.push_back({free.low, {free.high.x(), placed.low.y()}});
+        if (placed.high.y() < free.high.y())
+            split.push_back({{free.low.x(), placed.high.y()}, free.high});
+        free_[index] = free_.back();
+        free_.pop_back();
+    }
+    // The parts can't contain any of the untouched free rectangles, which is why only the parts themselves are pruned.
+    auto first_part = static_cast<std::ptrdiff_t>(free_.size());
+    for (const auto& part : split) {
+        if (std::any_of(free_.begin(), free_.end(), [&](const sbounds2& free) { return free.contains(part); }))
+            continue;
+        auto parts_end = std::remove_if(
+            free_.begin() + first_part, free_.end(), [&](const sbounds2& free) { return part.contains(free); });
+        free_.erase(parts_end, free_.end());
+        free_.push_back(part);
+    }
+}
+
+void MaxRectsPacker::remove(const sbounds2& bounds)
+{
+    auto merged = bounds;
+    for (auto iter = free_.begin(); iter != free_.end();) {
+        if (sharesEdge(merged, *iter)) {
+            merged = merged.join(*iter);
+            free_.erase(iter);
+            // The bigger rectangle might share an edge with one that was already checked.
+            iter = free_.begin();
+        }
+        else {
+            ++iter;
+        }
+    }
+    addFree(merged);
+}
+
+void MaxRectsPacker::addFree(const sbounds2& bounds)
+{
+    if (std::any_of(free_.begin(), free_.end(), [&](const sbounds2& free) { return free.contains(bounds); }))
+        return;
+    std::erase_if(free_, [&](const sbounds2& free) { return bounds.contains(free); });
+    free_.push_back(bounds);
+}
+
+TexturePacker::TexturePacker(TextureAtlasPacking packing, GLsizei alignment, GLsizei max_size)
+    : alignment_(alignment)
+    , max_size_(max_size)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    switch (packing) {
+    case TextureAtlasPacking::Skyline:
+        packer_ = SkylinePacker();
+        return;
+    case TextureAtlasPacking::MaxRects:
+        packer_ = MaxRectsPacker();
+        return;
+    case TextureAtlasPacking::Grid:
+    case TextureAtlasPacking::COUNT:
+        break;
+    }
+    throw std::invalid_argument("Texture atlas packing does not use a packer.");
+}
+
+GLsizei TexturePacker::size() const
+{
+    return std::visit([](const auto& packer) { return packer.size(); }, packer_) * alignment_;
+}
+
+svec2 TexturePacker::alignedSize(svec2 size) const { return (size + alignment_ - 1) / alignment_ * alignment_; }
+
+std::optional<svec2> TexturePacker::insert(svec2 size)
+{
+    auto units = alignedSize(size) / alignment_;
+    auto max_units = max_size_ / alignment_;
+    if (units.greaterThan(max_units).any())
+        return std::nullopt;
+    // Full layers are tried over and over again, which is cut short for tiles that are at least as big.
+    if (no_fit_ && units.greaterThanEqual(*no_fit_).all())
+        return std::nullopt;
+
+    auto position = std::visit(
+        [&](auto& packer) -> std::optional<svec2> {
+            // Layers start out just big enough for the first tile and double in size, whenever a tile does not fit.
+            if (packer.size() == 0) {
+                auto unsigned_units = static_cast<std::make_unsigned_t<GLsizei>>(units.maxValue());
+                packer.grow(std::min(GLsizei{1} << dutils::ilog2ceil(unsigned_units), max_units));
+            }
+            while (true) {
+                if (auto position = packer.insert(units))
+                    return *position * alignment_;
+                auto size = std::min(packer.size() * 2, max_units);
+                if (size == packer.size())
+                    return std::nullopt;
+                packer.grow(size);
+            }
+        },
+        packer_);
+    if (!position)
+        no_fit_ = units;
+    return position;
+}
+
+bool TexturePacker::canReserve(svec2 position, svec2 size) const
+{
+    if (position.lessThan(0).any() || position % alignment_ != svec2(0, 0))
+        return false;
+    auto bounds = sbounds2(position / alignment_, (position + alignedSize(size)) / alignment_);
+    if (bounds.high.greaterThan(max_size_ / alignment_).any())
+        return false;
+    return std::visit([&](const auto& packer) { return packer.canReserve(bounds); }, packer_);
+}
+
+void TexturePacker::reserve(svec2 position, svec2 size)
+{
+    assert(position % alignment_ == svec2(0, 0));
+    auto bounds = sbounds2(position / alignment_, (position + alignedSize(size)) / alignment_);
+    auto max_units = max_size_ / alignment_;
+    assert(bounds.high.lessThanEqual(max_units).all());
+    std::visit(
+        [&](auto& packer) {
+            // The layer grows to the same power of two, that inserting the tile in the first place would have.
+            auto required = static_cast<std::make_unsigned_t<GLsizei>>(bounds.high.maxValue());
+            auto size = std::min(GLsizei{1} << dutils::ilog2ceil(required), max_units);
+            if (size > packer.size())
+                packer.grow(size);
+            packer.reserve(bounds);
+        },
+        packer_);
+}
+
+void TexturePacker::remove(svec2 position, svec2 size)
+{
+    no_fit_.reset();
+    auto bounds = sbounds2(position / alignment_, (position + alignedSize(size)) / alignment_);
+    std::visit([&](auto& packer) { packer.remove(bounds); }, packer_);
+}
+
+} // namespace dang::gl
@@ -0,0 +1,252 @@
+#include "dang-gl/Image/BorderedImage.h"
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-math/bounds.h"
+#include "dang-math/vector.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+
+namespace {
+
+/// @brief A distinct pixel value for every position, so that misplaced pixels are noticed.
+template <typename TImage>
+typename TImage::Pixel pixelAt(const typename TImage::Size& pos)
+{
+    typename TImage::Pixel result;
+    for (std::size_t i = 0; i < result.size(); i++)
+        result[i] = static_cast<typename TImage::Pixel::value_type>(pos.sum() * 7 + pos[0] * 3 + i);
+    return result;
+}
+
+/// @brief Creates an image of the given size, where each pixel is set according to pixelAt.
+template <typename TImage>
+TImage patternImage(const typename TImage::Size& size)
+{
+    TImage result(size);
+    for (const auto& pos : typename TImage::Bounds(size))
+        result[pos] = pixelAt<TImage>(pos);
+    return result;
+}
+
+/// @brief Checks every pixel of the given bounds against a function, which returns the expected pixel.
+template <typename TImage, typename TFunction>
+bool allPixels(const TImage& image, TFunction expected)
+{
+    for (const auto& pos : typename TImage::Bounds(image.size()))
+        if (image[pos] != expected(pos))
+            return false;
+    return true;
+}
+
+} // namespace
+
+// RGB with an alignment of four has padding at the end of each row, which copies have to skip.
+TEMPLATE_TEST_CASE("Images copy and fill whole rows at once.",
+                   "[image]",
+                   dgl::Image2D,
+                   (dgl::Image<2, dgl::PixelFormat::RGB>),
+                   dgl::Image3D,
+                   (dgl::Image<3, dgl::PixelFormat::RGB>))
+{
+    using Image = TestType;
+    using Pixel = typename Image::Pixel;
+    using Size = typename Image::Size;
+    using Bounds = typename Image::Bounds;
+
+    Size size(7);
+    auto image = patternImage<Image>(size);
+
+    SECTION("Images can be filled with a single color.")
+    {
+        Pixel color(42);
+        CHECK(allPixels(Image(size, color), [&](const Size&) { return color; }));
+    }
+    SECTION("Images can be initialized using an iterator.")
+    {
+        std::vector<Pixel> pixels;
+        for (const auto& pos : Bounds(size).xFirst())
+            pixels.push_back(pixelAt<Image>(pos));
+        CHECK(allPixels(Image(size, pixels.begin()), pixelAt<Image>));
+    }
+    SECTION("Images can be cropped.")
+    {
+        Bounds bounds(Size(1), Size(5));
+        bounds.low[0] = 2;
+        CHECK(allPixels(image[bounds], [&](const Size& pos) { return pixelAt<Image>(pos + bounds.low); }));
+
+        SECTION("Only the last axis is cropped, which can be copied at once.")
+        {
+            Bounds last_axis(size);
+            last_axis.low[Image::dim - 1] = 3;
+            CHECK(allPixels(image[last_axis], [&](const Size& pos) { return pixelAt<Image>(pos + last_axis.low); }));
+        }
+    }
+    SECTION("Images can be copied into existing images.")
+    {
+        Pixel color(42);
+        Image target(Size(9), color);
+        Bounds bounds(Size(1), Size(5));
+        target.setSubImage(Size(3), image, bounds);
+        CHECK(allPixels(target, [&](const Size& pos) {
+            return Bounds(Size(4), Size(8)).contains(pos) ? pixelAt<Image>(pos - 3) : color;
+        }));
+
+        SECTION("Images of the same size can be copied at once.")
+        {
+            Image same(size, color);
+            same.setSubImage({}, image);
+            CHECK(allPixels(same, pixelAt<Image>));
+        }
+    }
+    SECTION("Images can be copied onto overlapping parts of themselves.")
+    {
+        Bounds bounds(Size(5));
+        Size offset(1);
+        image.setSubImage(offset, image, bounds);
+        CHECK(allPixels(image, [&](const Size& pos) {
+            return Bounds(offset, offset + 5).contains(pos) ? pixelAt<Image>(pos - offset) : pixelAt<Image>(pos);
+        }));
+    }
+    SECTION("Images can be padded with a color.")
+    {
+        Pixel color(42);
+        Size offset(1);
+        offset[0] = 2;
+        Image padded(size + 3, color, image, offset);
+        CHECK(allPixels(padded, [&](const Size& pos) {
+            return Bounds(offset, offset + size).contains(pos) ? pixelAt<Image>(pos - offset) : color;
+        }));
+    }
+    SECTION("Empty images can be copied into other images.")
+    {
+        Image empty;
+        Image padded(size, Pixel(42), empty, Size());
+        CHECK(allPixels(padded, [](const Size&) { return Pixel(42); }));
+        image.setSubImage({}, empty);
+        CHECK(allPixels(image, pixelAt<Image>));
+    }
+}
+
+TEST_CASE("Images get a solid border without filling the whole image first.", "[image]")
+{
+    using BorderedImage = dgl::BorderedImage<2>;
+
+    auto image = patternImage<dgl::Image2D>({5, 3});
+    dgl::Pixel<> color(1, 2, 3, 4);
+    auto bordered = BorderedImage::addBorder(BorderedImage::BorderSolid{color}, image);
+    CHECK(bordered.size() == dmath::svec2(7, 5));
+    CHECK(allPixels(bordered.image(), [&](const dmath::svec2& pos) {
+        return dmath::sbounds2({1, 1}, {6, 4}).contains(pos) ? pixelAt<dgl::Image2D>(pos - 1) : color;
+    }));
+}
+
+TEST_CASE("Images get wrapping borders, which copy from the opposite side of the image.", "[image]")
+{
+    using BorderedImage = dgl::BorderedImage<2>;
+
+    auto size = GENERATE(dmath::svec2(5, 3), dmath::svec2(1, 1), dmath::svec2(1, 4), dmath::svec2(64, 17));
+    CAPTURE(size);
+    auto image = patternImage<dgl::Image2D>(size);
+
+    SECTION("Both sides wrap around for BorderWrapBoth.")
+    {
+        auto bordered = BorderedImage::addBorder(BorderedImage::BorderWrapBoth{}, image);
+        CHECK(bordered.size() == size + 2);
+        CHECK(allPixels(bordered.image(), [&](const dmath::svec2& pos) {
+            return pixelAt<dgl::Image2D>((pos + size - 1) % size);
+        }));
+    }
+    SECTION("Only the positive sides wrap around for BorderWrapPositive.")
+    {
+        auto bordered = BorderedImage::addBorder(BorderedImage::BorderWrapPositive{}, image);
+        CHECK(bordered.size() == size + 1);
+        CHECK(allPixels(bordered.image(), [&](const dmath::svec2& pos) { return pixelAt<dgl::Image2D>(pos % size); }));
+    }
+    SECTION("Images with more dimensions wrap around just the same.")
+    {
+        auto image3d = patternImage<dgl::Image3D>({size.x(), size.y(), 2});
+        auto bordered = dgl::BorderedImage<3>::addBorder(dgl::BorderedImage<3>::BorderWrapBoth{}, image3d);
+        CHECK(allPixels(bordered.image(), [&](const dmath::svec3& pos) {
+            return pixelAt<dgl::Image3D>((pos + image3d.size() - 1) % image3d.size());
+        }));
+    }
+}
+
+TEST_CASE("Empty images get a wrapping border filled with zeros.", "[image]")
+{
+    using BorderedImage = dgl::BorderedImage<2>;
+
+    dgl::Image2D image(dmath::svec2(0, 3));
+    auto border = GENERATE(BorderedImage::Border(BorderedImage::BorderWrapBoth{}),
+                           BorderedImage::Border(BorderedImage::BorderWrapPositive{}));
+    CAPTURE(border.index());
+    auto bordered = BorderedImage::addBorder(border, image);
+    CHECK(bordered.image().count() > 0);
+    CHECK(allPixels(bordered.image(), [](const dmath::svec2&) { return dgl::Pixel<>(); }));
+}
+
+TEST_CASE("Placeholder images only have a size, just like freed images.", "[image]")
+{
+    using BorderedImage = dgl::BorderedImage<2>;
+
+    auto placeholder = BorderedImage::placeholder(BorderedImage::BorderWrapBoth{}, dmath::svec2(7, 5));
+    CHECK_FALSE(placeholder);
+    CHECK(placeholder.image().data() == nullptr);
+    CHECK(placeholder.size() == dmath::svec2(7, 5));
+    CHECK(placeholder.padding() == dmath::svec2(2, 2));
+}
+
+TEST_CASE("Bordered images can be loaded from PNG with room for the border right away.", "[image][png]")
+{
+    using BorderedImage = dgl::BorderedImage<2>;
+
+    auto image = patternImage<dgl::Image2D>({13, 6});
+    std::stringstream stream;
+    image.saveToPNG(stream);
+    auto png = stream.str();
+    auto data = std::as_bytes(std::span(png));
+
+    auto border = GENERATE(BorderedImage::Border(BorderedImage::BorderNone{}),
+                           BorderedImage::Border(BorderedImage::BorderSolid{dgl::Pixel<>(1, 2, 3, 4)}),
+                           BorderedImage::Border(BorderedImage::BorderWrapBoth{}),
+                           BorderedImage::Border(BorderedImage::BorderWrapPositive{}));
+    CAPTURE(border.index());
+
+    auto loaded = BorderedImage::loadFromPNG(border, data);
+    auto expected = BorderedImage::addBorder(border, image);
+    CHECK(loaded.padding() == expected.padding());
+    REQUIRE(loaded.size() == expected.size());
+    CHECK(allPixels(loaded.image(), [&](const dmath::svec2& pos) { return expected.image()[pos]; }));
+}
+
+TEST_CASE("Image copies on 4K images can be benchmarked.", "[.][image][benchmark]")
+{
+    dmath::svec2 size(4096, 4096);
+    auto image = patternImage<dgl::Image2D>(size);
+    dgl::Image2D target(size);
+    dmath::sbounds2 bounds({1, 1}, size - 1);
+
+    BENCHMARK("fill") { return dgl::Image2D(size, dgl::Pixel<>(42)); };
+    BENCHMARK("crop") { return image[bounds]; };
+    BENCHMARK("setSubImage") { target.setSubImage({1, 1}, image, bounds); };
+    BENCHMARK("setSubImage of the same size") { target.setSubImage({}, image); };
+    BENCHMARK("solid border")
+    {
+        return dgl::BorderedImage<2>::addBorder(dgl::BorderedImage<2>::BorderSolid{dgl::Pixel<>(42)}, image);
+    };
+    BENCHMARK("wrapping border")
+    {
+        return dgl::BorderedImage<2>::addBorder(dgl::BorderedImage<2>::BorderWrapBoth{}, image);
+    };
+    BENCHMARK("replacing a wrapping border in place")
+    {
+        using BorderedImage = dgl::BorderedImage<2>;
+        target = BorderedImage::replaceBorder(BorderedImage::BorderWrapBoth{}, std::move(target)).image();
+    };
+}
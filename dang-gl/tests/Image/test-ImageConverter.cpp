@@ -0,0 +1,275 @@
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/ImageConverter.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+using dgl::ImageConversionStage;
+using dgl::PixelFormat;
+using dgl::PixelType;
+
+namespace {
+
+template <PixelFormat v_format, PixelType v_type = PixelType::UNSIGNED_BYTE>
+using Row = dgl::Image<1, v_format, v_type>;
+
+/// @brief Creates a single row of pixels with random components.
+template <PixelFormat v_format, PixelType v_type = PixelType::UNSIGNED_BYTE>
+Row<v_format, v_type> randomRow(std::size_t count, unsigned seed = 1)
+{
+    dutils::SampleGenerator generator{seed};
+    std::vector<dgl::Pixel<v_format, v_type>> pixels(count);
+    for (auto& pixel : pixels)
+        for (auto& component : pixel)
+            component = static_cast<std::remove_reference_t<decltype(component)>>(generator.next());
+    return Row<v_format, v_type>(dmath::svec1(count), pixels.begin());
+}
+
+/// @brief Creates a single row of the given pixels.
+template <PixelFormat v_format, PixelType v_type = PixelType::UNSIGNED_BYTE>
+Row<v_format, v_type> row(const std::vector<typename Row<v_format, v_type>::Pixel>& pixels)
+{
+    return Row<v_format, v_type>(dmath::svec1(pixels.size()), pixels.begin());
+}
+
+/// @brief Returns all pixels of a single row.
+template <typename TRow>
+std::vector<typename TRow::Pixel> pixels(const TRow& row)
+{
+    auto data = static_cast<const typename TRow::Pixel*>(row.data());
+    return std::vector<typename TRow::Pixel>(data, data + row.count());
+}
+
+/// @brief Converts a single row and returns the resulting pixels.
+template <PixelFormat v_format, PixelType v_type, typename TRow>
+auto convertPixels(const TRow& row, const dgl::ImageConverter& converter = {})
+{
+    return pixels(converter.convert<v_format, v_type>(row));
+}
+
+} // namespace
+
+TEST_CASE("ImageConverter kernels for unsigned bytes only reorder components.", "[image][converter]")
+{
+    // Odd counts cover the remaining pixels after a SIMD loop.
+    for (std::size_t count = 0; count < 40; count++) {
+        CAPTURE(count);
+        auto rgba_row = randomRow<PixelFormat::RGBA>(count);
+        auto rgb_row = randomRow<PixelFormat::RGB>(count);
+        auto gray_row = randomRow<PixelFormat::RED>(count);
+        auto rgba = pixels(rgba_row);
+        auto rgb = pixels(rgb_row);
+        auto gray = pixels(gray_row);
+
+        auto bgra_row = dgl::ImageConverter().convert<PixelFormat::BGRA>(rgba_row);
+        auto bgra = pixels(bgra_row);
+        auto rgb_to_rgba = convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(rgb_row);
+        auto rgb_to_bgra = convertPixels<PixelFormat::BGRA, PixelType::UNSIGNED_BYTE>(rgb_row);
+        auto rgba_to_rgb = convertPixels<PixelFormat::RGB, PixelType::UNSIGNED_BYTE>(rgba_row);
+        auto rgba_to_bgr = convertPixels<PixelFormat::BGR, PixelType::UNSIGNED_BYTE>(rgba_row);
+        auto gray_to_rgba = convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(gray_row);
+
+        for (std::size_t i = 0; i < count; i++) {
+            const auto& [r, g, b, a] = rgba[i];
+            CHECK(bgra[i] == dgl::Pixel<PixelFormat::BGRA>(b, g, r, a));
+            CHECK(rgba_to_rgb[i] == dgl::Pixel<PixelFormat::RGB>(r, g, b));
+            CHECK(rgba_to_bgr[i] == dgl::Pixel<PixelFormat::BGR>(b, g, r));
+            CHECK(rgb_to_rgba[i] == dgl::Pixel<PixelFormat::RGBA>(rgb[i].x(), rgb[i].y(), rgb[i].z(), 255));
+            CHECK(rgb_to_bgra[i] == dgl::Pixel<PixelFormat::BGRA>(rgb[i].z(), rgb[i].y(), rgb[i].x(), 255));
+            CHECK(gray_to_rgba[i] == dgl::Pixel<PixelFormat::RGBA>(gray[i].x(), gray[i].x(), gray[i].x(), 255));
+        }
+        CHECK(convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(bgra_row) == rgba);
+    }
+}
+
+TEST_CASE("ImageConverter rounds when narrowing components.", "[image][converter]")
+{
+    std::vector<dgl::Pixel<PixelFormat::RED, PixelType::UNSIGNED_SHORT>> shorts;
+    for (unsigned value = 0; value < 65536; value++)
+        shorts.emplace_back(static_cast<GLushort>(value));
+    auto shorts_row = row<PixelFormat::RED, PixelType::UNSIGNED_SHORT>(shorts);
+    auto bytes_row = dgl::ImageConverter().convert<PixelFormat::RED>(shorts_row);
+    auto bytes = pixels(bytes_row);
+    for (unsigned value = 0; value < 65536; value++)
+        REQUIRE(bytes[value].x() == static_cast<GLubyte>(std::round(value / 257.0)));
+
+    // Widening is exact.
+    auto widened = convertPixels<PixelFormat::RED, PixelType::UNSIGNED_SHORT>(bytes_row);
+    CHECK(widened[65535].x() == 65535);
+    CHECK(widened[257 * 7].x() == 257 * 7);
+
+    auto signed_bytes = row<PixelFormat::RED, PixelType::BYTE>({{-128}, {-127}, {0}, {127}});
+    auto floats = convertPixels<PixelFormat::RED, PixelType::FLOAT>(signed_bytes);
+    CHECK(floats[0].x() == -1.0f);
+    CHECK(floats[1].x() == -1.0f);
+    CHECK(floats[2].x() == 0.0f);
+    CHECK(floats[3].x() == 1.0f);
+}
+
+TEST_CASE("ImageConverter converts between half and single precision floats.", "[image][converter]")
+{
+    for (unsigned bits = 0; bits < 65536; bits++) {
+        auto half = static_cast<GLhalf>(bits);
+        auto value = dgl::detail::halfToFloat(half);
+        if (std::isnan(value))
+            continue;
+        REQUIRE(dgl::detail::floatToHalf(value) == half);
+    }
+
+    CHECK(dgl::detail::halfToFloat(0x3C00) == 1.0f);
+    CHECK(dgl::detail::halfToFloat(0xC000) == -2.0f);
+    CHECK(dgl::detail::halfToFloat(0x0001) == 0x1p-24f);
+    CHECK(dgl::detail::halfToFloat(0x7BFF) == 65504.0f);
+    CHECK(std::isnan(dgl::detail::halfToFloat(dgl::detail::floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+    // Ties round to even.
+    CHECK(dgl::detail::floatToHalf(1.0f + 0x1p-11f) == 0x3C00);
+    CHECK(dgl::detail::floatToHalf(1.0f + 3 * 0x1p-11f) == 0x3C02);
+    CHECK(dgl::detail::floatToHalf(65519.0f) == 0x7BFF);
+    CHECK(dgl::detail::floatToHalf(65520.0f) == 0x7C00);
+    CHECK(dgl::detail::floatToHalf(0x1p-25f) == 0x0000);
+    CHECK(dgl::detail::floatToHalf(0x1p-25f * 3) == 0x0002);
+}
+
+TEST_CASE("ImageConverter converts between gray and color.", "[image][converter]")
+{
+    auto colors = row<PixelFormat::RGB, PixelType::FLOAT>({{1.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.5f}});
+    auto gray = convertPixels<PixelFormat::RED, PixelType::FLOAT>(colors);
+    CHECK(gray[0].x() == Catch::Approx(0.2126f));
+    CHECK(gray[1].x() == Catch::Approx(0.5f));
+
+    auto gray_alpha = row<PixelFormat::RG>({{10, 20}});
+    CHECK(convertPixels<PixelFormat::BGRA, PixelType::UNSIGNED_BYTE>(gray_alpha)[0] ==
+          dgl::Pixel<PixelFormat::BGRA>(10, 10, 10, 20));
+    CHECK(convertPixels<PixelFormat::RED, PixelType::UNSIGNED_SHORT>(gray_alpha)[0].x() == 10 * 257);
+}
+
+TEST_CASE("ImageConverter keeps values of integer formats.", "[image][converter]")
+{
+    auto ints = row<PixelFormat::RGB_INTEGER, PixelType::INT>({{-5, 300, 42}});
+    auto bytes = convertPixels<PixelFormat::BGRA_INTEGER, PixelType::UNSIGNED_BYTE>(ints);
+    CHECK(bytes[0] == dgl::Pixel<PixelFormat::BGRA_INTEGER>(42, 255, 0, 255));
+    auto shorts = convertPixels<PixelFormat::RGBA_INTEGER, PixelType::SHORT>(ints);
+    CHECK(shorts[0] == dgl::Pixel<PixelFormat::RGBA_INTEGER, PixelType::SHORT>(-5, 300, 42, 32767));
+}
+
+TEST_CASE("ImageConverter applies stages in order.", "[image][converter]")
+{
+    SECTION("sRGB to linear and back results in the same 8-bit values.")
+    {
+        std::vector<dgl::Pixel<PixelFormat::RGBA>> values;
+        for (unsigned value = 0; value < 256; value++)
+            values.emplace_back(static_cast<GLubyte>(value));
+        auto srgb = row<PixelFormat::RGBA>(values);
+
+        dgl::ImageConverter to_linear{ImageConversionStage::SRGBToLinear};
+        auto linear_row = to_linear.convert<PixelFormat::RGBA, PixelType::FLOAT>(srgb);
+        auto linear = pixels(linear_row);
+        CHECK(linear[0].x() == 0.0f);
+        CHECK(linear[128].x() == Catch::Approx(0.2158605f));
+        CHECK(linear[255].x() == Catch::Approx(1.0f));
+        // Alpha is not affected.
+        CHECK(linear[128].w() == Catch::Approx(128 / 255.0f));
+
+        dgl::ImageConverter to_srgb{ImageConversionStage::LinearToSRGB};
+        CHECK(convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(linear_row, to_srgb) == values);
+
+        dgl::ImageConverter round_trip{ImageConversionStage::SRGBToLinear, ImageConversionStage::LinearToSRGB};
+        CHECK(convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(srgb, round_trip) == values);
+    }
+    SECTION("Premultiplying alpha rounds to the nearest value.")
+    {
+        std::vector<dgl::Pixel<PixelFormat::RGBA>> values;
+        for (unsigned alpha = 0; alpha < 256; alpha++)
+            for (unsigned color = 0; color < 256; color++)
+                values.emplace_back(static_cast<GLubyte>(color), 0, 255, static_cast<GLubyte>(alpha));
+        auto straight = row<PixelFormat::RGBA>(values);
+
+        dgl::ImageConverter premultiply{ImageConversionStage::PremultiplyAlpha};
+        auto premultiplied = convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(straight, premultiply);
+        for (std::size_t i = 0; i < values.size(); i++) {
+            auto [color, zero, full, alpha] = values[i];
+            auto expected = static_cast<GLubyte>(std::round(color * alpha / 255.0));
+            REQUIRE(premultiplied[i] == dgl::Pixel<PixelFormat::RGBA>(expected, 0, alpha, alpha));
+        }
+
+        // Any other target goes through the generic path, which has to give the same results.
+        auto bgra = premultiply.convert<PixelFormat::BGRA>(straight);
+        CHECK(convertPixels<PixelFormat::RGBA, PixelType::UNSIGNED_BYTE>(bgra) == premultiplied);
+    }
+    SECTION("Unpremultiplying alpha restores the color.")
+    {
+        auto straight =
+            row<PixelFormat::RGBA, PixelType::FLOAT>({{0.2f, 0.4f, 0.6f, 0.5f}, {0.2f, 0.4f, 0.6f, 0.0f}});
+        dgl::ImageConverter premultiply{ImageConversionStage::PremultiplyAlpha};
+        premultiply.then(ImageConversionStage::UnpremultiplyAlpha);
+        auto result = convertPixels<PixelFormat::RGBA, PixelType::FLOAT>(straight, premultiply);
+        CHECK(result[0].x() == Catch::Approx(0.2f));
+        CHECK(result[0].z() == Catch::Approx(0.6f));
+        CHECK(result[1] == dgl::Pixel<PixelFormat::RGBA, PixelType::FLOAT>());
+    }
+}
+
+TEST_CASE("ImageConverter converts whole images, skipping row padding.", "[image][converter]")
+{
+    // RGB with an alignment of four has padding at the end of each row.
+    dgl::Image<2, PixelFormat::RGB> image(dmath::svec2(301, 257));
+    dutils::SampleGenerator generator{2};
+    for (const auto& pos : dmath::sbounds2(image.size()))
+        image[pos] = dgl::Pixel<PixelFormat::RGB>(static_cast<GLubyte>(generator.next()),
+                                                  static_cast<GLubyte>(generator.next()),
+                                                  static_cast<GLubyte>(generator.next()));
+
+    dgl::ImageConverter converter{ImageConversionStage::SRGBToLinear};
+    auto converted = converter.convert<PixelFormat::RGBA, PixelType::HALF_FLOAT>(image);
+    CHECK(converted.size() == image.size());
+
+    bool all_equal = true;
+    for (const auto& pos : dmath::sbounds2(image.size())) {
+        for (std::size_t i = 0; i < 3; i++) {
+            auto expected = dgl::detail::floatToHalf(dgl::detail::srgbToLinearTable()[image[pos][i]]);
+            all_equal = all_equal && converted[pos][i] == expected;
+        }
+        all_equal = all_equal && converted[pos].w() == 0x3C00;
+    }
+    CHECK(all_equal);
+}
+
+TEST_CASE("ImageConverter can be benchmarked on 4K images.", "[.][image][converter][benchmark]")
+{
+    dmath::svec2 size(4096, 4096);
+    dgl::Image<2, PixelFormat::RGB> rgb(size, dgl::Pixel<PixelFormat::RGB>(10, 20, 30));
+    dgl::Image2D rgba(size, dgl::Pixel<>(10, 20, 30, 40));
+    dgl::Image<2, PixelFormat::RGBA, PixelType::UNSIGNED_SHORT> rgba16(size);
+
+    dgl::ImageConverter converter;
+    BENCHMARK("RGB to RGBA") { return converter.convert<PixelFormat::RGBA>(rgb); };
+    BENCHMARK("RGBA to BGRA") { return converter.convert<PixelFormat::BGRA>(rgba); };
+    BENCHMARK("RGBA16 to RGBA8") { return converter.convert<PixelFormat::RGBA>(rgba16); };
+    BENCHMARK("RGBA to RGB") { return converter.convert<PixelFormat::RGB>(rgba); };
+
+    dgl::ImageConverter premultiply{ImageConversionStage::PremultiplyAlpha};
+    BENCHMARK("premultiply RGBA") { return premultiply.convert<PixelFormat::RGBA>(rgba); };
+
+    dgl::ImageConverter to_linear{ImageConversionStage::SRGBToLinear};
+    BENCHMARK("sRGB RGBA to linear float") { return to_linear.convert<PixelFormat::RGBA, PixelType::FLOAT>(rgba); };
+
+    dgl::ImageConverter to_linear_premultiplied{ImageConversionStage::SRGBToLinear,
+                                                ImageConversionStage::PremultiplyAlpha,
+                                                ImageConversionStage::LinearToSRGB};
+    BENCHMARK("sRGB premultiply RGBA") { return to_linear_premultiplied.convert<PixelFormat::RGBA>(rgba); };
+}
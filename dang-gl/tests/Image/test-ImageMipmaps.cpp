@@ -0,0 +1,242 @@
+#include <cstddef>
+#include <vector>
+
+#include "dang-gl/Image/BorderedImage.h"
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/ImageMipmaps.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/PixelType.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+using dgl::MipmapFilter;
+using dgl::MipmapOptions;
+using dgl::PixelFormat;
+using dgl::PixelType;
+
+namespace {
+
+/// @brief Creates an image with random pixels, which are the same on every run.
+template <typename TImage>
+TImage randomImage(typename TImage::Size size, unsigned seed = 1)
+{
+    auto image = TImage(size);
+    dutils::SampleGenerator generator{seed};
+    for (std::size_t y = 0; y < size.y(); y++) {
+        for (std::size_t x = 0; x < size.x(); x++) {
+            for (auto& component : image[dmath::svec2(x, y)])
+                component = static_cast<GLubyte>(generator.next() >> 24);
+        }
+    }
+    return image;
+}
+
+/// @brief A plain box filter of two by two pixels, which rounds to the nearest integer.
+dgl::Image2D boxReference(const dgl::Image2D& image)
+{
+    auto result = dgl::Image2D(image.size() / 2);
+    for (std::size_t y = 0; y < result.size().y(); y++) {
+        for (std::size_t x = 0; x < result.size().x(); x++) {
+            auto at = [&](std::size_t dx, std::size_t dy) { return image[dmath::svec2(2 * x + dx, 2 * y + dy)]; };
+            for (std::size_t i = 0; i < 4; i++) {
+                auto sum = at(0, 0)[i] + at(1, 0)[i] + at(0, 1)[i] + at(1, 1)[i];
+                result[dmath::svec2(x, y)][i] = static_cast<GLubyte>((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+bool equalPixels(const dgl::Image2D& lhs, const dgl::Image2D& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (std::size_t y = 0; y < lhs.size().y(); y++)
+        for (std::size_t x = 0; x < lhs.size().x(); x++)
+            if (lhs[dmath::svec2(x, y)] != rhs[dmath::svec2(x, y)])
+                return false;
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Mipmaps halve the size of each level down to a single pixel.", "[image][mipmaps]")
+{
+    auto image = dgl::Image2D(dmath::svec2(37, 20));
+    CHECK(dgl::maxMipmapLevels(image.size()) == 6);
+
+    auto mipmaps = dgl::generateMipmaps(image, 100);
+    REQUIRE(mipmaps.size() == 5);
+    CHECK(mipmaps[0].size() == dmath::svec2(18, 10));
+    CHECK(mipmaps[1].size() == dmath::svec2(9, 5));
+    CHECK(mipmaps[2].size() == dmath::svec2(4, 2));
+    CHECK(mipmaps[3].size() == dmath::svec2(2, 1));
+    CHECK(mipmaps[4].size() == dmath::svec2(1, 1));
+
+    CHECK(dgl::generateMipmaps(image, 3).size() == 2);
+    CHECK(dgl::generateMipmaps(image, 1).empty());
+    CHECK(dgl::generateMipmaps(dgl::Image2D(), 4).empty());
+}
+
+TEST_CASE("Mipmaps of unsigned bytes use a box filter, that rounds to the nearest value.", "[image][mipmaps]")
+{
+    auto size = GENERATE(dmath::svec2(64, 64), dmath::svec2(67, 33), dmath::svec2(9, 130));
+    CAPTURE(size);
+
+    auto image = randomImage<dgl::Image2D>(size);
+    auto mipmaps = dgl::generateMipmaps(image, 100);
+
+    const auto* expected_from = &image;
+    for (const auto& mipmap : mipmaps) {
+        if (expected_from->size().lessThan(2).any())
+            break;
+        auto expected = boxReference(*expected_from);
+        CHECK(equalPixels(mipmap, expected));
+        expected_from = &mipmap;
+    }
+
+    SECTION("Other formats, which go through floats, result in the same first level.")
+    {
+        auto bgra = dgl::Image<2, PixelFormat::BGRA>(image.size());
+        auto rgb = dgl::Image<2, PixelFormat::RGB>(image.size());
+        for (std::size_t y = 0; y < size.y(); y++) {
+            for (std::size_t x = 0; x < size.x(); x++) {
+                const auto& pixel = image[dmath::svec2(x, y)];
+                bgra[dmath::svec2(x, y)] = {pixel[2], pixel[1], pixel[0], pixel[3]};
+                rgb[dmath::svec2(x, y)] = {pixel[0], pixel[1], pixel[2]};
+            }
+        }
+
+        auto bgra_level = dgl::generateMipmaps(bgra, 2).front();
+        auto rgb_level = dgl::generateMipmaps(rgb, 2).front();
+        for (std::size_t y = 0; y < mipmaps[0].size().y(); y++) {
+            for (std::size_t x = 0; x < mipmaps[0].size().x(); x++) {
+                const auto& pixel = mipmaps[0][dmath::svec2(x, y)];
+                auto bgra_pixel = dgl::Pixel<PixelFormat::BGRA>{pixel[2], pixel[1], pixel[0], pixel[3]};
+                CHECK(bgra_level[dmath::svec2(x, y)] == bgra_pixel);
+                CHECK(rgb_level[dmath::svec2(x, y)] == dgl::Pixel<PixelFormat::RGB>{pixel[0], pixel[1], pixel[2]});
+            }
+        }
+    }
+}
+
+TEST_CASE("Mipmaps of a single color keep that color for all filters.", "[image][mipmaps]")
+{
+    auto filter = GENERATE(MipmapFilter::Box, MipmapFilter::Kaiser, MipmapFilter::Lanczos);
+    auto gamma_correct = GENERATE(false, true);
+    CAPTURE(filter, gamma_correct);
+    auto options = MipmapOptions{filter, gamma_correct};
+
+    auto color = dgl::Pixel<PixelFormat::RGB>{17, 128, 250};
+    auto rgb = dgl::Image<2, PixelFormat::RGB>(dmath::svec2(23, 16), color);
+    for (const auto& mipmap : dgl::generateMipmaps(rgb, 100, options))
+        for (std::size_t y = 0; y < mipmap.size().y(); y++)
+            for (std::size_t x = 0; x < mipmap.size().x(); x++)
+                CHECK(mipmap[dmath::svec2(x, y)] == color);
+
+    auto value = dgl::Pixel<PixelFormat::RG, PixelType::FLOAT>{0.25f, 0.75f};
+    auto gray = dgl::Image<2, PixelFormat::RG, PixelType::FLOAT>(dmath::svec2(16, 9), value);
+    for (const auto& mipmap : dgl::generateMipmaps(gray, 100, options)) {
+        for (std::size_t y = 0; y < mipmap.size().y(); y++) {
+            for (std::size_t x = 0; x < mipmap.size().x(); x++) {
+                CHECK(mipmap[dmath::svec2(x, y)][0] == Catch::Approx(0.25f));
+                CHECK(mipmap[dmath::svec2(x, y)][1] == Catch::Approx(0.75f));
+            }
+        }
+    }
+}
+
+TEST_CASE("Gamma correct mipmaps average colors in linear space.", "[image][mipmaps]")
+{
+    auto white = dgl::Pixel<PixelFormat::RGBA>{255, 255, 255, 255};
+    auto image = dgl::Image2D(dmath::svec2(2, 2), {0, 0, 0, 255});
+    image[dmath::svec2(0, 0)] = white;
+    image[dmath::svec2(1, 1)] = white;
+
+    auto srgb = dgl::generateMipmaps(image, 2).front();
+    CHECK(srgb[dmath::svec2(0, 0)] == dgl::Pixel<PixelFormat::RGBA>{128, 128, 128, 255});
+
+    auto linear = dgl::generateMipmaps(image, 2, {MipmapFilter::Box, true}).front();
+    CHECK(linear[dmath::svec2(0, 0)] == dgl::Pixel<PixelFormat::RGBA>{188, 188, 188, 255});
+}
+
+TEST_CASE("Mipmaps of images with more than two dimensions filter along every axis.", "[image][mipmaps]")
+{
+    using Image3D = dgl::Image<3, PixelFormat::RED, PixelType::FLOAT>;
+    auto image = Image3D(dmath::svec3(2, 2, 2));
+    for (std::size_t i = 0; i < 8; i++)
+        image[dmath::svec3(i & 1, (i >> 1) & 1, i >> 2)] = {static_cast<float>(i)};
+
+    auto mipmaps = dgl::generateMipmaps(image, 2);
+    REQUIRE(mipmaps.size() == 1);
+    CHECK(mipmaps[0].size() == dmath::svec3(1, 1, 1));
+    CHECK(mipmaps[0][dmath::svec3(0, 0, 0)][0] == Catch::Approx(3.5f));
+}
+
+TEST_CASE("Mipmaps of bordered images only wrap around for wrapping borders.", "[image][mipmaps]")
+{
+    // The left half is black and the right half white, so that wrapping brightens the left edge.
+    auto image = dgl::Image2D(dmath::svec2(16, 16), {0, 0, 0, 255});
+    for (std::size_t y = 0; y < 16; y++)
+        for (std::size_t x = 8; x < 16; x++)
+            image[dmath::svec2(x, y)] = {255, 255, 255, 255};
+
+    using BorderedImage = dgl::BorderedImage<2>;
+    auto options = MipmapOptions{MipmapFilter::Lanczos};
+
+    auto clamped = BorderedImage::addBorder(BorderedImage::BorderNone{}, image);
+    auto wrapped = BorderedImage::addBorder(BorderedImage::BorderWrapPositive{}, image);
+    clamped.generateMipmaps(3, options);
+    wrapped.generateMipmaps(3, options);
+
+    REQUIRE(clamped.mipmapLevels() == 3);
+    REQUIRE(wrapped.mipmapLevels() == 3);
+    CHECK(&clamped.mipmap(0) == &clamped.image());
+    CHECK(wrapped.mipmap(1).size() == dmath::svec2(8, 8));
+
+    CHECK(clamped.mipmap(1)[dmath::svec2(0, 4)][0] == 0);
+    CHECK(wrapped.mipmap(1)[dmath::svec2(0, 4)][0] > 0);
+    CHECK(clamped.mipmap(1)[dmath::svec2(7, 4)][0] == 255);
+
+    SECTION("Existing levels are kept, unless more are requested.")
+    {
+        const auto* level = &wrapped.mipmap(1);
+        wrapped.generateMipmaps(2);
+        CHECK(&wrapped.mipmap(1) == level);
+        wrapped.generateMipmaps(4);
+        CHECK(wrapped.mipmapLevels() == 4);
+    }
+    SECTION("Levels past a single pixel stay at a single pixel, so that exactly the requested levels exist.")
+    {
+        wrapped.generateMipmaps(8);
+        REQUIRE(wrapped.mipmapLevels() == 8);
+        CHECK(wrapped.mipmap(4).size() == dmath::svec2(1, 1));
+        CHECK(wrapped.mipmap(7).size() == dmath::svec2(1, 1));
+        CHECK(wrapped.mipmap(7)[dmath::svec2(0, 0)] == wrapped.mipmap(4)[dmath::svec2(0, 0)]);
+    }
+    SECTION("Freeing the image also frees all mipmaps.")
+    {
+        wrapped.free();
+        CHECK(wrapped.mipmapLevels() == 1);
+    }
+}
+
+TEST_CASE("Mipmap generation can be benchmarked on 4K images.", "[.][image][mipmaps][benchmark]")
+{
+    auto image = randomImage<dgl::Image2D>(dmath::svec2(4096, 4096));
+    auto levels = dgl::maxMipmapLevels(image.size());
+
+    BENCHMARK("box") { return dgl::generateMipmaps(image, levels); };
+    BENCHMARK("box, gamma correct") { return dgl::generateMipmaps(image, levels, {MipmapFilter::Box, true}); };
+    BENCHMARK("Kaiser") { return dgl::generateMipmaps(image, levels, {MipmapFilter::Kaiser}); };
+    BENCHMARK("Lanczos") { return dgl::generateMipmaps(image, levels, {MipmapFilter::Lanczos}); };
+}
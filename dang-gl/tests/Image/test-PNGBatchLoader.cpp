@@ -0,0 +1,195 @@
+#include "dang-gl/Image/BorderedImage.h"
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/PNGBatchLoader.h"
+#include "dang-gl/Image/PNGLoader.h"
+#include "dang-utils/parallel.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_message.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+namespace fs = std::filesystem;
+
+namespace {
+
+/// @brief Returns all .png files of the PngSuite, sorted by name.
+std::vector<fs::path> pngSuitePaths()
+{
+    std::vector<fs::path> result;
+    for (const auto& entry : fs::directory_iterator("PngSuite"))
+        if (entry.is_regular_file() && entry.path().extension() == ".png")
+            result.push_back(entry.path());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// @brief Files starting with an "x" are corrupted on purpose.
+bool shouldFail(const fs::path& path) { return path.filename().string().find("x") == 0; }
+
+template <typename TImage>
+bool sameImage(const TImage& lhs, const TImage& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (const auto& pos : typename TImage::Bounds(lhs.size()))
+        if (lhs[pos] != rhs[pos])
+            return false;
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("PNGBatchLoader loads the same images as Image::loadFromPNG.", "[image][png]")
+{
+    using PNGBatchLoader = dgl::PNGBatchLoader<>;
+
+    auto paths = pngSuitePaths();
+    dutils::ThreadPool thread_pool(4);
+    PNGBatchLoader batch_loader(thread_pool);
+
+    dmath::svec2 pad_low(1, 2);
+    dmath::svec2 pad_high(3, 0);
+    auto results = batch_loader.load(paths, {true, pad_low, pad_high});
+    REQUIRE(results.size() == paths.size());
+
+    std::size_t failed_count = 0;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        INFO("Loading " << paths[i].filename().string());
+        if (shouldFail(paths[i])) {
+            CHECK_THROWS_AS(results[i].get(), dgl::PNGError);
+            failed_count++;
+            continue;
+        }
+        std::ifstream stream(paths[i], std::ios::binary);
+        auto expected = dgl::Image2D::loadFromPNG(stream, pad_low, pad_high);
+        auto result = results[i].get();
+        CHECK(result.name == paths[i].string());
+        CHECK(sameImage(result.image, expected));
+    }
+
+    batch_loader.wait();
+    auto stats = batch_loader.stats();
+    CHECK(stats.file_count == paths.size() - failed_count);
+    CHECK(stats.failed_count == failed_count);
+    CHECK(stats.decode_time.count() > 0);
+    CHECK(stats.filesPerSecond() > 0.0);
+
+    batch_loader.resetStats();
+    CHECK(batch_loader.stats().file_count == 0);
+}
+
+TEST_CASE("PNGBatchLoader can report results using a callback.", "[image][png]")
+{
+    auto paths = pngSuitePaths();
+    std::mutex mutex;
+    std::set<std::string> loaded;
+    std::size_t failed_count = 0;
+
+    dgl::PNGBatchLoader<dgl::PixelFormat::RGB, 1> batch_loader;
+    batch_loader.load(paths, [&](auto result) {
+        try {
+            auto name = result.get().name;
+            std::scoped_lock lock(mutex);
+            loaded.insert(std::move(name));
+        }
+        catch (const dgl::PNGError&) {
+            std::scoped_lock lock(mutex);
+            failed_count++;
+        }
+    });
+    batch_loader.wait();
+
+    std::size_t expected_failed_count = 0;
+    for (const auto& path : paths) {
+        if (shouldFail(path))
+            expected_failed_count++;
+        else
+            CHECK(loaded.count(path.string()) == 1);
+    }
+    CHECK(failed_count == expected_failed_count);
+}
+
+TEST_CASE("PNGBatchLoader can load streams and add borders.", "[image][png]")
+{
+    using PNGBatchLoader = dgl::PNGBatchLoader<>;
+
+    auto paths = pngSuitePaths();
+    auto path = std::find_if_not(paths.begin(), paths.end(), shouldFail);
+    REQUIRE(path != paths.end());
+
+    std::ifstream expected_stream(*path, std::ios::binary);
+    auto expected = dgl::Image2D::loadFromPNG(expected_stream);
+
+    PNGBatchLoader batch_loader;
+    std::ifstream stream(*path, std::ios::binary);
+    auto result = batch_loader.load(stream, "stream").get();
+    CHECK(result.name == "stream");
+    CHECK(sameImage(result.image, expected));
+
+    auto border = GENERATE(PNGBatchLoader::Border(PNGBatchLoader::BorderedImage::BorderNone{}),
+                           PNGBatchLoader::Border(PNGBatchLoader::BorderedImage::BorderSolid{dgl::Pixel<>(1, 2, 3, 4)}),
+                           PNGBatchLoader::Border(PNGBatchLoader::BorderedImage::BorderWrapBoth{}),
+                           PNGBatchLoader::Border(PNGBatchLoader::BorderedImage::BorderWrapPositive{}));
+    CAPTURE(border.index());
+    auto bordered = batch_loader.loadBordered(*path, border).get();
+    auto expected_bordered = PNGBatchLoader::BorderedImage::addBorder(border, expected);
+    CHECK(bordered.image.padding() == expected_bordered.padding());
+    CHECK(sameImage(bordered.image.image(), expected_bordered.image()));
+}
+
+TEST_CASE("PNGBatchLoader reports warnings in the result.", "[image][png]")
+{
+    dgl::Image2D image(dmath::svec2(5, 3), dgl::Pixel<>(1, 2, 3, 4));
+    std::stringstream written;
+    image.saveToPNG(written);
+
+    // An ancillary chunk with a broken CRC is only worth a warning and gets skipped.
+    using namespace std::literals;
+    auto png = written.str();
+    png.insert(png.find("IEND") - 4, "\0\0\0\4tEXta\0bc\0\0\0\0"s);
+    std::stringstream stream(png);
+
+    dgl::PNGBatchLoader<> batch_loader;
+    auto result = batch_loader.load(stream, "stream").get();
+    CHECK(sameImage(result.image, image));
+    CHECK(!result.warnings.empty());
+}
+
+TEST_CASE("PNGBatchLoader can be benchmarked against loading one file after another.", "[.][image][png][benchmark]")
+{
+    auto paths = pngSuitePaths();
+    paths.erase(std::remove_if(paths.begin(), paths.end(), shouldFail), paths.end());
+
+    BENCHMARK("Image::loadFromPNG")
+    {
+        std::size_t pixel_count = 0;
+        for (const auto& path : paths)
+            pixel_count += dgl::Image2D::loadFromPNG(path).count();
+        return pixel_count;
+    };
+
+    BENCHMARK("PNGBatchLoader")
+    {
+        dgl::PNGBatchLoader<> batch_loader;
+        std::size_t pixel_count = 0;
+        for (auto& result : batch_loader.load(paths))
+            pixel_count += result.get().image.count();
+        return pixel_count;
+    };
+
+    dgl::PNGBatchLoader<> batch_loader;
+    for (auto& result : batch_loader.load(paths))
+        result.get();
+    batch_loader.wait();
+    auto stats = batch_loader.stats();
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    auto decode_time = std::chrono::duration_cast<Milliseconds>(stats.decode_time).count();
+    auto elapsed_time = std::chrono::duration_cast<Milliseconds>(stats.elapsed_time).count();
+    WARN(stats.file_count << " files with " << stats.pixel_count << " pixels, decoded in " << decode_time << " ms over "
+                          << elapsed_time << " ms: " << stats.filesPerSecond() << " files/s, "
+                          << stats.megapixelsPerSecond() << " MP/s");
+}
@@ -1,5 +1,8 @@
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/MappedFile.h"
 #include "dang-gl/Image/PNGLoader.h"
 
+#include "catch2/benchmark/catch_benchmark.hpp"
 #include "catch2/catch_message.hpp"
 #include "catch2/catch_template_test_macros.hpp"
 #include "catch2/catch_test_macros.hpp"
@@ -72,3 +75,140 @@ TEMPLATE_TEST_CASE_SIG("PNGLoader can read .png images in any format.",
     loadImages<format, 4>();
     loadImages<format, 8>();
 }
+
+TEST_CASE("PNGLoader reads PNGs from memory the same as from streams.", "[image]")
+{
+    for (const auto& entry : fs::directory_iterator("PngSuite")) {
+        const auto& path = entry.path();
+        if (!entry.is_regular_file() || path.extension() != ".png")
+            continue;
+
+        const auto& filename = path.filename().string();
+        INFO("Loading " << filename);
+
+        dgl::MappedFile file(path);
+        REQUIRE(file);
+        CHECK(file.size() == fs::file_size(path));
+
+        dgl::PNGLoader data_loader;
+        dgl::PNGLoader stream_loader;
+        std::ifstream stream(path, std::ios::binary);
+
+        if (filename.find("x") == 0) {
+            CHECK_THROWS_AS((data_loader.init(file.data()), data_loader.read()), dgl::PNGError);
+            continue;
+        }
+
+        data_loader.init(file.data());
+        stream_loader.init(stream);
+        REQUIRE(data_loader.size() == stream_loader.size());
+
+        auto byte_count = dgl::Image2D(data_loader.size()).byteCount();
+        auto data = data_loader.read();
+        auto expected = stream_loader.read();
+        CHECK(std::memcmp(data.get(), expected.get(), byte_count) == 0);
+    }
+}
+
+TEST_CASE("PNGLoader can read PNGs into given buffers and in bands of rows.", "[image]")
+{
+    auto flip = GENERATE(false, true);
+    auto band_rows = GENERATE(as<std::size_t>(), 1, 7, 100000);
+    CAPTURE(flip, band_rows);
+
+    for (const auto& entry : fs::directory_iterator("PngSuite")) {
+        const auto& path = entry.path();
+        if (!entry.is_regular_file() || path.extension() != ".png" || path.filename().string().find("x") == 0)
+            continue;
+
+        INFO("Loading " << path.filename().string());
+
+        dgl::MappedFile file(path);
+        REQUIRE(file);
+
+        dgl::PNGLoader expected_loader(file.data());
+        auto size = expected_loader.size();
+        auto stride = dgl::Image2D(size).alignedByteWidth();
+        auto byte_count = dgl::Image2D(size).byteCount();
+        auto expected = expected_loader.read(flip);
+
+        // Reading into a buffer with a bigger stride leaves the padding untouched.
+        auto padded_stride = stride + 12;
+        std::vector<std::byte> padded(size.y() * padded_stride, std::byte{0xCD});
+        dgl::PNGLoader(file.data()).readInto(padded, padded_stride, flip);
+        for (std::size_t y = 0; y < size.y(); y++) {
+            auto row = padded.begin() + y * padded_stride;
+            CHECK(std::equal(row, row + size.x() * 4, &expected[y * stride]));
+            CHECK(std::all_of(row + size.x() * 4, row + padded_stride, [](auto b) { return b == std::byte{0xCD}; }));
+        }
+
+        std::vector<std::byte> too_small(byte_count - 1);
+        CHECK_THROWS_AS(dgl::PNGLoader(file.data()).readInto(too_small, stride, flip), dgl::PNGError);
+        CHECK_THROWS_AS(dgl::PNGLoader(file.data()).readInto(padded, size.x() * 4 - 1, flip), dgl::PNGError);
+
+        // Bands of rows cover each row exactly once.
+        std::vector<std::byte> data(byte_count);
+        std::vector<int> covered(size.y());
+        dgl::PNGLoader(file.data()).readRows(
+            [&](const dgl::PNGRowBand& band) {
+                CHECK(band.row_count <= band_rows);
+                CHECK(band.stride == stride);
+                REQUIRE(band.first_row + band.row_count <= size.y());
+                REQUIRE(band.data.size() == band.row_count * band.stride);
+                std::copy(band.data.begin(), band.data.end(), data.begin() + band.first_row * stride);
+                for (std::size_t row = 0; row < band.row_count; row++)
+                    covered[band.first_row + row]++;
+            },
+            band_rows,
+            flip);
+
+        CHECK(std::all_of(covered.begin(), covered.end(), [](int count) { return count == 1; }));
+        CHECK(std::memcmp(data.data(), expected.get(), byte_count) == 0);
+    }
+}
+
+TEST_CASE("MappedFile reports files that cannot be opened.", "[image]")
+{
+    CHECK_FALSE(dgl::MappedFile("PngSuite/does-not-exist.png"));
+    CHECK_FALSE(dgl::MappedFile());
+    CHECK_THROWS_AS(dgl::Image2D::loadFromPNG(fs::path("PngSuite/does-not-exist.png")), dgl::PNGError);
+
+    auto empty_path = fs::temp_directory_path() / "dang-gl-empty.png";
+    std::ofstream(empty_path).close();
+    dgl::MappedFile empty(empty_path);
+    CHECK(empty);
+    CHECK(empty.data().empty());
+    CHECK_THROWS_AS(dgl::Image2D::loadFromPNG(empty_path), dgl::PNGError);
+
+    auto moved = std::move(empty);
+    CHECK(moved);
+    CHECK_FALSE(empty);
+    fs::remove(empty_path);
+}
+
+TEST_CASE("Loading PNGs from streams and memory-mapped files can be benchmarked.", "[.][image][benchmark]")
+{
+    std::vector<fs::path> paths;
+    for (const auto& entry : fs::directory_iterator("PngSuite"))
+        if (entry.is_regular_file() && entry.path().extension() == ".png" &&
+            entry.path().filename().string().find("x") != 0)
+            paths.push_back(entry.path());
+
+    BENCHMARK("std::ifstream")
+    {
+        std::size_t pixel_count = 0;
+        for (const auto& path : paths) {
+            std::ifstream stream(path, std::ios::binary);
+            pixel_count += dgl::Image2D::loadFromPNG(stream).count();
+        }
+        return pixel_count;
+    };
+
+    BENCHMARK("MappedFile")
+    {
+        std::size_t pixel_count = 0;
+        for (const auto& path : paths)
+            pixel_count += dgl::Image2D::loadFromPNG(path).count();
+        return pixel_count;
+    };
+}
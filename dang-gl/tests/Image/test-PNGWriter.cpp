@@ -0,0 +1,136 @@
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/PNGLoader.h"
+#include "dang-gl/Image/PNGWriter.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+namespace fs = std::filesystem;
+
+namespace {
+
+/// @brief Creates an image with a gradient and some noise, so that all filters have something to work with.
+template <typename TImage>
+TImage patternImage(const dmath::svec2& size)
+{
+    TImage result(size);
+    dutils::SampleGenerator generator{1};
+    for (const auto& pos : dmath::sbounds2(size)) {
+        auto noise = generator.next();
+        typename TImage::Pixel pixel;
+        for (std::size_t i = 0; i < pixel.size(); i++)
+            pixel[i] = static_cast<GLubyte>(pos.x() * (i + 1) + pos.y() * 3 + (noise >> 28));
+        result[pos] = pixel;
+    }
+    return result;
+}
+
+template <typename TImage>
+bool sameImage(const TImage& lhs, const TImage& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (const auto& pos : dmath::sbounds2(lhs.size()))
+        if (lhs[pos] != rhs[pos])
+            return false;
+    return true;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("PNGWriter writes images, which PNGLoader reads back the same.",
+                   "[image][png]",
+                   dgl::Image2D,
+                   (dgl::Image<2, dgl::PixelFormat::RGB>),
+                   (dgl::Image<2, dgl::PixelFormat::BGRA>),
+                   (dgl::Image<2, dgl::PixelFormat::BGR, dgl::PixelType::UNSIGNED_BYTE, 1>),
+                   (dgl::Image<2, dgl::PixelFormat::RG>),
+                   (dgl::Image<2, dgl::PixelFormat::RED>))
+{
+    auto image = patternImage<TestType>({37, 11});
+
+    auto options = GENERATE(dgl::PNGWriteOptions{},
+                            dgl::PNGWriteOptions::fast(),
+                            dgl::PNGWriteOptions{0, dgl::PNGWriteFilter::None},
+                            dgl::PNGWriteOptions{9, dgl::PNGWriteFilter::Paeth, dgl::PNGWriteStrategy::Filtered},
+                            dgl::PNGWriteOptions{5, dgl::PNGWriteFilter::Up, dgl::PNGWriteStrategy::HuffmanOnly},
+                            dgl::PNGWriteOptions{3, dgl::PNGWriteFilter::Average, dgl::PNGWriteStrategy::Fixed});
+    CAPTURE(options.compression_level, options.filter, options.strategy);
+
+    std::stringstream stream;
+    CHECK(image.saveToPNG(stream, options).empty());
+    CHECK(sameImage(TestType::loadFromPNG(stream), image));
+}
+
+TEST_CASE("PNGWriter can write images without flipping them.", "[image][png]")
+{
+    auto image = patternImage<dgl::Image2D>({5, 3});
+
+    std::stringstream stream;
+    dgl::PNGWriteOptions options;
+    options.flip = false;
+    dgl::PNGWriter().write(stream, image, options);
+
+    dgl::PNGLoader png_loader(stream);
+    auto data = png_loader.read(false);
+    CHECK(std::memcmp(data.get(), image.data(), image.byteCount()) == 0);
+}
+
+TEST_CASE("PNGWriter reports errors as PNGError.", "[image][png]")
+{
+    auto image = patternImage<dgl::Image2D>({5, 3});
+
+    dgl::PNGWriteOptions options;
+    options.compression_level = 10;
+    std::stringstream stream;
+    CHECK_THROWS_AS(image.saveToPNG(stream, options), dgl::PNGError);
+    CHECK_THROWS_AS(dgl::Image2D().saveToPNG(stream), dgl::PNGError);
+    CHECK_THROWS_AS(image.saveToPNG(fs::path("does-not-exist/image.png")), dgl::PNGError);
+}
+
+TEST_CASE("PNGWriter can write images on a thread pool.", "[image][png]")
+{
+    auto image = patternImage<dgl::Image2D>({64, 32});
+    auto path = fs::temp_directory_path() / "dang-gl-async.png";
+
+    auto result = dgl::writePNGAsync(path, image, dgl::PNGWriteOptions::fast());
+    CHECK(result.get().empty());
+    CHECK(sameImage(dgl::Image2D::loadFromPNG(path), image));
+    fs::remove(path);
+
+    CHECK_THROWS_AS(dgl::writePNGAsync(fs::path("does-not-exist/image.png"), image).get(), dgl::PNGError);
+}
+
+TEST_CASE("PNGWriter can be benchmarked.", "[.][image][png][benchmark]")
+{
+    auto image = patternImage<dgl::Image2D>({1024, 1024});
+
+    BENCHMARK("default")
+    {
+        std::stringstream stream;
+        image.saveToPNG(stream);
+        return stream.tellp();
+    };
+
+    BENCHMARK("fast")
+    {
+        std::stringstream stream;
+        image.saveToPNG(stream, dgl::PNGWriteOptions::fast());
+        return stream.tellp();
+    };
+
+    BENCHMARK("uncompressed")
+    {
+        std::stringstream stream;
+        image.saveToPNG(stream, {0, dgl::PNGWriteFilter::None});
+        return stream.tellp();
+    };
+}
@@ -0,0 +1,151 @@
+#include "dang-gl/Image/Image.h"
+#include "dang-gl/Image/PixelFormat.h"
+#include "dang-gl/Image/QOI.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+namespace fs = std::filesystem;
+
+namespace {
+
+/// @brief Creates an image with runs, small differences and noise, so that every QOI op is used.
+template <typename TImage>
+TImage patternImage(const dmath::svec2& size)
+{
+    TImage result(size);
+    dutils::SampleGenerator generator{1};
+    for (const auto& pos : dmath::sbounds2(size)) {
+        auto noise = generator.next();
+        typename TImage::Pixel pixel;
+        for (std::size_t i = 0; i < pixel.size(); i++) {
+            switch (pos.y() % 4) {
+            case 0:
+                pixel[i] = 42;
+                break;
+            case 1:
+                pixel[i] = static_cast<GLubyte>(pos.x() * (i + 1));
+                break;
+            case 2:
+                pixel[i] = static_cast<GLubyte>(pos.x() * (i + 1) * 9);
+                break;
+            default:
+                pixel[i] = static_cast<GLubyte>(noise >> (8 + i * 4));
+            }
+        }
+        result[pos] = pixel;
+    }
+    return result;
+}
+
+template <typename TImage>
+bool sameImage(const TImage& lhs, const TImage& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (const auto& pos : dmath::sbounds2(lhs.size()))
+        if (lhs[pos] != rhs[pos])
+            return false;
+    return true;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("QOI encodes images, which decode back the same.",
+                   "[image][qoi]",
+                   dgl::Image2D,
+                   (dgl::Image<2, dgl::PixelFormat::RGB>),
+                   (dgl::Image<2, dgl::PixelFormat::BGRA>),
+                   (dgl::Image<2, dgl::PixelFormat::BGR, dgl::PixelType::UNSIGNED_BYTE, 1>))
+{
+    for (auto size : {dmath::svec2(1, 1), dmath::svec2(200, 9), dmath::svec2(63, 64)}) {
+        CAPTURE(size);
+        auto image = patternImage<TestType>(size);
+        CHECK(sameImage(dgl::decodeQOI<TestType>(dgl::encodeQOI(image)), image));
+        CHECK(sameImage(dgl::decodeQOI<TestType>(dgl::encodeQOI(image, false), false), image));
+    }
+    CHECK(dgl::decodeQOI<TestType>(dgl::encodeQOI(TestType())).size() == dmath::svec2());
+}
+
+TEST_CASE("QOI matches the reference encoding.", "[image][qoi]")
+{
+    // A run of the initial color, small differences back and forth and an index into a previous color.
+    dgl::Image2D image(dmath::svec2(6, 1), dgl::Pixel<>(0, 0, 0, 255));
+    image[{3, 0}] = dgl::Pixel<>(1, 0, 255, 255);
+    image[{5, 0}] = dgl::Pixel<>(1, 0, 255, 255);
+
+    auto qoi = dgl::encodeQOI(image);
+    std::vector<std::uint8_t> expected{'q', 'o', 'i', 'f', 0, 0, 0, 6, 0, 0, 0, 1, 4, 0};
+    expected.insert(expected.end(), {0xC2, 0x40 | 3 << 4 | 2 << 2 | 1, 0x40 | 1 << 4 | 2 << 2 | 3, 0x00 | 49});
+    expected.insert(expected.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+    REQUIRE(qoi.size() == expected.size());
+    CHECK(std::equal(expected.begin(), expected.end(), reinterpret_cast<const std::uint8_t*>(qoi.data())));
+}
+
+TEST_CASE("QOI adds or removes alpha when decoding into a different format.", "[image][qoi]")
+{
+    auto rgb = patternImage<dgl::Image<2, dgl::PixelFormat::RGB>>({17, 5});
+    auto rgba = dgl::decodeQOI<dgl::Image2D>(dgl::encodeQOI(rgb));
+    for (const auto& pos : dmath::sbounds2(rgb.size()))
+        REQUIRE(rgba[pos] == dgl::Pixel<>(rgb[pos].x(), rgb[pos].y(), rgb[pos].z(), 255));
+}
+
+TEST_CASE("QOI reports invalid data as QOIError.", "[image][qoi]")
+{
+    auto qoi = dgl::encodeQOI(patternImage<dgl::Image2D>({16, 16}));
+
+    CHECK_THROWS_AS(dgl::decodeQOI<dgl::Image2D>(std::span(qoi).first(10)), dgl::QOIError);
+
+    auto truncated = qoi;
+    truncated.erase(truncated.begin() + 100, truncated.end() - 8);
+    CHECK_THROWS_AS(dgl::decodeQOI<dgl::Image2D>(truncated), dgl::QOIError);
+
+    auto bad_magic = qoi;
+    bad_magic[0] = std::byte{'x'};
+    CHECK_THROWS_AS(dgl::decodeQOI<dgl::Image2D>(bad_magic), dgl::QOIError);
+
+    auto bad_channels = qoi;
+    bad_channels[12] = std::byte{2};
+    CHECK_THROWS_AS(dgl::decodeQOI<dgl::Image2D>(bad_channels), dgl::QOIError);
+
+    auto huge = qoi;
+    std::fill(huge.begin() + 4, huge.begin() + 12, std::byte{0xFF});
+    CHECK_THROWS_AS(dgl::decodeQOI<dgl::Image2D>(huge), dgl::QOIError);
+
+    CHECK_THROWS_AS(dgl::Image2D::loadFromQOI("does-not-exist.qoi"), dgl::QOIError);
+}
+
+TEST_CASE("QOI images can be saved to and loaded from files.", "[image][qoi]")
+{
+    auto image = patternImage<dgl::Image2D>({31, 7});
+    auto path = fs::temp_directory_path() / "dang-gl-image.qoi";
+    image.saveToQOI(path);
+    CHECK(sameImage(dgl::Image2D::loadFromQOI(path), image));
+    fs::remove(path);
+}
+
+TEST_CASE("QOI can be benchmarked against PNG.", "[.][image][qoi][benchmark]")
+{
+    auto image = patternImage<dgl::Image2D>({1024, 1024});
+    auto qoi = dgl::encodeQOI(image);
+    std::stringstream png;
+    image.saveToPNG(png, dgl::PNGWriteOptions::fast());
+    auto png_data = png.str();
+    WARN("QOI: " << qoi.size() << " bytes, fast PNG: " << png_data.size() << " bytes");
+
+    BENCHMARK("encode QOI") { return dgl::encodeQOI(image); };
+    BENCHMARK("decode QOI") { return dgl::decodeQOI<dgl::Image2D>(qoi); };
+    BENCHMARK("encode fast PNG")
+    {
+        std::stringstream stream;
+        image.saveToPNG(stream, dgl::PNGWriteOptions::fast());
+        return stream.tellp();
+    };
+    BENCHMARK("decode PNG") { return dgl::Image2D::loadFromPNG(std::as_bytes(std::span(png_data))); };
+}
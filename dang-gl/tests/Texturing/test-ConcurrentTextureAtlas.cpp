@@ -0,0 +1,146 @@
+#include "dang-gl/Texturing/ConcurrentTextureAtlas.h"
+#include "dang-gl/Texturing/TextureAtlasBase.h"
+#include "dang-math/vector.h"
+#include "dang-utils/parallel.h"
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dgl = dang::gl;
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+namespace {
+
+/// @brief Only keeps track of its size and how many mipmap levels were generated.
+class ImageData {
+public:
+    explicit ImageData(dmath::svec2 size)
+        : size_(size)
+    {}
+
+    auto padding() const { return dmath::svec2(); }
+
+    explicit operator bool() const { return data_; }
+
+    auto size() const { return size_; }
+
+    void free() { data_ = false; }
+
+    void generateMipmaps(std::size_t levels) { mipmap_levels_ = std::max(mipmap_levels_, levels); }
+
+    auto mipmapLevels() const { return mipmap_levels_; }
+
+private:
+    dmath::svec2 size_;
+    bool data_ = true;
+    std::size_t mipmap_levels_ = 1;
+};
+
+/// @brief Records all uploads instead of modifying an actual texture.
+class RecordingTexture {
+public:
+    using BorderedImageData = ImageData;
+    using TileRegion = dgl::TextureAtlasTiles<ImageData>::TileRegion;
+
+    struct Upload {
+        dgl::ivec3 offset;
+        GLint mipmap_level;
+        std::size_t generated_mipmap_levels;
+    };
+
+    const std::vector<Upload>& uploads() const { return uploads_; }
+
+protected:
+    bool resize(GLsizei, GLsizei, GLsizei) { return false; }
+
+    dgl::TextureAtlasUploads modify(const ImageData& image_data, dgl::ivec3 offset, GLint mipmap_level)
+    {
+        uploads_.push_back({offset, mipmap_level, image_data.mipmapLevels()});
+        return {1, 0};
+    }
+
+    dgl::TextureAtlasUploads modifyRegions(std::span<const TileRegion> regions) { return {regions.size(), 0}; }
+
+    void copy(dgl::ivec3, dgl::ivec3, dgl::svec2, GLint) {}
+
+private:
+    std::vector<Upload> uploads_;
+};
+
+using Atlas = dgl::TextureAtlasBase<RecordingTexture>;
+using ConcurrentAtlas = dgl::ConcurrentTextureAtlas<Atlas>;
+
+dmath::svec2 tileSize(std::size_t index) { return {4 + index % 5 * 3, 4 + index % 7 * 2}; }
+
+} // namespace
+
+TEST_CASE("ConcurrentTextureAtlas places tiles, that are added from multiple threads.",
+          "[texturing][concurrent-texture-atlas]")
+{
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Grid, dgl::TextureAtlasPacking::Skyline);
+    CAPTURE(packing);
+
+    constexpr std::size_t tile_count = 200;
+    ConcurrentAtlas atlas(Atlas({128, 16, 3, packing}));
+
+    std::vector<std::future<ConcurrentAtlas::TileHandle>> futures;
+    {
+        dutils::ThreadPool thread_pool(4);
+        for (std::size_t index = 0; index < tile_count; index++)
+            futures.push_back(thread_pool.submit([&, index] { return atlas.add(ImageData(tileSize(index))); }));
+    }
+
+    std::vector<ConcurrentAtlas::TileHandle> tiles;
+    for (auto& future : futures)
+        tiles.push_back(future.get());
+
+    auto stats = atlas.updateTexture();
+    CHECK(stats.uploaded_tiles == tile_count);
+
+    atlas.access([&](const Atlas& plain_atlas) {
+        // Mipmaps were already generated by the threads, that added the tiles.
+        const auto& uploads = plain_atlas.uploads();
+        CHECK(uploads.size() == tile_count * 3);
+        for (const auto& upload : uploads)
+            CHECK(upload.generated_mipmap_levels == 3);
+
+        std::set<std::tuple<GLsizei, GLsizei, GLsizei>> placements;
+        for (const auto& tile : tiles) {
+            REQUIRE(plain_atlas.contains(tile));
+            auto [_, unique] = placements.emplace(tile.layer(), tile.pixelPos().x(), tile.pixelPos().y());
+            CHECK(unique);
+        }
+    });
+
+    SECTION("Tiles can also be removed from multiple threads.")
+    {
+        {
+            dutils::ThreadPool thread_pool(4);
+            for (std::size_t index = 0; index < tile_count; index += 2)
+                thread_pool.submit([&, index] { atlas.remove(tiles[index]); });
+        }
+        for (std::size_t index = 0; index < tile_count; index++)
+            CHECK(atlas.contains(tiles[index]) == (index % 2 == 1));
+    }
+}
+
+TEST_CASE("ConcurrentTextureAtlas places tiles just like the atlas itself, when adding them in the same order.",
+          "[texturing][concurrent-texture-atlas]")
+{
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Grid, dgl::TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    Atlas plain_atlas({128, 16, 1, packing});
+    ConcurrentAtlas atlas(Atlas({128, 16, 1, packing}));
+    for (std::size_t index = 0; index < 100; index++) {
+        auto expected = plain_atlas.add(ImageData(tileSize(index)));
+        auto tile = atlas.add(ImageData(tileSize(index)));
+        CHECK(tile.layer() == expected.layer());
+        CHECK(tile.pixelPos() == expected.pixelPos());
+    }
+    CHECK(atlas.generation() == plain_atlas.generation());
+
+    auto frozen = std::move(atlas).freeze();
+    CHECK(frozen.uploads().size() == 100);
+}
@@ -0,0 +1,197 @@
+#include "dang-gl/Image/ImageBorder.h"
+#include "dang-gl/Texturing/TextureAtlasCache.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+namespace dgl = dang::gl;
+namespace fs = std::filesystem;
+
+using Border = dgl::ImageBorder<>;
+
+namespace {
+
+dgl::TextureAtlasCacheLayout testLayout()
+{
+    dgl::TextureAtlasCacheLayout layout;
+    layout.format.max_texture_size = 64;
+    layout.format.max_mipmap_levels = 2;
+    layout.atlas_size = 32;
+    layout.layers = 2;
+    layout.mipmap_levels = 2;
+    auto [border_style, border_color] = dgl::detail::saveBorder(Border(dgl::ImageBorderSolid<>{{1, 2, 3, 4}}));
+    layout.tiles.push_back({{"grass.png", 42}, 0, {0, 0}, {16, 16}, 0, {}});
+    layout.tiles.push_back({{"stone.png", 1337}, 1, {16, 8}, {10, 12}, border_style, border_color});
+    return layout;
+}
+
+std::vector<std::byte> testPixels(std::size_t size, std::size_t seed)
+{
+    std::vector<std::byte> result(size);
+    for (std::size_t index = 0; index < size; index++)
+        result[index] = static_cast<std::byte>(index * 7 + seed);
+    return result;
+}
+
+/// @brief Writes blocks of varying sizes, which are then expected to be read back in the same order.
+void writeTestCache(const fs::path& path, const dgl::TextureAtlasCacheLayout& layout)
+{
+    dgl::TextureAtlasCacheWriter writer(path, layout);
+    for (std::size_t block = 0; block < layout.blockCount(); block++)
+        writer.write(testPixels(block * 5 + 3, block));
+    writer.finish();
+}
+
+} // namespace
+
+TEST_CASE("TextureAtlasCache reads back what TextureAtlasCacheWriter wrote.", "[texturing][texture-atlas-cache]")
+{
+    auto path = fs::temp_directory_path() / "dang-gl-atlas.cache";
+    auto layout = testLayout();
+    writeTestCache(path, layout);
+    CHECK_FALSE(fs::exists(fs::path(path).concat(".tmp")));
+
+    dgl::TextureAtlasCache cache(path);
+    REQUIRE(cache);
+    const auto& read_layout = cache.layout();
+    CHECK(read_layout.format == layout.format);
+    CHECK(read_layout.atlas_size == layout.atlas_size);
+    CHECK(read_layout.layers == layout.layers);
+    CHECK(read_layout.mipmap_levels == layout.mipmap_levels);
+    CHECK(read_layout.compression == layout.compression);
+    REQUIRE(read_layout.tiles.size() == layout.tiles.size());
+    for (std::size_t index = 0; index < layout.tiles.size(); index++) {
+        const auto& tile = read_layout.tiles[index];
+        const auto& expected = layout.tiles[index];
+        CHECK(tile.source.name == expected.source.name);
+        CHECK(tile.source.hash == expected.source.hash);
+        CHECK(tile.layer == expected.layer);
+        CHECK(tile.position == expected.position);
+        CHECK(tile.size == expected.size);
+        CHECK(tile.border_style == expected.border_style);
+        CHECK(tile.border_color == expected.border_color);
+    }
+
+    std::size_t block = 0;
+    for (GLint level = 0; level < layout.mipmap_levels; level++) {
+        for (GLsizei layer = 0; layer < layout.layers; layer++) {
+            auto pixels = cache.pixels(0, level, layer);
+            auto expected = testPixels(block * 5 + 3, block);
+            CHECK(std::equal(pixels.begin(), pixels.end(), expected.begin(), expected.end()));
+            CHECK(reinterpret_cast<std::uintptr_t>(pixels.data()) % 8 == 0);
+            block++;
+        }
+    }
+
+    SECTION("Tiles are only found, as long as their hash did not change.")
+    {
+        CHECK(cache.find({"grass.png", 42}) == &read_layout.tiles[0]);
+        CHECK(cache.find({"stone.png", 1337}) == &read_layout.tiles[1]);
+        CHECK(cache.find({"grass.png", 43}) == nullptr);
+        CHECK(cache.find({"dirt.png", 42}) == nullptr);
+    }
+    SECTION("The cache is only up to date, if it contains exactly the given sources.")
+    {
+        std::vector<dgl::TextureAtlasCacheSource> sources{{"stone.png", 1337}, {"grass.png", 42}};
+        CHECK(cache.upToDate(sources));
+        sources[1].hash = 43;
+        CHECK_FALSE(cache.upToDate(sources));
+        sources.pop_back();
+        CHECK_FALSE(cache.upToDate(sources));
+    }
+
+    cache = {};
+    fs::remove(path);
+}
+
+TEST_CASE("TextureAtlasCache is empty for missing or invalid files.", "[texturing][texture-atlas-cache]")
+{
+    auto path = fs::temp_directory_path() / "dang-gl-atlas-invalid.cache";
+    fs::remove(path);
+    CHECK_FALSE(dgl::TextureAtlasCache(path));
+
+    writeTestCache(path, testLayout());
+    auto size = fs::file_size(path);
+    SECTION("Truncated files are invalid.")
+    {
+        fs::resize_file(path, size - 1);
+        CHECK_FALSE(dgl::TextureAtlasCache(path));
+        fs::resize_file(path, 20);
+        CHECK_FALSE(dgl::TextureAtlasCache(path));
+    }
+    SECTION("Files with a different magic number are invalid.")
+    {
+        {
+            std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+            stream.put('X');
+        }
+        CHECK_FALSE(dgl::TextureAtlasCache(path));
+    }
+    SECTION("Tiles outside of the atlas are invalid.")
+    {
+        auto layout = testLayout();
+        layout.tiles[1].position = {24, 8};
+        writeTestCache(path, layout);
+        CHECK_FALSE(dgl::TextureAtlasCache(path));
+        layout = testLayout();
+        layout.tiles[1].layer = 2;
+        writeTestCache(path, layout);
+        CHECK_FALSE(dgl::TextureAtlasCache(path));
+    }
+    fs::remove(path);
+}
+
+TEST_CASE("TextureAtlasCacheWriter only moves finished caches into place.", "[texturing][texture-atlas-cache]")
+{
+    auto path = fs::temp_directory_path() / "dang-gl-atlas-unfinished.cache";
+    auto temporary_path = fs::path(path).concat(".tmp");
+    fs::remove(path);
+    auto layout = testLayout();
+    {
+        dgl::TextureAtlasCacheWriter writer(path, layout);
+        CHECK(fs::exists(temporary_path));
+        writer.write(testPixels(4, 0));
+        CHECK_THROWS_AS(writer.finish(), std::logic_error);
+        for (std::size_t block = 1; block < layout.blockCount(); block++)
+            writer.write(testPixels(4, block));
+        CHECK_THROWS_AS(writer.write(testPixels(4, 0)), std::logic_error);
+    }
+    CHECK_FALSE(fs::exists(temporary_path));
+    CHECK_FALSE(fs::exists(path));
+}
+
+TEST_CASE("Borders can be saved to and loaded from texture atlas caches.", "[texturing][texture-atlas-cache]")
+{
+    SECTION("Borders without a color only store their style.")
+    {
+        auto [border_style, border_color] = dgl::detail::saveBorder(Border(dgl::ImageBorderWrapBoth()));
+        CHECK(border_style == 2);
+        CHECK(border_color.empty());
+        auto border = dgl::detail::loadBorder<Border>(border_style, border_color);
+        REQUIRE(border);
+        CHECK(std::holds_alternative<dgl::ImageBorderWrapBoth>(*border));
+    }
+    SECTION("Solid borders also store their color.")
+    {
+        auto [border_style, border_color] = dgl::detail::saveBorder(Border(dgl::ImageBorderSolid<>{{1, 2, 3, 4}}));
+        CHECK(border_style == 1);
+        CHECK(border_color.size() == 4);
+        auto border = dgl::detail::loadBorder<Border>(border_style, border_color);
+        REQUIRE(border);
+        REQUIRE(std::holds_alternative<dgl::ImageBorderSolid<>>(*border));
+        CHECK(std::get<dgl::ImageBorderSolid<>>(*border).color == dgl::Pixel<dgl::PixelFormat::RGBA>{1, 2, 3, 4});
+    }
+    SECTION("Unknown styles and colors of the wrong size cannot be loaded.")
+    {
+        std::vector<std::byte> color(3);
+        CHECK_FALSE(dgl::detail::loadBorder<Border>(1, color));
+        CHECK_FALSE(dgl::detail::loadBorder<Border>(0, color));
+        CHECK_FALSE(dgl::detail::loadBorder<Border>(4, {}));
+    }
+}
+
+TEST_CASE("Sources are hashed using FNV-1a.", "[texturing][texture-atlas-cache]")
+{
+    CHECK(dgl::hashTextureAtlasSource({}) == 0xCBF29CE484222325);
+    auto text = std::string_view("a");
+    CHECK(dgl::hashTextureAtlasSource(std::as_bytes(std::span(text))) == 0xAF63DC4C8601EC8C);
+}
@@ -1,9 +1,11 @@
+#include "dang-gl/Image/BorderedImage.h"
 #include "dang-gl/Texturing/TextureAtlasTiles.h"
 #include "dang-math/vector.h"
 #include "dang-utils/catch2-stub-matcher.h"
 #include "dang-utils/stub.h"
 #include "dang-utils/utils.h"
 
+#include "catch2/benchmark/catch_benchmark.hpp"
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/generators/catch_generators.hpp"
 #include "catch2/generators/catch_generators_range.hpp"
@@ -38,6 +40,10 @@ public:
 
     void free() { data_ = false; }
 
+    void generateMipmaps(std::size_t levels) { mipmap_levels_ = levels; }
+
+    auto mipmapLevels() const { return mipmap_levels_; }
+
     bool operator==(const TileData& other) const
     {
         return std::tie(size_, data_) == std::tie(other.size_, other.data_);
@@ -51,6 +57,7 @@ private:
     Size size_;
     Padding padding_;
     bool data_ = false;
+    std::size_t mipmap_levels_ = 1;
 };
 
 using TextureAtlasTiles = dgl::TextureAtlasTiles<TileData>;
@@ -97,6 +104,63 @@ auto freeze(TextureAtlasTiles atlas_tiles)
 
 auto frozenTiles() { return freeze(atlasTiles()); }
 
+/// @brief The bitmap sizes of DejaVu Sans at 32 pixels, covering ASCII, Latin-1, Greek and Cyrillic.
+const std::vector<dgl::svec2> glyph_sizes = {
+    {4, 23}, {9, 9}, {23, 23}, {16, 30}, {28, 23}, {22, 23}, {3, 9}, {8, 29}, {8, 29}, {16, 14}, {21, 21}, {6, 8},
+    {9, 3}, {4, 4}, {11, 26}, {17, 23}, {15, 23}, {16, 23}, {16, 23}, {18, 23}, {16, 23}, {17, 23}, {16, 23}, {17, 23},
+    {17, 23}, {5, 17}, {6, 21}, {21, 17}, {21, 10}, {21, 17}, {13, 23}, {28, 28}, {22, 23}, {17, 23}, {20, 23},
+    {20, 23}, {16, 23}, {14, 23}, {22, 23}, {18, 23}, {4, 23}, {9, 29}, {19, 23}, {15, 23}, {22, 23}, {18, 23},
+    {23, 23}, {16, 23}, {23, 27}, {19, 23}, {17, 23}, {21, 23}, {19, 23}, {22, 23}, {30, 23}, {21, 23}, {21, 23},
+    {20, 23}, {8, 29}, {11, 26}, {7, 29}, {21, 9}, {18, 3}, {9, 6}, {16, 18}, {17, 24}, {15, 18}, {17, 24}, {17, 18},
+    {12, 24}, {17, 25}, {16, 24}, {3, 24}, {7, 31}, {17, 24}, {3, 24}, {27, 18}, {16, 18}, {17, 18}, {17, 25}, {17, 25},
+    {12, 18}, {15, 18}, {12, 23}, {16, 18}, {18, 18}, {24, 18}, {18, 18}, {18, 25}, {15, 18}, {13, 30}, {3, 32},
+    {13, 30}, {21, 7}, {4, 23}, {15, 27}, {16, 23}, {18, 18}, {19, 23}, {3, 28}, {14, 26}, {10, 3}, {24, 23}, {12, 17},
+    {15, 14}, {21, 9}, {9, 3}, {24, 23}, {10, 3}, {10, 10}, {21, 20}, {10, 13}, {11, 13}, {9, 6}, {18, 25}, {15, 26},
+    {4, 4}, {8, 6}, {10, 13}, {13, 17}, {15, 14}, {28, 23}, {27, 23}, {29, 23}, {13, 25}, {22, 30}, {22, 30}, {22, 30},
+    {22, 30}, {22, 29}, {22, 30}, {30, 23}, {20, 29}, {16, 30}, {16, 30}, {16, 30}, {16, 29}, {7, 30}, {7, 30},
+    {11, 30}, {10, 29}, {23, 23}, {18, 30}, {23, 30}, {23, 30}, {23, 30}, {23, 30}, {23, 29}, {19, 18}, {23, 25},
+    {19, 30}, {19, 30}, {19, 30}, {19, 29}, {21, 30}, {16, 23}, {17, 24}, {16, 26}, {16, 26}, {16, 26}, {16, 25},
+    {16, 24}, {16, 29}, {29, 18}, {15, 24}, {17, 26}, {17, 26}, {17, 26}, {17, 24}, {8, 26}, {8, 26}, {11, 26},
+    {11, 24}, {17, 24}, {16, 25}, {17, 26}, {17, 26}, {17, 26}, {17, 25}, {17, 24}, {21, 17}, {18, 22}, {16, 26},
+    {16, 26}, {16, 26}, {16, 24}, {18, 33}, {17, 31}, {18, 31}, {22, 23}, {17, 23}, {15, 23}, {22, 23}, {16, 23},
+    {20, 23}, {18, 23}, {23, 23}, {4, 23}, {19, 23}, {22, 23}, {22, 23}, {18, 23}, {15, 23}, {23, 23}, {18, 23},
+    {16, 23}, {16, 23}, {21, 23}, {21, 23}, {23, 23}, {21, 23}, {23, 23}, {23, 23}, {10, 29}, {21, 29}, {19, 26},
+    {14, 26}, {16, 33}, {9, 26}, {15, 33}, {19, 18}, {16, 31}, {18, 25}, {17, 24}, {14, 18}, {15, 31}, {16, 25},
+    {17, 24}, {8, 18}, {17, 18}, {18, 24}, {18, 25}, {16, 18}, {16, 31}, {17, 18}, {18, 18}, {17, 25}, {15, 25},
+    {19, 18}, {17, 18}, {15, 19}, {19, 25}, {18, 25}, {19, 25}, {23, 18}, {22, 23}, {17, 23}, {17, 23}, {15, 23},
+    {23, 28}, {16, 23}, {34, 23}, {17, 23}, {18, 23}, {18, 30}, {20, 23}, {20, 23}, {22, 23}, {18, 23}, {23, 23},
+    {18, 23}, {16, 23}, {20, 23}, {21, 23}, {19, 23}, {25, 23}, {21, 23}, {21, 28}, {17, 23}, {29, 23}, {31, 28},
+    {25, 23}, {23, 23}, {17, 23}, {20, 23}, {30, 23}, {18, 23}, {16, 18}, {17, 25}, {15, 18}, {14, 18}, {20, 22},
+    {17, 18}, {27, 18}, {14, 18}, {16, 18}, {16, 25}, {17, 18}, {17, 18}, {20, 18}, {17, 18}, {17, 18}, {17, 18},
+    {17, 25}, {15, 18}, {18, 18}, {18, 25}, {25, 31}, {18, 18}, {19, 22}, {14, 18}, {25, 18}, {27, 22}, {21, 18},
+    {21, 18}, {15, 18}, {15, 18}, {23, 18}, {16, 18},
+};
+
+/// @brief Scales the glyph sizes, which approximates the same font at a different size.
+std::vector<dgl::svec2> scaledGlyphSizes(GLsizei numerator, GLsizei denominator)
+{
+    std::vector<dgl::svec2> result;
+    for (auto size : glyph_sizes)
+        result.push_back(dgl::svec2((size * numerator + denominator - 1) / denominator));
+    return result;
+}
+
+/// @brief Adds a tile for each size and returns how much of the used layers is covered by the tiles themselves.
+float occupancy(TextureAtlasTiles& atlas_tiles, const std::vector<dgl::svec2>& sizes)
+{
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    GLsizei tile_area = 0;
+    for (auto size : sizes) {
+        tiles.push_back(atlas_tiles.add(TileData(size)));
+        tile_area += size.product();
+    }
+    GLsizei layers = 0;
+    for (const auto& tile : tiles)
+        layers = std::max(layers, tile.layer() + 1);
+    auto atlas_size = tiles.front().atlasPixelSize();
+    return static_cast<float>(tile_area) / static_cast<float>(atlas_size * atlas_size * layers);
+}
+
 auto frozenTilesWithTileHandle()
 {
     auto [atlas_tiles, tile_handle] = atlasTilesWithTileHandle();
@@ -271,6 +335,59 @@ TEST_CASE("TextureAtlasTiles allows arbitrary removal of tiles that were added p
     CHECK(tile_handle);
 }
 
+TEST_CASE("TextureAtlasTiles fills the gaps of removed tiles first.", "[texturing][texture-atlas-tiles]")
+{
+    auto atlas_tiles = TextureAtlasTiles({8, 3});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (int i = 0; i < 8; i++)
+        tiles.push_back(atlas_tiles.add(tileData()));
+    auto other_size_tile = atlas_tiles.add(TileData(dgl::svec2(8)));
+
+    CHECK(tiles[3].layer() == 0);
+    CHECK(tiles[4].layer() == 1);
+    CHECK(other_size_tile.layer() == 2);
+
+    SECTION("Gaps are filled starting with the lowest layer and the lowest position.")
+    {
+        auto first_gap = tiles[5].pixelPos();
+        atlas_tiles.remove(tiles[6]);
+        atlas_tiles.remove(tiles[5]);
+        atlas_tiles.remove(tiles[2]);
+
+        auto tile = atlas_tiles.add(tileData());
+        CHECK(tile.layer() == 0);
+        CHECK(tile.pixelPos() == tiles[2].pixelPos());
+        tile = atlas_tiles.add(tileData());
+        CHECK(tile.layer() == 1);
+        CHECK(tile.pixelPos() == first_gap);
+    }
+    SECTION("Tiles that fill a gap are uploaded as well.")
+    {
+        atlas_tiles.remove(tiles[1]);
+        auto tile = atlas_tiles.add(tileData());
+
+        dutils::Stub<void(const TileData&, dgl::ivec3, GLint)> modify;
+        atlas_tiles.updateTexture([](GLsizei, GLsizei, GLsizei) { return true; }, modify);
+        CHECK_THAT(modify, Called(9));
+        auto uploaded = std::any_of(modify.invocations().begin(), modify.invocations().end(), [&](const auto& args) {
+            return std::get<1>(args) == dgl::ivec3(tile.pixelPos().x(), tile.pixelPos().y(), 0);
+        });
+        CHECK(uploaded);
+    }
+    SECTION("Layers that become empty are removed, while free space on the remaining layers can still be found.")
+    {
+        for (int i = 0; i < 4; i++)
+            atlas_tiles.remove(tiles[i]);
+        CHECK(tiles[4].layer() == 0);
+        CHECK(other_size_tile.layer() == 1);
+
+        atlas_tiles.remove(tiles[7]);
+        CHECK(atlas_tiles.add(tileData()).layer() == 0);
+        CHECK(atlas_tiles.add(tileData()).layer() == 2);
+        CHECK_THROWS_AS(atlas_tiles.add(TileData(dgl::svec2(8))), std::length_error);
+    }
+}
+
 TEST_CASE("TextureAtlasTiles can be filled with tiles of the same size, spanning multiple layers.",
           "[texturing][texture-atlas-tiles]")
 {
@@ -371,6 +488,640 @@ TEST_CASE("TextureAtlasTiles can be used to update a texture.", "[texturing]")
     }
 }
 
+TEST_CASE("TextureAtlasTiles uploads all mipmap levels of each tile.", "[texturing]")
+{
+    auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    resize.setInfo({"resize", {"required_size", "layer_count", "mipmap_levels"}});
+
+    dutils::Stub<void(const TileData&, dgl::ivec3, GLint)> modify;
+    modify.setInfo({"modify", {"tile_data", "offset", "mipmap_level"}});
+
+    auto max_mipmap_levels = GENERATE(1, 2, 3, 8);
+    CAPTURE(max_mipmap_levels);
+
+    auto atlas_tiles = TextureAtlasTiles({16, 2, max_mipmap_levels});
+    (void)atlas_tiles.add(TileData(TileData::Size(4)));
+    auto first_small_tile = atlas_tiles.add(TileData(TileData::Size(2, 4)));
+    auto small_tile = atlas_tiles.add(TileData(TileData::Size(2, 4)));
+
+    // The smallest tiles have a width of 2 and therefore only allow for 2 levels.
+    auto levels = std::min(max_mipmap_levels, 2);
+    CHECK(atlas_tiles.mipmapLevels() == levels);
+
+    atlas_tiles.updateTexture(resize, modify);
+
+    CHECK_THAT(resize, CalledWith(4, 2, levels));
+    CHECK_THAT(modify, Called(3 * levels));
+
+    for (const auto& [tile_data, offset, mipmap_level] : modify.invocations()) {
+        CHECK(tile_data.mipmapLevels() == static_cast<std::size_t>(levels));
+        CHECK(mipmap_level < levels);
+    }
+
+    auto [small_data, small_offset, small_level] = modify.invocations().back();
+    CHECK(small_tile.pixelPos() == dgl::svec2(2, 0));
+    CHECK(small_level == levels - 1);
+    CHECK(small_offset == dgl::ivec3(2 >> (levels - 1), 0, 1));
+
+    SECTION("Removing the smallest tiles allows for more levels again.")
+    {
+        atlas_tiles.remove(first_small_tile);
+        atlas_tiles.remove(small_tile);
+        CHECK(atlas_tiles.mipmapLevels() == std::min(max_mipmap_levels, 3));
+    }
+}
+
+TEST_CASE("TextureAtlasTiles uploads all mipmap levels of tiles, whose size is not a power of two.", "[texturing]")
+{
+    using BorderedImage = dgl::BorderedImage<2>;
+    using ImageAtlasTiles = dgl::TextureAtlasTiles<BorderedImage>;
+
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Grid, dgl::TextureAtlasPacking::Skyline);
+    CAPTURE(packing);
+
+    // A 5x5 tile only has three levels on its own, but the 8x8 grid cell has four and packed tiles have eight.
+    auto atlas_tiles = ImageAtlasTiles({256, 4, 8, packing});
+    (void)atlas_tiles.add(BorderedImage(BorderedImage::Image(BorderedImage::Size(5), {255, 0, 0, 255})));
+    auto levels = atlas_tiles.mipmapLevels();
+    CHECK(levels == (packing == dgl::TextureAtlasPacking::Grid ? 4 : 8));
+
+    auto resize = [](GLsizei, GLsizei, GLsizei) { return true; };
+    auto check_levels = [&](const BorderedImage& image) {
+        REQUIRE(image.mipmapLevels() == static_cast<std::size_t>(levels));
+        CHECK(image.mipmap(1).size() == dmath::svec2(2, 2));
+        for (auto level = std::size_t{2}; level < image.mipmapLevels(); level++)
+            CHECK(image.mipmap(level).size() == dmath::svec2(1, 1));
+    };
+
+    SECTION("Using the updateTexture method.")
+    {
+        GLint uploaded_levels = 0;
+        atlas_tiles.updateTexture(resize, [&](const BorderedImage& image, dgl::ivec3, GLint mipmap_level) {
+            check_levels(image);
+            CHECK(mipmap_level == uploaded_levels++);
+        });
+        CHECK(uploaded_levels == levels);
+    }
+    SECTION("Using the updateTextureRegions method.")
+    {
+        std::size_t region_count = 0;
+        atlas_tiles.updateTextureRegions(resize, [&](std::span<const ImageAtlasTiles::TileRegion> regions) {
+            for (const auto& region : regions) {
+                REQUIRE(region.tiles.size() == 1);
+                check_levels(*region.tiles[0].bordered_image_data);
+            }
+            region_count += regions.size();
+        });
+        CHECK(region_count == static_cast<std::size_t>(levels));
+    }
+}
+
+TEST_CASE("TextureAtlasTiles only uploads new tiles, as long as resizing keeps the contents of the texture.",
+          "[texturing]")
+{
+    dutils::Stub<void(const TileData&, dgl::ivec3, GLint)> modify;
+    modify.setInfo({"modify", {"tile_data", "offset", "mipmap_level"}});
+
+    auto atlas_tiles = TextureAtlasTiles({16, 4});
+    for (int i = 0; i < 4; i++)
+        (void)atlas_tiles.add(tileData());
+
+    // The stub returns false by default, which means that the texture kept its contents.
+    auto keep = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    auto stats = atlas_tiles.updateTexture(keep, modify);
+    CHECK_THAT(keep, CalledWith(8, 1, 1));
+    CHECK(stats.resized);
+    CHECK_FALSE(stats.contents_lost);
+    CHECK(stats.uploaded_tiles == 4);
+
+    auto tile = atlas_tiles.add(tileData());
+    stats = atlas_tiles.updateTexture(keep, modify);
+    CHECK_THAT(keep, CalledWith(16, 1, 1));
+    CHECK(stats.resized);
+    CHECK(stats.uploaded_tiles == 1);
+    CHECK_THAT(modify, Called(5));
+
+    stats = atlas_tiles.updateTexture(keep, modify);
+    CHECK_FALSE(stats.resized);
+    CHECK(stats.uploaded_tiles == 0);
+
+    SECTION("Resizing, that loses the contents of the texture, uploads all tiles again.")
+    {
+        auto lose = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>([](GLsizei, GLsizei, GLsizei) { return true; });
+        stats = atlas_tiles.updateTexture(lose, modify);
+        CHECK(stats.contents_lost);
+        CHECK(stats.uploaded_tiles == 5);
+    }
+    SECTION("The texture only shrinks once no more than a quarter of its size is in use.")
+    {
+        atlas_tiles.remove(tile);
+        CHECK(tile.atlasPixelSize() == 16);
+        for (int i = 0; i < 3; i++)
+            (void)atlas_tiles.add(tileData());
+        CHECK(tile.atlasPixelSize() == 16);
+        CHECK(atlas_tiles.updateTexture(keep, modify).uploaded_tiles == 3);
+
+        auto small_atlas = TextureAtlasTiles({16, 4});
+        auto big_tile = small_atlas.add(TileData(dgl::svec2(16)));
+        auto small_tile = small_atlas.add(TileData(dgl::svec2(4)));
+        small_atlas.remove(big_tile);
+        CHECK(small_tile.atlasPixelSize() == 4);
+    }
+}
+
+TEST_CASE("TextureAtlasTiles grows the layers of the texture geometrically.", "[texturing]")
+{
+    auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    resize.setInfo({"resize", {"required_size", "layer_count", "mipmap_levels"}});
+    dutils::Stub<void(const TileData&, dgl::ivec3, GLint)> modify;
+
+    // Each tile fills a whole layer.
+    auto max_layer_count = GENERATE(6, 16);
+    CAPTURE(max_layer_count);
+    auto atlas_tiles = TextureAtlasTiles({4, max_layer_count});
+
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    std::vector<GLsizei> texture_layers;
+    for (int i = 0; i < max_layer_count; i++) {
+        tiles.push_back(atlas_tiles.add(tileData()));
+        if (atlas_tiles.updateTexture(resize, modify).resized)
+            texture_layers.push_back(atlas_tiles.textureLayers());
+    }
+
+    if (max_layer_count == 6)
+        CHECK(texture_layers == std::vector<GLsizei>{1, 2, 4, 6});
+    else
+        CHECK(texture_layers == std::vector<GLsizei>{1, 2, 4, 8, 16});
+
+    SECTION("Layers are only removed from the texture once no more than a quarter is in use.")
+    {
+        auto remaining = max_layer_count / 4;
+        for (auto i = remaining + 1; i < max_layer_count; i++)
+            atlas_tiles.remove(tiles[static_cast<std::size_t>(i)]);
+        CHECK_FALSE(atlas_tiles.updateTexture(resize, modify).resized);
+
+        atlas_tiles.remove(tiles[static_cast<std::size_t>(remaining)]);
+        CHECK(atlas_tiles.updateTexture(resize, modify).resized);
+        CHECK(atlas_tiles.textureLayers() == remaining);
+    }
+    SECTION("Tiles on layers, that move down after removing a layer, are uploaded again.")
+    {
+        atlas_tiles.remove(tiles[1]);
+        auto stats = atlas_tiles.updateTexture(resize, modify);
+        CHECK_FALSE(stats.resized);
+        CHECK(stats.uploaded_tiles == static_cast<std::size_t>(max_layer_count - 2));
+    }
+}
+
+TEST_CASE("TextureAtlasTiles can upload adjacent tiles together as regions.", "[texturing]")
+{
+    auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    std::vector<TextureAtlasTiles::TileRegion> regions;
+    std::size_t calls = 0;
+    auto modify_regions = [&](std::span<const TextureAtlasTiles::TileRegion> new_regions) {
+        regions.assign(new_regions.begin(), new_regions.end());
+        calls++;
+    };
+
+    auto max_mipmap_levels = GENERATE(1, 3);
+    CAPTURE(max_mipmap_levels);
+    auto levels = static_cast<std::size_t>(max_mipmap_levels);
+
+    auto atlas_tiles = TextureAtlasTiles({16, 2, max_mipmap_levels});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (int i = 0; i < 4; i++)
+        tiles.push_back(atlas_tiles.add(tileData()));
+
+    auto stats = atlas_tiles.updateTextureRegions(resize, modify_regions);
+    CHECK(stats.uploaded_tiles == 4);
+    REQUIRE(regions.size() == levels);
+    for (std::size_t level = 0; level < levels; level++) {
+        const auto& region = regions[level];
+        auto shift = static_cast<GLsizei>(level);
+        CHECK(region.mipmap_level == shift);
+        CHECK(region.offset == dgl::ivec3(0, 0, 0));
+        CHECK(region.size == dgl::svec2(8 >> shift));
+        CHECK(region.cell_size == dgl::svec2(4 >> shift));
+        REQUIRE(region.tiles.size() == 4);
+        CHECK(region.tiles[0].offset == dgl::svec2(0, 0));
+        CHECK(region.tiles[1].offset == dgl::svec2(4 >> shift, 0));
+        CHECK(region.tiles[2].offset == dgl::svec2(0, 4 >> shift));
+        CHECK(region.tiles[3].offset == dgl::svec2(4 >> shift, 4 >> shift));
+        CHECK(region.tiles[0].bordered_image_data->mipmapLevels() == levels);
+    }
+
+    SECTION("Only tiles that have not been written yet are uploaded, without calling modify if there are none.")
+    {
+        stats = atlas_tiles.updateTextureRegions(resize, modify_regions);
+        CHECK(stats.uploaded_tiles == 0);
+        CHECK(calls == 1);
+
+        for (int i = 0; i < 5; i++)
+            tiles.push_back(atlas_tiles.add(tileData()));
+        stats = atlas_tiles.updateTextureRegions(resize, modify_regions);
+        CHECK(stats.uploaded_tiles == 5);
+
+        // The first four new tiles form a square to the right, while the last one starts a new row below.
+        REQUIRE(regions.size() == 2 * levels);
+        CHECK(regions[0].offset == dgl::ivec3(8, 0, 0));
+        CHECK(regions[0].size == dgl::svec2(8, 8));
+        CHECK(regions[0].tiles.size() == 4);
+        CHECK(regions[1].offset == dgl::ivec3(0, 8, 0));
+        CHECK(regions[1].size == dgl::svec2(4, 4));
+        CHECK(regions[1].tiles.size() == 1);
+    }
+    SECTION("Tiles that fill a gap are uploaded on their own.")
+    {
+        for (int i = 0; i < 12; i++)
+            tiles.push_back(atlas_tiles.add(tileData()));
+        atlas_tiles.updateTextureRegions(resize, modify_regions);
+        // The new tiles cover everything but the top left square, which needs two rectangles.
+        REQUIRE(regions.size() == 2 * levels);
+        CHECK(regions[0].size == dgl::svec2(8, 8));
+        CHECK(regions[1].size == dgl::svec2(16, 8));
+        CHECK(regions[1].tiles.size() == 8);
+
+        atlas_tiles.remove(tiles[5]);
+        atlas_tiles.remove(tiles[6]);
+        tiles[5] = atlas_tiles.add(tileData());
+        tiles[6] = atlas_tiles.add(tileData());
+        atlas_tiles.updateTextureRegions(resize, modify_regions);
+        REQUIRE(regions.size() == 2 * levels);
+        CHECK(regions[0].offset == dgl::ivec3(12, 0, 0));
+        CHECK(regions[1].offset == dgl::ivec3(8, 4, 0));
+    }
+    SECTION("Tiles of different layers end up in different regions.")
+    {
+        tiles.push_back(atlas_tiles.add(TileData(dgl::svec2(8))));
+        stats = atlas_tiles.updateTextureRegions(resize, modify_regions);
+        CHECK(stats.uploaded_tiles == 1);
+        REQUIRE(regions.size() == levels);
+        CHECK(regions[0].offset == dgl::ivec3(0, 0, 1));
+        CHECK(regions[0].cell_size == dgl::svec2(8));
+    }
+    SECTION("Freezing uploads all remaining tiles as regions and frees their data.")
+    {
+        tiles.push_back(atlas_tiles.add(tileData()));
+        auto frozen_tiles = std::move(atlas_tiles).freezeRegions(resize, modify_regions);
+        REQUIRE(regions.size() == levels);
+        CHECK(regions[0].tiles.size() == 1);
+        CHECK_FALSE(*regions[0].tiles[0].bordered_image_data);
+        CHECK(frozen_tiles.contains(tiles.back()));
+    }
+}
+
+TEST_CASE("TextureAtlasTiles can pack tiles of mixed sizes onto shared layers.", "[texturing][texture-atlas-tiles]")
+{
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Skyline, dgl::TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    auto atlas_tiles = TextureAtlasTiles({64, 2, 3, packing});
+    // Tiles are aligned to four pixels, so that they keep at least a single pixel on all three mipmap levels.
+    CHECK(atlas_tiles.mipmapLevels() == 3);
+
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (auto size : {dgl::svec2(16, 16), dgl::svec2(9, 4), dgl::svec2(30, 12), dgl::svec2(5, 5), dgl::svec2(3, 20)})
+        tiles.push_back(atlas_tiles.add(TileData(size)));
+
+    CHECK(tiles.front().atlasPixelSize() == 64);
+    std::vector<dgl::sbounds2> placed;
+    for (const auto& tile : tiles) {
+        CHECK(tile.layer() == 0);
+        CHECK(tile.pixelPos() % 4 == dgl::svec2(0, 0));
+        auto bounds = dgl::sbounds2(tile.pixelPos(), tile.pixelPos() + static_cast<dgl::svec2>(tile.pixelSize()));
+        CHECK(dgl::sbounds2(64).contains(bounds));
+        for (const auto& other : placed)
+            CHECK_FALSE(bounds.overlaps(other));
+        placed.push_back(bounds);
+
+        CHECK(tile.pos() == static_cast<dgl::vec2>(tile.pixelPos()) / 64.0f);
+        CHECK(tile.size() == static_cast<dgl::vec2>(tile.pixelSize()) / 64.0f);
+        CHECK(tile.bounds() == dgl::bounds2(tile.pos(), tile.pos() + tile.size()));
+    }
+
+    SECTION("Removed tiles free their space for new tiles of a different size.")
+    {
+        auto position = tiles[2].pixelPos();
+        atlas_tiles.remove(tiles[2]);
+        auto tile = atlas_tiles.add(TileData(dgl::svec2(32, 12)));
+        CHECK(tile.layer() == 0);
+        CHECK(tile.pixelPos() == position);
+    }
+    SECTION("Tiles that no longer fit end up on a new layer.")
+    {
+        auto tile = atlas_tiles.add(TileData(dgl::svec2(64, 64)));
+        CHECK(tile.layer() == 1);
+        CHECK(tile.pixelPos() == dgl::svec2(0, 0));
+        CHECK_THROWS_MATCHES(atlas_tiles.add(TileData(dgl::svec2(64, 64))),
+                             std::length_error,
+                             Message("Too many texture atlas layers. (max 2)"));
+    }
+    SECTION("Each tile is uploaded as a separate region, covering its aligned size.")
+    {
+        auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+        std::vector<TextureAtlasTiles::TileRegion> regions;
+        auto modify_regions = [&](std::span<const TextureAtlasTiles::TileRegion> new_regions) {
+            regions.assign(new_regions.begin(), new_regions.end());
+        };
+        atlas_tiles.updateTextureRegions(resize, modify_regions);
+        REQUIRE(regions.size() == tiles.size() * 3);
+        CHECK(regions[0].mipmap_level == 0);
+        CHECK(regions[0].tiles.size() == 1);
+        CHECK(regions[1].size == dgl::svec2(12, 4));
+        CHECK(regions[tiles.size() + 1].mipmap_level == 1);
+        CHECK(regions[tiles.size() + 1].size == dgl::svec2(6, 2));
+        CHECK(regions[tiles.size() + 1].offset.xy() == tiles[1].pixelPos() / 2);
+    }
+}
+
+TEST_CASE("TextureAtlasTiles packs glyphs tighter than the grid.", "[texturing][texture-atlas-tiles]")
+{
+    // Four styles of the same font, which need a few layers, so that the last one being partially filled matters less.
+    std::vector<dgl::svec2> sizes;
+    for (int style = 0; style < 4; style++)
+        sizes.insert(sizes.end(), glyph_sizes.begin(), glyph_sizes.end());
+
+    auto grid = TextureAtlasTiles({256, 64});
+    auto skyline = TextureAtlasTiles({256, 64, 1, dgl::TextureAtlasPacking::Skyline});
+    auto max_rects = TextureAtlasTiles({256, 64, 1, dgl::TextureAtlasPacking::MaxRects});
+
+    CHECK(occupancy(grid, sizes) < 0.5f);
+    CHECK(occupancy(skyline, sizes) > 0.75f);
+    CHECK(occupancy(max_rects, sizes) > 0.75f);
+}
+
+TEST_CASE("TextureAtlasTiles can move tiles into gaps, so that layers shrink again.", "[texturing]")
+{
+    auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    auto modify = [](const TileData&, dgl::ivec3, GLint) {};
+    auto copy = dutils::Stub<void(dgl::ivec3, dgl::ivec3, dgl::svec2, GLint)>();
+    copy.setInfo({"copy", {"from", "to", "size", "mipmap_level"}});
+
+    auto atlas_tiles = TextureAtlasTiles({16, 4, 2});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (int i = 0; i < 8; i++)
+        tiles.push_back(atlas_tiles.add(tileData()));
+    atlas_tiles.updateTexture(resize, modify);
+
+    auto moved_from = tiles[7].pixelPos();
+    auto gap = tiles[1].pixelPos();
+    atlas_tiles.remove(tiles[1]);
+    atlas_tiles.remove(tiles[2]);
+    auto generation = atlas_tiles.generation();
+
+    SECTION("Each call moves at least a single tile.")
+    {
+        auto stats = atlas_tiles.defragment(copy, 0);
+        CHECK(stats.moved_tiles == 1);
+        CHECK(stats.moved_pixels == 16);
+        CHECK_FALSE(stats.finished);
+        CHECK(tiles[7].pixelPos() == gap);
+        CHECK(atlas_tiles.generation() != generation);
+        CHECK_THAT(copy, Called(2));
+        auto at = [](dgl::svec2 position) { return dgl::ivec3(position.x(), position.y(), 0); };
+        CHECK_THAT(copy, CalledWith(at(moved_from), at(gap), dgl::svec2(4), 0));
+        CHECK_THAT(copy, CalledWith(at(moved_from / 2), at(gap / 2), dgl::svec2(2), 1));
+    }
+    SECTION("The budget allows for multiple tiles to be moved at once.")
+    {
+        auto stats = atlas_tiles.defragment(copy, 1000);
+        CHECK(stats.moved_tiles == 2);
+        CHECK(stats.finished);
+        CHECK_THAT(copy, Called(4));
+
+        // The remaining six tiles take up the first six cells of the grid again.
+        std::set<dgl::svec2> positions;
+        for (const auto& tile : tiles)
+            if (atlas_tiles.contains(tile))
+                positions.insert(tile.pixelPos());
+        auto expected = std::set<dgl::svec2>{{0, 0}, {4, 0}, {0, 4}, {4, 4}, {8, 0}, {12, 0}};
+        CHECK(positions == expected);
+
+        generation = atlas_tiles.generation();
+        stats = atlas_tiles.defragment(copy, 1000);
+        CHECK(stats.moved_tiles == 0);
+        CHECK(stats.finished);
+        CHECK(atlas_tiles.generation() == generation);
+    }
+    SECTION("Tiles that haven't been written yet are not copied.")
+    {
+        // The first two new tiles fill the gaps, while the third one ends up last and takes the place of the first.
+        for (int i = 0; i < 3; i++)
+            tiles.push_back(atlas_tiles.add(tileData()));
+        auto gap = tiles[0].pixelPos();
+        atlas_tiles.remove(tiles[0]);
+        auto stats = atlas_tiles.defragment(copy, 0);
+        CHECK(stats.moved_tiles == 1);
+        CHECK(tiles.back().pixelPos() == gap);
+        CHECK_THAT(copy, Called(0));
+
+        // Written tiles on the other hand are still copied.
+        atlas_tiles.remove(tiles[3]);
+        stats = atlas_tiles.defragment(copy, 0);
+        CHECK(stats.moved_tiles == 1);
+        CHECK_THAT(copy, Called(2));
+    }
+}
+
+TEST_CASE("TextureAtlasTiles can move tiles off of sparse layers and compact the remaining layers.", "[texturing]")
+{
+    auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    auto modify = [](const TileData&, dgl::ivec3, GLint) {};
+    auto copy = dutils::Stub<void(dgl::ivec3, dgl::ivec3, dgl::svec2, GLint)>();
+    copy.setInfo({"copy", {"from", "to", "size", "mipmap_level"}});
+
+    // The first layer is full, while the second one only has a few tiles, followed by a layer of bigger tiles.
+    auto atlas_tiles = TextureAtlasTiles({16, 4});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (int i = 0; i < 20; i++)
+        tiles.push_back(atlas_tiles.add(tileData()));
+    auto big_tile = atlas_tiles.add(TileData(dgl::svec2(8)));
+    atlas_tiles.updateTexture(resize, modify);
+    CHECK(atlas_tiles.textureLayers() == 4);
+    REQUIRE(big_tile.layer() == 2);
+
+    for (int i = 0; i < 4; i++)
+        atlas_tiles.remove(tiles[static_cast<std::size_t>(i)]);
+
+    auto stats = atlas_tiles.defragment(copy, 1000);
+    CHECK(stats.moved_tiles == 4);
+    CHECK(stats.moved_layers == 1);
+    CHECK(stats.finished);
+    for (std::size_t i = 4; i < tiles.size(); i++)
+        CHECK(tiles[i].layer() == 0);
+
+    // The last layer takes the place of the freed up layer, so that the first layer stays untouched.
+    CHECK(big_tile.layer() == 1);
+    CHECK_THAT(copy, CalledWith(dgl::ivec3(0, 0, 2), dgl::ivec3(0, 0, 1), dgl::svec2(16), 0));
+
+    atlas_tiles.updateTexture(resize, modify);
+    CHECK(atlas_tiles.textureLayers() == 2);
+
+    SECTION("Layers with tiles that don't fit onto the other layers stay where they are.")
+    {
+        // Only the gap on the first layer gets filled, as the big tile has nowhere else to go.
+        atlas_tiles.remove(tiles[4]);
+        stats = atlas_tiles.defragment(copy, 1000);
+        CHECK(stats.moved_tiles == 1);
+        CHECK(stats.moved_layers == 0);
+        CHECK(stats.finished);
+        CHECK(big_tile.layer() == 1);
+    }
+}
+
+TEST_CASE("TextureAtlasTiles can move packed tiles off of sparse layers.", "[texturing]")
+{
+    auto copy = dutils::Stub<void(dgl::ivec3, dgl::ivec3, dgl::svec2, GLint)>();
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Skyline, dgl::TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    auto atlas_tiles = TextureAtlasTiles({64, 4, 1, packing});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (int i = 0; i < 5; i++)
+        tiles.push_back(atlas_tiles.add(TileData(dgl::svec2(32))));
+    REQUIRE(tiles[4].layer() == 1);
+
+    atlas_tiles.remove(tiles[1]);
+    auto stats = atlas_tiles.defragment(copy, 100'000);
+    CHECK(stats.moved_tiles == 1);
+    CHECK(stats.finished);
+    CHECK(tiles[4].layer() == 0);
+
+    SECTION("Layers are only emptied, if their tiles fit onto the other layers.")
+    {
+        tiles.push_back(atlas_tiles.add(TileData(dgl::svec2(64))));
+        tiles.push_back(atlas_tiles.add(TileData(dgl::svec2(16))));
+        atlas_tiles.remove(tiles[2]);
+        stats = atlas_tiles.defragment(copy, 100'000);
+        CHECK(stats.moved_tiles == 1);
+        CHECK(tiles.back().layer() == 0);
+        CHECK(tiles[5].layer() == 1);
+    }
+}
+
+TEST_CASE("TextureAtlasTiles can restore tiles at the position, that they were placed at before.", "[texturing]")
+{
+    auto resize = dutils::Stub<bool(GLsizei, GLsizei, GLsizei)>();
+    resize.setInfo({"resize", {"required_size", "layer_count", "mipmap_levels"}});
+
+    dutils::Stub<void(const TileData&, dgl::ivec3, GLint)> modify;
+    modify.setInfo({"modify", {"tile_data", "offset", "mipmap_level"}});
+
+    auto atlas_tiles = atlasTiles();
+    auto restored_tile = atlas_tiles.restore(tileData(), 0, {4, 0});
+    CHECK(restored_tile.layer() == 0);
+    CHECK(restored_tile.pixelPos() == dgl::svec2(4, 0));
+    CHECK(restored_tile.atlasPixelSize() == 8);
+
+    SECTION("Skipped positions are filled by new tiles.")
+    {
+        auto tile = atlas_tiles.add(tileData());
+        CHECK(tile.layer() == 0);
+        CHECK(tile.pixelPos() == dgl::svec2(0, 0));
+    }
+    SECTION("Tiles can only be restored on free positions of the grid.")
+    {
+        CHECK_THROWS_MATCHES(atlas_tiles.restore(tileData(), 0, {4, 0}),
+                             std::invalid_argument,
+                             Message("Restored tile cannot be placed at [4, 0]."));
+        CHECK_THROWS_AS(atlas_tiles.restore(tileData(), 0, {2, 0}), std::invalid_argument);
+        CHECK_THROWS_AS(atlas_tiles.restore(TileData(dgl::svec2(8)), 0, {8, 8}), std::invalid_argument);
+        CHECK_THROWS_AS(atlas_tiles.restore(tileData(), 0, {16, 0}), std::invalid_argument);
+    }
+    SECTION("Tiles can only be restored on existing layers or the next one.")
+    {
+        CHECK_THROWS_MATCHES(atlas_tiles.restore(tileData(), 2, {0, 0}),
+                             std::invalid_argument,
+                             Message("Restored tile must be placed on an existing or the next layer."));
+        auto tile = atlas_tiles.restore(TileData(dgl::svec2(8)), 1, {8, 8});
+        CHECK(tile.layer() == 1);
+        CHECK(tile.pixelPos() == dgl::svec2(8, 8));
+        CHECK(atlas_tiles.add(TileData(dgl::svec2(8))).layer() == 1);
+    }
+    SECTION("Restored tiles are not uploaded, once they are marked as written.")
+    {
+        auto tile = atlas_tiles.add(tileData());
+        atlas_tiles.resizeTexture(resize);
+        CHECK_THAT(resize, CalledWith(8, 1, 1));
+        CHECK_THAT(modify, Called(0));
+
+        atlas_tiles.markWritten(restored_tile);
+        atlas_tiles.updateTexture(resize, modify);
+        CHECK_THAT(modify, Called(1));
+        CHECK_THAT(modify, CalledWith(tileData(), dgl::ivec3(0, 0, 0), 0));
+
+        CHECK_THROWS_AS(atlas_tiles.markWritten(TextureAtlasTiles::TileHandle()), std::invalid_argument);
+        atlas_tiles.remove(tile);
+        CHECK_THROWS_AS(atlas_tiles.markWritten(tile), std::invalid_argument);
+    }
+}
+
+TEST_CASE("TextureAtlasTiles can restore packed tiles from bottom to top.", "[texturing][texture-atlas-tiles]")
+{
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Skyline, dgl::TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    auto atlas_tiles = TextureAtlasTiles({128, 4, 1, packing});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (std::size_t i = 0; i < 40; i++)
+        tiles.push_back(atlas_tiles.add(TileData(glyph_sizes[i])));
+    std::sort(tiles.begin(), tiles.end(), [](const auto& lhs, const auto& rhs) {
+        return std::tuple(lhs.layer(), lhs.pixelPos().y(), lhs.pixelPos().x()) <
+               std::tuple(rhs.layer(), rhs.pixelPos().y(), rhs.pixelPos().x());
+    });
+
+    auto restored_tiles = TextureAtlasTiles({128, 4, 1, packing});
+    std::vector<dgl::sbounds2> placed;
+    for (const auto& tile : tiles) {
+        auto size = static_cast<dgl::svec2>(tile.pixelSize());
+        auto restored_tile = restored_tiles.restore(TileData(size), tile.layer(), tile.pixelPos());
+        CHECK(restored_tile.layer() == tile.layer());
+        CHECK(restored_tile.pixelPos() == tile.pixelPos());
+        if (tile.layer() == 0)
+            placed.emplace_back(tile.pixelPos(), tile.pixelPos() + size);
+    }
+    CHECK(restored_tiles.size() == tiles.size());
+
+    // New tiles are packed into the remaining space, without overlapping any of the restored tiles.
+    for (auto size : {dgl::svec2(4, 4), dgl::svec2(8, 3), dgl::svec2(3, 8)}) {
+        auto tile = restored_tiles.add(TileData(size));
+        if (tile.layer() != 0)
+            continue;
+        auto bounds = dgl::sbounds2(tile.pixelPos(), tile.pixelPos() + size);
+        for (const auto& other : placed)
+            CHECK_FALSE(bounds.overlaps(other));
+    }
+}
+
+TEST_CASE("TextureAtlasTiles only restores packed tiles on free space.", "[texturing][texture-atlas-tiles]")
+{
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Skyline, dgl::TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    auto atlas_tiles = TextureAtlasTiles({64, 4, 1, packing});
+    auto tile = atlas_tiles.restore(TileData(dgl::svec2(16, 16)), 0, dgl::svec2(16, 0));
+    CHECK(tile.pixelPos() == dgl::svec2(16, 0));
+
+    SECTION("Tiles cannot overlap a tile, that was restored before.")
+    {
+        CHECK_THROWS_AS(atlas_tiles.restore(TileData(dgl::svec2(16, 16)), 0, dgl::svec2(16, 0)),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(atlas_tiles.restore(TileData(dgl::svec2(8, 8)), 0, dgl::svec2(28, 12)), std::invalid_argument);
+        CHECK_THROWS_AS(atlas_tiles.restore(TileData(dgl::svec2(24, 4)), 0, dgl::svec2(0, 0)), std::invalid_argument);
+    }
+    SECTION("Tiles cannot reach past the layer, once their size is aligned.")
+    {
+        CHECK_THROWS_AS(atlas_tiles.restore(TileData(dgl::svec2(3, 3)), 0, dgl::svec2(62, 32)), std::invalid_argument);
+    }
+    SECTION("Tiles next to or above the restored tile still fit.")
+    {
+        auto next = atlas_tiles.restore(TileData(dgl::svec2(16, 16)), 0, dgl::svec2(32, 0));
+        auto above = atlas_tiles.restore(TileData(dgl::svec2(16, 16)), 0, dgl::svec2(16, 16));
+        CHECK(next.pixelPos() == dgl::svec2(32, 0));
+        CHECK(above.pixelPos() == dgl::svec2(16, 16));
+    }
+}
+
 TEST_CASE("FrozenTextureAtlasTiles represents a frozen state of TextureAtlasTiles.",
           "[texturing][frozen-texture-atlas-tiles]")
 {
@@ -500,3 +1251,69 @@ TEST_CASE("TextureAtlasTiles::TileHandle provides information about a created ti
         }
     }
 }
+
+TEST_CASE("TextureAtlasTiles can be benchmarked adding and removing lots of tiles.",
+          "[.][texturing][texture-atlas-tiles][benchmark]")
+{
+    auto tile_count = GENERATE(10'000, 100'000);
+    CAPTURE(tile_count);
+
+    // The same order for every run, that looks random enough to leave gaps all over the place.
+    std::vector<std::size_t> order(static_cast<std::size_t>(tile_count));
+    for (std::size_t i = 0; i < order.size(); i++)
+        order[i] = i * 7919 % order.size();
+
+    BENCHMARK("add and remove all tiles")
+    {
+        auto atlas_tiles = TextureAtlasTiles({4096, 16});
+        std::vector<TextureAtlasTiles::TileHandle> tiles;
+        tiles.reserve(order.size());
+        for (std::size_t i = 0; i < order.size(); i++)
+            tiles.push_back(atlas_tiles.add(TileData(dgl::svec2(16))));
+        for (auto index : order)
+            atlas_tiles.remove(tiles[index]);
+        return atlas_tiles.size();
+    };
+
+    auto atlas_tiles = TextureAtlasTiles({4096, 16});
+    std::vector<TextureAtlasTiles::TileHandle> tiles;
+    for (std::size_t i = 0; i < order.size(); i++)
+        tiles.push_back(atlas_tiles.add(TileData(dgl::svec2(16))));
+
+    BENCHMARK("replace a tenth of the tiles")
+    {
+        for (std::size_t i = 0; i < order.size() / 10; i++) {
+            auto& tile = tiles[order[i]];
+            atlas_tiles.remove(tile);
+            tile = atlas_tiles.add(TileData(dgl::svec2(16)));
+        }
+        return atlas_tiles.size();
+    };
+}
+
+TEST_CASE("TextureAtlasTiles can be benchmarked packing the glyphs of a font.",
+          "[.][texturing][texture-atlas-tiles][benchmark]")
+{
+    auto packing = GENERATE(dgl::TextureAtlasPacking::Grid,
+                            dgl::TextureAtlasPacking::Skyline,
+                            dgl::TextureAtlasPacking::MaxRects);
+    auto [numerator, denominator] = GENERATE(std::pair{1, 2}, std::pair{1, 1}, std::pair{2, 1});
+    CAPTURE(packing, numerator, denominator);
+
+    // Multiple styles of the same font, as a text renderer would typically use.
+    std::vector<dgl::svec2> sizes;
+    auto scaled_sizes = scaledGlyphSizes(numerator, denominator);
+    for (int style = 0; style < 4; style++)
+        sizes.insert(sizes.end(), scaled_sizes.begin(), scaled_sizes.end());
+
+    auto occupancy_tiles = TextureAtlasTiles({512, 256, 1, packing});
+    WARN("occupancy: " << occupancy(occupancy_tiles, sizes));
+
+    BENCHMARK("add all glyphs")
+    {
+        auto atlas_tiles = TextureAtlasTiles({512, 256, 1, packing});
+        for (auto size : sizes)
+            (void)atlas_tiles.add(TileData(size));
+        return atlas_tiles.size();
+    };
+}
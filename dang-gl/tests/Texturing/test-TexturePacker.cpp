@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "dang-gl/Texturing/TexturePacker.h"
+#include "dang-math/bounds.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+#include "catch2/matchers/catch_matchers_exception.hpp"
+
+namespace dgl = dang::gl;
+namespace dutils = dang::utils;
+
+using Catch::Matchers::Message;
+using dgl::TextureAtlasPacking;
+
+namespace {
+
+/// @brief Returns sizes between one and the given maximum, which are the same on every run.
+std::vector<dgl::svec2> randomSizes(std::size_t count, GLsizei max_size, unsigned seed = 1)
+{
+    std::vector<dgl::svec2> result;
+    dutils::SampleGenerator generator{seed};
+    for (std::size_t i = 0; i < count; i++) {
+        auto& size = result.emplace_back();
+        for (auto& component : size)
+            component = static_cast<GLsizei>(generator.next() % static_cast<unsigned>(max_size)) + 1;
+    }
+    return result;
+}
+
+/// @brief Whether all rectangles lie within the bin without overlapping each other.
+bool validPacking(const std::vector<dgl::sbounds2>& placed, GLsizei size)
+{
+    auto bin = dgl::sbounds2(size);
+    for (std::size_t i = 0; i < placed.size(); i++) {
+        if (!bin.contains(placed[i]))
+            return false;
+        for (std::size_t j = i + 1; j < placed.size(); j++)
+            if (placed[i].overlaps(placed[j]))
+                return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Texture packers place rectangles without overlapping each other.",
+                   "[texturing][texture-packer]",
+                   dgl::SkylinePacker,
+                   dgl::MaxRectsPacker)
+{
+    auto packer = TestType(128);
+    CHECK(packer.size() == 128);
+
+    std::vector<dgl::sbounds2> placed;
+    std::vector<dgl::svec2> sizes;
+    for (auto size : randomSizes(200, 24)) {
+        auto position = packer.insert(size);
+        if (!position)
+            continue;
+        placed.emplace_back(*position, *position + size);
+        sizes.push_back(size);
+    }
+    // The bin should be filled to a reasonable degree, before rectangles stop fitting.
+    CHECK(placed.size() > 40);
+    CHECK(validPacking(placed, packer.size()));
+
+    SECTION("Removed rectangles free their space again.")
+    {
+        // Reinserting all of them at once could fail, as the heuristics are free to place them differently.
+        for (std::size_t i = 0; i < placed.size(); i += 2) {
+            packer.remove(placed[i]);
+            auto position = packer.insert(sizes[i]);
+            REQUIRE(position);
+            placed[i] = dgl::sbounds2(*position, *position + sizes[i]);
+        }
+        CHECK(validPacking(placed, packer.size()));
+    }
+    SECTION("Growing the bin keeps all rectangles in place and makes room for more.")
+    {
+        packer.grow(256);
+        CHECK(packer.size() == 256);
+        for (auto size : randomSizes(200, 24, 2)) {
+            auto position = packer.insert(size);
+            REQUIRE(position);
+            placed.emplace_back(*position, *position + size);
+        }
+        CHECK(validPacking(placed, packer.size()));
+    }
+    SECTION("Reserving all rectangles from bottom to top restores the packing.")
+    {
+        auto restored = TestType(packer.size());
+        auto sorted = placed;
+        std::sort(sorted.begin(), sorted.end(), [](const dgl::sbounds2& lhs, const dgl::sbounds2& rhs) {
+            return lhs.low.y() < rhs.low.y();
+        });
+        for (const auto& bounds : sorted)
+            restored.reserve(bounds);
+        // Only space, that is actually free, is used for new rectangles.
+        for (auto size : randomSizes(100, 8, 3)) {
+            if (auto position = restored.insert(size))
+                placed.emplace_back(*position, *position + size);
+        }
+        CHECK(validPacking(placed, restored.size()));
+    }
+}
+
+TEST_CASE("TexturePacker aligns tiles and grows the layer when necessary.", "[texturing][texture-packer]")
+{
+    auto packing = GENERATE(TextureAtlasPacking::Skyline, TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    auto packer = dgl::TexturePacker(packing, 4, 64);
+    CHECK(packer.alignment() == 4);
+    CHECK(packer.size() == 0);
+    CHECK(packer.alignedSize(dgl::svec2(5, 8)) == dgl::svec2(8, 8));
+
+    // The layer starts out with the next power of two of the first tile.
+    auto first = packer.insert(dgl::svec2(13, 14));
+    REQUIRE(first);
+    CHECK(*first == dgl::svec2(0, 0));
+    CHECK(packer.size() == 16);
+
+    // Sixteen tiles of 16x16 after alignment fill the layer entirely.
+    std::vector<dgl::sbounds2> placed = {{*first, *first + dgl::svec2(16)}};
+    for (int i = 0; i < 15; i++) {
+        auto position = packer.insert(dgl::svec2(15, 14));
+        REQUIRE(position);
+        CHECK(*position % 4 == dgl::svec2(0, 0));
+        placed.emplace_back(*position, *position + dgl::svec2(16));
+    }
+    CHECK(packer.size() == 64);
+    CHECK(validPacking(placed, packer.size()));
+    CHECK_FALSE(packer.insert(dgl::svec2(1, 1)));
+    CHECK_FALSE(packer.insert(dgl::svec2(65, 1)));
+
+    packer.remove(placed[5].low, dgl::svec2(13, 16));
+    auto reused = packer.insert(dgl::svec2(16, 13));
+    REQUIRE(reused);
+    CHECK(*reused == placed[5].low);
+}
+
+TEST_CASE("TexturePacker can reserve the space of tiles, that were placed before.", "[texturing][texture-packer]")
+{
+    auto packing = GENERATE(TextureAtlasPacking::Skyline, TextureAtlasPacking::MaxRects);
+    CAPTURE(packing);
+
+    auto packer = dgl::TexturePacker(packing, 4, 64);
+    packer.reserve(dgl::svec2(0, 0), dgl::svec2(13, 14));
+    CHECK(packer.size() == 16);
+    packer.reserve(dgl::svec2(16, 0), dgl::svec2(16, 32));
+    CHECK(packer.size() == 32);
+
+    // Only aligned and unused space, that fits on the layer once its size is aligned, can be reserved.
+    CHECK(packer.canReserve(dgl::svec2(32, 0), dgl::svec2(32, 32)));
+    CHECK(packer.canReserve(dgl::svec2(0, 16), dgl::svec2(16, 48)));
+    CHECK_FALSE(packer.canReserve(dgl::svec2(2, 16), dgl::svec2(4, 4)));
+    CHECK_FALSE(packer.canReserve(dgl::svec2(-4, 16), dgl::svec2(4, 4)));
+    CHECK_FALSE(packer.canReserve(dgl::svec2(8, 8), dgl::svec2(4, 4)));
+    CHECK_FALSE(packer.canReserve(dgl::svec2(12, 16), dgl::svec2(8, 4)));
+    CHECK_FALSE(packer.canReserve(dgl::svec2(60, 0), dgl::svec2(5, 4)));
+
+    std::vector<dgl::sbounds2> placed = {{{0, 0}, {16, 16}}, {{16, 0}, {32, 32}}};
+    while (auto position = packer.insert(dgl::svec2(16, 16)))
+        placed.emplace_back(*position, *position + dgl::svec2(16));
+    CHECK(placed.size() == 15);
+    CHECK(validPacking(placed, packer.size()));
+}
+
+TEST_CASE("TexturePacker cannot be used for grid packing.", "[texturing][texture-packer]")
+{
+    CHECK_THROWS_MATCHES(dgl::TexturePacker(TextureAtlasPacking::Grid, 1, 64),
+                         std::invalid_argument,
+                         Message("Texture atlas packing does not use a packer."));
+}
@@ -205,7 +205,7 @@ struct Bounds {
         if constexpr (std::is_integral_v<T>)
             return (low + high - 1) / T(2);
         else
-            return (low + high) + size() / T(2);
+            return (low + high) / T(2);
     }
 
     /// @brief Returns true, if other is enclosed by the calling bounds.
@@ -229,6 +229,19 @@ struct Bounds {
     /// @remark Comparison is exclusive for both low and high.
     constexpr bool containsExclusive(const Point& point) const { return point.allGreater(low) && point.allLess(high); }
 
+    /// @brief Returns true, if both bounds share any point.
+    /// @remark For floating point types, bounds that only touch are considered overlapping.
+    constexpr bool overlaps(const Bounds& other) const
+    {
+        if constexpr (std::is_integral_v<T>)
+            return low.allLess(other.high) && other.low.allLess(high);
+        else
+            return low.allLessEqual(other.high) && other.low.allLessEqual(high);
+    }
+
+    /// @brief Returns the smallest bounds, which enclose both bounds.
+    constexpr Bounds join(const Bounds& other) const { return {low.min(other.low), high.max(other.high)}; }
+
     /// @brief Clamps the given bounds, resulting in an intersection of both bounds.
     constexpr Bounds clamp(const Bounds& other) const { return {low.max(other.low), high.min(other.high)}; }
 
@@ -0,0 +1,667 @@
+#pragma once
+
+#include "dang-math/bounds.h"
+#include "dang-math/geometry.h"
+#include "dang-math/global.h"
+#include "dang-math/vector.h"
+
+namespace dang::math {
+
+namespace detail {
+
+/// @brief A stack for tree traversal, which only allocates for unusually deep trees.
+template <typename T, std::size_t v_inline_size = 64>
+class TraversalStack {
+public:
+    bool empty() const { return size_ == 0; }
+
+    void push(const T& value)
+    {
+        if (size_ < v_inline_size)
+            inline_[size_] = value;
+        else
+            overflow_.push_back(value);
+        size_++;
+    }
+
+    T pop()
+    {
+        size_--;
+        if (size_ < v_inline_size)
+            return inline_[size_];
+        T value = overflow_.back();
+        overflow_.pop_back();
+        return value;
+    }
+
+private:
+    std::array<T, v_inline_size> inline_;
+    std::vector<T> overflow_;
+    std::size_t size_ = 0;
+};
+
+/// @brief A measure for the cost of visiting bounds, which is half the surface area in three dimensions.
+/// @remark Reduces to half the perimeter in two and the length in one dimension.
+template <typename T, std::size_t v_dim>
+T halfArea(const Bounds<T, v_dim>& bounds)
+{
+    auto size = bounds.size();
+    if constexpr (v_dim == 1) {
+        return size[0];
+    }
+    else if constexpr (v_dim == 2) {
+        return size[0] + size[1];
+    }
+    else {
+        T result{};
+        for (std::size_t i = 0; i < v_dim; i++)
+            for (std::size_t j = i + 1; j < v_dim; j++)
+                result += size[i] * size[j];
+        return result;
+    }
+}
+
+} // namespace detail
+
+/// @brief A bounding volume hierarchy, which accelerates ray, overlap and nearest-point queries over lots of bounds.
+/// @remark Nodes are stored in a single flat array and reference each other by index. A full build with the surface
+/// area heuristic lays out nodes in depth-first order, so that the first child always directly follows its parent.
+/// @remark Entries can also be inserted, removed and moved incrementally, which keeps the tree valid but slowly
+/// degrades its quality. Calling build from time to time restores both quality and memory layout.
+/// @remark Handles stay valid until the entry is removed and are reused afterwards.
+template <typename T, std::size_t v_dim, typename TPayload>
+class BVH {
+public:
+    static_assert(std::is_floating_point_v<T>, "BVH requires a floating point type");
+
+    using Type = T;
+    static constexpr auto dim = v_dim;
+
+    using Payload = TPayload;
+    using Bounds = dang::math::Bounds<T, dim>;
+    using Point = Vector<T, dim>;
+    using Line = dang::math::Line<T, dim>;
+    using Handle = std::size_t;
+
+    /// @brief The closest entry hit by a ray together with the line factor of the hit.
+    struct RaycastResult {
+        Handle handle;
+        T factor;
+    };
+
+    /// @brief The closest entry to a point together with its distance.
+    struct NearestResult {
+        Handle handle;
+        T distance;
+    };
+
+    /// @brief The number of bins, which are checked per axis when looking for the best split during a build.
+    static constexpr std::size_t build_bins = 16;
+
+    /// @brief Creates an empty BVH.
+    BVH() = default;
+
+    /// @brief Inserts all given entries and builds an optimized tree for them.
+    explicit BVH(std::vector<std::pair<Bounds, Payload>> entries)
+    {
+        entries_.reserve(entries.size());
+        for (auto& [bounds, payload] : entries)
+            entries_.push_back({bounds, std::move(payload), invalid_index});
+        build();
+    }
+
+    /// @brief The number of entries.
+    std::size_t size() const { return entries_.size() - free_entries_.size(); }
+
+    /// @brief Whether there are no entries.
+    bool empty() const { return size() == 0; }
+
+    /// @brief Whether the handle refers to an entry, that has not been removed.
+    bool contains(Handle handle) const { return handle < entries_.size() && entries_[handle].payload.has_value(); }
+
+    /// @brief Provides access to the payload of an entry.
+    Payload& operator[](Handle handle) { return *entries_[handle].payload; }
+
+    /// @brief Provides access to the payload of an entry.
+    const Payload& operator[](Handle handle) const { return *entries_[handle].payload; }
+
+    /// @brief Returns the bounds of an entry.
+    const Bounds& bounds(Handle handle) const { return entries_[handle].bounds; }
+
+    /// @brief Returns bounds, which enclose all entries, or std::nullopt if there are none.
+    std::optional<Bounds> bounds() const
+    {
+        if (root_ == invalid_index)
+            return std::nullopt;
+        return nodes_[root_].bounds;
+    }
+
+    /// @brief Removes all entries.
+    void clear()
+    {
+        entries_.clear();
+        free_entries_.clear();
+        nodes_.clear();
+        free_nodes_.clear();
+        root_ = invalid_index;
+    }
+
+    /// @brief Rebuilds the whole tree, using the surface area heuristic to find good splits.
+    void build()
+    {
+        nodes_.clear();
+        free_nodes_.clear();
+        root_ = invalid_index;
+
+        std::vector<BuildEntry> build_entries;
+        build_entries.reserve(size());
+        for (Index entry = 0; entry < entries_.size(); entry++)
+            if (entries_[entry].payload)
+                build_entries.push_back({entry, entries_[entry].bounds.center()});
+
+        if (build_entries.empty())
+            return;
+
+        nodes_.reserve(build_entries.size() * 2 - 1);
+        root_ = buildNode(build_entries.begin(), build_entries.end(), invalid_index);
+    }
+
+    /// @brief Inserts a new entry into the existing tree and returns its handle.
+    /// @remark The entry is placed next to the sibling, which causes the smallest increase in surface area.
+    Handle insert(const Bounds& bounds, Payload payload)
+    {
+        Index entry;
+        if (free_entries_.empty()) {
+            entry = static_cast<Index>(entries_.size());
+            entries_.push_back({bounds, std::move(payload), invalid_index});
+        }
+        else {
+            entry = free_entries_.back();
+            free_entries_.pop_back();
+            entries_[entry] = {bounds, std::move(payload), invalid_index};
+        }
+        insertLeaf(entry);
+        return entry;
+    }
+
+    /// @brief Removes an entry from the tree, making its handle invalid.
+    void remove(Handle handle)
+    {
+        assert(contains(handle));
+        auto& entry = entries_[handle];
+        removeLeaf(entry.node);
+        entry.payload.reset();
+        entry.node = invalid_index;
+        free_entries_.push_back(static_cast<Index>(handle));
+    }
+
+    /// @brief Moves an entry to new bounds and immediately updates all bounds of the nodes above it.
+    void update(Handle handle, const Bounds& bounds)
+    {
+        setBounds(handle, bounds);
+        refitAncestors(nodes_[entries_[handle].node].parent);
+    }
+
+    /// @brief Sets new bounds for an entry without updating the nodes above it.
+    /// @remark Call refit after moving all entries, which is cheaper than updating them one by one.
+    void setBounds(Handle handle, const Bounds& bounds)
+    {
+        assert(contains(handle));
+        auto& entry = entries_[handle];
+        entry.bounds = bounds;
+        nodes_[entry.node].bounds = bounds;
+    }
+
+    /// @brief Updates the bounds of all nodes after entries were moved using setBounds.
+    /// @remark The structure of the tree stays the same, so quality degrades if entries move a lot.
+    void refit()
+    {
+        if (root_ == invalid_index)
+            return;
+
+        // Collect all nodes in depth-first order, so that children are updated before their parents.
+        std::vector<Index> order;
+        order.reserve(nodes_.size() - free_nodes_.size());
+        order.push_back(root_);
+        for (std::size_t i = 0; i < order.size(); i++) {
+            const auto& node = nodes_[order[i]];
+            if (!node.isLeaf()) {
+                order.push_back(node.children[0]);
+                order.push_back(node.children[1]);
+            }
+        }
+
+        for (auto iter = order.rbegin(); iter != order.rend(); ++iter) {
+            auto& node = nodes_[*iter];
+            if (!node.isLeaf())
+                node.bounds = nodes_[node.children[0]].bounds.join(nodes_[node.children[1]].bounds);
+        }
+    }
+
+    /// @brief Calls function(handle) for every entry, whose bounds overlap with the given bounds.
+    template <typename TFunction>
+    void forEachOverlap(const Bounds& bounds, TFunction function) const
+    {
+        if (root_ == invalid_index)
+            return;
+
+        detail::TraversalStack<Index> stack;
+        stack.push(root_);
+        while (!stack.empty()) {
+            const auto& node = nodes_[stack.pop()];
+            if (!node.bounds.overlaps(bounds))
+                continue;
+            if (node.isLeaf()) {
+                function(Handle{node.children[0]});
+            }
+            else {
+                stack.push(node.children[1]);
+                stack.push(node.children[0]);
+            }
+        }
+    }
+
+    /// @brief Returns the handles of all entries, whose bounds overlap with the given bounds.
+    std::vector<Handle> overlapping(const Bounds& bounds) const
+    {
+        std::vector<Handle> result;
+        forEachOverlap(bounds, [&](Handle handle) { result.push_back(handle); });
+        return result;
+    }
+
+    /// @brief Finds the entry, whose bounds are hit first by a ray starting at the support of the line.
+    /// @remark The factor is relative to the direction of the line and lies in the range [0, max_factor].
+    std::optional<RaycastResult> raycast(const Line& line, T max_factor = std::numeric_limits<T>::infinity()) const
+    {
+        return raycast(
+            line, [](Handle, T entry_factor) { return std::optional<T>(entry_factor); }, max_factor);
+    }
+
+    /// @brief Finds the closest hit of a ray starting at the support of the line with the actual shapes of entries.
+    /// @remark intersect(handle, entry_factor) returns the factor of the closest hit with the shape of an entry or
+    /// std::nullopt if it is missed. The shape must lie within the bounds of the entry, whose ray entry factor is given.
+    /// @remark Nodes are visited front to back and skipped as soon as they are further away than the closest hit.
+    template <typename TIntersect>
+    std::optional<RaycastResult> raycast(const Line& line,
+                                         TIntersect intersect,
+                                         T max_factor = std::numeric_limits<T>::infinity()) const
+    {
+        if (root_ == invalid_index)
+            return std::nullopt;
+
+        Ray ray(line);
+        std::optional<RaycastResult> result;
+        auto best_factor = max_factor;
+
+        detail::TraversalStack<std::pair<Index, T>> stack;
+        if (auto root_factor = ray.entryFactor(nodes_[root_].bounds, best_factor))
+            stack.push({root_, *root_factor});
+
+        while (!stack.empty()) {
+            auto [index, factor] = stack.pop();
+            if (factor > best_factor)
+                continue;
+
+            const auto& node = nodes_[index];
+            if (node.isLeaf()) {
+                Handle handle = node.children[0];
+                if (auto hit = intersect(handle, factor); hit && *hit <= best_factor) {
+                    best_factor = *hit;
+                    result = RaycastResult{handle, *hit};
+                }
+                continue;
+            }
+
+            auto first = ray.entryFactor(nodes_[node.children[0]].bounds, best_factor);
+            auto second = ray.entryFactor(nodes_[node.children[1]].bounds, best_factor);
+            if (first && second) {
+                if (*first <= *second) {
+                    stack.push({node.children[1], *second});
+                    stack.push({node.children[0], *first});
+                }
+                else {
+                    stack.push({node.children[0], *first});
+                    stack.push({node.children[1], *second});
+                }
+            }
+            else if (first) {
+                stack.push({node.children[0], *first});
+            }
+            else if (second) {
+                stack.push({node.children[1], *second});
+            }
+        }
+
+        return result;
+    }
+
+    /// @brief Finds the entry, whose bounds are closest to the given point.
+    /// @remark Points inside of bounds have a distance of zero.
+    std::optional<NearestResult> nearest(const Point& point, T max_distance = std::numeric_limits<T>::infinity()) const
+    {
+        return nearest(
+            point, [](Handle, T bounds_distance) { return bounds_distance; }, max_distance);
+    }
+
+    /// @brief Finds the entry, whose actual shape is closest to the given point.
+    /// @remark distance(handle, bounds_distance) returns the distance to the shape of an entry. The shape must lie
+    /// within the bounds of the entry, whose distance is given.
+    /// @remark Nodes are visited closest first and skipped as soon as they are further away than the closest entry.
+    template <typename TDistance>
+    std::optional<NearestResult> nearest(const Point& point,
+                                         TDistance distance,
+                                         T max_distance = std::numeric_limits<T>::infinity()) const
+    {
+        if (root_ == invalid_index)
+            return std::nullopt;
+
+        std::optional<NearestResult> result;
+        auto best_sqrdistance = max_distance * max_distance;
+
+        detail::TraversalStack<std::pair<Index, T>> stack;
+        stack.push({root_, sqrdistance(nodes_[root_].bounds, point)});
+
+        while (!stack.empty()) {
+            auto [index, node_sqrdistance] = stack.pop();
+            if (node_sqrdistance > best_sqrdistance)
+                continue;
+
+            const auto& node = nodes_[index];
+            if (node.isLeaf()) {
+                Handle handle = node.children[0];
+                auto entry_distance = distance(handle, std::sqrt(node_sqrdistance));
+                if (entry_distance * entry_distance <= best_sqrdistance) {
+                    best_sqrdistance = entry_distance * entry_distance;
+                    result = NearestResult{handle, entry_distance};
+                }
+                continue;
+            }
+
+            auto first = sqrdistance(nodes_[node.children[0]].bounds, point);
+            auto second = sqrdistance(nodes_[node.children[1]].bounds, point);
+            if (first <= second) {
+                stack.push({node.children[1], second});
+                stack.push({node.children[0], first});
+            }
+            else {
+                stack.push({node.children[0], first});
+                stack.push({node.children[1], second});
+            }
+        }
+
+        return result;
+    }
+
+private:
+    using Index = std::uint32_t;
+
+    static constexpr Index invalid_index = std::numeric_limits<Index>::max();
+
+    struct Entry {
+        Bounds bounds;
+        std::optional<Payload> payload;
+        Index node;
+    };
+
+    /// @brief A node of the tree, which is either a leaf with a single entry or has exactly two children.
+    struct Node {
+        Bounds bounds;
+        Index parent;
+        /// @brief For leaves, the first child holds the entry and the second one is invalid.
+        std::array<Index, 2> children;
+
+        bool isLeaf() const { return children[1] == invalid_index; }
+    };
+
+    struct BuildEntry {
+        Index entry;
+        Point center;
+    };
+
+    using BuildIterator = typename std::vector<BuildEntry>::iterator;
+
+    /// @brief A ray with precomputed inverse direction for slab tests.
+    struct Ray {
+        Point support;
+        Point inverse_direction;
+
+        explicit Ray(const Line& line)
+            : support(line.support)
+        {
+            for (std::size_t i = 0; i < dim; i++)
+                inverse_direction[i] = T(1) / line.direction()[i];
+        }
+
+        /// @brief Returns the factor at which the ray enters the bounds, which is zero if it starts inside.
+        /// @remark Axes, which the ray is parallel to and starts on the edge of, produce NaN. These are ignored, which
+        /// is why the running minimum and maximum have to be the first argument.
+        std::optional<T> entryFactor(const Bounds& bounds, T max_factor) const
+        {
+            T near = T(0);
+            T far = max_factor;
+            for (std::size_t i = 0; i < dim; i++) {
+                T low = (bounds.low[i] - support[i]) * inverse_direction[i];
+                T high = (bounds.high[i] - support[i]) * inverse_direction[i];
+                near = std::max(near, std::min(low, high));
+                far = std::min(far, std::max(low, high));
+            }
+            if (near > far)
+                return std::nullopt;
+            return near;
+        }
+    };
+
+    static T sqrdistance(const Bounds& bounds, const Point& point)
+    {
+        return (bounds.low - point).max((point - bounds.high).max(Point())).sqrdot();
+    }
+
+    Index allocateNode(const Node& node)
+    {
+        if (free_nodes_.empty()) {
+            nodes_.push_back(node);
+            return static_cast<Index>(nodes_.size() - 1);
+        }
+        auto index = free_nodes_.back();
+        free_nodes_.pop_back();
+        nodes_[index] = node;
+        return index;
+    }
+
+    Index createLeaf(Index entry, Index parent)
+    {
+        auto index = allocateNode({entries_[entry].bounds, parent, {entry, invalid_index}});
+        entries_[entry].node = index;
+        return index;
+    }
+
+    /// @brief Recursively builds the subtree for the given entries and returns the index of its root.
+    /// @remark Nodes are appended in depth-first order, which places the first child directly after its parent.
+    Index buildNode(BuildIterator begin, BuildIterator end, Index parent)
+    {
+        if (end - begin == 1)
+            return createLeaf(begin->entry, parent);
+
+        auto index = static_cast<Index>(nodes_.size());
+        nodes_.push_back({entries_[begin->entry].bounds, parent, {invalid_index, invalid_index}});
+
+        auto split = findSplit(begin, end);
+        nodes_[index].children[0] = buildNode(begin, split, index);
+        nodes_[index].children[1] = buildNode(split, end, index);
+        nodes_[index].bounds = nodes_[nodes_[index].children[0]].bounds.join(nodes_[nodes_[index].children[1]].bounds);
+        return index;
+    }
+
+    /// @brief Partitions the entries using the binned split with the lowest surface area heuristic cost.
+    /// @remark Falls back to splitting in the middle, if all centers are the same.
+    BuildIterator findSplit(BuildIterator begin, BuildIterator end)
+    {
+        Bounds center_bounds(begin->center, begin->center);
+        for (auto iter = begin; iter != end; ++iter)
+            center_bounds = center_bounds.join(Bounds(iter->center, iter->center));
+        auto extent = center_bounds.size();
+
+        auto binOf = [&](const BuildEntry& build_entry, std::size_t axis) {
+            auto bin = static_cast<std::size_t>((build_entry.center[axis] - center_bounds.low[axis]) * build_bins /
+                                                extent[axis]);
+            return std::min(bin, build_bins - 1);
+        };
+
+        std::optional<std::size_t> best_axis;
+        std::size_t best_bin = 0;
+        auto best_cost = std::numeric_limits<T>::infinity();
+
+        for (std::size_t axis = 0; axis < dim; axis++) {
+            if (!(extent[axis] > T(0)))
+                continue;
+
+            std::array<std::optional<Bounds>, build_bins> bin_bounds;
+            std::array<std::size_t, build_bins> bin_counts{};
+            for (auto iter = begin; iter != end; ++iter) {
+                auto bin = binOf(*iter, axis);
+                const auto& bounds = entries_[iter->entry].bounds;
+                bin_bounds[bin] = bin_bounds[bin] ? bin_bounds[bin]->join(bounds) : bounds;
+                bin_counts[bin]++;
+            }
+
+            // Sweep from the right to find the cost of everything to the right of each split.
+            std::array<T, build_bins> right_costs{};
+            std::optional<Bounds> right_bounds;
+            std::size_t right_count = 0;
+            for (std::size_t bin = build_bins - 1; bin > 0; bin--) {
+                if (bin_bounds[bin])
+                    right_bounds = right_bounds ? right_bounds->join(*bin_bounds[bin]) : *bin_bounds[bin];
+                right_count += bin_counts[bin];
+                right_costs[bin] = right_bounds ? T(right_count) * detail::halfArea(*right_bounds) : T(0);
+            }
+
+            std::optional<Bounds> left_bounds;
+            std::size_t left_count = 0;
+            for (std::size_t bin = 1; bin < build_bins; bin++) {
+                if (bin_bounds[bin - 1])
+                    left_bounds = left_bounds ? left_bounds->join(*bin_bounds[bin - 1]) : *bin_bounds[bin - 1];
+                left_count += bin_counts[bin - 1];
+                if (left_count == 0 || left_count == std::size_t(end - begin))
+                    continue;
+                auto cost = T(left_count) * detail::halfArea(*left_bounds) + right_costs[bin];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = bin;
+                }
+            }
+        }
+
+        if (!best_axis)
+            return begin + (end - begin) / 2;
+
+        return std::partition(
+            begin, end, [&](const BuildEntry& build_entry) { return binOf(build_entry, *best_axis) < best_bin; });
+    }
+
+    /// @brief Inserts the leaf of an entry next to the sibling, which results in the lowest cost.
+    void insertLeaf(Index entry)
+    {
+        if (root_ == invalid_index) {
+            root_ = createLeaf(entry, invalid_index);
+            return;
+        }
+
+        const auto& bounds = entries_[entry].bounds;
+        auto sibling = root_;
+        while (!nodes_[sibling].isLeaf()) {
+            const auto& node = nodes_[sibling];
+            auto area = detail::halfArea(node.bounds);
+            auto combined_area = detail::halfArea(node.bounds.join(bounds));
+
+            // Cost of making a new parent for this node and the new leaf.
+            auto cost = 2 * combined_area;
+            // Minimum cost of pushing the leaf further down the tree.
+            auto inheritance_cost = 2 * (combined_area - area);
+
+            auto childCost = [&](Index child) {
+                const auto& child_bounds = nodes_[child].bounds;
+                auto joined_area = detail::halfArea(child_bounds.join(bounds));
+                if (nodes_[child].isLeaf())
+                    return joined_area + inheritance_cost;
+                return joined_area - detail::halfArea(child_bounds) + inheritance_cost;
+            };
+
+            auto cost0 = childCost(node.children[0]);
+            auto cost1 = childCost(node.children[1]);
+            if (cost < cost0 && cost < cost1)
+                break;
+            sibling = cost0 < cost1 ? node.children[0] : node.children[1];
+        }
+
+        auto old_parent = nodes_[sibling].parent;
+        auto new_parent = allocateNode({nodes_[sibling].bounds.join(bounds), old_parent, {sibling, invalid_index}});
+        auto leaf = createLeaf(entry, new_parent);
+        nodes_[new_parent].children[1] = leaf;
+        nodes_[sibling].parent = new_parent;
+
+        if (old_parent == invalid_index)
+            root_ = new_parent;
+        else
+            nodes_[old_parent].children[nodes_[old_parent].children[0] == sibling ? 0 : 1] = new_parent;
+
+        refitAncestors(old_parent);
+    }
+
+    /// @brief Removes a leaf by replacing its parent with its sibling.
+    void removeLeaf(Index leaf)
+    {
+        free_nodes_.push_back(leaf);
+        auto parent = nodes_[leaf].parent;
+        if (parent == invalid_index) {
+            root_ = invalid_index;
+            return;
+        }
+
+        auto sibling = nodes_[parent].children[nodes_[parent].children[0] == leaf ? 1 : 0];
+        auto grandparent = nodes_[parent].parent;
+        nodes_[sibling].parent = grandparent;
+        free_nodes_.push_back(parent);
+
+        if (grandparent == invalid_index) {
+            root_ = sibling;
+            return;
+        }
+
+        nodes_[grandparent].children[nodes_[grandparent].children[0] == parent ? 0 : 1] = sibling;
+        refitAncestors(grandparent);
+    }
+
+    /// @brief Updates the bounds of the given node and all of its ancestors.
+    void refitAncestors(Index index)
+    {
+        while (index != invalid_index) {
+            auto& node = nodes_[index];
+            node.bounds = nodes_[node.children[0]].bounds.join(nodes_[node.children[1]].bounds);
+            index = node.parent;
+        }
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<Index> free_entries_;
+    std::vector<Node> nodes_;
+    std::vector<Index> free_nodes_;
+    Index root_ = invalid_index;
+};
+
+template <std::size_t v_dim, typename TPayload>
+using bvh = BVH<float, v_dim, TPayload>;
+template <std::size_t v_dim, typename TPayload>
+using dbvh = BVH<double, v_dim, TPayload>;
+
+template <typename TPayload>
+using bvh2 = bvh<2, TPayload>;
+template <typename TPayload>
+using bvh3 = bvh<3, TPayload>;
+
+template <typename TPayload>
+using dbvh2 = dbvh<2, TPayload>;
+template <typename TPayload>
+using dbvh3 = dbvh<3, TPayload>;
+
+} // namespace dang::math
@@ -0,0 +1,344 @@
+#pragma once
+
+#include "dang-math/bounds.h"
+#include "dang-math/consts.h"
+#include "dang-math/global.h"
+#include "dang-math/marchingcubes.h"
+#include "dang-math/vector.h"
+
+#include "dang-utils/parallel.h"
+
+namespace dang::math {
+
+/// @brief A read-only view on a dense three-dimensional grid of samples, stored with x varying fastest.
+template <typename TValue>
+struct ScalarField {
+    using Value = TValue;
+
+    std::span<const Value> values;
+    ivec3 size;
+
+    /// @brief The linear index of the given point.
+    std::size_t indexOf(const ivec3& point) const
+    {
+        return static_cast<std::size_t>(point.x()) +
+               static_cast<std::size_t>(size.x()) *
+                   (static_cast<std::size_t>(point.y()) +
+                    static_cast<std::size_t>(size.y()) * static_cast<std::size_t>(point.z()));
+    }
+
+    const Value& operator[](const ivec3& point) const { return values[indexOf(point)]; }
+
+    /// @brief The cells between the samples, of which there is one less than samples along each axis.
+    ibounds3 cells() const { return ibounds3((size - 1).max(0)); }
+};
+
+template <typename TValue>
+ScalarField(std::span<const TValue>, ivec3) -> ScalarField<TValue>;
+
+/// @brief Vertex and index buffers of a triangle mesh.
+struct MarchingCubesMesh {
+    std::vector<vec3> positions;
+    std::vector<std::uint32_t> indices;
+
+    /// @brief Removes all vertices and indices, but keeps the memory around for reuse.
+    void clear()
+    {
+        positions.clear();
+        indices.clear();
+    }
+};
+
+namespace detail {
+
+/// @brief The triangles of one MarchingCubes case, referring to cube edges instead of plane points.
+struct MarchingCubesCase {
+    /// @brief The number of used entries in vertices, which is three per triangle.
+    std::uint8_t vertex_count = 0;
+    /// @brief Either an edge in [0, 12) or a center point, which is offset by 12.
+    /// @remark Edges are numbered axis * 4 + o1 + o2 * 2, with o1 and o2 being the offsets of the edge along the
+    /// following two axes.
+    std::array<std::uint8_t, 36> vertices{};
+    std::uint8_t center_count = 0;
+    std::array<vec3, 4> centers{};
+};
+
+inline constexpr std::uint8_t marching_cubes_edge_count = 12;
+
+/// @brief Returns the offset of the low end of an edge in a cell.
+constexpr ivec3 marchingCubesEdgeOffset(std::size_t edge)
+{
+    auto axis = edge / 4;
+    ivec3 result;
+    result[(axis + 1) % 3] = static_cast<int>(edge & 1);
+    result[(axis + 2) % 3] = static_cast<int>((edge >> 1) & 1);
+    return result;
+}
+
+/// @brief Converts the lookup of MarchingCubes into one, which refers to edges and can be used for vertex caching.
+template <bool v_with_center>
+std::array<MarchingCubesCase, 256> buildMarchingCubesCases()
+{
+    MarchingCubes<v_with_center> marching_cubes;
+    std::array<MarchingCubesCase, 256> result;
+    for (std::size_t bits = 0; bits < result.size(); bits++) {
+        auto& cell_case = result[bits];
+        for (const auto& plane_info : marching_cubes[Corners3::fromBits(bits)]) {
+            for (const auto& point : plane_info.points) {
+                std::uint8_t vertex;
+                if (point.corner == Corner3::None) {
+                    auto center_end = cell_case.centers.begin() + cell_case.center_count;
+                    auto center = std::find(cell_case.centers.begin(), center_end, point.position);
+                    if (center == center_end)
+                        cell_case.centers[cell_case.center_count++] = point.position;
+                    vertex = static_cast<std::uint8_t>(marching_cubes_edge_count + (center - cell_case.centers.begin()));
+                }
+                else {
+                    auto axis = static_cast<std::size_t>(point.direction.abs().maxAxis());
+                    auto low = corner_vector_3[point.corner].min(corner_vector_3[point.corner] + ivec3(point.direction));
+                    vertex = static_cast<std::uint8_t>(axis * 4 + low[(axis + 1) % 3] + low[(axis + 2) % 3] * 2);
+                }
+                cell_case.vertices[cell_case.vertex_count++] = vertex;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace detail
+
+/// @brief Extracts triangle meshes from scalar fields, using the lookup of MarchingCubes.
+/// @remark Samples greater than the iso value are considered inside. For floating point samples vertices are
+/// interpolated along edges to match the iso value, other types (e.g. occupancy) place vertices at the edge center.
+/// @remark Fields are split into chunks, which are meshed in parallel. Within a chunk, vertices are shared between all
+/// cells using the same edge. A cache of just two slices of edges keeps track of them, so no hashing is involved.
+/// @remark Chunks are self-contained, so vertices on the border between two chunks exist once in each of them.
+/// @remark Meshing does not allocate per cell and the buffers of all chunks are kept around for the next call.
+template <bool v_with_center = false>
+class MarchingCubesMesher {
+public:
+    static constexpr auto with_center = v_with_center;
+
+    /// @brief Creates a mesher, which splits fields into chunks of the given number of cells along each axis.
+    explicit MarchingCubesMesher(int chunk_size = 32)
+        : chunk_size_(chunk_size)
+    {
+        assert(chunk_size > 0);
+    }
+
+    /// @brief The number of cells along each axis of a chunk.
+    int chunkSize() const { return chunk_size_; }
+
+    /// @brief Returns the cells of the given chunk, which are clamped to the cells of the field.
+    ibounds3 chunkCells(const ibounds3& field_cells, const ivec3& chunk) const
+    {
+        return field_cells.clamp(ibounds3(chunk * chunk_size_, (chunk + 1) * chunk_size_));
+    }
+
+    /// @brief The number of chunks along each axis, which are necessary to cover all cells of the field.
+    ivec3 chunkCount(const ibounds3& field_cells) const
+    {
+        return (field_cells.size() + chunk_size_ - 1) / chunk_size_;
+    }
+
+    /// @brief Meshes the whole field in parallel, concatenating the meshes of all chunks into the result.
+    template <typename TValue>
+    void mesh(const ScalarField<TValue>& field, MarchingCubesMesh& result, TValue iso = TValue())
+    {
+        auto cells = field.cells();
+        auto chunk_count = chunkCount(cells);
+        auto chunks = ibounds3(chunk_count);
+        auto total_chunks = static_cast<std::size_t>(chunk_count.product());
+        chunk_meshes_.resize(total_chunks);
+
+        dutils::parallelFor(total_chunks, 1, [&](std::size_t begin, std::size_t end) {
+            ChunkMesher chunk_mesher;
+            for (auto chunk = begin; chunk < end; chunk++)
+                chunk_mesher.mesh(field, chunkCells(cells, chunkAt(chunks, chunk)), iso, chunk_meshes_[chunk]);
+        });
+
+        // Chunks are concatenated in order, so that the result does not depend on the number of threads.
+        std::vector<std::pair<std::size_t, std::size_t>> offsets(total_chunks + 1);
+        for (std::size_t chunk = 0; chunk < total_chunks; chunk++)
+            offsets[chunk + 1] = {offsets[chunk].first + chunk_meshes_[chunk].positions.size(),
+                                  offsets[chunk].second + chunk_meshes_[chunk].indices.size()};
+        result.positions.resize(offsets.back().first);
+        result.indices.resize(offsets.back().second);
+
+        dutils::parallelFor(total_chunks, 1, [&](std::size_t begin, std::size_t end) {
+            for (auto chunk = begin; chunk < end; chunk++) {
+                const auto& chunk_mesh = chunk_meshes_[chunk];
+                auto [position_offset, index_offset] = offsets[chunk];
+                std::copy(chunk_mesh.positions.begin(),
+                          chunk_mesh.positions.end(),
+                          result.positions.begin() + position_offset);
+                std::transform(chunk_mesh.indices.begin(),
+                               chunk_mesh.indices.end(),
+                               result.indices.begin() + index_offset,
+                               [&](std::uint32_t index) { return static_cast<std::uint32_t>(index + position_offset); });
+            }
+        });
+    }
+
+    /// @brief Meshes the given chunks in parallel, storing each one in the mesh returned by result(index).
+    /// @remark Useful to only update some chunks, whose meshes are kept separately.
+    template <typename TValue, typename TResult>
+    void meshChunks(const ScalarField<TValue>& field,
+                    std::span<const ivec3> chunks,
+                    TResult result,
+                    TValue iso = TValue()) const
+    {
+        auto cells = field.cells();
+        dutils::parallelFor(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            ChunkMesher chunk_mesher;
+            for (auto index = begin; index < end; index++)
+                chunk_mesher.mesh(field, chunkCells(cells, chunks[index]), iso, result(index));
+        });
+    }
+
+    /// @brief Meshes only the given cells of the field on the calling thread.
+    template <typename TValue>
+    void meshCells(const ScalarField<TValue>& field,
+                   const ibounds3& cells,
+                   MarchingCubesMesh& result,
+                   TValue iso = TValue()) const
+    {
+        ChunkMesher().mesh(field, cells, iso, result);
+    }
+
+private:
+    /// @brief Meshes chunks one after another, reusing its edge cache.
+    class ChunkMesher {
+    public:
+        template <typename TValue>
+        void mesh(const ScalarField<TValue>& field, const ibounds3& cells, TValue iso, MarchingCubesMesh& result)
+        {
+            result.clear();
+            if (cells.size().product() <= 0)
+                return;
+
+            static const auto cases = detail::buildMarchingCubesCases<v_with_center>();
+
+            auto points = cells.size() + 1;
+            slice_size_ = static_cast<std::size_t>(points.x() * points.y());
+            row_size_ = static_cast<std::size_t>(points.x());
+            edges_.assign(slice_size_ * edge_slices, invalid_index);
+            low_slice_ = 0;
+
+            std::array<std::size_t, 8> corner_offsets;
+            for (std::size_t corner = 0; corner < corner_offsets.size(); corner++)
+                corner_offsets[corner] = field.indexOf(corner_vector_3[static_cast<Corner3>(corner)]);
+
+            auto inside = [&](std::size_t index) { return field.values[index] > iso; };
+
+            for (int z = cells.low.z(); z < cells.high.z(); z++) {
+                if (z != cells.low.z())
+                    nextLayer();
+
+                for (int y = cells.low.y(); y < cells.high.y(); y++) {
+                    auto row = field.indexOf({cells.low.x(), y, z});
+
+                    // Bits of the corners with x = 1, which become the corners with x = 0 of the next cell.
+                    auto rightBits = [&](std::size_t index) {
+                        return static_cast<unsigned>(inside(index + corner_offsets[1])) << 1 |
+                               static_cast<unsigned>(inside(index + corner_offsets[3])) << 3 |
+                               static_cast<unsigned>(inside(index + corner_offsets[5])) << 5 |
+                               static_cast<unsigned>(inside(index + corner_offsets[7])) << 7;
+                    };
+                    auto bits = rightBits(row - 1);
+
+                    for (int x = cells.low.x(); x < cells.high.x(); x++) {
+                        auto index = row + static_cast<std::size_t>(x - cells.low.x());
+                        bits = (bits & 0xAA) >> 1 | rightBits(index);
+                        if (bits == 0 || bits == 0xFF)
+                            continue;
+
+                        ivec3 cell{x, y, z};
+                        const auto& cell_case = cases[bits];
+                        std::array<std::uint32_t, 4> centers;
+                        for (std::size_t center = 0; center < cell_case.center_count; center++) {
+                            centers[center] = static_cast<std::uint32_t>(result.positions.size());
+                            result.positions.push_back(vec3(cell) + cell_case.centers[center]);
+                        }
+
+                        auto local = cell - cells.low;
+                        for (std::size_t vertex = 0; vertex < cell_case.vertex_count; vertex++) {
+                            auto id = cell_case.vertices[vertex];
+                            result.indices.push_back(id < detail::marching_cubes_edge_count
+                                                         ? edgeVertex(field, iso, cell, local, id, result)
+                                                         : centers[id - detail::marching_cubes_edge_count]);
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t invalid_index = std::numeric_limits<std::uint32_t>::max();
+
+        /// @brief Two slices of x- and y-edges for the bottom and top of the current layer of cells, followed by the
+        /// z-edges in between them.
+        static constexpr std::size_t edge_slices = 5;
+
+        /// @brief Swaps the top slice to the bottom and clears all edges, which are not shared with the next layer.
+        void nextLayer()
+        {
+            low_slice_ ^= 1;
+            auto high_slice = low_slice_ ^ 1;
+            std::fill_n(edges_.begin() + high_slice * 2 * slice_size_, 2 * slice_size_, invalid_index);
+            std::fill_n(edges_.begin() + 4 * slice_size_, slice_size_, invalid_index);
+        }
+
+        /// @brief Returns the vertex on the given edge of a cell, creating it if it does not exist yet.
+        template <typename TValue>
+        std::uint32_t edgeVertex(const ScalarField<TValue>& field,
+                                 TValue iso,
+                                 const ivec3& cell,
+                                 const ivec3& local,
+                                 std::size_t edge,
+                                 MarchingCubesMesh& result)
+        {
+            auto axis = edge / 4;
+            auto offset = detail::marchingCubesEdgeOffset(edge);
+            auto point = local + offset;
+            auto in_slice = static_cast<std::size_t>(point.x()) + static_cast<std::size_t>(point.y()) * row_size_;
+            auto slice = axis == 2 ? 4 : ((low_slice_ ^ static_cast<std::size_t>(offset.z())) * 2 + axis);
+
+            auto& vertex = edges_[slice * slice_size_ + in_slice];
+            if (vertex == invalid_index) {
+                vertex = static_cast<std::uint32_t>(result.positions.size());
+                auto low = cell + offset;
+                auto position = vec3(low);
+                if constexpr (std::is_floating_point_v<TValue>) {
+                    auto high = low;
+                    high[axis]++;
+                    auto low_value = field[low];
+                    position[axis] += static_cast<float>((iso - low_value) / (field[high] - low_value));
+                }
+                else {
+                    position[axis] += 0.5f;
+                }
+                result.positions.push_back(position);
+            }
+            return vertex;
+        }
+
+        std::vector<std::uint32_t> edges_;
+        std::size_t slice_size_ = 0;
+        std::size_t row_size_ = 0;
+        std::size_t low_slice_ = 0;
+    };
+
+    /// @brief Converts a linear chunk index into its position.
+    static ivec3 chunkAt(const ibounds3& chunks, std::size_t chunk)
+    {
+        auto size = chunks.size();
+        auto index = static_cast<int>(chunk);
+        return {index % size.x(), index / size.x() % size.y(), index / (size.x() * size.y())};
+    }
+
+    int chunk_size_;
+    std::vector<MarchingCubesMesh> chunk_meshes_;
+};
+
+} // namespace dang::math
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "dang-math/bounds.h"
+#include "dang-math/global.h"
+#include "dang-math/marchingcubesmesher.h"
+#include "dang-math/vector.h"
+
+namespace dang::math {
+
+/// @brief An editable volume of samples, which keeps one mesh per chunk and only remeshes chunks affected by edits.
+/// @remark Changing a sample affects all cells using it as a corner, which reach one cell into neighboring chunks.
+/// These chunks are marked dirty as well, so that meshes stay closed across chunk borders.
+/// @remark Chunk meshes are in the coordinates of the volume and can be uploaded independently of each other.
+template <typename TValue, bool v_with_center = false>
+class MarchingCubesVolume {
+public:
+    using Value = TValue;
+    using Mesher = MarchingCubesMesher<v_with_center>;
+
+    /// @brief Creates a volume of the given number of samples, which are all initialized with the fill value.
+    /// @remark All chunks start out dirty, so that the first update meshes everything.
+    explicit MarchingCubesVolume(const ivec3& size, Value iso = Value(), Value fill = Value(), int chunk_size = 32)
+        : size_(size)
+        , iso_(iso)
+        , values_(static_cast<std::size_t>(size.product()), fill)
+        , mesher_(chunk_size)
+        , chunk_count_(mesher_.chunkCount(field().cells()))
+        , chunk_meshes_(static_cast<std::size_t>(chunk_count_.product()))
+        , dirty_(chunk_meshes_.size(), false)
+    {
+        markDirty(ibounds3(size));
+    }
+
+    /// @brief The number of samples along each axis.
+    const ivec3& size() const { return size_; }
+
+    /// @brief Samples greater than this value are considered inside.
+    Value iso() const { return iso_; }
+
+    /// @brief A read-only view on all samples.
+    ScalarField<Value> field() const { return {values_, size_}; }
+
+    const Value& operator[](const ivec3& point) const { return values_[field().indexOf(point)]; }
+
+    /// @brief Changes a single sample and marks the affected chunks dirty.
+    void set(const ivec3& point, Value value)
+    {
+        values_[field().indexOf(point)] = value;
+        markDirty(ibounds3(point, point + 1));
+    }
+
+    /// @brief Calls function(point, value) with a modifiable value for all samples in the given bounds.
+    /// @remark Affected chunks are marked dirty once for the whole region, which is cheaper than calling set.
+    template <typename TFunction>
+    void modify(const ibounds3& points, TFunction function)
+    {
+        auto clamped = ibounds3(size_).clamp(points);
+        for (const auto& point : clamped.xFirst())
+            function(point, values_[field().indexOf(point)]);
+        markDirty(clamped);
+    }
+
+    /// @brief Marks all chunks dirty, which contain cells using any of the given samples as a corner.
+    void markDirty(const ibounds3& points)
+    {
+        auto cells = field().cells().clamp(ibounds3(points.low - 1, points.high));
+        if (!cells.size().allGreater(0))
+            return;
+
+        auto chunk_size = mesher_.chunkSize();
+        for (const auto& chunk : ibounds3(cells.low / chunk_size, (cells.high - 1) / chunk_size + 1)) {
+            auto index = chunkIndex(chunk);
+            if (!dirty_[index]) {
+                dirty_[index] = true;
+                dirty_chunks_.push_back(chunk);
+            }
+        }
+    }
+
+    /// @brief Whether any chunks need to be remeshed.
+    bool isDirty() const { return !dirty_chunks_.empty(); }
+
+    /// @brief The chunks, which need to be remeshed, in the order they were marked dirty.
+    const std::vector<ivec3>& dirtyChunks() const { return dirty_chunks_; }
+
+    /// @brief The number of chunks along each axis.
+    const ivec3& chunkCount() const { return chunk_count_; }
+
+    /// @brief The cells covered by the given chunk.
+    ibounds3 chunkCells(const ivec3& chunk) const { return mesher_.chunkCells(field().cells(), chunk); }
+
+    /// @brief The current mesh of a chunk, which is outdated while the chunk is dirty.
+    const MarchingCubesMesh& chunkMesh(const ivec3& chunk) const { return chunk_meshes_[chunkIndex(chunk)]; }
+
+    /// @brief Remeshes all dirty chunks in parallel and calls patch(chunk, mesh) for each of them afterwards.
+    /// @return The number of remeshed chunks.
+    template <typename TFunction>
+    std::size_t update(TFunction patch)
+    {
+        // Swapping keeps the memory of both lists around and allows patch to mark chunks dirty again.
+        updating_chunks_.swap(dirty_chunks_);
+
+        mesher_.meshChunks(
+            field(),
+            std::span<const ivec3>(updating_chunks_),
+            [&](std::size_t index) -> MarchingCubesMesh& { return chunk_meshes_[chunkIndex(updating_chunks_[index])]; },
+            iso_);
+
+        for (const auto& chunk : updating_chunks_)
+            dirty_[chunkIndex(chunk)] = false;
+        for (const auto& chunk : updating_chunks_)
+            patch(chunk, chunkMesh(chunk));
+
+        auto count = updating_chunks_.size();
+        updating_chunks_.clear();
+        return count;
+    }
+
+    /// @brief Remeshes all dirty chunks without being notified about the changed chunks.
+    std::size_t update()
+    {
+        return update([](const ivec3&, const MarchingCubesMesh&) {});
+    }
+
+private:
+    std::size_t chunkIndex(const ivec3& chunk) const
+    {
+        return static_cast<std::size_t>(chunk.x() + chunk_count_.x() * (chunk.y() + chunk_count_.y() * chunk.z()));
+    }
+
+    ivec3 size_;
+    Value iso_;
+    std::vector<Value> values_;
+    Mesher mesher_;
+    ivec3 chunk_count_;
+    std::vector<MarchingCubesMesh> chunk_meshes_;
+    std::vector<bool> dirty_;
+    std::vector<ivec3> dirty_chunks_;
+    std::vector<ivec3> updating_chunks_;
+};
+
+} // namespace dang::math
@@ -2,10 +2,14 @@
 
 #include "dang-math/bounds.h"
 #include "dang-math/global.h"
+#include "dang-math/simd.h"
 #include "dang-math/vector.h"
 
 namespace dang::math {
 
+template <typename T, std::size_t v_dim>
+struct LUDecomposition;
+
 /// @brief A generic, column-major matrix of any dimensions.
 template <typename T, std::size_t v_cols, std::size_t v_rows = v_cols>
 struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
@@ -201,23 +205,135 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
             return cofactorMatrix().transpose();
     }
 
+    /// @brief Returns the LU decomposition of the matrix using partial pivoting.
+    constexpr auto lu() const
+    {
+        static_assert(cols == rows);
+        return LUDecomposition<T, cols>(*this);
+    }
+
     /// @brief Returns the inverse of the matrix.
     /// @remark
     /// Algorithms used:
-    /// - Dim &lt;= 4: Cramer's rule
-    /// - Dim > 4: Blockwise inversion (recursive)
+    /// - Dim &lt; 3: Cramer's rule
+    /// - Dim = 3: Cramer's rule, with the adjugate built from cross products of the columns
+    /// - Dim = 4: Cramer's rule, with the adjugate expanded using shared 2x2 sub-determinants
+    /// - Dim > 4: LU decomposition for floating point types, otherwise blockwise inversion (recursive)
     constexpr std::optional<Matrix> inverse() const
     {
         static_assert(cols == rows);
 
         constexpr std::size_t Dim = cols;
 
-        if constexpr (Dim <= 4) {
+        if constexpr (Dim < 3) {
             T det = determinant();
             if (det == T{})
                 return std::nullopt;
             return adjugate() / det;
         }
+        else if constexpr (Dim == 3) {
+            Matrix result;
+            T det = adjugate3x3(result);
+            if (det == T{})
+                return std::nullopt;
+            return result / det;
+        }
+        else if constexpr (Dim == 4) {
+            // Since the inverse of the transpose is the transpose of the inverse, columns and rows can be swapped.
+            const auto& a = *this;
+
+            T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+            T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+            T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+            T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+            T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+            T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+
+            T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+            T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+            T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+            T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+            T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+            T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+
+            T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            if (det == T{})
+                return std::nullopt;
+
+            Matrix result;
+            result(0, 0) = a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3;
+            result(0, 1) = -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3;
+            result(0, 2) = a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3;
+            result(0, 3) = -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3;
+            result(1, 0) = -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1;
+            result(1, 1) = a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1;
+            result(1, 2) = -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1;
+            result(1, 3) = a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1;
+            result(2, 0) = a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0;
+            result(2, 1) = -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0;
+            result(2, 2) = a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0;
+            result(2, 3) = -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0;
+            result(3, 0) = -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0;
+            result(3, 1) = a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0;
+            result(3, 2) = -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0;
+            result(3, 3) = a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0;
+            return result / det;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+            return lu().inverse();
+        else
+            return inverseBlockwise();
+    }
+
+    /// @brief Returns the inverse of an affine transformation, whose last row is assumed to be (0, ..., 0, 1).
+    /// @remark Only the linear part has to be inverted, which is cheaper than a full inverse.
+    constexpr std::optional<Matrix> inverseAffine() const
+    {
+        static_assert(cols == rows && cols >= 2);
+
+        constexpr std::size_t dim = cols - 1;
+
+        Matrix result;
+        if constexpr (dim == 3 && std::is_floating_point_v<T>) {
+            // Scales the adjugate with a single reciprocal of the determinant instead of dividing each element.
+            T det = adjugate3x3(result);
+            if (det == T{})
+                return std::nullopt;
+            T inv_det = T{1} / det;
+            for (std::size_t col = 0; col < dim; col++)
+                for (std::size_t row = 0; row < dim; row++)
+                    result(col, row) *= inv_det;
+        }
+        else {
+            auto linear_inverse = subMatrix<0, 0, dim, dim>().inverse();
+            if (!linear_inverse)
+                return std::nullopt;
+            for (std::size_t col = 0; col < dim; col++)
+                for (std::size_t row = 0; row < dim; row++)
+                    result(col, row) = (*linear_inverse)(col, row);
+        }
+
+        // Written out instead of using the matrix-vector kernel, which would need the linear part repacked.
+        for (std::size_t row = 0; row < dim; row++) {
+            T offset{};
+            for (std::size_t col = 0; col < dim; col++)
+                offset += result(col, row) * (*this)(dim, col);
+            result(dim, row) = -offset;
+        }
+        result(dim, dim) = T{1};
+        return result;
+    }
+
+    /// @brief Returns the inverse of the matrix using recursive blockwise inversion.
+    /// @remark Fails, if the upper left block of the matrix is singular, even if the matrix itself is not.
+    constexpr std::optional<Matrix> inverseBlockwise() const
+    {
+        static_assert(cols == rows);
+
+        constexpr std::size_t Dim = cols;
+
+        if constexpr (Dim <= 4)
+            return inverse();
         else {
             constexpr std::size_t DimHalf1 = Dim / 2 + Dim % 2;
             constexpr std::size_t DimHalf2 = Dim / 2;
@@ -227,11 +343,11 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
             auto c = subMatrix<0, DimHalf1, DimHalf1, DimHalf2>();
             auto d = subMatrix<DimHalf1, DimHalf1, DimHalf2, DimHalf2>();
 
-            auto a_inv = a.inverse();
+            auto a_inv = a.inverseBlockwise();
             if (!a_inv)
                 return std::nullopt;
 
-            auto s_inv = (d - c * *a_inv * b).inverse();
+            auto s_inv = (d - c * *a_inv * b).inverseBlockwise();
             if (!s_inv)
                 return std::nullopt;
 
@@ -250,8 +366,20 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     }
 
     /// @brief Returns the determinant of the matrix.
-    /// @remark Up to 3x3 is hard-coded, otherwise uses very costly recursion.
+    /// @remark Up to 3x3 is hard-coded and 4x4 uses Laplace expansion. Above that, floating point types use an LU
+    /// decomposition, while all other types fall back to the very costly recursion of determinantLaplace.
     constexpr auto determinant() const
+    {
+        constexpr std::size_t Dim = cols < rows ? cols : rows;
+        if constexpr (Dim > 4 && cols == rows && std::is_floating_point_v<T>)
+            return lu().determinant();
+        else
+            return determinantLaplace();
+    }
+
+    /// @brief Returns the determinant of the matrix using Laplace expansion along the first row.
+    /// @remark Up to 3x3 is hard-coded, otherwise uses very costly recursion.
+    constexpr auto determinantLaplace() const
     {
         constexpr std::size_t Dim = cols < rows ? cols : rows;
         if constexpr (Dim == 1) {
@@ -268,8 +396,10 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
         else {
             T result{};
             if constexpr (Dim > 0) {
-                for (std::size_t i = 0; i < Dim; i++)
-                    result += (*this)(i, 0) * cofactor(i, 0);
+                for (std::size_t i = 0; i < Dim; i++) {
+                    const T factor = T{1} - (i & 1) * 2;
+                    result += (*this)(i, 0) * minor(i, 0).determinantLaplace() * factor;
+                }
             }
             return result;
         }
@@ -282,14 +412,18 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Solves a single column of the matrix, when seen as a linear equation.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 6: Inverse
+    /// - Unknowns >= 6: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 6: Column-swap and determinant. (Swaps performed in-place)
     constexpr std::optional<T> solveCol(std::size_t col)
     {
         static_assert(cols == rows + 1);
 
         if constexpr (rows >= 6) {
-            if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
+            if constexpr (std::is_floating_point_v<T>) {
+                if (auto result = subMatrix<0, 0, rows, rows>().lu().solve((*this)[rows]))
+                    return (*result)[col];
+            }
+            else if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
                 return (*inv * (*this)[rows])[col];
             return std::nullopt;
         }
@@ -314,14 +448,18 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Solves a single column of the matrix, when seen as a linear equation.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 6: Inverse
+    /// - Unknowns >= 6: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 6: Column-swap and determinant. (Swaps not performed in-place)
     constexpr std::optional<T> solveCol(std::size_t col) const
     {
         static_assert(cols == rows + 1);
 
         if constexpr (rows >= 6) {
-            if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
+            if constexpr (std::is_floating_point_v<T>) {
+                if (auto result = subMatrix<0, 0, rows, rows>().lu().solve((*this)[rows]))
+                    return (*result)[col];
+            }
+            else if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
                 return (*inv * (*this)[rows])[col];
             return std::nullopt;
         }
@@ -340,14 +478,18 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// vector.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 6: Inverse
+    /// - Unknowns >= 6: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 6: Column-swap and determinant. (Swaps performed in-place)
     constexpr std::optional<T> solveCol(std::size_t col, Vector<T, cols> vector)
     {
         static_assert(cols == rows);
 
         if constexpr (rows >= 6) {
-            if (auto inv = inverse())
+            if constexpr (std::is_floating_point_v<T>) {
+                if (auto result = lu().solve(vector))
+                    return (*result)[col];
+            }
+            else if (auto inv = inverse())
                 return (*inv * vector)[col];
             return std::nullopt;
         }
@@ -373,14 +515,18 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// vector.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 6: Inverse
+    /// - Unknowns >= 6: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 6: Column-swap and determinant. (Swaps not performed in-place)
     constexpr std::optional<T> solveCol(std::size_t col, Vector<T, cols> vector) const
     {
         static_assert(cols == rows);
 
         if constexpr (rows >= 6) {
-            if (auto inv = inverse())
+            if constexpr (std::is_floating_point_v<T>) {
+                if (auto result = lu().solve(vector))
+                    return (*result)[col];
+            }
+            else if (auto inv = inverse())
                 return (*inv * vector)[col];
             return std::nullopt;
         }
@@ -398,16 +544,19 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Solves the matrix, when seen as a linear equation.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 5: Inverse
+    /// - Unknowns >= 5: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 5: Column-swap and determinant. (Swaps performed in-place)
     constexpr std::optional<Vector<T, rows>> solve()
     {
         static_assert(cols == rows + 1);
 
         if constexpr (rows >= 5) {
-            if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
+            if constexpr (std::is_floating_point_v<T>)
+                return subMatrix<0, 0, rows, rows>().lu().solve((*this)[rows]);
+            else if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
                 return *inv * (*this)[rows];
-            return std::nullopt;
+            else
+                return std::nullopt;
         }
         else {
             T old_determinant = determinant();
@@ -434,16 +583,19 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Solves the matrix, when seen as a linear equation.
     /// @remark
     /// Algorithms used:
-    /// Unknowns >= 5: Inverse
+    /// Unknowns >= 5: LU decomposition for floating point types, otherwise inverse
     /// Unknowns &lt; 5: Column-swap and determinant. (Swaps not performed in-place)
     constexpr std::optional<Vector<T, rows>> solve() const
     {
         static_assert(cols == rows + 1);
 
         if constexpr (rows >= 5) {
-            if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
+            if constexpr (std::is_floating_point_v<T>)
+                return subMatrix<0, 0, rows, rows>().lu().solve((*this)[rows]);
+            else if (auto inv = subMatrix<0, 0, rows, rows>().inverse())
                 return *inv * (*this)[rows];
-            return std::nullopt;
+            else
+                return std::nullopt;
         }
         else {
             T old_determinant = determinant();
@@ -471,16 +623,19 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Solves the matrix, when seen as a linear equation in combination with the given vector.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 5: Inverse
+    /// - Unknowns >= 5: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 5: Column-swap and determinant. (Swaps performed in-place)
     constexpr std::optional<Vector<T, cols>> solve(Vector<T, cols> vector)
     {
         static_assert(cols == rows);
 
         if constexpr (rows >= 5) {
-            if (auto inv = inverse())
+            if constexpr (std::is_floating_point_v<T>)
+                return lu().solve(vector);
+            else if (auto inv = inverse())
                 return *inv * vector;
-            return std::nullopt;
+            else
+                return std::nullopt;
         }
         else {
             T old_determinant = determinant();
@@ -507,16 +662,19 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Solves the matrix, when seen as a linear equation in combination with the given vector.
     /// @remark
     /// Algorithms used:
-    /// - Unknowns >= 5: Inverse
+    /// - Unknowns >= 5: LU decomposition for floating point types, otherwise inverse
     /// - Unknowns &lt; 5: Column-swap and determinant. (Swaps not performed in-place)
     constexpr std::optional<Vector<T, cols>> solve(Vector<T, cols> vector) const
     {
         static_assert(cols == rows);
 
         if constexpr (rows >= 5) {
-            if (auto inv = inverse())
+            if constexpr (std::is_floating_point_v<T>)
+                return lu().solve(vector);
+            else if (auto inv = inverse())
                 return *inv * vector;
-            return std::nullopt;
+            else
+                return std::nullopt;
         }
         else {
             T old_determinant = determinant();
@@ -615,6 +773,13 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     friend constexpr auto operator*(const Matrix& lhs, const Matrix<T, v_other_cols, cols>& rhs)
     {
         Matrix<T, v_other_cols, rows> result;
+        if constexpr (simd::supports_transform_v<T, cols, rows>) {
+            if (!std::is_constant_evaluated()) {
+                for (std::size_t col = 0; col < v_other_cols; col++)
+                    simd::transform<T, cols, rows>(lhs[0].data(), rhs[col].data(), result[col].data());
+                return result;
+            }
+        }
         sbounds2 bounds{{v_other_cols, rows}};
         for (const auto& pos : bounds)
             for (std::size_t i = 0; i < cols; i++)
@@ -633,6 +798,13 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// @brief Performs a matrix-multiplication between the matrix and the given vector, seen as a single-column matrix.
     friend constexpr auto operator*(const Matrix& matrix, const Vector<T, cols>& vector)
     {
+        if constexpr (simd::supports_transform_v<T, cols, rows>) {
+            if (!std::is_constant_evaluated()) {
+                Vector<T, rows> result;
+                simd::transform<T, cols, rows>(matrix[0].data(), vector.data(), result.data());
+                return result;
+            }
+        }
         return Vector<T, rows>{matrix * Matrix<T, 1, cols>::fromVector(vector)};
     }
 
@@ -640,7 +812,11 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
     /// single-column matrix.
     friend constexpr auto operator*(const Vector<T, rows>& vector, const Matrix& matrix)
     {
-        return matrix.transpose() * vector;
+        // Each component is the dot-product with a column, which avoids building the transposed matrix.
+        Vector<T, cols> result;
+        for (std::size_t col = 0; col < cols; col++)
+            result[col] = matrix[col].dot(vector);
+        return result;
     }
 
     /// @brief Performs a matrix-multiplication between the inverse of the matrix and the given vector, seen as a
@@ -693,6 +869,150 @@ struct Matrix : std::array<Vector<T, v_rows>, v_cols> {
         }
         return stream;
     }
+
+private:
+    /// @brief Writes the adjugate of the upper left 3x3 block into the same block of result and returns the determinant
+    /// of that block.
+    /// @remark The rows of the adjugate are the cross products of the columns.
+    constexpr T adjugate3x3(Matrix& result) const
+    {
+        static_assert(cols >= 3 && rows >= 3);
+        const auto& a = *this;
+
+        result(0, 0) = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+        result(1, 0) = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+        result(2, 0) = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+        result(0, 1) = a(2, 1) * a(0, 2) - a(2, 2) * a(0, 1);
+        result(1, 1) = a(2, 2) * a(0, 0) - a(2, 0) * a(0, 2);
+        result(2, 1) = a(2, 0) * a(0, 1) - a(2, 1) * a(0, 0);
+        result(0, 2) = a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1);
+        result(1, 2) = a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2);
+        result(2, 2) = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+
+        return a(0, 0) * result(0, 0) + a(0, 1) * result(1, 0) + a(0, 2) * result(2, 0);
+    }
+};
+
+/// @brief The LU decomposition of a square matrix using scaled partial pivoting, so that P * A = L * U.
+/// @remark L and U are stored in a single matrix, as the diagonal of L always consists of ones.
+template <typename T, std::size_t v_dim>
+struct LUDecomposition {
+    static constexpr auto dim = v_dim;
+
+    /// @brief Contains L below the diagonal and U on and above the diagonal.
+    Matrix<T, dim> lu;
+    /// @brief The row of the original matrix for each row of the decomposition.
+    std::array<std::size_t, dim> permutation{};
+    /// @brief Whether an odd number of rows were swapped, which negates the determinant.
+    bool odd_permutation = false;
+    /// @brief Whether no pivot could be found for a column, meaning the original matrix cannot be inverted.
+    /// @remark Pivots are treated as zero, if they are within rounding error (dim * epsilon) of the largest entry of
+    /// their row in the original matrix.
+    bool singular = false;
+
+    /// @brief Initializes an empty decomposition.
+    constexpr LUDecomposition() = default;
+
+    /// @brief Decomposes the given matrix using Gaussian elimination with scaled partial pivoting.
+    explicit constexpr LUDecomposition(const Matrix<T, dim>& matrix)
+        : lu(matrix)
+    {
+        auto magnitude = [](T value) { return value < T{} ? -value : value; };
+
+        // Pivots are compared relative to their own row, so that rows of very different magnitude, as in well
+        // conditioned diagonal matrices, are not mistaken for rounding error of the largest row.
+        std::array<T, dim> row_scales{};
+        for (std::size_t col = 0; col < dim; col++) {
+            for (std::size_t row = 0; row < dim; row++)
+                row_scales[row] = std::max(row_scales[row], magnitude(lu(col, row)));
+        }
+        auto scaled = [&](std::size_t col, std::size_t row) {
+            auto scale = row_scales[permutation[row]];
+            return scale > T{} ? magnitude(lu(col, row)) / scale : T{};
+        };
+
+        // Elimination rarely cancels out exactly, e.g. when the compiler contracts it into fused multiply-adds.
+        const T tolerance = static_cast<T>(dim) * std::numeric_limits<T>::epsilon();
+
+        for (std::size_t row = 0; row < dim; row++)
+            permutation[row] = row;
+
+        for (std::size_t k = 0; k < dim; k++) {
+            std::size_t pivot = k;
+            for (std::size_t row = k + 1; row < dim; row++) {
+                if (scaled(k, row) > scaled(k, pivot))
+                    pivot = row;
+            }
+
+            if (scaled(k, pivot) <= tolerance) {
+                singular = true;
+                continue;
+            }
+
+            if (pivot != k) {
+                for (std::size_t col = 0; col < dim; col++)
+                    std::swap(lu(col, k), lu(col, pivot));
+                std::swap(permutation[k], permutation[pivot]);
+                odd_permutation = !odd_permutation;
+            }
+
+            for (std::size_t row = k + 1; row < dim; row++)
+                lu(k, row) /= lu(k, k);
+
+            for (std::size_t col = k + 1; col < dim; col++) {
+                const T factor = lu(col, k);
+                for (std::size_t row = k + 1; row < dim; row++)
+                    lu(col, row) -= lu(k, row) * factor;
+            }
+        }
+    }
+
+    /// @brief Returns the determinant of the original matrix.
+    constexpr T determinant() const
+    {
+        if (singular)
+            return T{};
+
+        T result{1};
+        for (std::size_t i = 0; i < dim; i++)
+            result *= lu(i, i);
+        return odd_permutation ? -result : result;
+    }
+
+    /// @brief Solves the original matrix, when seen as a linear equation in combination with the given vector.
+    constexpr std::optional<Vector<T, dim>> solve(const Vector<T, dim>& vector) const
+    {
+        if (singular)
+            return std::nullopt;
+
+        Vector<T, dim> result;
+        for (std::size_t row = 0; row < dim; row++) {
+            result[row] = vector[permutation[row]];
+            for (std::size_t col = 0; col < row; col++)
+                result[row] -= lu(col, row) * result[col];
+        }
+        for (std::size_t row = dim; row-- > 0;) {
+            for (std::size_t col = row + 1; col < dim; col++)
+                result[row] -= lu(col, row) * result[col];
+            result[row] /= lu(row, row);
+        }
+        return result;
+    }
+
+    /// @brief Returns the inverse of the original matrix.
+    constexpr std::optional<Matrix<T, dim>> inverse() const
+    {
+        if (singular)
+            return std::nullopt;
+
+        Matrix<T, dim> result;
+        for (std::size_t col = 0; col < dim; col++) {
+            Vector<T, dim> unit;
+            unit[col] = T{1};
+            result[col] = *solve(unit);
+        }
+        return result;
+    }
 };
 
 template <std::size_t v_cols, std::size_t v_rows = v_cols>
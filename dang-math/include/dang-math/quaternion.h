@@ -105,7 +105,9 @@ struct Quaternion : private Vector<T, 4> {
     /// @brief Returns the vector z-part of the quaternion.
     constexpr T z() const { return Base::z(); }
 
-    using Base::dot;
+    /// @brief Returns the dot-product with the given quaternion.
+    constexpr T dot(const Quaternion& other) const { return Base::dot(other); }
+
     using Base::sqrdot;
 
     /// @brief Returns the normalized quaternion, which can safely be applied using multiplication.
@@ -247,13 +249,13 @@ struct Quaternion : private Vector<T, 4> {
     /// @brief Returns true, if both quaternions are identical.
     friend constexpr bool operator==(const Quaternion& lhs, const Quaternion& rhs)
     {
-        return Base::operator==(lhs, rhs);
+        return lhs.asVector() == rhs.asVector();
     }
 
     /// @brief Returns true, if the quaternions differ.
     friend constexpr bool operator!=(const Quaternion& lhs, const Quaternion& rhs)
     {
-        return Base::operator!=(lhs, rhs);
+        return lhs.asVector() != rhs.asVector();
     }
 
     struct SlerpResult {
@@ -308,6 +310,15 @@ struct Quaternion : private Vector<T, 4> {
             return result.normalize();
         return result;
     }
+
+    /// @brief Performs a normalized linear interpolation, which is cheaper than slerp, but does not have constant
+    /// velocity.
+    /// @remark Like slerp, the interpolation always takes the shorter path.
+    constexpr Quaternion nlerp(const Quaternion& target, T factor) const
+    {
+        T target_factor = dot(target) < T() ? -factor : factor;
+        return ((T(1) - factor) * *this + target_factor * target).normalize();
+    }
 };
 
 /// @brief A dual-quaternion, which can represent both rotation (real) and translation (dual).
@@ -358,7 +369,7 @@ struct DualQuaternion {
     static constexpr DualQuaternion fromEulerRad(const Vector<T, v_angle_count>& radians,
                                                  const std::array<Axis3, v_angle_count>& order)
     {
-        return DualQuaternion(Quaternion<T>::fromEulerRad<v_angle_count>(radians, order));
+        return DualQuaternion(Quaternion<T>::template fromEulerRad<v_angle_count>(radians, order));
     }
 
     /// @brief Returns a dual-quaternion with all euler angles in degrees applied in the given order.
@@ -366,7 +377,7 @@ struct DualQuaternion {
     static constexpr DualQuaternion fromEuler(const Vector<T, v_angle_count>& degrees,
                                               const std::array<Axis3, v_angle_count>& order)
     {
-        return DualQuaternion(Quaternion<T>::fromEuler<v_angle_count>(degrees, order));
+        return DualQuaternion(Quaternion<T>::template fromEuler<v_angle_count>(degrees, order));
     }
 
     /// @brief Returns a dual-quaternion with all euler angles in radians applied in YXZ-order.
@@ -420,7 +431,7 @@ struct DualQuaternion {
     constexpr DualQuaternion normalize() const { return *this / real.magnitude(); }
 
     /// @brief Returns the dot product between the real-parts of the dual-quaternions.
-    constexpr Quaternion<T> dot(const DualQuaternion& other) const { return real.dot(other.real); }
+    constexpr T dot(const DualQuaternion& other) const { return real.dot(other.real); }
 
     /// @brief Returns the inverse of the dual-quaternion, assuming it is normalized, for which it simply calculates the
     /// conjugate for both parts.
@@ -455,7 +466,7 @@ struct DualQuaternion {
     constexpr Matrix<T, 4> toMatrix() const
     {
         Matrix<T, 4> result;
-        result.setSubMatrix<0, 0, 3, 3>(real.toMatrix());
+        result.template setSubMatrix<0, 0, 3, 3>(real.toMatrix());
         result[3] = Vector<T, 4>(translation(), T(1));
         return result;
     }
@@ -560,6 +571,15 @@ struct DualQuaternion {
             return result.normalize();
         return result;
     }
+
+    /// @brief Performs a normalized linear interpolation, which is cheaper than slerp, but does not have constant
+    /// velocity.
+    /// @remark Commonly used to blend bone transformations, as it is still well-behaved for close rotations.
+    constexpr DualQuaternion nlerp(const DualQuaternion& target, T factor) const
+    {
+        T target_factor = real.dot(target.real) < T() ? -factor : factor;
+        return ((T(1) - factor) * *this + target_factor * target).normalize();
+    }
 };
 
 using quat = Quaternion<float>;
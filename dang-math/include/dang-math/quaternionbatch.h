@@ -0,0 +1,348 @@
+#pragma once
+
+#include "dang-math/global.h"
+#include "dang-math/quaternion.h"
+#include "dang-math/simd.h"
+#include "dang-math/vector.h"
+
+#include "dang-utils/parallel.h"
+
+namespace dang::math {
+
+namespace detail {
+
+/// @brief The minimum number of elements per thread, as smaller chunks are not worth the overhead of a thread.
+inline constexpr std::size_t batch_parallel_chunk_size = 1 << 14;
+
+/// @brief Calls function(index) for all elements, splitting large counts across the shared thread pool.
+template <typename TFunction>
+void forEachBatchElement(std::size_t count, TFunction function)
+{
+    auto& thread_pool = dutils::ThreadPool::shared();
+    dutils::parallelFor(thread_pool, count, batch_parallel_chunk_size, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; i++)
+            function(i);
+    });
+}
+
+/// @brief Calls kernel(packet, index) for all elements, splitting large counts across the shared thread pool.
+template <typename T, typename TKernel>
+void forEachBatchPacket(std::size_t count, TKernel kernel)
+{
+    auto& thread_pool = dutils::ThreadPool::shared();
+    dutils::parallelFor(thread_pool, count, batch_parallel_chunk_size, [&](std::size_t begin, std::size_t end) {
+        simd::forEachPacket<T>(end - begin, [&](auto packet, std::size_t index) { kernel(packet, begin + index); });
+    });
+}
+
+/// @brief Provides access to the components of records, which consist of nothing but values of type T.
+template <typename T, typename TRecord>
+struct BatchRecord {
+    static_assert(sizeof(TRecord) % sizeof(T) == 0);
+
+    /// @brief The number of values from the start of one record to the next.
+    static constexpr std::size_t stride = sizeof(TRecord) / sizeof(T);
+
+    static const T* data(const TRecord* records, std::size_t index)
+    {
+        return reinterpret_cast<const T*>(records + index);
+    }
+
+    static T* data(TRecord* records, std::size_t index) { return reinterpret_cast<T*>(records + index); }
+};
+
+/// @brief The components of multiple three-dimensional vectors, one packet per axis.
+template <typename TPacket>
+using Vector3Packet = std::array<TPacket, 3>;
+
+/// @brief Mirrors Vector::cross, so that results are identical.
+template <typename TPacket>
+Vector3Packet<TPacket> cross(const Vector3Packet<TPacket>& lhs, const Vector3Packet<TPacket>& rhs)
+{
+    return {lhs[1] * rhs[2] - lhs[2] * rhs[1], lhs[2] * rhs[0] - lhs[0] * rhs[2], lhs[0] * rhs[1] - lhs[1] * rhs[0]};
+}
+
+/// @brief Loads the vectors starting at the given index into one packet per axis.
+template <typename TPacket, typename T>
+Vector3Packet<TPacket> loadVector3Packet(const Vector<T, 3>* vectors, std::size_t index)
+{
+    using Record = BatchRecord<T, Vector<T, 3>>;
+    return TPacket::template loadTransposed<3, Record::stride>(Record::data(vectors, index));
+}
+
+/// @brief Stores one packet per axis into the vectors starting at the given index.
+template <typename TPacket, typename T>
+void storeVector3Packet(const Vector3Packet<TPacket>& packet, Vector<T, 3>* vectors, std::size_t index)
+{
+    using Record = BatchRecord<T, Vector<T, 3>>;
+    TPacket::template storeTransposed<3, Record::stride>(packet, Record::data(vectors, index));
+}
+
+/// @brief The components of multiple quaternions, one packet per component.
+/// @remark All operations mirror the order of operations of Quaternion, so that results are identical.
+template <typename TPacket>
+struct QuaternionPacket {
+    TPacket x, y, z, w;
+
+    template <typename T>
+    static QuaternionPacket broadcast(const Quaternion<T>& quaternion)
+    {
+        return {TPacket::broadcast(quaternion.x()),
+                TPacket::broadcast(quaternion.y()),
+                TPacket::broadcast(quaternion.z()),
+                TPacket::broadcast(quaternion.w())};
+    }
+
+    /// @brief Loads the xyzw-components of records, which are v_stride values apart.
+    template <std::size_t v_stride, typename T>
+    static QuaternionPacket load(const T* data)
+    {
+        auto [x, y, z, w] = TPacket::template loadTransposed<4, v_stride>(data);
+        return {x, y, z, w};
+    }
+
+    template <typename T>
+    static QuaternionPacket load(const Quaternion<T>* quaternions, std::size_t index)
+    {
+        using Record = BatchRecord<T, Quaternion<T>>;
+        return load<Record::stride>(Record::data(quaternions, index));
+    }
+
+    /// @brief Stores the xyzw-components into records, which are v_stride values apart.
+    template <std::size_t v_stride, typename T>
+    void store(T* data) const
+    {
+        TPacket::template storeTransposed<4, v_stride>({x, y, z, w}, data);
+    }
+
+    template <typename T>
+    void store(Quaternion<T>* quaternions, std::size_t index) const
+    {
+        using Record = BatchRecord<T, Quaternion<T>>;
+        store<Record::stride>(Record::data(quaternions, index));
+    }
+
+    TPacket dot(const QuaternionPacket& other) const
+    {
+        return x * other.x + y * other.y + z * other.z + w * other.w;
+    }
+
+    QuaternionPacket normalize() const { return *this / sqrt(dot(*this)); }
+
+    QuaternionPacket nlerp(const QuaternionPacket& target, TPacket factor) const
+    {
+        auto target_factor = selectLess(dot(target), TPacket::broadcast(0), -factor, factor);
+        return ((TPacket::broadcast(1) - factor) * *this + target_factor * target).normalize();
+    }
+
+    QuaternionPacket conjugate() const { return {-x, -y, -z, w}; }
+
+    QuaternionPacket operator-() const { return {-x, -y, -z, -w}; }
+
+    friend QuaternionPacket operator+(const QuaternionPacket& lhs, const QuaternionPacket& rhs)
+    {
+        return {lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w};
+    }
+
+    friend QuaternionPacket operator*(const QuaternionPacket& lhs, const QuaternionPacket& rhs)
+    {
+        return {lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+                lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+                lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+                lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z};
+    }
+
+    friend QuaternionPacket operator*(TPacket factor, const QuaternionPacket& quaternion)
+    {
+        return {quaternion.x * factor, quaternion.y * factor, quaternion.z * factor, quaternion.w * factor};
+    }
+
+    friend QuaternionPacket operator/(const QuaternionPacket& quaternion, TPacket factor)
+    {
+        return {quaternion.x / factor, quaternion.y / factor, quaternion.z / factor, quaternion.w / factor};
+    }
+
+    friend Vector3Packet<TPacket> operator*(const QuaternionPacket& quaternion, const Vector3Packet<TPacket>& vector)
+    {
+        Vector3Packet<TPacket> u{quaternion.x, quaternion.y, quaternion.z};
+        auto uv = cross(u, vector);
+        auto uuv = cross(u, uv);
+        auto two = TPacket::broadcast(2);
+        return {vector[0] + two * ((quaternion.w * uv[0]) + uuv[0]),
+                vector[1] + two * ((quaternion.w * uv[1]) + uuv[1]),
+                vector[2] + two * ((quaternion.w * uv[2]) + uuv[2])};
+    }
+};
+
+/// @brief The components of multiple dual-quaternions.
+/// @remark All operations mirror the order of operations of DualQuaternion, so that results are identical.
+template <typename TPacket>
+struct DualQuaternionPacket {
+    QuaternionPacket<TPacket> real;
+    QuaternionPacket<TPacket> dual;
+
+    template <typename T>
+    static DualQuaternionPacket broadcast(const DualQuaternion<T>& dual_quaternion)
+    {
+        return {QuaternionPacket<TPacket>::broadcast(dual_quaternion.real),
+                QuaternionPacket<TPacket>::broadcast(dual_quaternion.dual)};
+    }
+
+    template <typename T>
+    static DualQuaternionPacket load(const DualQuaternion<T>* dual_quaternions, std::size_t index)
+    {
+        using Record = BatchRecord<T, DualQuaternion<T>>;
+        const T* data = Record::data(dual_quaternions, index);
+        return {QuaternionPacket<TPacket>::template load<Record::stride>(data),
+                QuaternionPacket<TPacket>::template load<Record::stride>(data + Record::stride / 2)};
+    }
+
+    template <typename T>
+    void store(DualQuaternion<T>* dual_quaternions, std::size_t index) const
+    {
+        using Record = BatchRecord<T, DualQuaternion<T>>;
+        T* data = Record::data(dual_quaternions, index);
+        real.template store<Record::stride>(data);
+        dual.template store<Record::stride>(data + Record::stride / 2);
+    }
+
+    /// @brief Mirrors the DualQuaternion constructor, which copies the vector into the dual part.
+    static DualQuaternionPacket fromVector(const Vector3Packet<TPacket>& vector)
+    {
+        auto zero = TPacket::broadcast(0);
+        return {{zero, zero, zero, TPacket::broadcast(1)}, {vector[0], vector[1], vector[2], zero}};
+    }
+
+    DualQuaternionPacket conjugate() const { return {real.conjugate(), -dual.conjugate()}; }
+
+    DualQuaternionPacket normalize() const
+    {
+        auto magnitude = sqrt(real.dot(real));
+        return {real / magnitude, dual / magnitude};
+    }
+
+    DualQuaternionPacket nlerp(const DualQuaternionPacket& target, TPacket factor) const
+    {
+        auto target_factor = selectLess(real.dot(target.real), TPacket::broadcast(0), -factor, factor);
+        return ((TPacket::broadcast(1) - factor) * *this + target_factor * target).normalize();
+    }
+
+    friend DualQuaternionPacket operator+(const DualQuaternionPacket& lhs, const DualQuaternionPacket& rhs)
+    {
+        return {lhs.real + rhs.real, lhs.dual + rhs.dual};
+    }
+
+    friend DualQuaternionPacket operator*(TPacket factor, const DualQuaternionPacket& dual_quaternion)
+    {
+        return {factor * dual_quaternion.real, factor * dual_quaternion.dual};
+    }
+
+    friend DualQuaternionPacket operator*(const DualQuaternionPacket& lhs, const DualQuaternionPacket& rhs)
+    {
+        return {rhs.real * lhs.real, rhs.dual * lhs.real + rhs.real * lhs.dual};
+    }
+
+    friend Vector3Packet<TPacket> operator*(const DualQuaternionPacket& dual_quaternion,
+                                            const Vector3Packet<TPacket>& vector)
+    {
+        auto dual = (dual_quaternion.conjugate() * fromVector(vector) * dual_quaternion).dual;
+        return {dual.x, dual.y, dual.z};
+    }
+};
+
+/// @brief Shared implementation of QuaternionBatch and DualQuaternionBatch.
+template <typename T, typename TValue, template <typename> typename TValuePacket>
+struct QuaternionBatchBase {
+    using Value = TValue;
+    using Vector3 = Vector<T, 3>;
+
+    /// @brief Combines the values pair-wise.
+    static void multiply(std::span<const Value> lhs, std::span<const Value> rhs, std::span<Value> result)
+    {
+        assert(lhs.size() == result.size() && rhs.size() == result.size());
+        forEachBatchPacket<T>(result.size(), [&](auto packet, std::size_t index) {
+            using Packet = TValuePacket<decltype(packet)>;
+            (Packet::load(lhs.data(), index) * Packet::load(rhs.data(), index)).store(result.data(), index);
+        });
+    }
+
+    /// @brief Normalizes each value.
+    static void normalize(std::span<const Value> values, std::span<Value> result)
+    {
+        assert(values.size() == result.size());
+        forEachBatchPacket<T>(result.size(), [&](auto packet, std::size_t index) {
+            using Packet = TValuePacket<decltype(packet)>;
+            Packet::load(values.data(), index).normalize().store(result.data(), index);
+        });
+    }
+
+    /// @brief Performs a normalized linear interpolation between the pairs with a common factor.
+    static void nlerp(std::span<const Value> from, std::span<const Value> to, T factor, std::span<Value> result)
+    {
+        assert(from.size() == result.size() && to.size() == result.size());
+        forEachBatchPacket<T>(result.size(), [&](auto packet, std::size_t index) {
+            using Scalar = decltype(packet);
+            using Packet = TValuePacket<Scalar>;
+            auto interpolated = Packet::load(from.data(), index).nlerp(Packet::load(to.data(), index),
+                                                                        Scalar::broadcast(factor));
+            interpolated.store(result.data(), index);
+        });
+    }
+
+    /// @brief Performs a spherical interpolation between the pairs with a common factor.
+    /// @remark Stays a loop over single values, as there are no SIMD versions of acos and sin to build on.
+    static void slerp(std::span<const Value> from, std::span<const Value> to, T factor, std::span<Value> result)
+    {
+        assert(from.size() == result.size() && to.size() == result.size());
+        forEachBatchElement(result.size(), [&](std::size_t i) { result[i] = Value(from[i]).slerp(to[i], factor); });
+    }
+
+    /// @brief Applies each value to the vector at the same index.
+    static void transform(std::span<const Value> values, std::span<const Vector3> vectors, std::span<Vector3> result)
+    {
+        assert(values.size() == result.size() && vectors.size() == result.size());
+        forEachBatchPacket<T>(result.size(), [&](auto packet, std::size_t index) {
+            using Scalar = decltype(packet);
+            auto vector = loadVector3Packet<Scalar>(vectors.data(), index);
+            storeVector3Packet(TValuePacket<Scalar>::load(values.data(), index) * vector, result.data(), index);
+        });
+    }
+
+    /// @brief Applies a single value to all vectors.
+    static void transform(const Value& value, std::span<const Vector3> vectors, std::span<Vector3> result)
+    {
+        assert(vectors.size() == result.size());
+        forEachBatchPacket<T>(result.size(), [&](auto packet, std::size_t index) {
+            using Scalar = decltype(packet);
+            auto vector = loadVector3Packet<Scalar>(vectors.data(), index);
+            storeVector3Packet(TValuePacket<Scalar>::broadcast(value) * vector, result.data(), index);
+        });
+    }
+};
+
+} // namespace detail
+
+/// @brief Bulk operations on spans of quaternions, e.g. for thousands of instance or bone transformations per frame.
+/// @remark All operations but slerp transpose the values into one SIMD register per component, processing multiple
+/// at once.
+/// @remark Large spans are split across the threads of dutils::ThreadPool::shared().
+/// @remark Results match the corresponding Quaternion operations up to rounding and are only bit-identical if the
+/// compiler does not contract floating-point operations into fused multiply-adds.
+/// @remark Results may alias any of the inputs.
+template <typename T>
+struct QuaternionBatch : detail::QuaternionBatchBase<T, Quaternion<T>, detail::QuaternionPacket> {};
+
+/// @brief Bulk operations on spans of dual-quaternions, e.g. for skinning or lots of instance transformations.
+/// @remark All operations but slerp transpose the values into one SIMD register per component, processing multiple
+/// at once.
+/// @remark Large spans are split across the threads of dutils::ThreadPool::shared().
+/// @remark Results match the corresponding DualQuaternion operations up to rounding and are only bit-identical if
+/// the compiler does not contract floating-point operations into fused multiply-adds.
+/// @remark Results may alias any of the inputs.
+template <typename T>
+struct DualQuaternionBatch : detail::QuaternionBatchBase<T, DualQuaternion<T>, detail::DualQuaternionPacket> {};
+
+using quatbatch = QuaternionBatch<float>;
+using dquatbatch = DualQuaternionBatch<float>;
+
+} // namespace dang::math
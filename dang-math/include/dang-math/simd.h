@@ -0,0 +1,366 @@
+#pragma once
+
+#include "dang-math/global.h"
+
+#if !defined(DANG_MATH_NO_SIMD) &&                                                                                     \
+    (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DANG_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+// MSVC has no macro for SSSE3 and only reports it implicitly as part of AVX.
+#if defined(DANG_MATH_SSE2) && (defined(__SSSE3__) || defined(__AVX__))
+#define DANG_MATH_SSSE3
+#include <tmmintrin.h>
+#endif
+
+/// @brief SIMD kernels, which are used by the most common vector types outside of constant evaluation.
+/// @remark Defining DANG_MATH_NO_SIMD (or setting the DANG_MATH_SIMD CMake option to OFF) disables all kernels and
+/// falls back to the generic scalar loops.
+/// @remark Kernels follow the order of operations of the generic loops, but are only guaranteed to match them up to
+/// rounding, since the compiler is free to contract the generic loops into fused multiply-adds. Results are identical
+/// bit for bit only with contraction disabled (-ffp-contract=off for GCC/Clang), which is what the tests use.
+namespace dang::math::simd {
+
+/// @brief The component-wise operations, which might be provided by a kernel.
+/// @remark Arithmetic, bit operations and dot products are left to the compiler, which already vectorizes the generic
+/// loops just as well.
+enum class Op { Min, Max };
+
+/// @brief The component-wise comparisons, which might be provided by a kernel.
+enum class Cmp { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+/// @brief Whether SIMD kernels exist for vectors of the given type and dimension.
+template <typename T, std::size_t v_dim>
+inline constexpr bool supported_v = false;
+
+#ifdef DANG_MATH_SSE2
+
+template <>
+inline constexpr bool supported_v<float, 3> = true;
+
+template <>
+inline constexpr bool supported_v<float, 4> = true;
+
+template <>
+inline constexpr bool supported_v<int, 4> = true;
+
+#endif
+
+/// @brief Whether a kernel for the given component-wise operation exists.
+/// @remark Only vec3 is covered, as the compiler does not vectorize std::min/std::max on three floats by itself.
+template <typename T, std::size_t v_dim, Op v_op>
+inline constexpr bool supports_op_v = std::is_same_v<T, float> && v_dim == 3 && supported_v<T, v_dim>;
+
+/// @brief Whether kernels for component-wise comparisons exist.
+/// @remark Loading three lanes outweighs the gain of comparing them at once, so vec3 is left to the compiler.
+template <typename T, std::size_t v_dim>
+inline constexpr bool supports_compare_v = supported_v<T, v_dim> && v_dim != 3;
+
+/// @brief A single value, providing the same interface as a SIMD packet.
+/// @remark Used for the remainder of streams and as fallback for types without SIMD support.
+template <typename T>
+struct Scalar {
+    static constexpr std::size_t width = 1;
+
+    T value;
+
+    static Scalar load(const T* data) { return {*data}; }
+    static Scalar broadcast(T value) { return {value}; }
+    void store(T* data) const { *data = value; }
+
+    /// @brief Loads the first v_count components of a record, returning one packet per component.
+    template <std::size_t v_count, std::size_t>
+    static std::array<Scalar, v_count> loadTransposed(const T* data)
+    {
+        std::array<Scalar, v_count> result;
+        for (std::size_t i = 0; i < v_count; i++)
+            result[i] = {data[i]};
+        return result;
+    }
+
+    /// @brief Stores the first v_count components of a record from one packet per component.
+    template <std::size_t v_count, std::size_t>
+    static void storeTransposed(const std::array<Scalar, v_count>& packets, T* data)
+    {
+        for (std::size_t i = 0; i < v_count; i++)
+            data[i] = packets[i].value;
+    }
+
+    friend Scalar operator-(Scalar scalar) { return {-scalar.value}; }
+    friend Scalar operator+(Scalar lhs, Scalar rhs) { return {lhs.value + rhs.value}; }
+    friend Scalar operator-(Scalar lhs, Scalar rhs) { return {lhs.value - rhs.value}; }
+    friend Scalar operator*(Scalar lhs, Scalar rhs) { return {lhs.value * rhs.value}; }
+    friend Scalar operator/(Scalar lhs, Scalar rhs) { return {lhs.value / rhs.value}; }
+
+    friend Scalar min(Scalar lhs, Scalar rhs) { return {std::min(lhs.value, rhs.value)}; }
+    friend Scalar max(Scalar lhs, Scalar rhs) { return {std::max(lhs.value, rhs.value)}; }
+    friend Scalar sqrt(Scalar scalar) { return {std::sqrt(scalar.value)}; }
+
+    /// @brief Picks if_less where lhs < rhs and otherwise everywhere else.
+    friend Scalar selectLess(Scalar lhs, Scalar rhs, Scalar if_less, Scalar otherwise)
+    {
+        return lhs.value < rhs.value ? if_less : otherwise;
+    }
+};
+
+/// @brief The widest available packet type for the given type, falling back to Scalar.
+template <typename T>
+struct packet {
+    using type = Scalar<T>;
+};
+
+template <typename T>
+using packet_t = typename packet<T>::type;
+
+/// @brief Calls the kernel with (packet, index) for as many elements as possible using the widest packet type and with
+/// scalars for the remaining elements.
+/// @remark The kernel should be a generic lambda, using the type of its first parameter to load and store values.
+template <typename T, typename TKernel>
+void forEachPacket(std::size_t count, TKernel kernel)
+{
+    using Packet = packet_t<T>;
+    std::size_t index = 0;
+    if constexpr (Packet::width > 1) {
+        for (; index + Packet::width <= count; index += Packet::width)
+            kernel(Packet{}, index);
+    }
+    for (; index < count; index++)
+        kernel(Scalar<T>{}, index);
+}
+
+/// @brief Applies a component-wise operation on lhs and rhs and writes it into result.
+template <Op v_op, typename T, std::size_t v_dim>
+void apply(const T* lhs, const T* rhs, T* result);
+
+/// @brief Performs a component-wise comparison and returns a bitmask of the results, starting at the lowest bit.
+template <Cmp v_cmp, typename T, std::size_t v_dim>
+int compare(const T* lhs, const T* rhs);
+
+/// @brief Whether a kernel for multiplying a matrix of the given size with a vector exists.
+template <typename T, std::size_t v_cols, std::size_t v_rows>
+inline constexpr bool supports_transform_v = std::is_same_v<T, float> && supported_v<T, v_rows>;
+
+/// @brief Multiplies the column-major matrix with the given vector, summing up the scaled columns in order.
+template <typename T, std::size_t v_cols, std::size_t v_rows>
+void transform(const T* matrix, const T* vector, T* result);
+
+#ifdef DANG_MATH_SSE2
+
+namespace detail {
+
+/// @brief Loads three or four floats, filling the unused lane with zero.
+template <std::size_t v_dim>
+inline __m128 load(const float* data)
+{
+    if constexpr (v_dim == 4) {
+        return _mm_loadu_ps(data);
+    }
+    else {
+        static_assert(v_dim == 3);
+        // Avoids reading past the end and going through memory, which would stall store forwarding.
+        auto xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(data));
+        return _mm_movelh_ps(xy, _mm_load_ss(data + 2));
+    }
+}
+
+/// @brief Stores three or four floats, ignoring the unused lane.
+template <std::size_t v_dim>
+inline void store(float* data, __m128 value)
+{
+    if constexpr (v_dim == 4) {
+        _mm_storeu_ps(data, value);
+    }
+    else {
+        static_assert(v_dim == 3);
+        _mm_storel_pi(reinterpret_cast<__m64*>(data), value);
+        _mm_store_ss(data + 2, _mm_movehl_ps(value, value));
+    }
+}
+
+template <std::size_t v_dim>
+inline __m128i load(const int* data)
+{
+    static_assert(v_dim == 4);
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+template <std::size_t v_dim>
+inline void store(int* data, __m128i value)
+{
+    static_assert(v_dim == 4);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value);
+}
+
+} // namespace detail
+
+/// @brief Four floats, which are processed at once.
+struct Float4 {
+    static constexpr std::size_t width = 4;
+
+    __m128 value;
+
+    static Float4 load(const float* data) { return {_mm_loadu_ps(data)}; }
+    static Float4 broadcast(float value) { return {_mm_set1_ps(value)}; }
+    void store(float* data) const { _mm_storeu_ps(data, value); }
+
+    /// @brief Loads the first v_count components of four records, which are v_stride floats apart, returning one
+    /// packet per component.
+    /// @remark This transposes the records in registers, which is a lot cheaper than going through memory.
+    template <std::size_t v_count, std::size_t v_stride>
+    static std::array<Float4, v_count> loadTransposed(const float* data)
+    {
+        if constexpr (v_count == 3 && v_stride == 3) {
+            // Three loads cover exactly four tightly packed records: xyzx yzxy zxyz
+            auto a = _mm_loadu_ps(data);
+            auto b = _mm_loadu_ps(data + 4);
+            auto c = _mm_loadu_ps(data + 8);
+            auto xy23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+            auto yz01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+            return {Float4{_mm_shuffle_ps(a, xy23, _MM_SHUFFLE(2, 0, 3, 0))},
+                    Float4{_mm_shuffle_ps(yz01, xy23, _MM_SHUFFLE(3, 1, 2, 0))},
+                    Float4{_mm_shuffle_ps(yz01, c, _MM_SHUFFLE(3, 0, 3, 1))}};
+        }
+        else {
+            __m128 rows[4];
+            for (std::size_t i = 0; i < 4; i++)
+                rows[i] = detail::load<v_count>(data + i * v_stride);
+            _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+            std::array<Float4, v_count> result;
+            for (std::size_t i = 0; i < v_count; i++)
+                result[i] = {rows[i]};
+            return result;
+        }
+    }
+
+    /// @brief Stores the first v_count components of four records, which are v_stride floats apart, from one packet
+    /// per component.
+    template <std::size_t v_count, std::size_t v_stride>
+    static void storeTransposed(const std::array<Float4, v_count>& packets, float* data)
+    {
+        if constexpr (v_count == 3 && v_stride == 3) {
+            auto [x, y, z] = packets;
+            auto xy01 = _mm_shuffle_ps(x.value, y.value, _MM_SHUFFLE(1, 0, 1, 0));
+            auto zx01 = _mm_shuffle_ps(z.value, x.value, _MM_SHUFFLE(1, 1, 0, 0));
+            auto yz1 = _mm_shuffle_ps(y.value, z.value, _MM_SHUFFLE(1, 1, 1, 1));
+            auto xy2 = _mm_shuffle_ps(x.value, y.value, _MM_SHUFFLE(2, 2, 2, 2));
+            auto zx23 = _mm_shuffle_ps(z.value, x.value, _MM_SHUFFLE(3, 3, 2, 2));
+            auto yz3 = _mm_shuffle_ps(y.value, z.value, _MM_SHUFFLE(3, 3, 3, 3));
+            _mm_storeu_ps(data, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(data + 4, _mm_shuffle_ps(yz1, xy2, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(data + 8, _mm_shuffle_ps(zx23, yz3, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+        else {
+            __m128 rows[4];
+            for (std::size_t i = 0; i < 4; i++)
+                rows[i] = i < v_count ? packets[i].value : _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+            for (std::size_t i = 0; i < 4; i++)
+                detail::store<v_count>(data + i * v_stride, rows[i]);
+        }
+    }
+
+    // Flipping the sign bit is exactly what scalar negation does.
+    friend Float4 operator-(Float4 packet) { return {_mm_xor_ps(packet.value, _mm_set1_ps(-0.0f))}; }
+    friend Float4 operator+(Float4 lhs, Float4 rhs) { return {_mm_add_ps(lhs.value, rhs.value)}; }
+    friend Float4 operator-(Float4 lhs, Float4 rhs) { return {_mm_sub_ps(lhs.value, rhs.value)}; }
+    friend Float4 operator*(Float4 lhs, Float4 rhs) { return {_mm_mul_ps(lhs.value, rhs.value)}; }
+    friend Float4 operator/(Float4 lhs, Float4 rhs) { return {_mm_div_ps(lhs.value, rhs.value)}; }
+
+    // Operands are swapped to match std::min/std::max.
+    friend Float4 min(Float4 lhs, Float4 rhs) { return {_mm_min_ps(rhs.value, lhs.value)}; }
+    friend Float4 max(Float4 lhs, Float4 rhs) { return {_mm_max_ps(rhs.value, lhs.value)}; }
+    friend Float4 sqrt(Float4 packet) { return {_mm_sqrt_ps(packet.value)}; }
+
+    friend Float4 selectLess(Float4 lhs, Float4 rhs, Float4 if_less, Float4 otherwise)
+    {
+        auto mask = _mm_cmplt_ps(lhs.value, rhs.value);
+        return {_mm_or_ps(_mm_and_ps(mask, if_less.value), _mm_andnot_ps(mask, otherwise.value))};
+    }
+};
+
+template <>
+struct packet<float> {
+    using type = Float4;
+};
+
+template <Op v_op, typename T, std::size_t v_dim>
+inline void apply(const T* lhs, const T* rhs, T* result)
+{
+    static_assert(supports_op_v<T, v_dim, v_op>);
+    auto a = detail::load<v_dim>(lhs);
+    auto b = detail::load<v_dim>(rhs);
+    // Operands are swapped to match std::min/std::max, which return the first argument for ties and NaN.
+    if constexpr (v_op == Op::Min)
+        detail::store<v_dim>(result, _mm_min_ps(b, a));
+    else if constexpr (v_op == Op::Max)
+        detail::store<v_dim>(result, _mm_max_ps(b, a));
+}
+
+template <Cmp v_cmp, typename T, std::size_t v_dim>
+inline int compare(const T* lhs, const T* rhs)
+{
+    static_assert(supports_compare_v<T, v_dim>);
+    constexpr int lanes = (1 << v_dim) - 1;
+    if constexpr (std::is_same_v<T, float>) {
+        auto a = detail::load<v_dim>(lhs);
+        auto b = detail::load<v_dim>(rhs);
+        if constexpr (v_cmp == Cmp::Less)
+            return _mm_movemask_ps(_mm_cmplt_ps(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::LessEqual)
+            return _mm_movemask_ps(_mm_cmple_ps(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::Greater)
+            return _mm_movemask_ps(_mm_cmpgt_ps(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::GreaterEqual)
+            return _mm_movemask_ps(_mm_cmpge_ps(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::Equal)
+            return _mm_movemask_ps(_mm_cmpeq_ps(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::NotEqual)
+            return _mm_movemask_ps(_mm_cmpneq_ps(a, b)) & lanes;
+    }
+    else {
+        auto a = detail::load<v_dim>(lhs);
+        auto b = detail::load<v_dim>(rhs);
+        auto mask = [](__m128i value) { return _mm_movemask_ps(_mm_castsi128_ps(value)); };
+        if constexpr (v_cmp == Cmp::Less)
+            return mask(_mm_cmplt_epi32(a, b));
+        else if constexpr (v_cmp == Cmp::LessEqual)
+            return ~mask(_mm_cmpgt_epi32(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::Greater)
+            return mask(_mm_cmpgt_epi32(a, b));
+        else if constexpr (v_cmp == Cmp::GreaterEqual)
+            return ~mask(_mm_cmplt_epi32(a, b)) & lanes;
+        else if constexpr (v_cmp == Cmp::Equal)
+            return mask(_mm_cmpeq_epi32(a, b));
+        else if constexpr (v_cmp == Cmp::NotEqual)
+            return ~mask(_mm_cmpeq_epi32(a, b)) & lanes;
+    }
+}
+
+template <typename T, std::size_t v_cols, std::size_t v_rows>
+inline void transform(const T* matrix, const T* vector, T* result)
+{
+    static_assert(supports_transform_v<T, v_cols, v_rows>);
+    auto sum = _mm_setzero_ps();
+    if constexpr (v_cols == 3 || v_cols == 4) {
+        // Broadcast each lane of a single load instead of loading every component separately.
+        auto factors = detail::load<v_cols>(vector);
+        sum = _mm_add_ps(sum, _mm_mul_ps(detail::load<v_rows>(matrix), _mm_shuffle_ps(factors, factors, 0x00)));
+        sum = _mm_add_ps(sum,
+                         _mm_mul_ps(detail::load<v_rows>(matrix + v_rows), _mm_shuffle_ps(factors, factors, 0x55)));
+        sum = _mm_add_ps(
+            sum, _mm_mul_ps(detail::load<v_rows>(matrix + 2 * v_rows), _mm_shuffle_ps(factors, factors, 0xAA)));
+        if constexpr (v_cols == 4)
+            sum = _mm_add_ps(
+                sum, _mm_mul_ps(detail::load<v_rows>(matrix + 3 * v_rows), _mm_shuffle_ps(factors, factors, 0xFF)));
+    }
+    else {
+        for (std::size_t col = 0; col < v_cols; col++)
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::load<v_rows>(matrix + col * v_rows), _mm_set1_ps(vector[col])));
+    }
+    detail::store<v_rows>(result, sum);
+}
+
+#endif
+
+} // namespace dang::math::simd
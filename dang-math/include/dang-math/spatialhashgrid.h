@@ -0,0 +1,414 @@
+#pragma once
+
+#include "dang-math/bounds.h"
+#include "dang-math/global.h"
+#include "dang-math/vector.h"
+
+namespace dang::math {
+
+/// @brief Sorts points into a uniform grid of cells, which is stored sparsely in a hash table.
+/// @remark Meant for lots of evenly distributed and moving points, for which a BVH would constantly need to be rebuilt.
+/// Inserting, moving and removing points are all constant time.
+/// @remark Cells are looked up in a compact open addressing table using linear probing and hold the positions of their
+/// points next to each other, so that queries only touch a few contiguous arrays.
+/// @remark Handles stay valid until the point is removed and are reused afterwards.
+template <std::size_t v_dim, typename TPayload>
+class SpatialHashGrid {
+public:
+    static constexpr auto dim = v_dim;
+
+    using Payload = TPayload;
+    using Point = vec<dim>;
+    using Bounds = bounds<dim>;
+    using Cell = ivec<dim>;
+    using CellBounds = ibounds<dim>;
+    using Handle = std::size_t;
+
+    /// @brief A point returned by a nearest-point query together with its distance.
+    struct NearestResult {
+        Handle handle;
+        float distance;
+    };
+
+    /// @brief Creates an empty grid with cells of the given size along each axis.
+    /// @remark Ideally, cells are about as big as typical query ranges.
+    explicit SpatialHashGrid(float cell_size)
+        : cell_size_(cell_size)
+    {
+        assert(cell_size > 0.0f);
+    }
+
+    /// @brief The size of cells along each axis.
+    float cellSize() const { return cell_size_; }
+
+    /// @brief The number of points.
+    std::size_t size() const { return entries_.size() - free_entries_.size(); }
+
+    /// @brief Whether there are no points.
+    bool empty() const { return size() == 0; }
+
+    /// @brief The number of cells, which contain at least one point.
+    std::size_t cellCount() const { return cells_.size() - free_cells_.size(); }
+
+    /// @brief Whether the handle refers to a point, that has not been removed.
+    bool contains(Handle handle) const { return handle < entries_.size() && entries_[handle].payload.has_value(); }
+
+    /// @brief Provides access to the payload of a point.
+    Payload& operator[](Handle handle) { return *entries_[handle].payload; }
+
+    /// @brief Provides access to the payload of a point.
+    const Payload& operator[](Handle handle) const { return *entries_[handle].payload; }
+
+    /// @brief Returns the position of a point.
+    const Point& position(Handle handle) const { return entries_[handle].position; }
+
+    /// @brief Returns the cell, which contains the given position.
+    Cell cellAt(const Point& position) const
+    {
+        Cell result;
+        for (std::size_t i = 0; i < dim; i++)
+            result[i] = static_cast<int>(detail::floordiv(position[i], cell_size_));
+        return result;
+    }
+
+    /// @brief Returns all cells touched by the given bounds.
+    CellBounds cellBounds(const Bounds& bounds) const { return {cellAt(bounds.low), cellAt(bounds.high) + 1}; }
+
+    /// @brief Removes all points.
+    void clear()
+    {
+        entries_.clear();
+        free_entries_.clear();
+        cells_.clear();
+        free_cells_.clear();
+        slots_.clear();
+    }
+
+    /// @brief Inserts a new point and returns its handle.
+    Handle insert(const Point& position, Payload payload)
+    {
+        Index entry;
+        if (free_entries_.empty()) {
+            entry = static_cast<Index>(entries_.size());
+            entries_.push_back({position, invalid_index, invalid_index, std::move(payload)});
+        }
+        else {
+            entry = free_entries_.back();
+            free_entries_.pop_back();
+            entries_[entry] = {position, invalid_index, invalid_index, std::move(payload)};
+        }
+        addToCell(entry, cellAt(position));
+        return entry;
+    }
+
+    /// @brief Moves a point to a new position.
+    /// @remark Only touches the hash table, if the point moves into a different cell.
+    void move(Handle handle, const Point& position)
+    {
+        assert(contains(handle));
+        auto& entry = entries_[handle];
+        entry.position = position;
+        auto cell = cellAt(position);
+        if (cell == cells_[entry.cell].cell) {
+            cells_[entry.cell].items[entry.item].position = position;
+            return;
+        }
+        removeFromCell(static_cast<Index>(handle));
+        addToCell(static_cast<Index>(handle), cell);
+    }
+
+    /// @brief Removes a point, making its handle invalid.
+    void remove(Handle handle)
+    {
+        assert(contains(handle));
+        removeFromCell(static_cast<Index>(handle));
+        entries_[handle].payload.reset();
+        free_entries_.push_back(static_cast<Index>(handle));
+    }
+
+    /// @brief Calls function(handle) for all points within the given bounds, including its edges.
+    /// @remark Visits only the touched cells or all non-empty cells, depending on which are fewer.
+    template <typename TFunction>
+    void forEachInBounds(const Bounds& bounds, TFunction function) const
+    {
+        forEachCell(cellBounds(bounds), [&](const CellData& cell_data) {
+            for (const auto& item : cell_data.items)
+                if (bounds.containsInclusive(item.position))
+                    function(Handle{item.entry});
+        });
+    }
+
+    /// @brief Returns the handles of all points within the given bounds, including its edges.
+    std::vector<Handle> inBounds(const Bounds& bounds) const
+    {
+        std::vector<Handle> result;
+        forEachInBounds(bounds, [&](Handle handle) { result.push_back(handle); });
+        return result;
+    }
+
+    /// @brief Calls function(handle) for all points, which are at most the given radius away from the center.
+    template <typename TFunction>
+    void forEachInRadius(const Point& center, float radius, TFunction function) const
+    {
+        auto sqrradius = radius * radius;
+        forEachCell(cellBounds(Bounds(center - radius, center + radius)), [&](const CellData& cell_data) {
+            for (const auto& item : cell_data.items)
+                if ((item.position - center).sqrdot() <= sqrradius)
+                    function(Handle{item.entry});
+        });
+    }
+
+    /// @brief Returns the handles of all points, which are at most the given radius away from the center.
+    std::vector<Handle> inRadius(const Point& center, float radius) const
+    {
+        std::vector<Handle> result;
+        forEachInRadius(center, radius, [&](Handle handle) { result.push_back(handle); });
+        return result;
+    }
+
+    /// @brief Finds up to count points closest to the given position, sorted by distance.
+    /// @remark Searches rings of cells around the position, until no unvisited cell can contain a closer point. Once a
+    /// ring has more cells than there are non-empty cells, the remaining non-empty cells are checked directly instead.
+    std::vector<NearestResult> nearest(const Point& position,
+                                       std::size_t count,
+                                       float max_distance = std::numeric_limits<float>::infinity()) const
+    {
+        std::vector<NearestResult> result;
+        if (count == 0 || empty())
+            return result;
+
+        auto max_sqrdistance = max_distance * max_distance;
+        // A max-heap of the closest points so far, so that the furthest one can be replaced quickly.
+        auto further = [](const NearestResult& lhs, const NearestResult& rhs) { return lhs.distance < rhs.distance; };
+        auto addItems = [&](const CellData& cell_data) {
+            for (const auto& item : cell_data.items) {
+                auto sqrdistance = (item.position - position).sqrdot();
+                if (sqrdistance > max_sqrdistance)
+                    continue;
+                if (result.size() < count) {
+                    result.push_back({item.entry, sqrdistance});
+                    std::push_heap(result.begin(), result.end(), further);
+                }
+                else if (sqrdistance < result.front().distance) {
+                    std::pop_heap(result.begin(), result.end(), further);
+                    result.back() = {item.entry, sqrdistance};
+                    std::push_heap(result.begin(), result.end(), further);
+                }
+            }
+        };
+
+        auto center = cellAt(position);
+        for (int ring = 0;; ring++) {
+            if (ringCellCount(ring) > cellCount()) {
+                for (const auto& cell_data : cells_)
+                    if (!cell_data.items.empty() && ringOf(cell_data.cell, center) >= ring)
+                        addItems(cell_data);
+                break;
+            }
+
+            for (const auto& cell : CellBounds(center - ring, center + ring + 1))
+                if (ringOf(cell, center) == ring)
+                    if (auto cell_data = findCell(cell))
+                        addItems(*cell_data);
+
+            // Any point outside of the searched rings is at least as far away as the border of the searched cells.
+            auto border = std::numeric_limits<float>::infinity();
+            for (std::size_t i = 0; i < dim; i++) {
+                border = std::min(border, position[i] - static_cast<float>(center[i] - ring) * cell_size_);
+                border = std::min(border, static_cast<float>(center[i] + ring + 1) * cell_size_ - position[i]);
+            }
+            auto sqrborder = border * border;
+            if (sqrborder > max_sqrdistance || (result.size() == count && result.front().distance <= sqrborder))
+                break;
+        }
+
+        std::sort_heap(result.begin(), result.end(), further);
+        for (auto& nearest_result : result)
+            nearest_result.distance = std::sqrt(nearest_result.distance);
+        return result;
+    }
+
+private:
+    using Index = std::uint32_t;
+
+    static constexpr Index invalid_index = std::numeric_limits<Index>::max();
+
+    /// @brief The minimum number of slots in the hash table.
+    static constexpr std::size_t min_slot_count = 16;
+
+    struct Entry {
+        Point position;
+        Index cell;
+        /// @brief The index within the items of the cell.
+        Index item;
+        std::optional<Payload> payload;
+    };
+
+    /// @brief A copy of the position next to the entry, so that queries do not need to look up entries.
+    struct CellItem {
+        Point position;
+        Index entry;
+    };
+
+    struct CellData {
+        Cell cell;
+        std::vector<CellItem> items;
+    };
+
+    /// @brief A slot in the hash table, which refers to the data of a cell or is empty.
+    struct Slot {
+        Cell cell;
+        Index cell_data = invalid_index;
+    };
+
+    static std::size_t hash(const Cell& cell)
+    {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < dim; i++)
+            result = (result ^ static_cast<std::uint32_t>(cell[i])) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(result ^ (result >> 32));
+    }
+
+    /// @brief The Chebyshev distance between two cells.
+    static int ringOf(const Cell& cell, const Cell& center)
+    {
+        int result = 0;
+        for (std::size_t i = 0; i < dim; i++)
+            result = std::max(result, std::abs(cell[i] - center[i]));
+        return result;
+    }
+
+    /// @brief The number of cells with the given Chebyshev distance from a center cell.
+    static std::size_t ringCellCount(int ring)
+    {
+        std::size_t outer = 1;
+        std::size_t inner = 1;
+        for (std::size_t i = 0; i < dim; i++) {
+            outer *= static_cast<std::size_t>(2 * ring + 1);
+            inner *= static_cast<std::size_t>(std::max(2 * ring - 1, 0));
+        }
+        return outer - inner;
+    }
+
+    std::size_t slotMask() const { return slots_.size() - 1; }
+
+    /// @brief Returns the slot, which either holds the given cell or is the empty slot to insert it at.
+    std::size_t findSlot(const Cell& cell) const
+    {
+        auto slot = hash(cell) & slotMask();
+        while (slots_[slot].cell_data != invalid_index && slots_[slot].cell != cell)
+            slot = (slot + 1) & slotMask();
+        return slot;
+    }
+
+    const CellData* findCell(const Cell& cell) const
+    {
+        if (slots_.empty())
+            return nullptr;
+        auto cell_data = slots_[findSlot(cell)].cell_data;
+        return cell_data != invalid_index ? &cells_[cell_data] : nullptr;
+    }
+
+    /// @brief Calls function(cell_data) for all non-empty cells within the given cell bounds.
+    template <typename TFunction>
+    void forEachCell(const CellBounds& cell_bounds, TFunction function) const
+    {
+        std::size_t touched = 1;
+        for (std::size_t i = 0; i < dim; i++)
+            touched *= static_cast<std::size_t>(cell_bounds.high[i] - cell_bounds.low[i]);
+
+        if (touched > cellCount()) {
+            for (const auto& cell_data : cells_)
+                if (!cell_data.items.empty() && cell_bounds.contains(cell_data.cell))
+                    function(cell_data);
+            return;
+        }
+
+        for (const auto& cell : cell_bounds.xFirst())
+            if (auto cell_data = findCell(cell))
+                function(*cell_data);
+    }
+
+    /// @brief Doubles the size of the hash table and reinserts all cells.
+    void grow()
+    {
+        auto old_slots = std::move(slots_);
+        slots_.assign(std::max(old_slots.size() * 2, min_slot_count), Slot{});
+        for (const auto& slot : old_slots)
+            if (slot.cell_data != invalid_index)
+                slots_[findSlot(slot.cell)] = slot;
+    }
+
+    void addToCell(Index entry, const Cell& cell)
+    {
+        // Keep the load factor at or below one half, so that probe sequences stay short.
+        if ((cellCount() + 1) * 2 > slots_.size())
+            grow();
+
+        auto slot = findSlot(cell);
+        if (slots_[slot].cell_data == invalid_index) {
+            Index cell_data;
+            if (free_cells_.empty()) {
+                cell_data = static_cast<Index>(cells_.size());
+                cells_.push_back({cell, {}});
+            }
+            else {
+                // Reuse old cells, as their item vectors still hold on to their memory.
+                cell_data = free_cells_.back();
+                free_cells_.pop_back();
+                cells_[cell_data].cell = cell;
+            }
+            slots_[slot] = {cell, cell_data};
+        }
+
+        auto& items = cells_[slots_[slot].cell_data].items;
+        entries_[entry].cell = slots_[slot].cell_data;
+        entries_[entry].item = static_cast<Index>(items.size());
+        items.push_back({entries_[entry].position, entry});
+    }
+
+    void removeFromCell(Index entry)
+    {
+        auto cell_data = entries_[entry].cell;
+        auto& items = cells_[cell_data].items;
+        auto item = entries_[entry].item;
+
+        items[item] = items.back();
+        entries_[items[item].entry].item = item;
+        items.pop_back();
+
+        if (items.empty()) {
+            removeSlot(findSlot(cells_[cell_data].cell));
+            free_cells_.push_back(cell_data);
+        }
+    }
+
+    /// @brief Empties a slot by shifting back any following slots, which would otherwise become unreachable.
+    void removeSlot(std::size_t slot)
+    {
+        auto next = (slot + 1) & slotMask();
+        while (slots_[next].cell_data != invalid_index) {
+            auto home = hash(slots_[next].cell) & slotMask();
+            if (((next - home) & slotMask()) >= ((next - slot) & slotMask())) {
+                slots_[slot] = slots_[next];
+                slot = next;
+            }
+            next = (next + 1) & slotMask();
+        }
+        slots_[slot].cell_data = invalid_index;
+    }
+
+    float cell_size_;
+    std::vector<Entry> entries_;
+    std::vector<Index> free_entries_;
+    std::vector<CellData> cells_;
+    std::vector<Index> free_cells_;
+    std::vector<Slot> slots_;
+};
+
+template <typename TPayload>
+using spatialhashgrid2 = SpatialHashGrid<2, TPayload>;
+template <typename TPayload>
+using spatialhashgrid3 = SpatialHashGrid<3, TPayload>;
+
+} // namespace dang::math
@@ -2,6 +2,7 @@
 
 #include "dang-math/enums.h"
 #include "dang-math/global.h"
+#include "dang-math/simd.h"
 #include "dang-math/utils.h"
 
 namespace dang::math {
@@ -257,14 +258,14 @@ struct Vector : std::array<T, v_dim> {
     constexpr auto min(const Vector& other) const
     {
         static_assert(!std::is_same_v<T, bool>);
-        return variadicOp([](T a, T b) { return std::min(a, b); }, other);
+        return simdOp<simd::Op::Min>([](T a, T b) { return std::min(a, b); }, other);
     }
 
     /// @brief Returns a vector, only taking the larger components of both vectors.
     constexpr auto max(const Vector& other) const
     {
         static_assert(!std::is_same_v<T, bool>);
-        return variadicOp([](T a, T b) { return std::max(a, b); }, other);
+        return simdOp<simd::Op::Max>([](T a, T b) { return std::max(a, b); }, other);
     }
 
     /// @brief Returns a vector, for which each component is clamped between low and high.
@@ -305,28 +306,72 @@ struct Vector : std::array<T, v_dim> {
     }
 
     /// @brief Component-wise comparison, returning a bvec.
-    constexpr auto lessThan(const Vector& other) const { return variadicOp(std::less{}, other); }
+    constexpr auto lessThan(const Vector& other) const
+    {
+        return simdCompare<simd::Cmp::Less>(std::less{}, other);
+    }
 
     /// @brief Component-wise comparison, returning a bvec.
-    constexpr auto lessThanEqual(const Vector& other) const { return variadicOp(std::less_equal{}, other); }
+    constexpr auto lessThanEqual(const Vector& other) const
+    {
+        return simdCompare<simd::Cmp::LessEqual>(std::less_equal{}, other);
+    }
 
     /// @brief Component-wise comparison, returning a bvec.
-    constexpr auto greaterThan(const Vector& other) const { return variadicOp(std::greater{}, other); }
+    constexpr auto greaterThan(const Vector& other) const
+    {
+        return simdCompare<simd::Cmp::Greater>(std::greater{}, other);
+    }
 
     /// @brief Component-wise comparison, returning a bvec.
-    constexpr auto greaterThanEqual(const Vector& other) const { return variadicOp(std::greater_equal{}, other); }
+    constexpr auto greaterThanEqual(const Vector& other) const
+    {
+        return simdCompare<simd::Cmp::GreaterEqual>(std::greater_equal{}, other);
+    }
 
     /// @brief Component-wise comparison, returning a bvec.
-    constexpr auto equal(const Vector& other) const { return variadicOp(std::equal_to{}, other); }
+    constexpr auto equal(const Vector& other) const
+    {
+        return simdCompare<simd::Cmp::Equal>(std::equal_to{}, other);
+    }
 
     /// @brief Component-wise comparison, returning a bvec.
-    constexpr auto notEqual(const Vector& other) const { return variadicOp(std::not_equal_to{}, other); }
+    constexpr auto notEqual(const Vector& other) const
+    {
+        return simdCompare<simd::Cmp::NotEqual>(std::not_equal_to{}, other);
+    }
+
+    /// @brief Whether all components are less than the components of the given vector.
+    constexpr bool allLess(const Vector& other) const { return lessThan(other).all(); }
+
+    /// @brief Whether all components are less than or equal to the components of the given vector.
+    constexpr bool allLessEqual(const Vector& other) const { return lessThanEqual(other).all(); }
+
+    /// @brief Whether all components are greater than the components of the given vector.
+    constexpr bool allGreater(const Vector& other) const { return greaterThan(other).all(); }
+
+    /// @brief Whether all components are greater than or equal to the components of the given vector.
+    constexpr bool allGreaterEqual(const Vector& other) const { return greaterThanEqual(other).all(); }
 
     /// @brief Provided as constexpr, as std::array does not.
-    friend constexpr auto operator==(const Vector& lhs, const Vector& rhs) { return lhs.equal(rhs).all(); }
+    friend constexpr auto operator==(const Vector& lhs, const Vector& rhs)
+    {
+        if constexpr (simd::supports_compare_v<T, dim>) {
+            if (!std::is_constant_evaluated())
+                return simd::compare<simd::Cmp::Equal, T, dim>(lhs.data(), rhs.data()) == (1 << dim) - 1;
+        }
+        return lhs.equal(rhs).all();
+    }
 
     /// @brief Provided as constexpr, as std::array does not.
-    friend constexpr auto operator!=(const Vector& lhs, const Vector& rhs) { return lhs.notEqual(rhs).any(); }
+    friend constexpr auto operator!=(const Vector& lhs, const Vector& rhs)
+    {
+        if constexpr (simd::supports_compare_v<T, dim>) {
+            if (!std::is_constant_evaluated())
+                return simd::compare<simd::Cmp::NotEqual, T, dim>(lhs.data(), rhs.data()) != 0;
+        }
+        return lhs.notEqual(rhs).any();
+    }
 
     /// @brief Whether all components are true.
     constexpr auto all() const
@@ -817,6 +862,36 @@ struct Vector : std::array<T, v_dim> {
 #undef DMATH_DEFINE_SWIZZLE
 
 private:
+    /// @brief Uses a SIMD kernel for the given operation outside of constant evaluation, if one is available.
+    template <simd::Op v_op, typename TOperation>
+    constexpr auto simdOp(TOperation operation, const Vector& other) const
+    {
+        if constexpr (simd::supports_op_v<T, dim, v_op>) {
+            if (!std::is_constant_evaluated()) {
+                Vector result;
+                simd::apply<v_op, T, dim>(this->data(), other.data(), result.data());
+                return result;
+            }
+        }
+        return variadicOp(operation, other);
+    }
+
+    /// @brief Uses a SIMD kernel for the given comparison outside of constant evaluation, if one is available.
+    template <simd::Cmp v_cmp, typename TOperation>
+    constexpr Vector<bool, dim> simdCompare(TOperation operation, const Vector& other) const
+    {
+        if constexpr (simd::supports_compare_v<T, dim>) {
+            if (!std::is_constant_evaluated()) {
+                auto mask = simd::compare<v_cmp, T, dim>(this->data(), other.data());
+                Vector<bool, dim> result;
+                for (std::size_t i = 0; i < dim; i++)
+                    result[i] = (mask >> i) & 1;
+                return result;
+            }
+        }
+        return variadicOp(operation, other);
+    }
+
     template <std::size_t... v_indices, std::size_t... v_other_indices>
     constexpr void setSwizzleHelper(Vector<T, sizeof...(v_indices)> vector, std::index_sequence<v_other_indices...>)
     {
@@ -0,0 +1,477 @@
+#pragma once
+
+#include "dang-math/global.h"
+#include "dang-math/matrix.h"
+#include "dang-math/quaternion.h"
+#include "dang-math/simd.h"
+#include "dang-math/vector.h"
+
+namespace dang::math {
+
+/// @brief A non-owning view of vectors, which are stored in one contiguous array per component.
+/// @remark Use a const-qualified type for read-only views, similar to std::span.
+/// @remark The layout differs from a span of vectors, which is why copyFrom and copyTo have to transpose the data.
+template <typename T, std::size_t v_dim>
+struct VectorSoASpan {
+    using Type = std::remove_const_t<T>;
+    static constexpr auto dim = v_dim;
+
+    using Vector = dang::math::Vector<Type, dim>;
+    using Component = std::span<T>;
+    using Components = std::array<Component, dim>;
+
+    /// @brief The individual components, which all have the same size.
+    Components components;
+
+    /// @brief Initializes an empty span.
+    constexpr VectorSoASpan() = default;
+
+    /// @brief Initializes the span with the given components, which must all have the same size.
+    explicit constexpr VectorSoASpan(const Components& components)
+        : components(components)
+    {
+        assert(std::all_of(
+            components.begin(), components.end(), [&](const auto& component) { return component.size() == size(); }));
+    }
+
+    /// @brief Allows for implicit conversion of a mutable span into a read-only span.
+    template <typename TOther,
+              typename = std::enable_if_t<std::is_same_v<const TOther, T> && !std::is_same_v<TOther, T>>>
+    constexpr VectorSoASpan(const VectorSoASpan<TOther, dim>& other)
+    {
+        std::copy(other.components.begin(), other.components.end(), components.begin());
+    }
+
+    /// @brief The number of vectors in the span.
+    constexpr std::size_t size() const
+    {
+        if constexpr (dim == 0)
+            return 0;
+        else
+            return components[0].size();
+    }
+
+    /// @brief Whether the span contains no vectors.
+    constexpr bool empty() const { return size() == 0; }
+
+    /// @brief Returns the contiguous values of a single component.
+    constexpr Component component(std::size_t axis) const { return components[axis]; }
+
+    /// @brief Gathers the components of the vector at the given index.
+    constexpr Vector operator[](std::size_t index) const
+    {
+        Vector result;
+        for (std::size_t axis = 0; axis < dim; axis++)
+            result[axis] = components[axis][index];
+        return result;
+    }
+
+    /// @brief Scatters the components of the vector to the given index.
+    constexpr void set(std::size_t index, const Vector& vector) const
+    {
+        for (std::size_t axis = 0; axis < dim; axis++)
+            components[axis][index] = vector[axis];
+    }
+
+    /// @brief Returns a view of count vectors, starting at the given offset.
+    constexpr VectorSoASpan subspan(std::size_t offset, std::size_t count = std::dynamic_extent) const
+    {
+        Components result;
+        for (std::size_t axis = 0; axis < dim; axis++)
+            result[axis] = components[axis].subspan(offset, count);
+        return VectorSoASpan(result);
+    }
+
+    /// @brief Copies the vectors from the given span, which must have the same size.
+    constexpr void copyFrom(std::span<const Vector> vectors) const
+    {
+        assert(vectors.size() == size());
+        for (std::size_t axis = 0; axis < dim; axis++) {
+            for (std::size_t index = 0; index < vectors.size(); index++)
+                components[axis][index] = vectors[index][axis];
+        }
+    }
+
+    /// @brief Copies all vectors into the given span, which must have the same size.
+    constexpr void copyTo(std::span<Vector> vectors) const
+    {
+        assert(vectors.size() == size());
+        for (std::size_t axis = 0; axis < dim; axis++) {
+            for (std::size_t index = 0; index < vectors.size(); index++)
+                vectors[index][axis] = components[axis][index];
+        }
+    }
+};
+
+/// @brief Stores a list of vectors as one contiguous array per component (structure of arrays).
+/// @remark The bulk operations process multiple vectors at once using SIMD packets, where supported.
+/// @remark Results follow the order of operations of the corresponding Vector, Matrix and Quaternion operations, but
+/// can still differ in rounding, since the compiler is free to contract either side into fused multiply-adds. Only
+/// with contraction disabled (-ffp-contract=off for GCC/Clang) are they identical bit for bit.
+template <typename T, std::size_t v_dim>
+class VectorSoA {
+public:
+    using Type = T;
+    static constexpr auto dim = v_dim;
+
+    using Vector = dang::math::Vector<T, dim>;
+    using Span = VectorSoASpan<T, dim>;
+    using ConstSpan = VectorSoASpan<const T, dim>;
+
+    /// @brief Initializes an empty list of vectors.
+    VectorSoA() = default;
+
+    /// @brief Initializes the list with size copies of the given vector.
+    explicit VectorSoA(std::size_t size, const Vector& value = {}) { resize(size, value); }
+
+    /// @brief Initializes the list with a copy of the given vectors.
+    explicit VectorSoA(std::span<const Vector> vectors)
+        : VectorSoA(vectors.size())
+    {
+        span().copyFrom(vectors);
+    }
+
+    /// @brief Initializes the list with a copy of the given vectors.
+    explicit VectorSoA(ConstSpan vectors)
+    {
+        for (std::size_t axis = 0; axis < dim; axis++)
+            components_[axis].assign(vectors.components[axis].begin(), vectors.components[axis].end());
+    }
+
+    /// @brief The number of vectors in the list.
+    std::size_t size() const
+    {
+        if constexpr (dim == 0)
+            return 0;
+        else
+            return components_[0].size();
+    }
+
+    /// @brief Whether the list contains no vectors.
+    bool empty() const { return size() == 0; }
+
+    /// @brief Reserves memory for the given number of vectors.
+    void reserve(std::size_t capacity)
+    {
+        for (auto& component : components_)
+            component.reserve(capacity);
+    }
+
+    /// @brief Resizes the list, filling new entries with the given vector.
+    void resize(std::size_t size, const Vector& value = {})
+    {
+        for (std::size_t axis = 0; axis < dim; axis++)
+            components_[axis].resize(size, value[axis]);
+    }
+
+    /// @brief Removes all vectors.
+    void clear()
+    {
+        for (auto& component : components_)
+            component.clear();
+    }
+
+    /// @brief Appends a single vector.
+    void push_back(const Vector& vector)
+    {
+        for (std::size_t axis = 0; axis < dim; axis++)
+            components_[axis].push_back(vector[axis]);
+    }
+
+    /// @brief Gathers the components of the vector at the given index.
+    Vector operator[](std::size_t index) const { return span()[index]; }
+
+    /// @brief Scatters the components of the vector to the given index.
+    void set(std::size_t index, const Vector& vector) { span().set(index, vector); }
+
+    /// @brief Returns the contiguous values of a single component.
+    std::span<T> component(std::size_t axis) { return components_[axis]; }
+
+    /// @brief Returns the contiguous values of a single component.
+    std::span<const T> component(std::size_t axis) const { return components_[axis]; }
+
+    /// @brief Returns a view of all vectors, which does not copy any data.
+    Span span()
+    {
+        typename Span::Components result;
+        for (std::size_t axis = 0; axis < dim; axis++)
+            result[axis] = components_[axis];
+        return Span(result);
+    }
+
+    /// @brief Returns a read-only view of all vectors, which does not copy any data.
+    ConstSpan span() const
+    {
+        typename ConstSpan::Components result;
+        for (std::size_t axis = 0; axis < dim; axis++)
+            result[axis] = components_[axis];
+        return ConstSpan(result);
+    }
+
+    /// @brief Allows for implicit conversion into a read-only view.
+    operator ConstSpan() const { return span(); }
+
+    /// @brief Copies all vectors into the given span, which must have the same size.
+    void copyTo(std::span<Vector> vectors) const { span().copyTo(vectors); }
+
+    /// @brief Returns a copy of all vectors as a list of vectors.
+    std::vector<Vector> toVectors() const
+    {
+        std::vector<Vector> result(size());
+        copyTo(result);
+        return result;
+    }
+
+    /// @brief Performs a component-wise addition.
+    friend VectorSoA operator+(const VectorSoA& lhs, const VectorSoA& rhs)
+    {
+        return lhs.binaryOp(rhs, [](auto a, auto b) { return a + b; });
+    }
+
+    /// @brief Performs a component-wise subtraction.
+    friend VectorSoA operator-(const VectorSoA& lhs, const VectorSoA& rhs)
+    {
+        return lhs.binaryOp(rhs, [](auto a, auto b) { return a - b; });
+    }
+
+    /// @brief Performs a component-wise multiplication.
+    friend VectorSoA operator*(const VectorSoA& lhs, const VectorSoA& rhs)
+    {
+        return lhs.binaryOp(rhs, [](auto a, auto b) { return a * b; });
+    }
+
+    /// @brief Performs a component-wise division.
+    friend VectorSoA operator/(const VectorSoA& lhs, const VectorSoA& rhs)
+    {
+        return lhs.binaryOp(rhs, [](auto a, auto b) { return a / b; });
+    }
+
+    /// @brief Performs a component-wise addition with the same vector for all entries.
+    friend VectorSoA operator+(const VectorSoA& lhs, const Vector& rhs)
+    {
+        return lhs.broadcastOp(rhs, [](auto a, auto b) { return a + b; });
+    }
+
+    /// @brief Performs a component-wise subtraction with the same vector for all entries.
+    friend VectorSoA operator-(const VectorSoA& lhs, const Vector& rhs)
+    {
+        return lhs.broadcastOp(rhs, [](auto a, auto b) { return a - b; });
+    }
+
+    /// @brief Performs a component-wise multiplication with the same vector for all entries.
+    friend VectorSoA operator*(const VectorSoA& lhs, const Vector& rhs)
+    {
+        return lhs.broadcastOp(rhs, [](auto a, auto b) { return a * b; });
+    }
+
+    /// @brief Performs a component-wise division with the same vector for all entries.
+    friend VectorSoA operator/(const VectorSoA& lhs, const Vector& rhs)
+    {
+        return lhs.broadcastOp(rhs, [](auto a, auto b) { return a / b; });
+    }
+
+    /// @brief Performs a component-wise addition.
+    friend VectorSoA& operator+=(VectorSoA& lhs, const VectorSoA& rhs) { return lhs = lhs + rhs; }
+    /// @brief Performs a component-wise subtraction.
+    friend VectorSoA& operator-=(VectorSoA& lhs, const VectorSoA& rhs) { return lhs = lhs - rhs; }
+    /// @brief Performs a component-wise multiplication.
+    friend VectorSoA& operator*=(VectorSoA& lhs, const VectorSoA& rhs) { return lhs = lhs * rhs; }
+    /// @brief Performs a component-wise division.
+    friend VectorSoA& operator/=(VectorSoA& lhs, const VectorSoA& rhs) { return lhs = lhs / rhs; }
+
+    /// @brief Performs a component-wise addition with the same vector for all entries.
+    friend VectorSoA& operator+=(VectorSoA& lhs, const Vector& rhs) { return lhs = lhs + rhs; }
+    /// @brief Performs a component-wise subtraction with the same vector for all entries.
+    friend VectorSoA& operator-=(VectorSoA& lhs, const Vector& rhs) { return lhs = lhs - rhs; }
+    /// @brief Performs a component-wise multiplication with the same vector for all entries.
+    friend VectorSoA& operator*=(VectorSoA& lhs, const Vector& rhs) { return lhs = lhs * rhs; }
+    /// @brief Performs a component-wise division with the same vector for all entries.
+    friend VectorSoA& operator/=(VectorSoA& lhs, const Vector& rhs) { return lhs = lhs / rhs; }
+
+    /// @brief Returns the dot-product of each vector with the vector at the same index in other.
+    std::vector<T> dot(const VectorSoA& other) const
+    {
+        assert(size() == other.size());
+        std::vector<T> result(size());
+        simd::forEachPacket<T>(size(), [&](auto packet, std::size_t index) {
+            using Packet = decltype(packet);
+            dotPacket<Packet>(*this, other, index).store(result.data() + index);
+        });
+        return result;
+    }
+
+    /// @brief Returns the dot-product of each vector with itself.
+    std::vector<T> sqrdot() const { return dot(*this); }
+
+    /// @brief Returns the length of each vector.
+    std::vector<T> length() const
+    {
+        static_assert(std::is_floating_point_v<T>);
+        std::vector<T> result(size());
+        simd::forEachPacket<T>(size(), [&](auto packet, std::size_t index) {
+            using Packet = decltype(packet);
+            sqrt(dotPacket<Packet>(*this, *this, index)).store(result.data() + index);
+        });
+        return result;
+    }
+
+    /// @brief Returns a list with each vector normalized.
+    VectorSoA normalize() const
+    {
+        static_assert(std::is_floating_point_v<T>);
+        VectorSoA result(size());
+        simd::forEachPacket<T>(size(), [&](auto packet, std::size_t index) {
+            using Packet = decltype(packet);
+            auto length = sqrt(dotPacket<Packet>(*this, *this, index));
+            for (std::size_t axis = 0; axis < dim; axis++)
+                (Packet::load(components_[axis].data() + index) / length)
+                    .store(result.components_[axis].data() + index);
+        });
+        return result;
+    }
+
+    /// @brief Returns the component-wise minimum over all vectors, which must not be empty.
+    /// @remark Reduces the vectors in order, so that the result matches repeated calls to Vector::min exactly, even
+    /// for signed zero.
+    Vector min() const
+    {
+        return reduce([](T a, T b) { return std::min(a, b); });
+    }
+
+    /// @brief Returns the component-wise maximum over all vectors, which must not be empty.
+    /// @remark Reduces the vectors in order, so that the result matches repeated calls to Vector::max exactly, even
+    /// for signed zero.
+    Vector max() const
+    {
+        return reduce([](T a, T b) { return std::max(a, b); });
+    }
+
+    /// @brief Performs a matrix-multiplication with each vector, seen as a single-column matrix.
+    template <std::size_t v_rows>
+    friend VectorSoA<T, v_rows> operator*(const Matrix<T, dim, v_rows>& matrix, const VectorSoA& vectors)
+    {
+        VectorSoA<T, v_rows> result(vectors.size());
+        simd::forEachPacket<T>(vectors.size(), [&](auto packet, std::size_t index) {
+            using Packet = decltype(packet);
+            std::array<Packet, dim> values;
+            for (std::size_t axis = 0; axis < dim; axis++)
+                values[axis] = Packet::load(vectors.components_[axis].data() + index);
+            for (std::size_t row = 0; row < v_rows; row++) {
+                auto sum = Packet::broadcast(T());
+                for (std::size_t col = 0; col < dim; col++)
+                    sum = sum + Packet::broadcast(matrix(col, row)) * values[col];
+                sum.store(result.component(row).data() + index);
+            }
+        });
+        return result;
+    }
+
+    /// @brief Applies the quaternion transformation to each vector.
+    friend VectorSoA operator*(const Quaternion<T>& quaternion, const VectorSoA& vectors)
+    {
+        static_assert(dim == 3);
+        VectorSoA result(vectors.size());
+        auto u = quaternion.vector();
+        simd::forEachPacket<T>(vectors.size(), [&](auto packet, std::size_t index) {
+            using Packet = decltype(packet);
+            auto cross = [](const std::array<Packet, 3>& lhs, const std::array<Packet, 3>& rhs) {
+                return std::array<Packet, 3>{lhs[1] * rhs[2] - lhs[2] * rhs[1],
+                                             lhs[2] * rhs[0] - lhs[0] * rhs[2],
+                                             lhs[0] * rhs[1] - lhs[1] * rhs[0]};
+            };
+            std::array<Packet, 3> packed_u{Packet::broadcast(u[0]), Packet::broadcast(u[1]), Packet::broadcast(u[2])};
+            std::array<Packet, 3> vector;
+            for (std::size_t axis = 0; axis < 3; axis++)
+                vector[axis] = Packet::load(vectors.components_[axis].data() + index);
+            auto uv = cross(packed_u, vector);
+            auto uuv = cross(packed_u, uv);
+            auto scalar = Packet::broadcast(quaternion.scalar());
+            auto two = Packet::broadcast(T(2));
+            for (std::size_t axis = 0; axis < 3; axis++)
+                (vector[axis] + two * ((scalar * uv[axis]) + uuv[axis])).store(result.components_[axis].data() + index);
+        });
+        return result;
+    }
+
+private:
+    /// @brief Calculates the dot-product of the packets at the given index, summing up components in order.
+    template <typename TPacket>
+    static TPacket dotPacket(const VectorSoA& lhs, const VectorSoA& rhs, std::size_t index)
+    {
+        auto result = TPacket::broadcast(T());
+        for (std::size_t axis = 0; axis < dim; axis++)
+            result = result + TPacket::load(lhs.components_[axis].data() + index) *
+                                  TPacket::load(rhs.components_[axis].data() + index);
+        return result;
+    }
+
+    /// @brief Applies the given operation on each component of each vector using the packets of lhs and rhs.
+    template <typename TOperation>
+    VectorSoA binaryOp(const VectorSoA& other, TOperation operation) const
+    {
+        assert(size() == other.size());
+        VectorSoA result(size());
+        for (std::size_t axis = 0; axis < dim; axis++) {
+            const T* lhs = components_[axis].data();
+            const T* rhs = other.components_[axis].data();
+            T* out = result.components_[axis].data();
+            simd::forEachPacket<T>(size(), [&](auto packet, std::size_t index) {
+                using Packet = decltype(packet);
+                operation(Packet::load(lhs + index), Packet::load(rhs + index)).store(out + index);
+            });
+        }
+        return result;
+    }
+
+    /// @brief Applies the given operation on each component of each vector using the same vector for rhs.
+    template <typename TOperation>
+    VectorSoA broadcastOp(const Vector& other, TOperation operation) const
+    {
+        VectorSoA result(size());
+        for (std::size_t axis = 0; axis < dim; axis++) {
+            const T* lhs = components_[axis].data();
+            T* out = result.components_[axis].data();
+            simd::forEachPacket<T>(size(), [&](auto packet, std::size_t index) {
+                using Packet = decltype(packet);
+                operation(Packet::load(lhs + index), Packet::broadcast(other[axis])).store(out + index);
+            });
+        }
+        return result;
+    }
+
+    /// @brief Reduces each component in order using the given operation.
+    template <typename TOperation>
+    Vector reduce(TOperation operation) const
+    {
+        assert(!empty());
+        Vector result;
+        for (std::size_t axis = 0; axis < dim; axis++) {
+            const auto& component = components_[axis];
+            result[axis] = std::accumulate(std::next(component.begin()), component.end(), component.front(), operation);
+        }
+        return result;
+    }
+
+    std::array<std::vector<T>, dim> components_;
+};
+
+template <std::size_t v_dim>
+using vecsoa = VectorSoA<float, v_dim>;
+template <std::size_t v_dim>
+using dvecsoa = VectorSoA<double, v_dim>;
+template <std::size_t v_dim>
+using ivecsoa = VectorSoA<int, v_dim>;
+
+using vec2soa = vecsoa<2>;
+using vec3soa = vecsoa<3>;
+using vec4soa = vecsoa<4>;
+
+using dvec2soa = dvecsoa<2>;
+using dvec3soa = dvecsoa<3>;
+using dvec4soa = dvecsoa<4>;
+
+using ivec2soa = ivecsoa<2>;
+using ivec3soa = ivecsoa<3>;
+using ivec4soa = ivecsoa<4>;
+
+} // namespace dang::math
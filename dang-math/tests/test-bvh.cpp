@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "dang-math/bounds.h"
+#include "dang-math/bvh.h"
+#include "dang-math/geometry.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+namespace {
+
+struct SampleGenerator : dutils::SampleGenerator {
+    dmath::vec3 point(float scale) { return dmath::vec3{nextFloat(), nextFloat(), nextFloat()} * scale; }
+
+    dmath::bounds3 bounds(float scale, float max_size)
+    {
+        auto low = point(scale);
+        return {low, low + point(max_size)};
+    }
+};
+
+std::vector<std::pair<dmath::bounds3, int>> sampleEntries(std::size_t count, unsigned seed)
+{
+    SampleGenerator generator{seed};
+    std::vector<std::pair<dmath::bounds3, int>> result;
+    for (std::size_t i = 0; i < count; i++)
+        result.emplace_back(generator.bounds(100.0f, 4.0f), static_cast<int>(i));
+    return result;
+}
+
+using BVH = dmath::bvh3<int>;
+
+/// @brief Returns the sorted payloads of all entries, whose bounds overlap with the given bounds.
+std::vector<int> overlappingPayloads(const BVH& bvh, const dmath::bounds3& bounds)
+{
+    std::vector<int> result;
+    bvh.forEachOverlap(bounds, [&](BVH::Handle handle) { result.push_back(bvh[handle]); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// @brief The reference implementation for overlap queries.
+std::vector<int> linearOverlappingPayloads(const std::vector<std::pair<dmath::bounds3, int>>& entries,
+                                           const dmath::bounds3& bounds)
+{
+    std::vector<int> result;
+    for (const auto& [entry_bounds, payload] : entries)
+        if (entry_bounds.overlaps(bounds))
+            result.push_back(payload);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// @brief The reference implementation for ray queries, returning the closest entry factor.
+std::optional<float> linearRaycast(const std::vector<std::pair<dmath::bounds3, int>>& entries, const dmath::Line3& line)
+{
+    std::optional<float> result;
+    for (const auto& [bounds, payload] : entries) {
+        float near = 0.0f;
+        float far = std::numeric_limits<float>::infinity();
+        for (std::size_t i = 0; i < 3; i++) {
+            float low = (bounds.low[i] - line.support[i]) * (1.0f / line.direction()[i]);
+            float high = (bounds.high[i] - line.support[i]) * (1.0f / line.direction()[i]);
+            near = std::max(near, std::min(low, high));
+            far = std::min(far, std::max(low, high));
+        }
+        if (near <= far && (!result || near < *result))
+            result = near;
+    }
+    return result;
+}
+
+/// @brief The reference implementation for nearest-point queries, returning the closest distance.
+float linearNearest(const std::vector<std::pair<dmath::bounds3, int>>& entries, const dmath::vec3& point)
+{
+    float result = std::numeric_limits<float>::infinity();
+    for (const auto& [bounds, payload] : entries)
+        result = std::min(result, (bounds.low - point).max((point - bounds.high).max(dmath::vec3())).length());
+    return result;
+}
+
+/// @brief Checks all kinds of queries against the reference implementations.
+void checkQueries(const BVH& bvh, const std::vector<std::pair<dmath::bounds3, int>>& entries, unsigned seed)
+{
+    SampleGenerator generator{seed};
+    for (int i = 0; i < 50; i++) {
+        auto bounds = generator.bounds(100.0f, 20.0f);
+        CHECK(overlappingPayloads(bvh, bounds) == linearOverlappingPayloads(entries, bounds));
+
+        dmath::Line3 line(generator.point(120.0f) - 10.0f, generator.point(2.0f) - 1.0f);
+        auto hit = bvh.raycast(line);
+        auto expected_hit = linearRaycast(entries, line);
+        REQUIRE(hit.has_value() == expected_hit.has_value());
+        if (hit)
+            CHECK(hit->factor == *expected_hit);
+
+        auto point = generator.point(120.0f) - 10.0f;
+        auto nearest = bvh.nearest(point);
+        REQUIRE(nearest.has_value() == !entries.empty());
+        if (nearest)
+            CHECK(nearest->distance == linearNearest(entries, point));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Bounds can be checked for overlaps and joined.", "[bounds]")
+{
+    dmath::bounds2 bounds({0.0f, 0.0f}, {2.0f, 2.0f});
+    CHECK(bounds.overlaps(dmath::bounds2({1.0f, 1.0f}, {3.0f, 3.0f})));
+    CHECK(bounds.overlaps(dmath::bounds2({2.0f, 0.0f}, {3.0f, 1.0f})));
+    CHECK_FALSE(bounds.overlaps(dmath::bounds2({2.5f, 0.0f}, {3.0f, 1.0f})));
+    CHECK_FALSE(dmath::ibounds2({0, 0}, {2, 2}).overlaps(dmath::ibounds2({2, 0}, {3, 1})));
+
+    auto joined = bounds.join(dmath::bounds2({-1.0f, 1.0f}, {1.0f, 3.0f}));
+    CHECK(joined.low == dmath::vec2(-1.0f, 0.0f));
+    CHECK(joined.high == dmath::vec2(2.0f, 3.0f));
+    CHECK(dmath::bounds2({1.0f, 2.0f}, {3.0f, 6.0f}).center() == dmath::vec2(2.0f, 4.0f));
+}
+
+TEST_CASE("A BVH answers queries like a linear scan.", "[bvh]")
+{
+    auto entries = sampleEntries(1000, 1);
+    BVH bvh(entries);
+    CHECK(bvh.size() == entries.size());
+    checkQueries(bvh, entries, 2);
+
+    SECTION("Entries can be inserted incrementally.")
+    {
+        BVH incremental;
+        for (const auto& [bounds, payload] : entries)
+            incremental.insert(bounds, payload);
+        checkQueries(incremental, entries, 3);
+    }
+    SECTION("Entries can be removed.")
+    {
+        for (BVH::Handle handle = 0; handle < entries.size(); handle += 3)
+            bvh.remove(handle);
+        std::vector<std::pair<dmath::bounds3, int>> remaining;
+        for (std::size_t i = 0; i < entries.size(); i++)
+            if (i % 3 != 0)
+                remaining.push_back(entries[i]);
+        CHECK(bvh.size() == remaining.size());
+        CHECK_FALSE(bvh.contains(0));
+        checkQueries(bvh, remaining, 4);
+
+        SECTION("Removed handles are reused by inserts.")
+        {
+            auto handle = bvh.insert(entries[0].first, entries[0].second);
+            CHECK(handle % 3 == 0);
+            remaining.push_back(entries[0]);
+            checkQueries(bvh, remaining, 5);
+        }
+        SECTION("The tree can be rebuilt.")
+        {
+            bvh.build();
+            checkQueries(bvh, remaining, 6);
+        }
+    }
+    SECTION("Entries can be moved and refit.")
+    {
+        SampleGenerator generator{7};
+        for (BVH::Handle handle = 0; handle < entries.size(); handle++) {
+            entries[handle].first = generator.bounds(100.0f, 4.0f);
+            bvh.setBounds(handle, entries[handle].first);
+        }
+        bvh.refit();
+        checkQueries(bvh, entries, 8);
+
+        entries[5].first = generator.bounds(100.0f, 4.0f);
+        bvh.update(5, entries[5].first);
+        checkQueries(bvh, entries, 9);
+    }
+    SECTION("Removing everything results in an empty tree.")
+    {
+        for (BVH::Handle handle = 0; handle < entries.size(); handle++)
+            bvh.remove(handle);
+        CHECK(bvh.empty());
+        CHECK_FALSE(bvh.bounds().has_value());
+        checkQueries(bvh, {}, 10);
+    }
+}
+
+TEST_CASE("A BVH can refine queries with the actual shapes of entries.", "[bvh]")
+{
+    // Spheres, which are hit at the center and have a distance of zero at their center.
+    std::vector<std::pair<dmath::bounds3, int>> entries;
+    for (int i = 0; i < 10; i++) {
+        dmath::vec3 center(static_cast<float>(i) * 10.0f, 0.0f, 0.0f);
+        entries.emplace_back(dmath::bounds3(center - 1.0f, center + 1.0f), i);
+    }
+    BVH bvh(entries);
+
+    auto center = [&](BVH::Handle handle) { return bvh.bounds(handle).center(); };
+
+    dmath::Line3 line(dmath::vec3(-5.0f, 0.0f, 0.0f), dmath::vec3(1.0f, 0.0f, 0.0f));
+    auto hit = bvh.raycast(line, [&](BVH::Handle handle, float) { return std::optional(center(handle).x() + 5.0f); });
+    REQUIRE(hit);
+    CHECK(bvh[hit->handle] == 0);
+    CHECK(hit->factor == 5.0f);
+
+    auto limited = bvh.raycast(line, 3.0f);
+    CHECK_FALSE(limited);
+
+    auto nearest =
+        bvh.nearest(dmath::vec3(42.0f, 0.5f, 0.0f), [&](BVH::Handle handle, float) { return center(handle).distanceTo(
+                                                        dmath::vec3(42.0f, 0.5f, 0.0f)); });
+    REQUIRE(nearest);
+    CHECK(bvh[nearest->handle] == 4);
+}
+
+TEST_CASE("BVH queries can be benchmarked against a linear scan.", "[.][bvh][benchmark]")
+{
+    auto entries = sampleEntries(10'000, 11);
+    BVH bvh(entries);
+
+    SampleGenerator generator{12};
+    std::vector<dmath::Line3> lines;
+    std::vector<dmath::bounds3> boxes;
+    for (int i = 0; i < 64; i++) {
+        lines.emplace_back(generator.point(120.0f) - 10.0f, generator.point(2.0f) - 1.0f);
+        boxes.push_back(generator.bounds(100.0f, 8.0f));
+    }
+
+    BENCHMARK("build")
+    {
+        return BVH(entries).size();
+    };
+
+    BENCHMARK("raycast (linear)")
+    {
+        float sum = 0.0f;
+        for (const auto& line : lines)
+            sum += linearRaycast(entries, line).value_or(0.0f);
+        return sum;
+    };
+    BENCHMARK("raycast (bvh)")
+    {
+        float sum = 0.0f;
+        for (const auto& line : lines)
+            if (auto hit = bvh.raycast(line))
+                sum += hit->factor;
+        return sum;
+    };
+
+    BENCHMARK("overlap (linear)")
+    {
+        std::size_t count = 0;
+        for (const auto& box : boxes)
+            for (const auto& [bounds, payload] : entries)
+                count += bounds.overlaps(box);
+        return count;
+    };
+    BENCHMARK("overlap (bvh)")
+    {
+        std::size_t count = 0;
+        for (const auto& box : boxes)
+            bvh.forEachOverlap(box, [&](BVH::Handle) { count++; });
+        return count;
+    };
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "dang-math/marchingcubesmesher.h"
+#include "dang-math/vector.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dmath = dang::math;
+
+namespace {
+
+/// @brief Samples a sphere, which is positive inside and negative outside.
+std::vector<float> sphereField(const dmath::ivec3& size, const dmath::vec3& center, float radius)
+{
+    std::vector<float> result;
+    for (int z = 0; z < size.z(); z++)
+        for (int y = 0; y < size.y(); y++)
+            for (int x = 0; x < size.x(); x++)
+                result.push_back(radius - dmath::vec3(dmath::ivec3(x, y, z)).distanceTo(center));
+    return result;
+}
+
+/// @brief Samples a few overlapping spheres as an occupancy field.
+std::vector<std::uint8_t> occupancyField(const dmath::ivec3& size)
+{
+    auto a = sphereField(size, dmath::vec3(10.0f, 12.0f, 11.0f), 7.5f);
+    auto b = sphereField(size, dmath::vec3(17.0f, 14.0f, 13.0f), 6.0f);
+    std::vector<std::uint8_t> result;
+    for (std::size_t i = 0; i < a.size(); i++)
+        result.push_back(a[i] > 0.0f || b[i] > 0.0f);
+    return result;
+}
+
+using Position = std::array<float, 3>;
+
+Position toArray(const dmath::vec3& position) { return {position.x(), position.y(), position.z()}; }
+
+/// @brief Returns the triangles as positions, rotated so that the smallest position comes first and sorted.
+std::vector<std::array<Position, 3>> sortedTriangles(const dmath::MarchingCubesMesh& mesh)
+{
+    std::vector<std::array<Position, 3>> result;
+    for (std::size_t i = 0; i < mesh.indices.size(); i += 3) {
+        std::array<Position, 3> triangle{toArray(mesh.positions[mesh.indices[i]]),
+                                         toArray(mesh.positions[mesh.indices[i + 1]]),
+                                         toArray(mesh.positions[mesh.indices[i + 2]])};
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        result.push_back(triangle);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// @brief Checks, that every edge is shared by exactly two triangles, which use it in opposite directions.
+/// @remark Vertices are identified by their position, as chunk borders duplicate vertices.
+bool isClosedAndConsistent(const dmath::MarchingCubesMesh& mesh)
+{
+    std::map<std::pair<Position, Position>, int> edges;
+    for (std::size_t i = 0; i < mesh.indices.size(); i += 3) {
+        for (std::size_t j = 0; j < 3; j++) {
+            auto from = toArray(mesh.positions[mesh.indices[i + j]]);
+            auto to = toArray(mesh.positions[mesh.indices[i + (j + 1) % 3]]);
+            edges[{from, to}]++;
+        }
+    }
+    return std::all_of(edges.begin(), edges.end(), [&](const auto& edge) {
+        auto reverse = edges.find({edge.first.second, edge.first.first});
+        return edge.second == 1 && reverse != edges.end() && reverse->second == 1;
+    });
+}
+
+} // namespace
+
+TEST_CASE("MarchingCubesMesher extracts closed meshes from scalar fields.", "[marchingcubes][mesher]")
+{
+    dmath::ivec3 size(30, 28, 26);
+    dmath::vec3 center(14.2f, 13.7f, 12.9f);
+    auto values = sphereField(size, center, 10.3f);
+    dmath::ScalarField field(std::span<const float>(values), size);
+
+    dmath::MarchingCubesMesher<> single_chunk(64);
+    dmath::MarchingCubesMesh single_mesh;
+    single_chunk.mesh(field, single_mesh);
+
+    REQUIRE_FALSE(single_mesh.indices.empty());
+    CHECK(single_mesh.indices.size() % 3 == 0);
+    CHECK(isClosedAndConsistent(single_mesh));
+
+    SECTION("Vertices lie on the surface.")
+    {
+        CHECK(std::all_of(single_mesh.positions.begin(), single_mesh.positions.end(), [&](const dmath::vec3& position) {
+            return std::abs(position.distanceTo(center) - 10.3f) < 0.05f;
+        }));
+    }
+    SECTION("Vertices are shared between cells.")
+    {
+        std::vector<Position> positions;
+        for (const auto& position : single_mesh.positions)
+            positions.push_back(toArray(position));
+        std::sort(positions.begin(), positions.end());
+        CHECK(std::adjacent_find(positions.begin(), positions.end()) == positions.end());
+        // Each vertex of a closed triangle mesh of genus zero is shared by six triangles on average.
+        CHECK(single_mesh.positions.size() * 5 < single_mesh.indices.size());
+    }
+    SECTION("Splitting the field into chunks results in the same triangles.")
+    {
+        auto chunk_size = GENERATE(1, 5, 8, 13);
+        CAPTURE(chunk_size);
+        dmath::MarchingCubesMesher<> chunked(chunk_size);
+        dmath::MarchingCubesMesh chunked_mesh;
+        chunked.mesh(field, chunked_mesh);
+        CHECK(sortedTriangles(chunked_mesh) == sortedTriangles(single_mesh));
+    }
+    SECTION("Meshing again reuses all buffers.")
+    {
+        dmath::MarchingCubesMesher<> chunked(8);
+        dmath::MarchingCubesMesh chunked_mesh;
+        chunked.mesh(field, chunked_mesh);
+        auto positions = chunked_mesh.positions.data();
+        auto indices = chunked_mesh.indices.data();
+        chunked.mesh(field, chunked_mesh);
+        CHECK(chunked_mesh.positions.data() == positions);
+        CHECK(chunked_mesh.indices.data() == indices);
+    }
+    SECTION("Only the given cells can be meshed.")
+    {
+        dmath::MarchingCubesMesh half_mesh;
+        single_chunk.meshCells(field, dmath::ibounds3({0, 0, 0}, {29, 27, 13}), half_mesh);
+        CHECK(half_mesh.indices.size() > single_mesh.indices.size() / 3);
+        CHECK(half_mesh.indices.size() < single_mesh.indices.size() * 2 / 3);
+        CHECK(std::all_of(half_mesh.positions.begin(), half_mesh.positions.end(), [](const dmath::vec3& position) {
+            return position.z() <= 13.0f;
+        }));
+    }
+}
+
+TEMPLATE_TEST_CASE("MarchingCubesMesher extracts closed meshes from occupancy fields.",
+                   "[marchingcubes][mesher]",
+                   dmath::MarchingCubesMesher<>,
+                   dmath::MarchingCubesMesher<true>)
+{
+    dmath::ivec3 size(28, 26, 24);
+    auto values = occupancyField(size);
+    dmath::ScalarField field(std::span<const std::uint8_t>(values), size);
+
+    TestType mesher(7);
+    dmath::MarchingCubesMesh mesh;
+    mesher.mesh(field, mesh);
+
+    REQUIRE_FALSE(mesh.indices.empty());
+    CHECK(isClosedAndConsistent(mesh));
+}
+
+TEST_CASE("MarchingCubesMesher throughput can be benchmarked.", "[.][marchingcubes][mesher][benchmark]")
+{
+    // Divide the number of cells by the measured time to get voxels per second.
+    dmath::ivec3 size(129);
+    std::vector<float> values;
+    for (int z = 0; z < size.z(); z++)
+        for (int y = 0; y < size.y(); y++)
+            for (int x = 0; x < size.x(); x++)
+                values.push_back(std::sin(x * 0.21f) + std::sin(y * 0.17f) * std::cos(z * 0.13f));
+    dmath::ScalarField field(std::span<const float>(values), size);
+
+    dmath::MarchingCubesMesher<> mesher;
+    dmath::MarchingCubesMesh mesh;
+
+    BENCHMARK("128^3 cells")
+    {
+        mesher.mesh(field, mesh);
+        return mesh.indices.size();
+    };
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dang-math/bounds.h"
+#include "dang-math/marchingcubesmesher.h"
+#include "dang-math/marchingcubesvolume.h"
+#include "dang-math/vector.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dmath = dang::math;
+
+namespace {
+
+using Position = std::array<float, 3>;
+using Triangle = std::array<Position, 3>;
+
+/// @brief Appends the triangles of the mesh, rotated so that the smallest position comes first.
+void appendTriangles(const dmath::MarchingCubesMesh& mesh, std::vector<Triangle>& triangles)
+{
+    auto toArray = [](const dmath::vec3& position) { return Position{position.x(), position.y(), position.z()}; };
+    for (std::size_t i = 0; i < mesh.indices.size(); i += 3) {
+        Triangle triangle{toArray(mesh.positions[mesh.indices[i]]),
+                          toArray(mesh.positions[mesh.indices[i + 1]]),
+                          toArray(mesh.positions[mesh.indices[i + 2]])};
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+}
+
+/// @brief Returns the sorted triangles of all chunks of the volume.
+template <typename TVolume>
+std::vector<Triangle> volumeTriangles(const TVolume& volume)
+{
+    std::vector<Triangle> result;
+    for (const auto& chunk : dmath::ibounds3(volume.chunkCount()))
+        appendTriangles(volume.chunkMesh(chunk), result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// @brief Returns the sorted triangles of a full remesh of the field.
+template <typename TVolume>
+std::vector<Triangle> remeshedTriangles(const TVolume& volume)
+{
+    dmath::MarchingCubesMesher<> mesher(8);
+    dmath::MarchingCubesMesh mesh;
+    mesher.mesh(volume.field(), mesh, volume.iso());
+    std::vector<Triangle> result;
+    appendTriangles(mesh, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// @brief Sets all samples within a sphere to the given value.
+template <typename TVolume>
+void brush(TVolume& volume, const dmath::ivec3& center, int radius, typename TVolume::Value value)
+{
+    volume.modify(dmath::ibounds3(center - radius, center + radius + 1), [&](const dmath::ivec3& point, auto& sample) {
+        if ((point - center).sqrdot() <= radius * radius)
+            sample = value;
+    });
+}
+
+} // namespace
+
+TEST_CASE("MarchingCubesVolume only remeshes chunks affected by edits.", "[marchingcubes][volume]")
+{
+    dmath::MarchingCubesVolume<float> volume(dmath::ivec3(33, 30, 25), 0.0f, -1.0f, 8);
+    CHECK(volume.chunkCount() == dmath::ivec3(4, 4, 3));
+    CHECK(volume.dirtyChunks().size() == 48);
+    CHECK(volume.update() == 48);
+    CHECK_FALSE(volume.isDirty());
+    CHECK(volume.update() == 0);
+
+    SECTION("An edit inside of a chunk only affects that chunk.")
+    {
+        brush(volume, {12, 12, 12}, 2, 1.0f);
+        CHECK(volume.dirtyChunks() == std::vector<dmath::ivec3>{{1, 1, 1}});
+
+        std::vector<dmath::ivec3> patches;
+        volume.update([&](const dmath::ivec3& chunk, const dmath::MarchingCubesMesh& mesh) {
+            patches.push_back(chunk);
+            CHECK_FALSE(mesh.indices.empty());
+        });
+        CHECK(patches == std::vector<dmath::ivec3>{{1, 1, 1}});
+        CHECK(volumeTriangles(volume) == remeshedTriangles(volume));
+    }
+    SECTION("An edit on a chunk border also affects the neighboring chunks.")
+    {
+        volume.set({8, 8, 4}, 1.0f);
+        const auto& dirty = volume.dirtyChunks();
+        CHECK(dirty.size() == 4);
+        for (const auto& chunk : dmath::ibounds3(dmath::ivec3(0, 0, 0), dmath::ivec3(2, 2, 1)))
+            CHECK(std::find(dirty.begin(), dirty.end(), chunk) != dirty.end());
+
+        volume.update();
+        CHECK(volumeTriangles(volume) == remeshedTriangles(volume));
+    }
+    SECTION("Multiple edits are combined until the next update.")
+    {
+        brush(volume, {3, 3, 3}, 3, 1.0f);
+        brush(volume, {20, 25, 18}, 5, 1.0f);
+        brush(volume, {4, 4, 4}, 2, -1.0f);
+        volume.update();
+        CHECK(volumeTriangles(volume) == remeshedTriangles(volume));
+
+        SECTION("Edits on the edge of the volume are clamped.")
+        {
+            brush(volume, {32, 29, 24}, 4, 1.0f);
+            volume.update();
+            CHECK(volumeTriangles(volume) == remeshedTriangles(volume));
+        }
+    }
+}
+
+TEST_CASE("MarchingCubesVolume edit to mesh latency can be benchmarked.", "[.][marchingcubes][volume][benchmark]")
+{
+    dmath::MarchingCubesVolume<std::uint8_t> volume(dmath::ivec3(512), 0, 0);
+    brush(volume, {256, 256, 256}, 200, 1);
+    volume.update();
+
+    // A brush stroke touches a few hundred samples, alternating between adding and removing material.
+    std::uint8_t value = 0;
+    BENCHMARK("brush stroke of radius 4 on 512^3")
+    {
+        value ^= 1;
+        brush(volume, {256, 256, 455}, 4, value);
+        return volume.update();
+    };
+}
@@ -0,0 +1,378 @@
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "dang-math/matrix.h"
+#include "dang-math/quaternion.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+using Catch::Approx;
+
+namespace {
+
+/// @brief A deterministic, well-conditioned matrix with a zero in the top left, which requires pivoting.
+template <std::size_t v_dim>
+constexpr dmath::dmat<v_dim> sampleMatrix()
+{
+    dmath::dmat<v_dim> result;
+    dutils::SampleGenerator generator{12345};
+    for (std::size_t col = 0; col < v_dim; col++) {
+        for (std::size_t row = 0; row < v_dim; row++)
+            result(col, row) = generator.nextFloat(-0.5f, 0.5f);
+        result(col, col) += v_dim;
+    }
+    result(0, 0) = 0.0;
+    return result;
+}
+
+/// @brief The Hilbert matrix, which is notoriously ill-conditioned.
+template <std::size_t v_dim>
+constexpr dmath::dmat<v_dim> hilbertMatrix()
+{
+    dmath::dmat<v_dim> result;
+    for (std::size_t col = 0; col < v_dim; col++)
+        for (std::size_t row = 0; row < v_dim; row++)
+            result(col, row) = 1.0 / static_cast<double>(col + row + 1);
+    return result;
+}
+
+/// @brief Returns the largest deviation of the product of matrix and inverse from the identity matrix.
+template <std::size_t v_dim>
+double inverseResidual(const dmath::dmat<v_dim>& matrix, const dmath::dmat<v_dim>& inverse)
+{
+    auto product = matrix * inverse;
+    double result = 0.0;
+    for (std::size_t col = 0; col < v_dim; col++) {
+        for (std::size_t row = 0; row < v_dim; row++) {
+            double expected = col == row ? 1.0 : 0.0;
+            result = std::max(result, std::abs(product(col, row) - expected));
+        }
+    }
+    return result;
+}
+
+/// @brief Compares two matrices bit by bit.
+template <typename T, std::size_t v_cols, std::size_t v_rows>
+bool identical(const dmath::Matrix<T, v_cols, v_rows>& lhs, const dmath::Matrix<T, v_cols, v_rows>& rhs)
+{
+    return std::memcmp(lhs.data(), rhs.data(), sizeof(lhs)) == 0;
+}
+
+/// @brief Compares two vectors bit by bit.
+template <typename T, std::size_t v_dim>
+bool identical(const dmath::Vector<T, v_dim>& lhs, const dmath::Vector<T, v_dim>& rhs)
+{
+    return std::memcmp(lhs.data(), rhs.data(), sizeof(lhs)) == 0;
+}
+
+/// @brief The generic matrix multiplication, which the fast paths have to match.
+template <typename T, std::size_t v_cols, std::size_t v_rows, std::size_t v_other_cols>
+dmath::Matrix<T, v_other_cols, v_rows> multiplyGeneric(const dmath::Matrix<T, v_cols, v_rows>& lhs,
+                                                       const dmath::Matrix<T, v_other_cols, v_cols>& rhs)
+{
+    dmath::Matrix<T, v_other_cols, v_rows> result;
+    for (std::size_t col = 0; col < v_other_cols; col++)
+        for (std::size_t row = 0; row < v_rows; row++)
+            for (std::size_t i = 0; i < v_cols; i++)
+                result(col, row) += lhs(i, row) * rhs(col, i);
+    return result;
+}
+
+/// @brief An affine transformation consisting of translation, rotation and non-uniform scaling.
+dmath::mat4 sampleTransform()
+{
+    auto rotation = dmath::quat::fromAxis(dmath::vec3(1.0f, -2.0f, 0.5f).normalize(), 33.0f).toMatrix();
+    dmath::mat4 result = dmath::mat4::identity();
+    rotation[0] *= 2.0f;
+    rotation[1] *= 0.5f;
+    rotation[2] *= 3.0f;
+    result.setSubMatrix<0, 0, 3, 3>(rotation);
+    result[3] = dmath::vec4(4.0f, -7.5f, 12.0f, 1.0f);
+    return result;
+}
+
+template <std::size_t v_dim>
+void checkLUAgainstRecursion()
+{
+    CAPTURE(v_dim);
+    auto matrix = sampleMatrix<v_dim>();
+
+    auto lu = matrix.lu();
+    REQUIRE_FALSE(lu.singular);
+
+    auto lu_inverse = matrix.inverse();
+    REQUIRE(lu_inverse);
+    CHECK(inverseResidual(matrix, *lu_inverse) < 1e-12);
+
+    // Blockwise inversion fails if any of its upper left blocks is singular, so only compare if it succeeded.
+    if (auto blockwise_inverse = matrix.inverseBlockwise()) {
+        for (std::size_t col = 0; col < v_dim; col++)
+            for (std::size_t row = 0; row < v_dim; row++)
+                CHECK((*lu_inverse)(col, row) == Approx((*blockwise_inverse)(col, row)).margin(1e-12));
+    }
+
+    dmath::dvec<v_dim> vector;
+    for (std::size_t i = 0; i < v_dim; i++)
+        vector[i] = static_cast<double>(i) - 2.0;
+    auto solution = matrix.solve(vector);
+    REQUIRE(solution);
+    auto product = matrix * *solution;
+    for (std::size_t i = 0; i < v_dim; i++)
+        CHECK(product[i] == Approx(vector[i]).margin(1e-12));
+}
+
+template <std::size_t v_dim>
+void benchmarkMatrix()
+{
+    auto matrix = sampleMatrix<v_dim>();
+    matrix(0, 0) = 1.0;
+    auto name = std::to_string(v_dim) + "x" + std::to_string(v_dim);
+
+    BENCHMARK("inverse " + name + " (blockwise)") { return matrix.inverseBlockwise(); };
+    BENCHMARK("inverse " + name + " (lu)") { return matrix.inverse(); };
+    if constexpr (v_dim <= 8)
+        BENCHMARK("determinant " + name + " (laplace)") { return matrix.determinantLaplace(); };
+    BENCHMARK("determinant " + name + " (lu)") { return matrix.determinant(); };
+}
+
+} // namespace
+
+TEST_CASE("Matrices can be decomposed into L and U using partial pivoting.", "[matrix][lu]")
+{
+    auto matrix = sampleMatrix<6>();
+    auto lu = matrix.lu();
+
+    REQUIRE_FALSE(lu.singular);
+
+    dmath::dmat<6> lower;
+    dmath::dmat<6> upper;
+    for (std::size_t col = 0; col < 6; col++) {
+        for (std::size_t row = 0; row < 6; row++) {
+            if (row > col)
+                lower(col, row) = lu.lu(col, row);
+            else
+                upper(col, row) = lu.lu(col, row);
+        }
+        lower(col, col) = 1.0;
+    }
+
+    auto product = lower * upper;
+    for (std::size_t col = 0; col < 6; col++)
+        for (std::size_t row = 0; row < 6; row++)
+            CHECK(product(col, row) == Approx(matrix(col, lu.permutation[row])).margin(1e-12));
+}
+
+TEST_CASE("Matrices above 4x4 use the LU decomposition for inverse, solve and determinant.", "[matrix][lu]")
+{
+    checkLUAgainstRecursion<5>();
+    checkLUAgainstRecursion<6>();
+    checkLUAgainstRecursion<7>();
+    checkLUAgainstRecursion<8>();
+    checkLUAgainstRecursion<12>();
+    checkLUAgainstRecursion<16>();
+
+    SECTION("The determinant matches the Laplace expansion.")
+    {
+        auto matrix5 = sampleMatrix<5>();
+        CHECK(matrix5.determinant() == Approx(matrix5.determinantLaplace()));
+        auto matrix7 = sampleMatrix<7>();
+        CHECK(matrix7.determinant() == Approx(matrix7.determinantLaplace()));
+    }
+}
+
+TEST_CASE("The LU decomposition is at least as stable as blockwise inversion.", "[matrix][lu]")
+{
+    auto hilbert = hilbertMatrix<7>();
+    auto lu_inverse = hilbert.inverse();
+    auto blockwise_inverse = hilbert.inverseBlockwise();
+    REQUIRE(lu_inverse);
+    REQUIRE(blockwise_inverse);
+    CHECK(inverseResidual(hilbert, *lu_inverse) <= inverseResidual(hilbert, *blockwise_inverse));
+    CHECK(inverseResidual(hilbert, *lu_inverse) < 1e-6);
+
+    SECTION("Pivoting handles matrices with a singular top left block.")
+    {
+        dmath::dmat<5> permutation;
+        for (std::size_t col = 0; col < 5; col++)
+            permutation(col, (col + 1) % 5) = 1.0;
+
+        CHECK_FALSE(permutation.inverseBlockwise());
+        auto inverse = permutation.inverse();
+        REQUIRE(inverse);
+        CHECK(*inverse == permutation.transpose());
+        CHECK(permutation.determinant() == 1.0);
+    }
+}
+
+TEST_CASE("Singular matrices above 4x4 cannot be inverted or solved.", "[matrix][lu]")
+{
+    auto matrix = sampleMatrix<6>();
+    matrix[3] = matrix[1] * 2.0;
+
+    CHECK(matrix.lu().singular);
+    CHECK(matrix.determinant() == 0.0);
+    CHECK_FALSE(matrix.inverse());
+    CHECK_FALSE(matrix.solve(dmath::dvec<6>(1.0)));
+}
+
+TEST_CASE("Well conditioned matrices with rows of very different magnitude are not singular.", "[matrix][lu]")
+{
+    SECTION("Float diagonal matrices with large and small entries.")
+    {
+        dmath::mat<5> matrix;
+        for (std::size_t i = 0; i < 5; i++)
+            matrix(i, i) = 1.0f;
+        matrix(0, 0) = 1e4f;
+        matrix(4, 4) = 1e-4f;
+
+        CHECK_FALSE(matrix.lu().singular);
+        CHECK(matrix.determinant() == Approx(matrix.determinantLaplace()));
+        CHECK(matrix.determinant() == Approx(1.0f));
+        auto inverse = matrix.inverse();
+        REQUIRE(inverse);
+        CHECK((*inverse)(4, 4) == Approx(1e4f));
+    }
+    SECTION("Double diagonal matrices with a single huge entry.")
+    {
+        auto matrix = dmath::dmat<5>::identity();
+        matrix(0, 0) = 1e20;
+
+        CHECK_FALSE(matrix.lu().singular);
+        CHECK(matrix.determinant() == Approx(1e20));
+        auto inverse = matrix.inverse();
+        auto blockwise_inverse = matrix.inverseBlockwise();
+        REQUIRE(inverse);
+        REQUIRE(blockwise_inverse);
+        CHECK((*inverse)(0, 0) == Approx((*blockwise_inverse)(0, 0)));
+        CHECK((*inverse)(4, 4) == 1.0);
+    }
+}
+
+TEST_CASE("The LU decomposition can be used in constant expressions.", "[matrix][lu]")
+{
+    constexpr auto matrix = [] {
+        dmath::dmat<5> result = dmath::dmat<5>::identity(2.0);
+        result(4, 0) = 1.0;
+        result(0, 0) = 0.0;
+        result(0, 4) = 4.0;
+        return result;
+    }();
+    STATIC_REQUIRE(matrix.determinant() == -32.0);
+    STATIC_REQUIRE(matrix.inverse().has_value());
+    STATIC_REQUIRE((*matrix.solve(dmath::dvec<5>(4.0)))[1] == 2.0);
+}
+
+TEST_CASE("The LU decomposition can be benchmarked against recursive inversion.", "[.][matrix][lu][benchmark]")
+{
+    benchmarkMatrix<5>();
+    benchmarkMatrix<6>();
+    benchmarkMatrix<8>();
+    benchmarkMatrix<12>();
+    benchmarkMatrix<16>();
+}
+
+TEST_CASE("Matrix multiplication fast paths produce the same results as the generic loop.", "[matrix][simd]")
+{
+    dmath::mat4 a{{{1.5f, 2.0f, -3.0f, 0.25f},
+                   {0.0f, -1.0f, 4.0f, 1.0f},
+                   {5.5f, 0.125f, 1.0f, -2.0f},
+                   {-0.5f, 3.0f, 2.0f, 1.0f}}};
+    auto b = sampleTransform();
+    dmath::vec4 v4(0.3f, -1.7f, 2.9f, 1.0f);
+    dmath::vec3 v3(-4.1f, 0.6f, 7.3f);
+    dmath::mat3 a3 = a.minor(3, 3);
+    dmath::mat3x4 a3x4 = a.subMatrix<0, 0, 3, 4>();
+
+    // The test target disables floating-point contraction, which would otherwise fuse the generic loop into FMA.
+    CHECK(identical(a * b, multiplyGeneric(a, b)));
+    CHECK(identical(b * a, multiplyGeneric(b, a)));
+    CHECK(identical(a * v4, dmath::vec4(multiplyGeneric(a, dmath::mat<1, 4>::fromVector(v4)))));
+    CHECK(identical(a3 * v3, dmath::vec3(multiplyGeneric(a3, dmath::mat<1, 3>::fromVector(v3)))));
+    CHECK(identical(a3x4 * v3, dmath::vec4(multiplyGeneric(a3x4, dmath::mat<1, 3>::fromVector(v3)))));
+    CHECK(identical(v4 * a, dmath::vec4(multiplyGeneric(a.transpose(), dmath::mat<1, 4>::fromVector(v4)))));
+    CHECK(identical(v3 * a3, dmath::vec3(multiplyGeneric(a3.transpose(), dmath::mat<1, 3>::fromVector(v3)))));
+
+    STATIC_REQUIRE(dmath::mat2{{{1, 2}, {3, 4}}} * dmath::vec2(1, 1) == dmath::vec2(4, 6));
+    STATIC_REQUIRE(dmath::vec2(1, 1) * dmath::mat2{{{1, 2}, {3, 4}}} == dmath::vec2(3, 7));
+}
+
+TEST_CASE("4x4 matrices can be inverted.", "[matrix][inverse]")
+{
+    auto transform = sampleTransform();
+
+    auto inverse = transform.inverse();
+    REQUIRE(inverse);
+    auto cramer = transform.adjugate() / transform.determinant();
+    for (std::size_t col = 0; col < 4; col++)
+        for (std::size_t row = 0; row < 4; row++)
+            CHECK((*inverse)(col, row) == Approx(cramer(col, row)).margin(1e-6));
+
+    SECTION("3x3 matrices match the cofactor based inverse.")
+    {
+        auto linear = transform.minor(3, 3);
+        auto linear_inverse = linear.inverse();
+        REQUIRE(linear_inverse);
+        auto linear_cramer = linear.adjugate() / linear.determinant();
+        for (std::size_t col = 0; col < 3; col++)
+            for (std::size_t row = 0; row < 3; row++)
+                CHECK((*linear_inverse)(col, row) == Approx(linear_cramer(col, row)).margin(1e-6));
+    }
+    SECTION("Affine transformations can be inverted more cheaply.")
+    {
+        auto affine_inverse = transform.inverseAffine();
+        REQUIRE(affine_inverse);
+        for (std::size_t col = 0; col < 4; col++)
+            for (std::size_t row = 0; row < 4; row++)
+                CHECK((*affine_inverse)(col, row) == Approx((*inverse)(col, row)).margin(1e-6));
+        CHECK((*affine_inverse)[3][3] == 1.0f);
+    }
+    SECTION("Integer matrices are inverted exactly like before.")
+    {
+        dmath::Matrix<int, 4> matrix{{{2, 0, 0, 0}, {1, 3, 0, 0}, {4, -2, 1, 5}, {7, 1, 0, 1}}};
+        CHECK(*matrix.inverse() == matrix.adjugate() / matrix.determinant());
+    }
+    SECTION("Singular matrices cannot be inverted.")
+    {
+        transform[1] = dmath::vec4();
+        CHECK_FALSE(transform.inverse());
+        CHECK_FALSE(transform.inverseAffine());
+    }
+
+    STATIC_REQUIRE(*dmath::dmat4::identity(2.0).inverse() == dmath::dmat4::identity(0.5));
+}
+
+TEST_CASE("Matrix fast paths can be benchmarked against the generic implementations.", "[.][matrix][simd][benchmark]")
+{
+    auto a = sampleTransform();
+    auto b = *a.inverse();
+    auto v4 = dmath::vec4(0.3f, -1.7f, 2.9f, 1.0f);
+    auto v3 = dmath::vec3(-4.1f, 0.6f, 7.3f);
+    auto a3 = a.minor(3, 3);
+
+    BENCHMARK("mat4 * mat4 (generic)") { return multiplyGeneric(a, b); };
+    BENCHMARK("mat4 * mat4 (fast)") { return a * b; };
+
+    BENCHMARK("mat4 * vec4 (generic)") { return multiplyGeneric(a, dmath::mat<1, 4>::fromVector(v4)); };
+    BENCHMARK("mat4 * vec4 (fast)") { return a * v4; };
+
+    BENCHMARK("mat3 * vec3 (generic)") { return multiplyGeneric(a3, dmath::mat<1, 3>::fromVector(v3)); };
+    BENCHMARK("mat3 * vec3 (fast)") { return a3 * v3; };
+
+    BENCHMARK("vec4 * mat4 (generic)") { return multiplyGeneric(a.transpose(), dmath::mat<1, 4>::fromVector(v4)); };
+    BENCHMARK("vec4 * mat4 (fast)") { return v4 * a; };
+
+    BENCHMARK("mat3 inverse (cofactors)") { return a3.adjugate() / a3.determinant(); };
+    BENCHMARK("mat3 inverse (fast)") { return a3.inverse(); };
+
+    BENCHMARK("mat4 inverse (cofactors)") { return a.adjugate() / a.determinant(); };
+    BENCHMARK("mat4 inverse (fast)") { return a.inverse(); };
+    BENCHMARK("mat4 inverse (affine)") { return a.inverseAffine(); };
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "dang-math/quaternion.h"
+#include "dang-math/quaternionbatch.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+namespace {
+
+/// @brief Compares two records of floats bit by bit, so that NaN and signed zero are also checked.
+/// @remark On FMA targets, GCC fuses vectorized add/sub pairs of the scalar operations into vfmaddsub, even with
+/// -ffp-contract=off. Since e.g. slerp amplifies the rounding differences, a small relative difference is accepted.
+template <typename T>
+bool matches(const T& lhs, const T& rhs)
+{
+#ifdef __FMA__
+    static_assert(sizeof(T) % sizeof(float) == 0);
+    std::array<float, sizeof(T) / sizeof(float)> lhs_values;
+    std::array<float, sizeof(T) / sizeof(float)> rhs_values;
+    std::memcpy(lhs_values.data(), &lhs, sizeof(T));
+    std::memcpy(rhs_values.data(), &rhs, sizeof(T));
+    for (std::size_t i = 0; i < lhs_values.size(); i++) {
+        auto tolerance = 64.0f * std::numeric_limits<float>::epsilon() * std::max(1.0f, std::abs(rhs_values[i]));
+        if (!(std::abs(lhs_values[i] - rhs_values[i]) <= tolerance))
+            return false;
+    }
+    return true;
+#else
+    return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+#endif
+}
+
+struct SampleGenerator : dutils::SampleGenerator {
+    float next() { return nextFloat(-8.0f, 8.0f); }
+
+    dmath::vec3 vector() { return {next(), next(), next()}; }
+
+    dmath::quat quaternion()
+    {
+        auto [x, y, z, w] = dmath::vec4{next(), next(), next(), next()};
+        return dmath::quat(w, x, y, z).normalize();
+    }
+
+    dmath::dquat dualQuaternion()
+    {
+        return dmath::dquat(quaternion()).translate(vector());
+    }
+};
+
+std::vector<dmath::vec3> sampleVectors(std::size_t count, unsigned seed)
+{
+    SampleGenerator generator{seed};
+    std::vector<dmath::vec3> result(count);
+    for (auto& vector : result)
+        vector = generator.vector();
+    return result;
+}
+
+std::vector<dmath::quat> sampleQuaternions(std::size_t count, unsigned seed)
+{
+    SampleGenerator generator{seed};
+    std::vector<dmath::quat> result(count);
+    for (auto& quaternion : result)
+        quaternion = generator.quaternion();
+    return result;
+}
+
+std::vector<dmath::dquat> sampleDualQuaternions(std::size_t count, unsigned seed)
+{
+    SampleGenerator generator{seed};
+    std::vector<dmath::dquat> result(count);
+    for (auto& dual_quaternion : result)
+        dual_quaternion = generator.dualQuaternion();
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Quaternions can be interpolated using nlerp.", "[quaternion]")
+{
+    auto from = dmath::quat::fromAxis(dmath::vec3(0.0f, 0.0f, 1.0f), 10.0f);
+    auto to = dmath::quat::fromAxis(dmath::vec3(0.0f, 0.0f, 1.0f), 50.0f);
+
+    CHECK(from.nlerp(to, 0.0f) == from.normalize());
+    CHECK(from.nlerp(to, 1.0f) == to.normalize());
+    auto halfway = from.nlerp(to, 0.5f);
+    CHECK(std::abs(halfway.dot(dmath::quat::fromAxis(dmath::vec3(0.0f, 0.0f, 1.0f), 30.0f)) - 1.0f) < 1e-6f);
+
+    SECTION("The interpolation takes the shorter path.")
+    {
+        CHECK(from.nlerp(-to, 0.5f) == halfway);
+        auto dual_from = dmath::dquat(from);
+        auto dual_to = dmath::dquat(to);
+        CHECK(dual_from.nlerp(-dual_to, 0.5f).real == dual_from.nlerp(dual_to, 0.5f).real);
+    }
+}
+
+TEST_CASE("QuaternionBatch matches the scalar quaternion operations.", "[quaternion][batch]")
+{
+    auto count = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{130}, std::size_t{70'000});
+    CAPTURE(count);
+
+    auto lhs = sampleQuaternions(count, 1);
+    auto rhs = sampleQuaternions(count, 2);
+    auto vectors = sampleVectors(count, 3);
+    auto single = dmath::quat::fromAxis(dmath::vec3(1.0f, 2.0f, -0.5f).normalize(), 37.0f);
+
+    std::vector<dmath::quat> product(count), normalized(count), nlerped(count), slerped(count);
+    std::vector<dmath::vec3> transformed(count), rotated(count);
+    dmath::quatbatch::multiply(lhs, rhs, product);
+    dmath::quatbatch::normalize(product, normalized);
+    dmath::quatbatch::nlerp(lhs, rhs, 0.25f, nlerped);
+    dmath::quatbatch::slerp(lhs, rhs, 0.25f, slerped);
+    dmath::quatbatch::transform(lhs, vectors, transformed);
+    dmath::quatbatch::transform(single, vectors, rotated);
+
+    bool all_matching = true;
+    for (std::size_t i = 0; i < count; i++) {
+        auto expected_product = lhs[i] * rhs[i];
+        all_matching = all_matching && matches(product[i], expected_product) &&
+                       matches(normalized[i], expected_product.normalize()) &&
+                       matches(nlerped[i], lhs[i].nlerp(rhs[i], 0.25f)) &&
+                       matches(slerped[i], dmath::quat(lhs[i]).slerp(rhs[i], 0.25f)) &&
+                       matches(transformed[i], lhs[i] * vectors[i]) &&
+                       matches(rotated[i], single * vectors[i]);
+    }
+    CHECK(all_matching);
+
+    SECTION("Results may alias the inputs.")
+    {
+        auto expected = product;
+        dmath::quatbatch::multiply(lhs, rhs, lhs);
+        CHECK(lhs == expected);
+    }
+}
+
+TEST_CASE("DualQuaternionBatch matches the scalar dual-quaternion operations.", "[quaternion][batch]")
+{
+    auto count = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{130}, std::size_t{70'000});
+    CAPTURE(count);
+
+    auto lhs = sampleDualQuaternions(count, 4);
+    auto rhs = sampleDualQuaternions(count, 5);
+    auto vectors = sampleVectors(count, 6);
+    auto single = dmath::dquat::fromAxis(dmath::vec3(0.0f, 1.0f, 0.0f), 75.0f).translate(dmath::vec3(1.0f, 2.0f, 3.0f));
+
+    std::vector<dmath::dquat> product(count), normalized(count), nlerped(count), slerped(count);
+    std::vector<dmath::vec3> transformed(count), moved(count);
+    dmath::dquatbatch::multiply(lhs, rhs, product);
+    dmath::dquatbatch::normalize(product, normalized);
+    dmath::dquatbatch::nlerp(lhs, rhs, 0.75f, nlerped);
+    dmath::dquatbatch::slerp(lhs, rhs, 0.75f, slerped);
+    dmath::dquatbatch::transform(lhs, vectors, transformed);
+    dmath::dquatbatch::transform(single, vectors, moved);
+
+    bool all_matching = true;
+    for (std::size_t i = 0; i < count; i++) {
+        auto expected_product = lhs[i] * rhs[i];
+        all_matching = all_matching && matches(product[i], expected_product) &&
+                       matches(normalized[i], expected_product.normalize()) &&
+                       matches(nlerped[i], lhs[i].nlerp(rhs[i], 0.75f)) &&
+                       matches(slerped[i], dmath::dquat(lhs[i]).slerp(rhs[i], 0.75f)) &&
+                       matches(transformed[i], lhs[i] * vectors[i]) &&
+                       matches(moved[i], single * vectors[i]);
+    }
+    CHECK(all_matching);
+}
+
+TEST_CASE("Quaternion batches can be benchmarked against scalar loops.", "[.][quaternion][batch][benchmark]")
+{
+    // Small enough to stay in cache, as this would otherwise only measure memory bandwidth.
+    constexpr std::size_t count = 1 << 12;
+    auto quaternions = sampleQuaternions(count, 7);
+    auto dual_quaternions = sampleDualQuaternions(count, 8);
+    auto vectors = sampleVectors(count, 9);
+    auto single = dual_quaternions.front();
+
+    std::vector<dmath::vec3> result(count);
+
+    BENCHMARK("quat * points (scalar)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = quaternions[i] * vectors[i];
+        return result.back();
+    };
+    BENCHMARK("quat * points (batch)")
+    {
+        dmath::quatbatch::transform(quaternions, vectors, result);
+        return result.back();
+    };
+
+    BENCHMARK("dquat * points (scalar)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = dual_quaternions[i] * vectors[i];
+        return result.back();
+    };
+    BENCHMARK("dquat * points (batch)")
+    {
+        dmath::dquatbatch::transform(dual_quaternions, vectors, result);
+        return result.back();
+    };
+
+    BENCHMARK("single dquat * points (scalar)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = single * vectors[i];
+        return result.back();
+    };
+    BENCHMARK("single dquat * points (batch)")
+    {
+        dmath::dquatbatch::transform(single, vectors, result);
+        return result.back();
+    };
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "dang-math/simd.h"
+#include "dang-math/vector.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dmath = dang::math;
+
+namespace {
+
+/// @brief Compares two float vectors bit by bit, so that NaN and signed zero are also checked.
+template <typename T, std::size_t v_dim>
+bool identical(const dmath::Vector<T, v_dim>& lhs, const dmath::Vector<T, v_dim>& rhs)
+{
+    return std::memcmp(lhs.data(), rhs.data(), sizeof(T) * v_dim) == 0;
+}
+
+template <typename TVector>
+std::vector<TVector> sampleVectors()
+{
+    using T = typename TVector::Type;
+    std::vector<T> values{T(0), T(1), T(-1), T(2), T(-3), T(7), T(100), T(-42)};
+    if constexpr (std::is_floating_point_v<T>) {
+        values.push_back(T(0.5));
+        values.push_back(T(-0.0));
+        values.push_back(std::numeric_limits<T>::infinity());
+        values.push_back(std::numeric_limits<T>::quiet_NaN());
+    }
+
+    std::vector<TVector> result;
+    for (std::size_t i = 0; i < values.size(); i++) {
+        TVector vector;
+        for (std::size_t d = 0; d < TVector::dim; d++)
+            vector[d] = values[(i + d * 3) % values.size()];
+        result.push_back(vector);
+    }
+    return result;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("SIMD vector kernels produce the same results as the generic loops.",
+                   "[vector][simd]",
+                   dmath::vec3,
+                   dmath::vec4,
+                   dmath::ivec4)
+{
+    using T = typename TestType::Type;
+    constexpr auto dim = TestType::dim;
+
+    auto samples = sampleVectors<TestType>();
+
+    for (const auto& a : samples) {
+        for (const auto& b : samples) {
+            CAPTURE(a, b);
+
+            CHECK(identical(a + b, a.variadicOp(std::plus{}, b)));
+            CHECK(identical(a - b, a.variadicOp(std::minus{}, b)));
+            CHECK(identical(a * b, a.variadicOp(std::multiplies{}, b)));
+            CHECK(identical(a.min(b), a.variadicOp([](T x, T y) { return std::min(x, y); }, b)));
+            CHECK(identical(a.max(b), a.variadicOp([](T x, T y) { return std::max(x, y); }, b)));
+
+            auto c = a;
+            c += b;
+            CHECK(identical(c, a.variadicOp(std::plus{}, b)));
+
+            if constexpr (std::is_floating_point_v<T>) {
+                CHECK(identical(a / b, a.variadicOp(std::divides{}, b)));
+
+                T dot{};
+                for (std::size_t i = 0; i < dim; i++)
+                    dot += a[i] * b[i];
+                auto simd_dot = a.dot(b);
+                CHECK(std::memcmp(&simd_dot, &dot, sizeof(T)) == 0);
+            }
+            else {
+                CHECK((a & b) == a.variadicOp(std::bit_and{}, b));
+                CHECK((a | b) == a.variadicOp(std::bit_or{}, b));
+                CHECK((a ^ b) == a.variadicOp(std::bit_xor{}, b));
+
+                T dot{};
+                for (std::size_t i = 0; i < dim; i++)
+                    dot += a[i] * b[i];
+                CHECK(a.dot(b) == dot);
+            }
+
+            CHECK(a.lessThan(b) == a.variadicOp(std::less{}, b));
+            CHECK(a.lessThanEqual(b) == a.variadicOp(std::less_equal{}, b));
+            CHECK(a.greaterThan(b) == a.variadicOp(std::greater{}, b));
+            CHECK(a.greaterThanEqual(b) == a.variadicOp(std::greater_equal{}, b));
+            CHECK(a.equal(b) == a.variadicOp(std::equal_to{}, b));
+            CHECK(a.notEqual(b) == a.variadicOp(std::not_equal_to{}, b));
+
+            CHECK((a == b) == a.variadicOp(std::equal_to{}, b).all());
+            CHECK((a != b) == a.variadicOp(std::not_equal_to{}, b).any());
+        }
+    }
+}
+
+TEST_CASE("SIMD vector kernels do not interfere with constant evaluation.", "[vector][simd]")
+{
+    STATIC_REQUIRE(dmath::vec4(1, 2, 3, 4) + dmath::vec4(4, 3, 2, 1) == dmath::vec4(5));
+    STATIC_REQUIRE(dmath::vec3(1, 2, 3).dot(dmath::vec3(4, 5, 6)) == 32);
+    STATIC_REQUIRE(dmath::ivec4(1, -2, 3, -4).min(0) == dmath::ivec4(0, -2, 0, -4));
+    STATIC_REQUIRE(dmath::vec3(1, 2, 3).lessThan(2) == dmath::bvec3(true, false, false));
+}
+
+TEMPLATE_TEST_CASE("SIMD vector kernels can be benchmarked against the generic loops.",
+                   "[.][vector][simd][benchmark]",
+                   dmath::vec3,
+                   dmath::vec4,
+                   dmath::ivec4)
+{
+    using T = typename TestType::Type;
+
+    constexpr std::size_t count = 4096;
+    std::vector<TestType> lhs(count);
+    std::vector<TestType> rhs(count);
+    for (std::size_t i = 0; i < count; i++) {
+        for (std::size_t d = 0; d < TestType::dim; d++) {
+            lhs[i][d] = static_cast<T>(i % 17 + d);
+            rhs[i][d] = static_cast<T>(i % 13 + 1);
+        }
+    }
+    std::vector<TestType> result(count);
+
+    auto benchmarkOp = [&](const std::string& name, auto generic_op, auto simd_op) {
+        BENCHMARK(name + " (generic)")
+        {
+            for (std::size_t i = 0; i < count; i++)
+                result[i] = lhs[i].variadicOp(generic_op, rhs[i]);
+            return result.back();
+        };
+        BENCHMARK(name + " (simd)")
+        {
+            for (std::size_t i = 0; i < count; i++)
+                result[i] = simd_op(lhs[i], rhs[i]);
+            return result.back();
+        };
+    };
+
+    benchmarkOp(
+        "min", [](T a, T b) { return std::min(a, b); }, [](const TestType& a, const TestType& b) { return a.min(b); });
+    benchmarkOp(
+        "max", [](T a, T b) { return std::max(a, b); }, [](const TestType& a, const TestType& b) { return a.max(b); });
+
+    BENCHMARK("less (generic)")
+    {
+        std::size_t less = 0;
+        for (std::size_t i = 0; i < count; i++)
+            less += lhs[i].variadicOp(std::less{}, rhs[i]).any();
+        return less;
+    };
+    BENCHMARK("less (simd)")
+    {
+        std::size_t less = 0;
+        for (std::size_t i = 0; i < count; i++)
+            less += lhs[i].lessThan(rhs[i]).any();
+        return less;
+    };
+
+    BENCHMARK("equal (generic)")
+    {
+        std::size_t equal = 0;
+        for (std::size_t i = 0; i < count; i++)
+            equal += lhs[i].variadicOp(std::equal_to{}, rhs[i]).all();
+        return equal;
+    };
+    BENCHMARK("equal (simd)")
+    {
+        std::size_t equal = 0;
+        for (std::size_t i = 0; i < count; i++)
+            equal += lhs[i] == rhs[i];
+        return equal;
+    };
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "dang-math/bounds.h"
+#include "dang-math/spatialhashgrid.h"
+#include "dang-math/vector.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+namespace {
+
+struct SampleGenerator : dutils::SampleGenerator {
+    dmath::vec3 point(float scale) { return dmath::vec3{nextFloat(), nextFloat(), nextFloat()} * scale; }
+};
+
+using Grid = dmath::spatialhashgrid3<int>;
+
+/// @brief Keeps track of all points in a grid to compare against a linear scan.
+struct Reference {
+    Grid grid{4.0f};
+    std::vector<Grid::Handle> handles;
+
+    std::vector<Grid::Handle> inBounds(const dmath::bounds3& bounds) const
+    {
+        std::vector<Grid::Handle> result;
+        for (auto handle : handles)
+            if (bounds.containsInclusive(grid.position(handle)))
+                result.push_back(handle);
+        return result;
+    }
+
+    std::vector<Grid::Handle> inRadius(const dmath::vec3& center, float radius) const
+    {
+        std::vector<Grid::Handle> result;
+        for (auto handle : handles)
+            if ((grid.position(handle) - center).sqrdot() <= radius * radius)
+                result.push_back(handle);
+        return result;
+    }
+
+    std::vector<float> nearestDistances(const dmath::vec3& position, std::size_t count) const
+    {
+        std::vector<float> result;
+        for (auto handle : handles)
+            result.push_back(std::sqrt((grid.position(handle) - position).sqrdot()));
+        std::sort(result.begin(), result.end());
+        result.resize(std::min(result.size(), count));
+        return result;
+    }
+
+    void check(unsigned seed) const
+    {
+        CHECK(grid.size() == handles.size());
+
+        SampleGenerator generator{seed};
+        for (int i = 0; i < 20; i++) {
+            auto low = generator.point(120.0f) - 10.0f;
+            dmath::bounds3 bounds(low, low + generator.point(30.0f));
+            auto in_bounds = grid.inBounds(bounds);
+            std::sort(in_bounds.begin(), in_bounds.end());
+            CHECK(in_bounds == this->inBounds(bounds));
+
+            auto center = generator.point(120.0f) - 10.0f;
+            auto in_radius = grid.inRadius(center, 12.0f);
+            std::sort(in_radius.begin(), in_radius.end());
+            CHECK(in_radius == this->inRadius(center, 12.0f));
+
+            auto nearest = grid.nearest(center, 10);
+            std::vector<float> distances;
+            for (const auto& result : nearest)
+                distances.push_back(result.distance);
+            CHECK(distances == nearestDistances(center, 10));
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("A SpatialHashGrid sorts points into cells.", "[spatialhashgrid]")
+{
+    Grid grid(2.0f);
+    CHECK(grid.cellAt(dmath::vec3(0.5f, 2.0f, -0.5f)) == dmath::ivec3(0, 1, -1));
+    CHECK(grid.cellBounds(dmath::bounds3(dmath::vec3(-1.0f), dmath::vec3(3.0f))).low == dmath::ivec3(-1));
+    CHECK(grid.cellBounds(dmath::bounds3(dmath::vec3(-1.0f), dmath::vec3(3.0f))).high == dmath::ivec3(2));
+
+    auto a = grid.insert(dmath::vec3(0.5f), 1);
+    auto b = grid.insert(dmath::vec3(1.5f), 2);
+    CHECK(grid.cellCount() == 1);
+    grid.move(b, dmath::vec3(2.5f));
+    CHECK(grid.cellCount() == 2);
+    CHECK(grid[b] == 2);
+    grid.remove(a);
+    CHECK(grid.cellCount() == 1);
+    CHECK_FALSE(grid.contains(a));
+    CHECK(grid.insert(dmath::vec3(), 3) == a);
+}
+
+TEST_CASE("A SpatialHashGrid answers queries like a linear scan.", "[spatialhashgrid]")
+{
+    Reference reference;
+    SampleGenerator generator{1};
+    for (int i = 0; i < 2000; i++)
+        reference.handles.push_back(reference.grid.insert(generator.point(100.0f), i));
+    reference.check(2);
+
+    SECTION("Points can be moved.")
+    {
+        for (auto handle : reference.handles)
+            reference.grid.move(handle, reference.grid.position(handle) + generator.point(10.0f) - 5.0f);
+        reference.check(3);
+    }
+    SECTION("Points can be removed, which also removes empty cells.")
+    {
+        // Removes most points, so that lots of cells become empty and slots are shifted back in the hash table.
+        std::vector<Grid::Handle> remaining;
+        for (auto handle : reference.handles) {
+            if (handle % 10 == 0)
+                remaining.push_back(handle);
+            else
+                reference.grid.remove(handle);
+        }
+        reference.handles = remaining;
+        reference.check(4);
+
+        for (auto handle : remaining)
+            reference.grid.remove(handle);
+        reference.handles.clear();
+        CHECK(reference.grid.empty());
+        CHECK(reference.grid.cellCount() == 0);
+        CHECK(reference.grid.nearest(dmath::vec3(), 5).empty());
+    }
+    SECTION("Nearest point queries can be limited to a maximum distance.")
+    {
+        auto nearest = reference.grid.nearest(dmath::vec3(50.0f), 1000, 5.0f);
+        CHECK(nearest.size() == reference.inRadius(dmath::vec3(50.0f), 5.0f).size());
+        CHECK(std::all_of(nearest.begin(), nearest.end(), [](const auto& result) { return result.distance <= 5.0f; }));
+    }
+}
+
+TEST_CASE("A SpatialHashGrid finds nearest points, which are far away.", "[spatialhashgrid]")
+{
+    Grid grid(1.0f);
+    auto far = grid.insert(dmath::vec3(1000.0f, 0.0f, 0.0f), 1);
+    grid.insert(dmath::vec3(-2000.0f, 0.0f, 0.0f), 2);
+
+    auto nearest = grid.nearest(dmath::vec3(), 1);
+    REQUIRE(nearest.size() == 1);
+    CHECK(nearest[0].handle == far);
+    CHECK(nearest[0].distance == 1000.0f);
+}
+
+TEST_CASE("SpatialHashGrid can be benchmarked with lots of moving points.", "[.][spatialhashgrid][benchmark]")
+{
+    auto count = GENERATE(std::size_t{100'000}, std::size_t{1'000'000});
+    // Keeps the density the same, with about four points per cell.
+    auto extent = std::cbrt(static_cast<float>(count) / 4.0f) * 4.0f;
+
+    SampleGenerator generator{5};
+    Grid grid(4.0f);
+    std::vector<dmath::vec3> velocities;
+    for (std::size_t i = 0; i < count; i++) {
+        grid.insert(generator.point(extent), static_cast<int>(i));
+        velocities.push_back(generator.point(0.5f) - 0.25f);
+    }
+
+    std::vector<dmath::vec3> centers;
+    for (int i = 0; i < 1000; i++)
+        centers.push_back(generator.point(extent));
+
+    BENCHMARK("move all " + std::to_string(count))
+    {
+        for (std::size_t i = 0; i < count; i++)
+            grid.move(i, grid.position(i) + velocities[i]);
+        return grid.cellCount();
+    };
+
+    BENCHMARK("1000 radius queries " + std::to_string(count))
+    {
+        std::size_t found = 0;
+        for (const auto& center : centers)
+            grid.forEachInRadius(center, 4.0f, [&](Grid::Handle) { found++; });
+        return found;
+    };
+
+    BENCHMARK("1000 nearest 8 queries " + std::to_string(count))
+    {
+        std::size_t found = 0;
+        for (const auto& center : centers)
+            found += grid.nearest(center, 8).size();
+        return found;
+    };
+
+    BENCHMARK("1 radius query (linear) " + std::to_string(count))
+    {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < count; i++)
+            found += (grid.position(i) - centers.front()).sqrdot() <= 16.0f;
+        return found;
+    };
+}
@@ -0,0 +1,217 @@
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "dang-math/matrix.h"
+#include "dang-math/quaternion.h"
+#include "dang-math/vector.h"
+#include "dang-math/vectorsoa.h"
+#include "dang-utils/catch2-sample-generator.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+namespace dmath = dang::math;
+namespace dutils = dang::utils;
+
+namespace {
+
+/// @brief Compares two vectors bit by bit, so that NaN and signed zero are also checked.
+template <typename T, std::size_t v_dim>
+bool identical(const dmath::Vector<T, v_dim>& lhs, const dmath::Vector<T, v_dim>& rhs)
+{
+    return std::memcmp(lhs.data(), rhs.data(), sizeof(T) * v_dim) == 0;
+}
+
+template <typename T>
+bool identical(T lhs, T rhs)
+{
+    return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+
+/// @brief Generates a deterministic list of vectors, which also contains a few special values.
+template <std::size_t v_dim>
+std::vector<dmath::vec<v_dim>> sampleVectors(std::size_t count, unsigned seed)
+{
+    std::vector<dmath::vec<v_dim>> result(count);
+    dutils::SampleGenerator generator{seed};
+    for (auto& vector : result)
+        for (auto& value : vector)
+            value = generator.nextFloat(-8.0f, 8.0f);
+    if (count > 2) {
+        result[1][0] = -0.0f;
+        result[2][v_dim - 1] = std::numeric_limits<float>::infinity();
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("VectorSoA can be converted from and to a list of vectors.", "[vectorsoa]")
+{
+    auto vectors = sampleVectors<3>(11, 1);
+    dmath::vec3soa soa(vectors);
+
+    CHECK(soa.size() == vectors.size());
+    CHECK(soa.toVectors() == vectors);
+    for (std::size_t i = 0; i < vectors.size(); i++)
+        CHECK(soa[i] == vectors[i]);
+
+    SECTION("Components are stored contiguously.")
+    {
+        auto y = soa.component(1);
+        for (std::size_t i = 0; i < vectors.size(); i++)
+            CHECK(y[i] == vectors[i].y());
+    }
+    SECTION("Spans write through to the underlying storage.")
+    {
+        auto span = soa.span().subspan(3, 4);
+        CHECK(span.size() == 4);
+        span.set(1, dmath::vec3(1, 2, 3));
+        CHECK(soa[4] == dmath::vec3(1, 2, 3));
+
+        dmath::VectorSoASpan<const float, 3> const_span = span;
+        std::vector<dmath::vec3> copied(4);
+        const_span.copyTo(copied);
+        CHECK(copied[1] == dmath::vec3(1, 2, 3));
+
+        std::vector<dmath::vec3> replacement(4, dmath::vec3(7));
+        span.copyFrom(replacement);
+        CHECK(soa[3] == dmath::vec3(7));
+        CHECK(soa[6] == dmath::vec3(7));
+        CHECK(soa[7] == vectors[7]);
+    }
+    SECTION("Vectors can be appended and resized.")
+    {
+        soa.push_back(dmath::vec3(4, 5, 6));
+        CHECK(soa.size() == vectors.size() + 1);
+        CHECK(soa[vectors.size()] == dmath::vec3(4, 5, 6));
+        soa.resize(2, dmath::vec3(9));
+        CHECK(soa.toVectors() == std::vector{vectors[0], vectors[1]});
+        soa.clear();
+        CHECK(soa.empty());
+    }
+}
+
+TEST_CASE("VectorSoA bulk operations match the scalar vector operations bit for bit.", "[vectorsoa]")
+{
+    auto count = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{5}, std::size_t{37});
+    CAPTURE(count);
+
+    auto lhs = sampleVectors<3>(count, 1);
+    auto rhs = sampleVectors<3>(count, 2);
+    dmath::vec3soa soa_lhs(lhs);
+    dmath::vec3soa soa_rhs(rhs);
+    dmath::vec3 factor(0.5f, -3.0f, 7.25f);
+
+    auto sum = soa_lhs + soa_rhs;
+    auto product = soa_lhs * soa_rhs;
+    auto quotient = soa_lhs / soa_rhs;
+    auto scaled = soa_lhs * factor;
+    auto dot = soa_lhs.dot(soa_rhs);
+    auto length = soa_lhs.length();
+    auto normalized = soa_lhs.normalize();
+
+    for (std::size_t i = 0; i < count; i++) {
+        CAPTURE(i);
+        CHECK(identical(sum[i], lhs[i] + rhs[i]));
+        CHECK(identical(product[i], lhs[i] * rhs[i]));
+        CHECK(identical(quotient[i], lhs[i] / rhs[i]));
+        CHECK(identical(scaled[i], lhs[i] * factor));
+        CHECK(identical(dot[i], lhs[i].dot(rhs[i])));
+        CHECK(identical(length[i], lhs[i].length()));
+        CHECK(identical(normalized[i], lhs[i].normalize()));
+    }
+
+    if (count > 0) {
+        auto min = lhs.front();
+        auto max = lhs.front();
+        for (const auto& vector : lhs) {
+            min = min.min(vector);
+            max = max.max(vector);
+        }
+        CHECK(identical(soa_lhs.min(), min));
+        CHECK(identical(soa_lhs.max(), max));
+    }
+}
+
+TEST_CASE("VectorSoA can be transformed by matrices and quaternions.", "[vectorsoa]")
+{
+    auto count = GENERATE(std::size_t{1}, std::size_t{6}, std::size_t{33});
+    CAPTURE(count);
+
+    auto points3 = sampleVectors<3>(count, 3);
+    auto points4 = sampleVectors<4>(count, 4);
+    dmath::vec3soa soa3(points3);
+    dmath::vec4soa soa4(points4);
+
+    dmath::mat4 mat4{{{1.5f, 2.0f, -3.0f, 0.25f},
+                      {0.0f, -1.0f, 4.0f, 1.0f},
+                      {5.5f, 0.125f, 1.0f, -2.0f},
+                      {-0.5f, 3.0f, 2.0f, 1.0f}}};
+    dmath::mat3 mat3 = mat4.minor(3, 3);
+    dmath::mat3x4 mat3x4{{{1.0f, 2.0f, 3.0f, 4.0f}, {-1.0f, 0.5f, 0.25f, 8.0f}, {2.0f, -3.0f, 1.5f, 0.0f}}};
+    auto quat = dmath::quat::fromAxis(dmath::vec3(1.0f, 2.0f, -0.5f).normalize(), 37.0f);
+
+    auto transformed4 = mat4 * soa4;
+    auto transformed3 = mat3 * soa3;
+    auto extended = mat3x4 * soa3;
+    auto rotated = quat * soa3;
+
+    for (std::size_t i = 0; i < count; i++) {
+        CAPTURE(i);
+        CHECK(identical(transformed4[i], mat4 * points4[i]));
+        CHECK(identical(transformed3[i], mat3 * points3[i]));
+        CHECK(identical(extended[i], mat3x4 * points3[i]));
+        CHECK(identical(rotated[i], quat * points3[i]));
+    }
+}
+
+TEST_CASE("VectorSoA bulk operations can be benchmarked against lists of vectors.", "[.][vectorsoa][benchmark]")
+{
+    constexpr std::size_t count = 1 << 16;
+    auto points = sampleVectors<3>(count, 5);
+    auto offsets = sampleVectors<3>(count, 6);
+    dmath::vec3soa soa_points(points);
+    dmath::vec3soa soa_offsets(offsets);
+
+    auto matrix = dmath::mat3{{{0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 2.0f}}};
+    auto quat = dmath::quat::fromAxis(dmath::vec3(0.0f, 0.0f, 1.0f), 45.0f);
+
+    std::vector<dmath::vec3> result(count);
+
+    BENCHMARK("add (vectors)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = points[i] + offsets[i];
+        return result.back();
+    };
+    BENCHMARK("add (soa)") { return soa_points + soa_offsets; };
+
+    BENCHMARK("normalize (vectors)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = points[i].normalize();
+        return result.back();
+    };
+    BENCHMARK("normalize (soa)") { return soa_points.normalize(); };
+
+    BENCHMARK("matrix * points (vectors)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = matrix * points[i];
+        return result.back();
+    };
+    BENCHMARK("matrix * points (soa)") { return matrix * soa_points; };
+
+    BENCHMARK("quaternion * points (vectors)")
+    {
+        for (std::size_t i = 0; i < count; i++)
+            result[i] = quat * points[i];
+        return result.back();
+    };
+    BENCHMARK("quaternion * points (soa)") { return quat * soa_points; };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "dang-utils/global.h"
+
+namespace dang::utils {
+
+/// @brief A simple linear congruential generator, so that samples are deterministic across runs and platforms.
+/// @remark Only the upper half of the state is ever returned, as the lower bits of an LCG have very short periods.
+struct SampleGenerator {
+    std::uint64_t state;
+
+    /// @brief Returns 32 random bits.
+    constexpr std::uint32_t next()
+    {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        return static_cast<std::uint32_t>(state >> 32);
+    }
+
+    /// @brief Returns 64 random bits.
+    constexpr std::uint64_t next64()
+    {
+        auto high = std::uint64_t{next()} << 32;
+        return high | next();
+    }
+
+    /// @brief Returns a value in the range [0, 1), which is evenly spaced, so that scaling by powers of two is exact.
+    constexpr float nextFloat() { return static_cast<float>(next() >> 8) / static_cast<float>(1u << 24); }
+
+    /// @brief Returns a value in the range [min, max).
+    constexpr float nextFloat(float min, float max) { return min + nextFloat() * (max - min); }
+};
+
+} // namespace dang::utils
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "dang-utils/global.h"
+
+namespace dang::utils {
+
+/// @brief Splits the range [0, count) into contiguous chunks and calls function(begin, end) for each of them, using
+/// one thread per chunk.
+/// @remark Chunks contain at least min_chunk_size elements, so small ranges are processed on the calling thread only.
+/// @remark The calling thread processes the first chunk itself and waits for all other chunks to finish.
+/// @remark The function must not throw, as there is no way to propagate exceptions out of the worker threads.
+template <typename TFunction>
+void parallelFor(std::size_t count, std::size_t min_chunk_size, TFunction function)
+{
+    if (count == 0)
+        return;
+
+    std::size_t max_threads = std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+    std::size_t thread_count = std::clamp(count / std::max(min_chunk_size, std::size_t{1}), std::size_t{1}, max_threads);
+    if (thread_count == 1) {
+        function(std::size_t{0}, count);
+        return;
+    }
+
+    auto chunkBegin = [&](std::size_t chunk) { return chunk * count / thread_count; };
+
+    std::vector<std::jthread> threads;
+    threads.reserve(thread_count - 1);
+    for (std::size_t chunk = 1; chunk < thread_count; chunk++)
+        threads.emplace_back(
+            [&function, begin = chunkBegin(chunk), end = chunkBegin(chunk + 1)] { function(begin, end); });
+    function(std::size_t{0}, chunkBegin(1));
+}
+
+/// @brief A fixed number of worker threads, which process submitted tasks in order.
+/// @remark Destroying the pool finishes all queued tasks before joining the worker threads.
+class ThreadPool {
+public:
+    /// @brief Starts the given number of worker threads, defaulting to one per hardware thread.
+    explicit ThreadPool(std::size_t thread_count = defaultThreadCount())
+    {
+        threads_.reserve(std::max(thread_count, std::size_t{1}));
+        for (std::size_t i = 0; i < std::max(thread_count, std::size_t{1}); i++)
+            threads_.emplace_back([this] { work(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /// @brief A pool with one thread per hardware thread, which is shared by everything that does not bring its own.
+    static ThreadPool& shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /// @brief The number of hardware threads, but at least one.
+    static std::size_t defaultThreadCount()
+    {
+        return std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+    }
+
+    /// @brief The number of worker threads.
+    std::size_t threadCount() const { return threads_.size(); }
+
+    /// @brief Queues the function to be called on one of the worker threads.
+    /// @remark Exceptions are stored in the returned future.
+    template <typename TFunction>
+    auto submit(TFunction function) -> std::future<std::invoke_result_t<TFunction&>>
+    {
+        // std::function requires copyable functions, which a packaged_task is not.
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<TFunction&>()>>(std::move(function));
+        auto result = task->get_future();
+        {
+            std::scoped_lock lock(mutex_);
+            tasks_.emplace_back([task = std::move(task)] { (*task)(); });
+        }
+        condition_.notify_one();
+        return result;
+    }
+
+private:
+    void work()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock, [&] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty())
+                    return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    // Declared last, so that the threads are joined before anything else is destroyed.
+    std::vector<std::jthread> threads_;
+};
+
+/// @brief Splits the range [0, count) into contiguous chunks and calls function(begin, end) for each of them, using the
+/// worker threads of the given pool instead of starting new threads.
+/// @remark Chunks contain at least min_chunk_size elements, so small ranges are processed on the calling thread only.
+/// @remark The calling thread processes chunks as well and only waits for chunks, that are already being processed,
+/// which makes it safe to call from within a task of the same pool.
+/// @remark The function must not throw, as there is no way to propagate exceptions out of the worker threads.
+template <typename TFunction>
+void parallelFor(ThreadPool& thread_pool, std::size_t count, std::size_t min_chunk_size, TFunction function)
+{
+    if (count == 0)
+        return;
+
+    std::size_t max_chunks = thread_pool.threadCount() + 1;
+    std::size_t chunk_count = std::clamp(count / std::max(min_chunk_size, std::size_t{1}), std::size_t{1}, max_chunks);
+    if (chunk_count == 1) {
+        function(std::size_t{0}, count);
+        return;
+    }
+
+    // Tasks, that only start once all chunks are done, must not touch the function or anything else on the stack.
+    struct State {
+        std::atomic<std::size_t> next_chunk = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t finished_chunks = 0;
+    };
+    auto state = std::make_shared<State>();
+
+    auto process = [state, &function, count, chunk_count] {
+        for (auto chunk = state->next_chunk++; chunk < chunk_count; chunk = state->next_chunk++) {
+            function(chunk * count / chunk_count, (chunk + 1) * count / chunk_count);
+            std::scoped_lock lock(state->mutex);
+            if (++state->finished_chunks == chunk_count)
+                state->finished.notify_all();
+        }
+    };
+    for (std::size_t chunk = 1; chunk < chunk_count; chunk++)
+        thread_pool.submit(process);
+    process();
+
+    std::unique_lock lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->finished_chunks == chunk_count; });
+}
+
+} // namespace dang::utils
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <array>
+#include <bit>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
 #include <utility>
 
 #include "dang-utils/global.h"
 
+#if !defined(DANG_UTILS_NO_BMI2) && defined(__BMI2__)
+#define DANG_UTILS_BMI2
+#include <immintrin.h>
+#endif
+
 #ifdef _MSC_VER
 #define DANG_MSVC_FORCE_EBO __declspec(empty_bases)
 #else
@@ -280,53 +289,32 @@ struct remove_cvref {
 template <class T>
 using remove_cvref_t = typename remove_cvref<T>::type;
 
-// TODO: C++20 replace with std::popcount
+/// @brief Forwards to std::popcount, which compiles down to a single instruction where available.
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 [[nodiscard]] constexpr int popcount(T value)
 {
-    static_assert(char_bit == 8);
-    constexpr std::size_t bits = sizeof(T) * char_bit;
-    // Modified version of an algorithm taken from:
-    // https://en.wikipedia.org/wiki/Hamming_weight
-    constexpr auto m1 = static_cast<T>(0x5555555555555555);
-    constexpr auto m2 = static_cast<T>(0x3333333333333333);
-    constexpr auto m4 = static_cast<T>(0x0f0f0f0f0f0f0f0f);
-    constexpr auto h01 = static_cast<T>(0x0101010101010101);
-    value -= (value >> 1) & m1;
-    value = (value & m2) + ((value >> 2) & m2);
-    value = (value + (value >> 4)) & m4;
-    return static_cast<int>(static_cast<T>(value * h01) >> (bits - 8));
+    return std::popcount(value);
 }
 
-// TODO: C++20 replace with std::bit_width
+/// @brief Forwards to std::bit_width, which compiles down to a single instruction where available.
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 [[nodiscard]] constexpr int bit_width(T value)
 {
-    int count = 0;
-    while (value) {
-        value = static_cast<T>(value >> 1);
-        count++;
-    }
-    return count;
+    return static_cast<int>(std::bit_width(value));
 }
 
-// TODO: C++20 replace with std::countl_zero
+/// @brief Forwards to std::countl_zero, which compiles down to a single instruction where available.
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 [[nodiscard]] constexpr int countl_zero(T value)
 {
-    return sizeof(T) * char_bit - bit_width(value);
+    return std::countl_zero(value);
 }
 
-// TODO: C++20 replace with std::countr_zero
+/// @brief Forwards to std::countr_zero, which compiles down to a single instruction where available.
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 [[nodiscard]] constexpr int countr_zero(T value)
 {
-    int count = 0;
-    while (value) {
-        value = static_cast<T>(value << 1);
-        count++;
-    }
-    return sizeof(T) * char_bit - count;
+    return std::countr_zero(value);
 }
 
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
@@ -340,17 +328,61 @@ template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 [[nodiscard]] constexpr int ilog2ceil(T value)
 {
     assert(value > 0);
-    return bit_width(value - 1);
+    return bit_width(static_cast<T>(value - 1));
+}
+
+namespace detail {
+
+/// @brief A mask of every v_stride-th bit, limited to as many bits as fit v_stride times into T.
+template <typename T, std::size_t v_stride>
+inline constexpr T every_nth_bit = [] {
+    T result = 0;
+    for (std::size_t bit = 0; bit < sizeof(T) * char_bit / v_stride; bit++)
+        result |= static_cast<T>(T{1} << (bit * v_stride));
+    return result;
+}();
+
+#ifdef DANG_UTILS_BMI2
+
+/// @brief Scatters the low bits of value to the set bits of mask, using the BMI2 pdep instruction.
+template <typename T>
+T depositBits(T value, T mask)
+{
+    if constexpr (sizeof(T) <= sizeof(std::uint32_t))
+        return static_cast<T>(_pdep_u32(value, mask));
+    else
+        return static_cast<T>(_pdep_u64(value, mask));
+}
+
+/// @brief Gathers the bits of value at the set bits of mask into the low bits, using the BMI2 pext instruction.
+template <typename T>
+T extractBits(T value, T mask)
+{
+    if constexpr (sizeof(T) <= sizeof(std::uint32_t))
+        return static_cast<T>(_pext_u32(value, mask));
+    else
+        return static_cast<T>(_pext_u64(value, mask));
 }
 
+#endif
+
+} // namespace detail
+
 /// @brief Removes every odd bit, shifting over every even bit into the less significant half of the value.
-/// @remark Inverse operation to interleaveBits.
+/// @remark Inverse operation to interleaveZeros.
+/// @remark Uses the BMI2 pext instruction when targeting it, unless DANG_UTILS_NO_BMI2 is defined. Some older AMD
+/// CPUs implement it in microcode, which is slower than the portable fallback.
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 [[nodiscard]] constexpr T removeOddBits(T value)
 {
     constexpr auto bits = sizeof(T) * char_bit;
     static_assert(bits <= 64);
 
+#ifdef DANG_UTILS_BMI2
+    if (!std::is_constant_evaluated())
+        return detail::extractBits(value, detail::every_nth_bit<T, 2>);
+#endif
+
     if constexpr (bits >= 2)
         value &= static_cast<T>(0x5555555555555555);
     if constexpr (bits >= 4)
@@ -369,7 +401,8 @@ template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 
 /// @brief Interleaves zeros in between every existing bit.
 /// @remark Inverse operation to removeOddBits.
-/// @remark The more significant half of the value should be filled with zero.
+/// @remark Only the less significant half of bits are kept, all others are discarded.
+/// @remark Uses the BMI2 pdep instruction when targeting it, unless DANG_UTILS_NO_BMI2 is defined.
 template <typename T>
 [[nodiscard]] constexpr T interleaveZeros(T value)
 {
@@ -378,6 +411,12 @@ template <typename T>
     constexpr auto bits = sizeof(T) * char_bit;
     static_assert(bits <= 64);
 
+#ifdef DANG_UTILS_BMI2
+    if (!std::is_constant_evaluated())
+        return detail::depositBits(value, detail::every_nth_bit<T, 2>);
+#endif
+
+    value &= std::numeric_limits<T>::max() >> bits / 2;
     if constexpr (bits >= 64)
         value = (value | value << 16) & static_cast<T>(0x0000FFFF0000FFFF);
     if constexpr (bits >= 32)
@@ -392,6 +431,102 @@ template <typename T>
     return value;
 }
 
+/// @brief Keeps only every third bit, starting with the least significant one, and packs them together.
+/// @remark Inverse operation to interleaveTwoZeros.
+/// @remark Uses the BMI2 pext instruction when targeting it, unless DANG_UTILS_NO_BMI2 is defined.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+[[nodiscard]] constexpr T removeTwoThirdsOfBits(T value)
+{
+    static_assert(sizeof(T) * char_bit <= 64);
+
+#ifdef DANG_UTILS_BMI2
+    if (!std::is_constant_evaluated())
+        return detail::extractBits(value, detail::every_nth_bit<T, 3>);
+#endif
+
+    if constexpr (sizeof(T) > sizeof(std::uint32_t)) {
+        std::uint64_t result = value & detail::every_nth_bit<T, 3>;
+        result = (result ^ (result >> 2)) & 0x10C30C30C30C30C3;
+        result = (result ^ (result >> 4)) & 0x100F00F00F00F00F;
+        result = (result ^ (result >> 8)) & 0x001F0000FF0000FF;
+        result = (result ^ (result >> 16)) & 0x001F00000000FFFF;
+        result = (result ^ (result >> 32)) & 0x00000000001FFFFF;
+        return static_cast<T>(result);
+    }
+    else {
+        std::uint32_t result = value & detail::every_nth_bit<T, 3>;
+        result = (result ^ (result >> 2)) & 0x030C30C3;
+        result = (result ^ (result >> 4)) & 0x0300F00F;
+        result = (result ^ (result >> 8)) & 0xFF0000FF;
+        result = (result ^ (result >> 16)) & 0x000003FF;
+        return static_cast<T>(result);
+    }
+}
+
+/// @brief Interleaves two zeros in between every existing bit.
+/// @remark Inverse operation to removeTwoThirdsOfBits.
+/// @remark Only the least significant third of bits are kept, all others are discarded.
+/// @remark Uses the BMI2 pdep instruction when targeting it, unless DANG_UTILS_NO_BMI2 is defined.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+[[nodiscard]] constexpr T interleaveTwoZeros(T value)
+{
+    constexpr auto bits = sizeof(T) * char_bit;
+    static_assert(bits <= 64);
+
+#ifdef DANG_UTILS_BMI2
+    if (!std::is_constant_evaluated())
+        return detail::depositBits(value, detail::every_nth_bit<T, 3>);
+#endif
+
+    if constexpr (sizeof(T) > sizeof(std::uint32_t)) {
+        std::uint64_t result = value & ((std::uint64_t{1} << bits / 3) - 1);
+        result = (result | result << 32) & 0x001F00000000FFFF;
+        result = (result | result << 16) & 0x001F0000FF0000FF;
+        result = (result | result << 8) & 0x100F00F00F00F00F;
+        result = (result | result << 4) & 0x10C30C30C30C30C3;
+        result = (result | result << 2) & 0x1249249249249249;
+        return static_cast<T>(result);
+    }
+    else {
+        std::uint32_t result = value & ((std::uint32_t{1} << bits / 3) - 1);
+        result = (result | result << 16) & 0x030000FF;
+        result = (result | result << 8) & 0x0300F00F;
+        result = (result | result << 4) & 0x030C30C3;
+        result = (result | result << 2) & 0x09249249;
+        return static_cast<T>(result);
+    }
+}
+
+/// @brief Combines two coordinates into a Morton code (Z-order curve), with x in the even and y in the odd bits.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+[[nodiscard]] constexpr T mortonEncode2(T x, T y)
+{
+    return static_cast<T>(interleaveZeros(x) | interleaveZeros(y) << 1);
+}
+
+/// @brief Splits a Morton code (Z-order curve) back into its two coordinates.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+[[nodiscard]] constexpr std::array<T, 2> mortonDecode2(T code)
+{
+    return {removeOddBits(code), removeOddBits(static_cast<T>(code >> 1))};
+}
+
+/// @brief Combines three coordinates into a Morton code (Z-order curve), using every third bit for each of them.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+[[nodiscard]] constexpr T mortonEncode3(T x, T y, T z)
+{
+    return static_cast<T>(interleaveTwoZeros(x) | interleaveTwoZeros(y) << 1 | interleaveTwoZeros(z) << 2);
+}
+
+/// @brief Splits a Morton code (Z-order curve) back into its three coordinates.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+[[nodiscard]] constexpr std::array<T, 3> mortonDecode3(T code)
+{
+    return {removeTwoThirdsOfBits(code),
+            removeTwoThirdsOfBits(static_cast<T>(code >> 1)),
+            removeTwoThirdsOfBits(static_cast<T>(code >> 2))};
+}
+
 template <typename T>
 [[nodiscard]] constexpr auto sqr(const T& value)
 {
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dang-utils/parallel.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+namespace dutils = dang::utils;
+
+TEST_CASE("parallelFor calls the function for contiguous chunks, which cover the whole range.", "[parallel]")
+{
+    constexpr std::size_t count = 100'000;
+    std::vector<int> visits(count);
+    std::atomic<std::size_t> chunks = 0;
+
+    dutils::parallelFor(count, 1'000, [&](std::size_t begin, std::size_t end) {
+        CHECK(begin < end);
+        for (auto i = begin; i < end; i++)
+            visits[i]++;
+        chunks++;
+    });
+
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int visit) { return visit == 1; }));
+    CHECK(chunks >= 1);
+    CHECK(chunks <= std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+TEST_CASE("parallelFor processes small ranges in a single chunk.", "[parallel]")
+{
+    std::vector<std::pair<std::size_t, std::size_t>> calls;
+    dutils::parallelFor(10, 1'000, [&](std::size_t begin, std::size_t end) { calls.emplace_back(begin, end); });
+    CHECK(calls == std::vector<std::pair<std::size_t, std::size_t>>{{0, 10}});
+
+    dutils::parallelFor(0, 1'000, [&](std::size_t, std::size_t) { FAIL("Called for empty range."); });
+}
+
+TEST_CASE("ThreadPool runs all submitted tasks and stores their results in futures.", "[parallel]")
+{
+    dutils::ThreadPool pool(3);
+    CHECK(pool.threadCount() == 3);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; i++)
+        results.push_back(pool.submit([i] { return i * i; }));
+    for (int i = 0; i < 100; i++)
+        CHECK(results[i].get() == i * i);
+
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+    CHECK_THROWS_AS(failing.get(), std::runtime_error);
+}
+
+TEST_CASE("parallelFor can distribute chunks onto the threads of a ThreadPool.", "[parallel]")
+{
+    constexpr std::size_t count = 100'000;
+    dutils::ThreadPool pool(3);
+    std::vector<int> visits(count);
+    std::atomic<std::size_t> chunks = 0;
+
+    dutils::parallelFor(pool, count, 1'000, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; i++)
+            visits[i]++;
+        chunks++;
+    });
+
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int visit) { return visit == 1; }));
+    CHECK(chunks == 4);
+
+    SECTION("Calling it from within a task of the same pool does not wait for queued tasks.")
+    {
+        dutils::ThreadPool single(1);
+        std::atomic<std::size_t> visited = 0;
+        single
+            .submit([&] {
+                dutils::parallelFor(single, count, 1'000, [&](std::size_t begin, std::size_t end) {
+                    visited += end - begin;
+                });
+            })
+            .get();
+        CHECK(visited == count);
+    }
+}
+
+TEST_CASE("ThreadPool finishes all queued tasks when it is destroyed.", "[parallel]")
+{
+    std::atomic<int> done = 0;
+    {
+        dutils::ThreadPool pool(2);
+        for (int i = 0; i < 100; i++)
+            pool.submit([&] { done++; });
+    }
+    CHECK(done == 100);
+}
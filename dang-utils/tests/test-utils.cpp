@@ -0,0 +1,190 @@
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "dang-utils/catch2-sample-generator.h"
+#include "dang-utils/utils.h"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace dutils = dang::utils;
+
+namespace {
+
+/// @brief Returns a mix of random values and edge cases for the given type.
+template <typename T>
+std::vector<T> sampleValues()
+{
+    std::vector<T> result{0, 1, 2, 3, std::numeric_limits<T>::max(), static_cast<T>(std::numeric_limits<T>::max() / 2)};
+    for (int bit = 0; bit < std::numeric_limits<T>::digits; bit++)
+        result.push_back(static_cast<T>(T{1} << bit));
+    dutils::SampleGenerator generator{1};
+    for (int i = 0; i < 1000; i++)
+        result.push_back(static_cast<T>(generator.next64() >> (i % 64)));
+    return result;
+}
+
+/// @brief A naive implementation to compare against, which moves every v_stride-th bit into the low bits.
+template <std::size_t v_stride, typename T>
+T referenceExtract(T value)
+{
+    T result = 0;
+    for (std::size_t bit = 0; bit < sizeof(T) * dutils::char_bit / v_stride; bit++)
+        result |= static_cast<T>(((value >> (bit * v_stride)) & 1) << bit);
+    return result;
+}
+
+/// @brief A naive implementation to compare against, which moves the low bits to every v_stride-th bit.
+template <std::size_t v_stride, typename T>
+T referenceDeposit(T value)
+{
+    T result = 0;
+    for (std::size_t bit = 0; bit < sizeof(T) * dutils::char_bit / v_stride; bit++)
+        result |= static_cast<T>(((value >> bit) & 1) << (bit * v_stride));
+    return result;
+}
+
+} // namespace
+
+static_assert(dutils::popcount(0b1011u) == 3);
+static_assert(dutils::bit_width(0u) == 0);
+static_assert(dutils::bit_width(0b1011u) == 4);
+static_assert(dutils::countl_zero(std::uint8_t{0b0001'0000}) == 3);
+static_assert(dutils::countr_zero(std::uint8_t{0b0001'0000}) == 4);
+static_assert(dutils::countr_zero(std::uint16_t{0}) == 16);
+static_assert(dutils::ilog2(1u) == 0);
+static_assert(dutils::ilog2(255u) == 7);
+static_assert(dutils::ilog2ceil(1u) == 0);
+static_assert(dutils::ilog2ceil(257u) == 9);
+static_assert(dutils::interleaveZeros(std::uint8_t{0b1111}) == 0b0101'0101);
+static_assert(dutils::removeOddBits(std::uint8_t{0b1101'0011}) == 0b1101);
+static_assert(dutils::interleaveTwoZeros(std::uint16_t{0b11111}) == 0b0001'0010'0100'1001);
+static_assert(dutils::removeTwoThirdsOfBits(std::uint16_t{0b0001'0010'0100'1001}) == 0b11111);
+static_assert(dutils::mortonEncode2(std::uint32_t{0b11}, std::uint32_t{0b01}) == 0b0111);
+static_assert(dutils::mortonDecode2(std::uint32_t{0b0111}) == std::array<std::uint32_t, 2>{0b11, 0b01});
+static_assert(dutils::mortonEncode3(std::uint32_t{1}, std::uint32_t{0}, std::uint32_t{1}) == 0b101);
+static_assert(dutils::mortonDecode3(std::uint32_t{0b110'101}) == std::array<std::uint32_t, 3>{1, 2, 3});
+
+TEMPLATE_TEST_CASE("Bit utilities match naive implementations.",
+                   "[utils]",
+                   std::uint8_t,
+                   std::uint16_t,
+                   std::uint32_t,
+                   std::uint64_t)
+{
+    // Compares against naive loops, which also covers the BMI2 path when compiling for it.
+    for (auto value : sampleValues<TestType>()) {
+        CAPTURE(value);
+
+        int width = 0;
+        while (width < std::numeric_limits<TestType>::digits && (value >> width) != 0)
+            width++;
+        CHECK(dutils::bit_width(value) == width);
+        if (value != 0) {
+            CHECK(dutils::ilog2(value) == width - 1);
+            CHECK(dutils::countl_zero(value) == std::numeric_limits<TestType>::digits - width);
+            CHECK(((value >> dutils::countr_zero(value)) & 1) == 1);
+        }
+
+        CHECK(dutils::removeOddBits(value) == referenceExtract<2>(value));
+        CHECK(dutils::interleaveZeros(value) == referenceDeposit<2>(value));
+        CHECK(dutils::removeTwoThirdsOfBits(value) == referenceExtract<3>(value));
+        CHECK(dutils::interleaveTwoZeros(value) == referenceDeposit<3>(value));
+    }
+}
+
+TEMPLATE_TEST_CASE("Morton codes can be encoded and decoded again.", "[utils]", std::uint32_t, std::uint64_t)
+{
+    constexpr auto half = std::numeric_limits<TestType>::digits / 2;
+    constexpr auto third = std::numeric_limits<TestType>::digits / 3;
+
+    dutils::SampleGenerator generator{2};
+    for (int i = 0; i < 1000; i++) {
+        auto x = static_cast<TestType>(generator.next64());
+        auto y = static_cast<TestType>(generator.next64());
+        auto z = static_cast<TestType>(generator.next64());
+
+        auto half_mask = static_cast<TestType>((TestType{1} << half) - 1);
+        auto [x2, y2] = dutils::mortonDecode2(dutils::mortonEncode2(x & half_mask, y & half_mask));
+        CHECK(x2 == (x & half_mask));
+        CHECK(y2 == (y & half_mask));
+
+        auto third_mask = static_cast<TestType>((TestType{1} << third) - 1);
+        auto [x3, y3, z3] = dutils::mortonDecode3(dutils::mortonEncode3(x & third_mask, y & third_mask, z));
+        CHECK(x3 == (x & third_mask));
+        CHECK(y3 == (y & third_mask));
+        CHECK(z3 == (z & third_mask));
+    }
+}
+
+TEST_CASE("Bit utilities can be benchmarked.", "[.][utils][benchmark]")
+{
+    // Each benchmark processes the same 4096 values, so that they can be compared with each other.
+    std::vector<std::uint64_t> values;
+    dutils::SampleGenerator generator{3};
+    for (int i = 0; i < 4096; i++)
+        values.push_back(generator.next64() >> (i % 63) | 1);
+
+    BENCHMARK("bit_width")
+    {
+        int result = 0;
+        for (auto value : values)
+            result += dutils::bit_width(value);
+        return result;
+    };
+
+    BENCHMARK("countr_zero")
+    {
+        int result = 0;
+        for (auto value : values)
+            result += dutils::countr_zero(value);
+        return result;
+    };
+
+    BENCHMARK("ilog2")
+    {
+        int result = 0;
+        for (auto value : values)
+            result += dutils::ilog2(value);
+        return result;
+    };
+
+    BENCHMARK("mortonEncode2")
+    {
+        std::uint64_t result = 0;
+        for (auto value : values)
+            result ^= dutils::mortonEncode2(value & 0xFFFFFFFF, value >> 32);
+        return result;
+    };
+
+    BENCHMARK("mortonDecode2")
+    {
+        std::uint64_t result = 0;
+        for (auto value : values) {
+            auto [x, y] = dutils::mortonDecode2(value);
+            result ^= x + y;
+        }
+        return result;
+    };
+
+    BENCHMARK("mortonEncode3")
+    {
+        std::uint64_t result = 0;
+        for (auto value : values)
+            result ^= dutils::mortonEncode3(value, value >> 21, value >> 42);
+        return result;
+    };
+
+    BENCHMARK("mortonDecode3")
+    {
+        std::uint64_t result = 0;
+        for (auto value : values) {
+            auto [x, y, z] = dutils::mortonDecode3(value);
+            result ^= x + y + z;
+        }
+        return result;
+    };
+}